@@ -0,0 +1,103 @@
+// dapp/app/api/frame/route.ts
+// Binary counterpart of create-digest and execute-sponsored: one request
+// frame in, one response frame out (see lib/sensor-frame.ts)
+import { NextRequest, NextResponse } from "next/server";
+import { z } from "zod";
+import {
+  FRAME_CONTENT_TYPE,
+  FRAME_MAX_SIZE,
+  FrameError,
+  FrameType,
+  decodeDigestRequest,
+  decodeExecuteRequest,
+  decodeGasCoinsRequest,
+  encodeDigestResponse,
+  encodeError,
+  encodeExecuteResponse,
+  encodeGasCoinsResponse,
+  parseFrame,
+} from "@/lib/sensor-frame";
+import {
+  SponsorError,
+  SponsoredReadingSchema,
+  executeSponsoredReading,
+  fetchCycleObjects,
+  fetchGasCoins,
+} from "@/lib/sponsor";
+
+// CORS headers
+const corsHeaders = {
+  "Access-Control-Allow-Origin": "*",
+  "Access-Control-Allow-Methods": "POST, OPTIONS",
+  "Access-Control-Allow-Headers": "Content-Type, X-API-Key",
+};
+
+function frameResponse(frame: Uint8Array, status: number) {
+  return new NextResponse(Buffer.from(frame), {
+    status,
+    headers: { ...corsHeaders, "Content-Type": FRAME_CONTENT_TYPE },
+  });
+}
+
+export async function POST(request: NextRequest) {
+  try {
+    const body = new Uint8Array(await request.arrayBuffer());
+    if (body.length > FRAME_MAX_SIZE) {
+      throw new FrameError("Frame too large");
+    }
+
+    const frame = parseFrame(body);
+
+    switch (frame.type) {
+      case FrameType.DigestRequest: {
+        const senderAddress = decodeDigestRequest(frame);
+        const objects = await fetchCycleObjects(senderAddress);
+        return frameResponse(encodeDigestResponse(objects), 200);
+      }
+
+      case FrameType.ExecuteRequest: {
+        const { reading, gas, signature } = decodeExecuteRequest(frame);
+        console.log("[Frame] Execute request:", { ...reading, gas, signature });
+
+        const { result, next } = await executeSponsoredReading(
+          SponsoredReadingSchema.parse(reading),
+          signature,
+          gas
+        );
+        return frameResponse(encodeExecuteResponse(result.digest, next), 200);
+      }
+
+      case FrameType.GasCoinsRequest: {
+        const { senderAddress, count } = decodeGasCoinsRequest(frame);
+        const coins = await fetchGasCoins(senderAddress, count);
+        return frameResponse(encodeGasCoinsResponse(coins), 200);
+      }
+
+      default:
+        throw new FrameError(`Unsupported frame type ${frame.type}`);
+    }
+  } catch (error: any) {
+    if (error instanceof SponsorError) {
+      return frameResponse(
+        encodeError(error.status, `${error.error}: ${error.details}`),
+        error.status
+      );
+    }
+    if (error instanceof FrameError || error instanceof z.ZodError) {
+      return frameResponse(encodeError(400, error.message), 400);
+    }
+
+    console.error("[Frame] Error:", error);
+    return frameResponse(
+      encodeError(500, error.message || "Unknown error"),
+      500
+    );
+  }
+}
+
+export async function OPTIONS() {
+  return NextResponse.json(null, {
+    status: 204,
+    headers: corsHeaders,
+  });
+}
@@ -1,5 +1,6 @@
 import { NextRequest, NextResponse } from 'next/server';
 import { submitSignedTransaction } from '@/lib/transaction-builder';
+import { isVersionConflict } from '@/lib/sponsor';
 
 export async function POST(request: NextRequest) {
   try {
@@ -31,12 +32,13 @@ export async function POST(request: NextRequest) {
   } catch (error: any) {
     console.error('Submit TX Error:', error);
     
+    // Stale gas ref: the device refetches its refs and signs again
     return NextResponse.json(
       {
         success: false,
         error: error.message || 'Failed to submit transaction'
       },
-      { status: 500 }
+      { status: isVersionConflict(error) ? 409 : 500 }
     );
   }
 }
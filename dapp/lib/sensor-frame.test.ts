@@ -0,0 +1,258 @@
+// dapp/lib/sensor-frame.test.ts
+// Frame codec tests (npm test). With FRAME_VECTORS_DIR set, also the
+// TypeScript half of the C -> TypeScript -> C round trip: frames written by
+// esp32_sensor/bench/frame_test --write are decoded here, re-encoded, and
+// written back as ts_*.bin for frame_test --check.
+import { test } from "node:test";
+import assert from "node:assert/strict";
+import { existsSync, readFileSync, writeFileSync } from "node:fs";
+import { join } from "node:path";
+import {
+  FRAME_HEADER_SIZE,
+  FRAME_MAX_SIZE,
+  Frame,
+  FrameError,
+  FrameType,
+  decodeDigestRequest,
+  decodeDigestResponse,
+  decodeError,
+  decodeExecuteRequest,
+  decodeExecuteResponse,
+  decodeGasCoinsRequest,
+  decodeGasCoinsResponse,
+  encodeDigestRequest,
+  encodeDigestResponse,
+  encodeError,
+  encodeExecuteRequest,
+  encodeExecuteResponse,
+  encodeGasCoinsRequest,
+  encodeGasCoinsResponse,
+  parseFrame,
+} from "./sensor-frame";
+import type { CycleObjects, GasCoins, GasRef, SponsoredReading } from "./sponsor";
+
+interface Vectors {
+  sender: string;
+  objects: CycleObjects;
+  reading: SponsoredReading;
+  gas: GasRef;
+  signature: string;
+  digest: string;
+  next: CycleObjects;
+  coins: GasCoins;
+  coinCount: number;
+  error: { status: number; message: string };
+  longError: { status: number; message: string };
+}
+
+const vectorsDir = process.env.FRAME_VECTORS_DIR;
+
+// Frames and values of the same shape as the C vectors, for runs without them
+const sample: Vectors = {
+  sender: "0x" + "33".repeat(32),
+  objects: {
+    sensorObjectId: "0x" + "22".repeat(32),
+    sensorVersion: "5882390",
+    gasObjectId: "0x" + "44".repeat(32),
+    gasVersion: "409312068",
+    gasDigest: "EFDAwevMr5AvBLNthn5dhbgz7x18akenyjYcfrsZcgPn",
+  },
+  reading: { temperature: 2357, humidity: 6533, ec: 1014, ph: 857, timestamp: 1730822820 },
+  gas: {
+    objectId: "0x" + "44".repeat(32),
+    version: "409312068",
+    digest: "EFDAwevMr5AvBLNthn5dhbgz7x18akenyjYcfrsZcgPn",
+  },
+  signature: Buffer.alloc(97, 7).toString("base64"),
+  digest: "6kDN4EEECyCmnbVW8MvmGaQneHrPwpo8TPPjExb7Kr3f",
+  next: {
+    sensorObjectId: "0x" + "22".repeat(32),
+    sensorVersion: "5882391",
+    gasObjectId: "0x" + "45".repeat(32),
+    gasVersion: "409312069",
+    gasDigest: "EK8U5xPNSNU9KRdQ95QYzUTkN7DLFpLcY9DGjEvAN1iV",
+  },
+  coins: {
+    sensorObjectId: "0x" + "22".repeat(32),
+    sensorVersion: "5882390",
+    gasCoins: [],
+  },
+  coinCount: 3,
+  error: { status: 409, message: "Gas coin version conflict" },
+  longError: { status: 409, message: "abcdefghijklmnopqrstuvwxyz".repeat(24) },
+};
+
+// Decode a frame of the named kind and encode the result again
+const codecs: Record<string, (frame: Frame, values: Vectors) => Uint8Array> = {
+  digest_request(frame, values) {
+    const sender = decodeDigestRequest(frame);
+    assert.equal(sender, values.sender);
+    return encodeDigestRequest(sender);
+  },
+  digest_response(frame, values) {
+    const objects = decodeDigestResponse(frame);
+    assert.deepEqual(objects, values.objects);
+    return encodeDigestResponse(objects);
+  },
+  execute_request(frame, values) {
+    const { reading, gas, signature } = decodeExecuteRequest(frame);
+    assert.deepEqual(reading, values.reading);
+    assert.deepEqual(gas, values.gas);
+    assert.equal(signature, values.signature);
+    return encodeExecuteRequest(reading, gas, signature);
+  },
+  execute_response(frame, values) {
+    const { digest, next } = decodeExecuteResponse(frame);
+    assert.equal(digest, values.digest);
+    assert.deepEqual(next, values.next);
+    return encodeExecuteResponse(digest, next);
+  },
+  gas_coins_request(frame, values) {
+    const { senderAddress, count } = decodeGasCoinsRequest(frame);
+    assert.equal(senderAddress, values.sender);
+    assert.equal(count, values.coinCount);
+    return encodeGasCoinsRequest(senderAddress, count);
+  },
+  gas_coins_response(frame, values) {
+    const coins = decodeGasCoinsResponse(frame);
+    assert.deepEqual(coins, values.coins);
+    return encodeGasCoinsResponse(coins);
+  },
+  error(frame, values) {
+    const { status, message } = decodeError(frame);
+    assert.deepEqual({ status, message }, values.error);
+    return encodeError(status, message);
+  },
+  error_long(frame, values) {
+    const { status, message } = decodeError(frame);
+    assert.equal(status, values.longError.status);
+    assert.equal(message, values.longError.message.slice(0, FRAME_MAX_SIZE - FRAME_HEADER_SIZE - 2));
+    return encodeError(status, message);
+  },
+};
+
+function sampleFrames(values: Vectors): Record<string, Uint8Array> {
+  return {
+    digest_request: encodeDigestRequest(values.sender),
+    digest_response: encodeDigestResponse(values.objects),
+    execute_request: encodeExecuteRequest(values.reading, values.gas, values.signature),
+    execute_response: encodeExecuteResponse(values.digest, values.next),
+    gas_coins_request: encodeGasCoinsRequest(values.sender, values.coinCount),
+    gas_coins_response: encodeGasCoinsResponse(values.coins),
+    error: encodeError(values.error.status, values.error.message),
+    error_long: encodeError(values.longError.status, values.longError.message),
+  };
+}
+
+function expectFrameError(fn: () => unknown) {
+  assert.throws(fn, FrameError);
+}
+
+test("every frame type round-trips", () => {
+  const values = { ...sample, coins: { ...sample.coins, gasCoins: [sample.gas, sample.gas] } };
+  for (const [name, frame] of Object.entries(sampleFrames(values))) {
+    assert.ok(frame.length <= FRAME_MAX_SIZE, name);
+    assert.deepEqual(codecs[name](parseFrame(frame), values), frame, name);
+  }
+});
+
+test("truncated and malformed frames are rejected", () => {
+  for (const [name, frame] of Object.entries(sampleFrames(sample))) {
+    // Every truncation, and one byte too many
+    for (let length = 0; length < frame.length; length++) {
+      expectFrameError(() => parseFrame(frame.subarray(0, length)));
+    }
+    const longer = new Uint8Array(frame.length + 1);
+    longer.set(frame);
+    expectFrameError(() => parseFrame(longer));
+
+    // Another version
+    const other = frame.slice();
+    other[0]++;
+    expectFrameError(() => parseFrame(other));
+
+    // Another type's decoder
+    const parsed = parseFrame(frame);
+    const wrong = name === "digest_request" ? decodeDigestResponse : decodeDigestRequest;
+    expectFrameError(() => wrong(parsed));
+  }
+
+  // ERROR frames need the status; gas coin counts are bounded
+  expectFrameError(() => decodeError({ type: FrameType.Error, payload: new Uint8Array(1) }));
+  const coins = parseFrame(encodeGasCoinsResponse({ ...sample.coins, gasCoins: [sample.gas] }));
+  coins.payload[40] = 2;
+  expectFrameError(() => decodeGasCoinsResponse(coins));
+  coins.payload[40] = 7;
+  expectFrameError(() => decodeGasCoinsResponse(coins));
+});
+
+test("frames written by the C codec round-trip", { skip: !vectorsDir && "FRAME_VECTORS_DIR not set" }, () => {
+  const dir = vectorsDir as string;
+  const values: Vectors = JSON.parse(readFileSync(join(dir, "vectors.json"), "utf8"));
+
+  for (const name of Object.keys(codecs)) {
+    const path = join(dir, `${name}.bin`);
+    assert.ok(existsSync(path), path);
+    const frame = new Uint8Array(readFileSync(path));
+
+    const encoded = codecs[name](parseFrame(frame), values);
+    assert.deepEqual(encoded, frame, name);
+    writeFileSync(join(dir, `ts_${name}.bin`), encoded);
+
+    for (let length = 0; length < frame.length; length++) {
+      expectFrameError(() => parseFrame(frame.subarray(0, length)));
+    }
+  }
+});
+
+// Time fn over iterations calls, in microseconds per call
+function timeUs(iterations: number, fn: () => unknown): number {
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) {
+    fn();
+  }
+  return Number(process.hrtime.bigint() - start) / 1000 / iterations;
+}
+
+test("wire size and parse time against JSON", (t) => {
+  const values = sample;
+  const iterations = 20000;
+
+  // The JSON bodies the same exchanges use (create-digest, execute-sponsored)
+  const digestJson = JSON.stringify({ success: true, ...values.objects, timestamp: Date.now() });
+  const executeJson = JSON.stringify({
+    ...values.reading,
+    signature: values.signature,
+    gasObjectId: values.gas.objectId,
+    gasVersion: values.gas.version,
+    gasDigest: values.gas.digest,
+  });
+  const digestFrame = encodeDigestResponse(values.objects);
+  const executeFrame = encodeExecuteRequest(values.reading, values.gas, values.signature);
+  const jsonBytes = (text: string) => new TextEncoder().encode(text);
+
+  const rows = [
+    {
+      exchange: "digest response",
+      jsonBytes: jsonBytes(digestJson).length,
+      frameBytes: digestFrame.length,
+      jsonUs: timeUs(iterations, () => JSON.parse(digestJson)),
+      frameUs: timeUs(iterations, () => decodeDigestResponse(parseFrame(digestFrame))),
+    },
+    {
+      exchange: "execute request",
+      jsonBytes: jsonBytes(executeJson).length,
+      frameBytes: executeFrame.length,
+      jsonUs: timeUs(iterations, () => JSON.parse(executeJson)),
+      frameUs: timeUs(iterations, () => decodeExecuteRequest(parseFrame(executeFrame))),
+    },
+  ];
+
+  for (const row of rows) {
+    t.diagnostic(
+      `${row.exchange}: ${row.jsonBytes} B JSON vs ${row.frameBytes} B frame, ` +
+        `parse ${row.jsonUs.toFixed(2)} us vs ${row.frameUs.toFixed(2)} us`
+    );
+    assert.ok(row.frameBytes < row.jsonBytes, row.exchange);
+  }
+});
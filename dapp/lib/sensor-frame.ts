@@ -0,0 +1,308 @@
+// dapp/lib/sensor-frame.ts
+// Binary framing shared with the device (esp32_sensor/sensor_frame.h):
+//
+//   version (u8) | type (u8) | payload length (u16 LE) | payload
+//
+// Payloads are fixed-layout BCS with raw IDs, digests and signatures.
+// Every frame can be both encoded and decoded, so sensor-frame.test.ts can
+// round-trip frames through the device codec.
+import { fromBase58, fromBase64, fromHex, toBase58, toBase64, toHex } from "@mysten/bcs";
+import type { CycleObjects, GasCoins, GasRef, SponsoredReading } from "./sponsor";
+
+export const FRAME_VERSION = 1;
+export const FRAME_HEADER_SIZE = 4;
+export const FRAME_MAX_SIZE = 512;
+export const SUI_SIGNATURE_LENGTH = 97;
+export const FRAME_MAX_GAS_COINS = 6;
+
+export const FRAME_CONTENT_TYPE = "application/octet-stream";
+
+export enum FrameType {
+  DigestRequest = 0x01,
+  DigestResponse = 0x02,
+  ExecuteRequest = 0x03,
+  ExecuteResponse = 0x04,
+  GasCoinsRequest = 0x05,
+  GasCoinsResponse = 0x06,
+  Error = 0x7f,
+}
+
+export interface Frame {
+  type: number;
+  payload: Uint8Array;
+}
+
+export class FrameError extends Error {}
+
+const DIGEST_REQUEST_SIZE = 32;
+const DIGEST_RESPONSE_SIZE = 32 + 8 + 73;
+const OBJECT_REF_SIZE = 73;
+const EXECUTE_REQUEST_SIZE = 16 + OBJECT_REF_SIZE + SUI_SIGNATURE_LENGTH;
+const GAS_COINS_REQUEST_SIZE = 32 + 1;
+
+// 32-byte object ID or address from its 0x hex form (short forms are left-padded)
+function idBytes(id: string): Uint8Array {
+  const hex = id.startsWith("0x") ? id.slice(2) : id;
+  const bytes = fromHex(hex.padStart(64, "0"));
+  if (bytes.length !== 32) {
+    throw new FrameError(`Invalid object ID: ${id}`);
+  }
+  return bytes;
+}
+
+function digestBytes(digest: string): Uint8Array {
+  const bytes = fromBase58(digest);
+  if (bytes.length !== 32) {
+    throw new FrameError(`Invalid digest: ${digest}`);
+  }
+  return bytes;
+}
+
+/**
+ * Parse one frame; throws FrameError for truncated or unsupported input
+ */
+export function parseFrame(data: Uint8Array): Frame {
+  if (data.length < FRAME_HEADER_SIZE) {
+    throw new FrameError("Truncated frame header");
+  }
+
+  const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+  const version = view.getUint8(0);
+  const type = view.getUint8(1);
+  const length = view.getUint16(2, true);
+
+  if (version !== FRAME_VERSION) {
+    throw new FrameError(`Unsupported frame version ${version}`);
+  }
+  if (data.length !== FRAME_HEADER_SIZE + length) {
+    throw new FrameError("Frame length does not match the body");
+  }
+
+  return { type, payload: data.subarray(FRAME_HEADER_SIZE) };
+}
+
+export function encodeFrame(type: FrameType, payload: Uint8Array): Uint8Array {
+  const frame = new Uint8Array(FRAME_HEADER_SIZE + payload.length);
+  const view = new DataView(frame.buffer);
+  view.setUint8(0, FRAME_VERSION);
+  view.setUint8(1, type);
+  view.setUint16(2, payload.length, true);
+  frame.set(payload, FRAME_HEADER_SIZE);
+  return frame;
+}
+
+function expectPayload(frame: Frame, type: FrameType, size: number): DataView {
+  if (frame.type !== type || frame.payload.length !== size) {
+    throw new FrameError(`Expected frame type ${type} with a ${size}-byte payload`);
+  }
+  return new DataView(
+    frame.payload.buffer,
+    frame.payload.byteOffset,
+    frame.payload.byteLength
+  );
+}
+
+/**
+ * DIGEST_REQUEST -> sender address (0x hex)
+ */
+export function decodeDigestRequest(frame: Frame): string {
+  expectPayload(frame, FrameType.DigestRequest, DIGEST_REQUEST_SIZE);
+  return "0x" + toHex(frame.payload);
+}
+
+export function encodeDigestRequest(senderAddress: string): Uint8Array {
+  return encodeFrame(FrameType.DigestRequest, idBytes(senderAddress));
+}
+
+// ObjectRef in BCS layout: ID, version, length-prefixed digest
+function writeObjectRef(payload: Uint8Array, offset: number, ref: GasRef) {
+  payload.set(idBytes(ref.objectId), offset);
+  new DataView(payload.buffer).setBigUint64(offset + 32, BigInt(ref.version), true);
+  payload[offset + 40] = 32;
+  payload.set(digestBytes(ref.digest), offset + 41);
+}
+
+function readObjectRef(payload: Uint8Array, offset: number): GasRef {
+  if (payload[offset + 40] !== 32) {
+    throw new FrameError("Invalid ObjectRef digest length");
+  }
+  const view = new DataView(payload.buffer, payload.byteOffset, payload.byteLength);
+  return {
+    objectId: "0x" + toHex(payload.subarray(offset, offset + 32)),
+    version: view.getBigUint64(offset + 32, true).toString(),
+    digest: toBase58(payload.subarray(offset + 41, offset + 73)),
+  };
+}
+
+// Sensor ID, sensor version, gas ObjectRef (DIGEST_RESPONSE layout)
+function encodeCycleObjects(objects: CycleObjects): Uint8Array {
+  const payload = new Uint8Array(DIGEST_RESPONSE_SIZE);
+  payload.set(idBytes(objects.sensorObjectId), 0);
+  new DataView(payload.buffer).setBigUint64(32, BigInt(objects.sensorVersion), true);
+  writeObjectRef(payload, 40, {
+    objectId: objects.gasObjectId,
+    version: objects.gasVersion,
+    digest: objects.gasDigest,
+  });
+  return payload;
+}
+
+function decodeCycleObjects(payload: Uint8Array, offset: number): CycleObjects {
+  const view = new DataView(payload.buffer, payload.byteOffset, payload.byteLength);
+  const gas = readObjectRef(payload, offset + 40);
+  return {
+    sensorObjectId: "0x" + toHex(payload.subarray(offset, offset + 32)),
+    sensorVersion: view.getBigUint64(offset + 32, true).toString(),
+    gasObjectId: gas.objectId,
+    gasVersion: gas.version,
+    gasDigest: gas.digest,
+  };
+}
+
+export function encodeDigestResponse(objects: CycleObjects): Uint8Array {
+  return encodeFrame(FrameType.DigestResponse, encodeCycleObjects(objects));
+}
+
+export function decodeDigestResponse(frame: Frame): CycleObjects {
+  expectPayload(frame, FrameType.DigestResponse, DIGEST_RESPONSE_SIZE);
+  return decodeCycleObjects(frame.payload, 0);
+}
+
+/**
+ * EXECUTE_REQUEST -> reading, the gas ref it was signed with and the
+ * Base64 serialized signature
+ */
+export function decodeExecuteRequest(frame: Frame): {
+  reading: SponsoredReading;
+  gas: GasRef;
+  signature: string;
+} {
+  const view = expectPayload(frame, FrameType.ExecuteRequest, EXECUTE_REQUEST_SIZE);
+
+  const reading = {
+    temperature: view.getUint16(0, true),
+    humidity: view.getUint16(2, true),
+    ec: view.getUint16(4, true),
+    ph: view.getUint16(6, true),
+    timestamp: Number(view.getBigUint64(8, true)),
+  };
+  const gas = readObjectRef(frame.payload, 16);
+  const signature = toBase64(frame.payload.subarray(16 + OBJECT_REF_SIZE));
+
+  return { reading, gas, signature };
+}
+
+export function encodeExecuteRequest(reading: SponsoredReading, gas: GasRef, signature: string): Uint8Array {
+  const signatureBytes = fromBase64(signature);
+  if (signatureBytes.length !== SUI_SIGNATURE_LENGTH) {
+    throw new FrameError(`Expected a ${SUI_SIGNATURE_LENGTH}-byte signature`);
+  }
+
+  const payload = new Uint8Array(EXECUTE_REQUEST_SIZE);
+  const view = new DataView(payload.buffer);
+  view.setUint16(0, reading.temperature, true);
+  view.setUint16(2, reading.humidity, true);
+  view.setUint16(4, reading.ec, true);
+  view.setUint16(6, reading.ph, true);
+  view.setBigUint64(8, BigInt(reading.timestamp), true);
+  writeObjectRef(payload, 16, gas);
+  payload.set(signatureBytes, 16 + OBJECT_REF_SIZE);
+  return encodeFrame(FrameType.ExecuteRequest, payload);
+}
+
+/**
+ * EXECUTE_RESPONSE from the Base58 transaction digest and the refs the
+ * device should build its next transaction from
+ */
+export function encodeExecuteResponse(digest: string, next: CycleObjects): Uint8Array {
+  const payload = new Uint8Array(32 + DIGEST_RESPONSE_SIZE);
+  payload.set(digestBytes(digest), 0);
+  payload.set(encodeCycleObjects(next), 32);
+  return encodeFrame(FrameType.ExecuteResponse, payload);
+}
+
+export function decodeExecuteResponse(frame: Frame): { digest: string; next: CycleObjects } {
+  expectPayload(frame, FrameType.ExecuteResponse, 32 + DIGEST_RESPONSE_SIZE);
+  return {
+    digest: toBase58(frame.payload.subarray(0, 32)),
+    next: decodeCycleObjects(frame.payload, 32),
+  };
+}
+
+/**
+ * GAS_COINS_REQUEST -> sender address (0x hex) and how many coins it wants
+ */
+export function decodeGasCoinsRequest(frame: Frame): {
+  senderAddress: string;
+  count: number;
+} {
+  expectPayload(frame, FrameType.GasCoinsRequest, GAS_COINS_REQUEST_SIZE);
+  return {
+    senderAddress: "0x" + toHex(frame.payload.subarray(0, 32)),
+    count: frame.payload[32],
+  };
+}
+
+export function encodeGasCoinsRequest(senderAddress: string, count: number): Uint8Array {
+  const payload = new Uint8Array(GAS_COINS_REQUEST_SIZE);
+  payload.set(idBytes(senderAddress), 0);
+  payload[32] = count;
+  return encodeFrame(FrameType.GasCoinsRequest, payload);
+}
+
+/**
+ * GAS_COINS_RESPONSE: sensor ID and version, then the coins as a BCS
+ * vector of ObjectRefs (at most FRAME_MAX_GAS_COINS)
+ */
+export function encodeGasCoinsResponse(coins: GasCoins): Uint8Array {
+  const gasCoins = coins.gasCoins.slice(0, FRAME_MAX_GAS_COINS);
+  // The count fits a single ULEB128 byte
+  const payload = new Uint8Array(32 + 8 + 1 + gasCoins.length * OBJECT_REF_SIZE);
+  payload.set(idBytes(coins.sensorObjectId), 0);
+  new DataView(payload.buffer).setBigUint64(32, BigInt(coins.sensorVersion), true);
+  payload[40] = gasCoins.length;
+  gasCoins.forEach((ref, i) => writeObjectRef(payload, 41 + i * OBJECT_REF_SIZE, ref));
+  return encodeFrame(FrameType.GasCoinsResponse, payload);
+}
+
+export function decodeGasCoinsResponse(frame: Frame): GasCoins {
+  if (frame.payload.length < 41 || frame.payload[40] > FRAME_MAX_GAS_COINS) {
+    throw new FrameError("Invalid gas coins response");
+  }
+  const count = frame.payload[40];
+  const view = expectPayload(frame, FrameType.GasCoinsResponse, 41 + count * OBJECT_REF_SIZE);
+  const gasCoins: GasRef[] = [];
+  for (let i = 0; i < count; i++) {
+    gasCoins.push(readObjectRef(frame.payload, 41 + i * OBJECT_REF_SIZE));
+  }
+  return {
+    sensorObjectId: "0x" + toHex(frame.payload.subarray(0, 32)),
+    sensorVersion: view.getBigUint64(32, true).toString(),
+    gasCoins,
+  };
+}
+
+/**
+ * ERROR frame; the message is cut to fit FRAME_MAX_SIZE
+ */
+export function encodeError(status: number, message: string): Uint8Array {
+  const text = new TextEncoder().encode(message);
+  const length = Math.min(text.length, FRAME_MAX_SIZE - FRAME_HEADER_SIZE - 2);
+
+  const payload = new Uint8Array(2 + length);
+  new DataView(payload.buffer).setUint16(0, status, true);
+  payload.set(text.subarray(0, length), 2);
+
+  return encodeFrame(FrameType.Error, payload);
+}
+
+export function decodeError(frame: Frame): { status: number; message: string } {
+  if (frame.type !== FrameType.Error || frame.payload.length < 2) {
+    throw new FrameError("Expected an error frame");
+  }
+  const view = new DataView(frame.payload.buffer, frame.payload.byteOffset, frame.payload.byteLength);
+  return {
+    status: view.getUint16(0, true),
+    message: new TextDecoder().decode(frame.payload.subarray(2)),
+  };
+}
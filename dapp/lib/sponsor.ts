@@ -0,0 +1,348 @@
+// dapp/lib/sponsor.ts
+// Shared by the JSON endpoints (create-digest, execute-sponsored) and the
+// binary /api/frame endpoint, so both transports build identical transactions.
+import { SuiClient, getFullnodeUrl } from "@mysten/sui/client";
+import { Transaction } from "@mysten/sui/transactions";
+import { toBase64 } from "@mysten/sui/utils";
+import { z } from "zod";
+
+// Reading fields accepted from the device
+export const SponsoredReadingSchema = z.object({
+  temperature: z.number().int().min(0).max(10000), // 0-100°C in hundredths
+  humidity: z.number().int().min(0).max(10000), // 0-100% in hundredths
+  ec: z.number().int().min(0).max(50000), // 0-5000 in tens
+  ph: z.number().int().min(0).max(1400), // 0-14 in hundredths
+  timestamp: z.number().int().positive(),
+});
+
+export type SponsoredReading = z.infer<typeof SponsoredReadingSchema>;
+
+// Gas coin the device signed with, sent back so the rebuild uses the same ref
+export const GasRefSchema = z.object({
+  objectId: z.string().regex(/^0x[0-9a-fA-F]{1,64}$/),
+  version: z.string().regex(/^[0-9]+$/),
+  digest: z.string().min(32).max(44),
+});
+
+export type GasRef = z.infer<typeof GasRefSchema>;
+
+export interface CycleObjects {
+  sensorObjectId: string;
+  sensorVersion: string;
+  gasObjectId: string;
+  gasVersion: string;
+  gasDigest: string; // Base58
+}
+
+export interface GasCoins {
+  sensorObjectId: string;
+  sensorVersion: string;
+  gasCoins: GasRef[];
+}
+
+/**
+ * Failure with the HTTP status and messages each transport reports
+ */
+export class SponsorError extends Error {
+  constructor(
+    public status: number,
+    public error: string,
+    public details: string
+  ) {
+    super(details);
+  }
+}
+
+// Stale gas (or other owned object) version: the device must refetch its refs
+export function isVersionConflict(error: any): boolean {
+  const message = String(error?.message || error);
+  return /unavailable for consumption|not available for consumption|ObjectVersionUnavailableForConsumption/i.test(
+    message
+  );
+}
+
+export function suiNetwork(): string {
+  return process.env.SUI_NETWORK || "testnet";
+}
+
+function suiClient(): SuiClient {
+  return new SuiClient({
+    url: getFullnodeUrl(suiNetwork() as any),
+  });
+}
+
+// Up to limit SUI coins of owner, each usable as a gas payment
+async function listGasCoins(client: SuiClient, owner: string, limit: number) {
+  const coins = await client.getCoins({
+    owner,
+    coinType: "0x2::sui::SUI",
+    limit,
+  });
+
+  if (coins.data.length === 0) {
+    throw new SponsorError(
+      400,
+      "No gas coins available",
+      `Sender ${owner} has no SUI coins for gas`
+    );
+  }
+
+  return coins.data;
+}
+
+// First SUI coin of owner; used as the gas payment
+async function firstGasCoin(client: SuiClient, owner: string) {
+  const coins = await listGasCoins(client, owner, 1);
+  return coins[0];
+}
+
+// Configured sensor object, as currently on chain
+async function fetchSensorObject(client: SuiClient) {
+  // Get sensor object from environment
+  const sensorObjectId = process.env.NEXT_PUBLIC_SENSOR_OBJECT_ID;
+  if (!sensorObjectId) {
+    throw new SponsorError(
+      500,
+      "Sensor object ID not configured",
+      "Set NEXT_PUBLIC_SENSOR_OBJECT_ID in environment"
+    );
+  }
+
+  // Get sensor object details
+  let sensorObject;
+  try {
+    sensorObject = await client.getObject({
+      id: sensorObjectId,
+      options: {
+        showType: true,
+        showOwner: true,
+        showPreviousTransaction: true,
+        showStorageRebate: true,
+        showContent: true,
+      },
+    });
+  } catch (error) {
+    console.error("[Create Digest] Failed to fetch sensor object:", error);
+    throw new SponsorError(
+      404,
+      "Sensor object not found",
+      `No sensor found with ID: ${sensorObjectId}`
+    );
+  }
+
+  if (!sensorObject.data) {
+    throw new SponsorError(
+      500,
+      "Sensor object has no data",
+      `Sensor object ${sensorObjectId} exists but has no data`
+    );
+  }
+
+  return sensorObject.data;
+}
+
+/**
+ * Sensor object and gas coin the device needs to build its next transaction
+ */
+export async function fetchCycleObjects(
+  senderAddress: string
+): Promise<CycleObjects> {
+  const client = suiClient();
+
+  const sensorObject = await fetchSensorObject(client);
+  const sensorObjectId = sensorObject.objectId;
+
+  console.log("[Create Digest] Fetching objects for:", {
+    sensorObjectId,
+    senderAddress,
+    network: suiNetwork(),
+  });
+
+  // Use the first coin with sufficient balance
+  const gasCoin = await firstGasCoin(client, senderAddress);
+
+  console.log("[Create Digest] Success:", {
+    sensorObjectId,
+    sensorVersion: sensorObject.version,
+    gasObjectId: gasCoin.coinObjectId,
+    gasVersion: gasCoin.version,
+  });
+
+  return {
+    sensorObjectId,
+    sensorVersion: sensorObject.version,
+    gasObjectId: gasCoin.coinObjectId,
+    gasVersion: gasCoin.version,
+    gasDigest: gasCoin.digest,
+  };
+}
+
+/**
+ * Sensor object and up to count gas coins, so the device can keep several
+ * transactions in flight (one per coin)
+ */
+export async function fetchGasCoins(
+  senderAddress: string,
+  count: number
+): Promise<GasCoins> {
+  const client = suiClient();
+
+  const sensorObject = await fetchSensorObject(client);
+  const coins = await listGasCoins(client, senderAddress, Math.max(1, count));
+
+  console.log("[Gas Coins] Fetched:", {
+    sensorObjectId: sensorObject.objectId,
+    senderAddress,
+    coins: coins.length,
+  });
+
+  return {
+    sensorObjectId: sensorObject.objectId,
+    sensorVersion: sensorObject.version,
+    gasCoins: coins.map((coin) => ({
+      objectId: coin.coinObjectId,
+      version: coin.version,
+      digest: coin.digest,
+    })),
+  };
+}
+
+/**
+ * Rebuild the device's single-reading transaction and execute it with the
+ * device's signature (Base64 serialized Sui signature)
+ *
+ * gas is the coin ref the device built with; without it the sender's first
+ * coin is used. Returns the execution result and the refs for the device's
+ * next transaction, so it can skip create-digest. A stale gas ref fails
+ * with a 409 SponsorError.
+ */
+export async function executeSponsoredReading(
+  reading: SponsoredReading,
+  signature: string,
+  gas?: GasRef
+) {
+  const { temperature, humidity, ec, ph } = reading;
+
+  // Get configuration from environment
+  const packageId = process.env.NEXT_PUBLIC_SENSOR_PACKAGE_ID;
+  const sensorObjectId = process.env.NEXT_PUBLIC_SENSOR_OBJECT_ID;
+  const senderAddress = process.env.SUI_SENDER_ADDRESS;
+  const clockObjectId = process.env.NEXT_PUBLIC_SUI_CLOCK_OBJECT_ID || "0x6";
+
+  if (!packageId || !sensorObjectId || !senderAddress) {
+    throw new SponsorError(
+      500,
+      "Configuration missing",
+      "Set NEXT_PUBLIC_SENSOR_PACKAGE_ID, NEXT_PUBLIC_SENSOR_OBJECT_ID, and SUI_SENDER_ADDRESS in environment"
+    );
+  }
+
+  const client = suiClient();
+
+  // The device's coin ref, or the first coin
+  let gasPayment = gas;
+  if (!gasPayment) {
+    const gasCoin = await firstGasCoin(client, senderAddress);
+    gasPayment = {
+      objectId: gasCoin.coinObjectId,
+      version: gasCoin.version,
+      digest: gasCoin.digest,
+    };
+  }
+
+  console.log("[Execute Sponsored] Building transaction with:", {
+    packageId,
+    gasObjectId: gasPayment.objectId,
+    gasVersion: gasPayment.version,
+    clockObjectId,
+  });
+
+  // Build the transaction
+  const tx = new Transaction();
+  tx.setSender(senderAddress);
+
+  // Set gas payment
+  tx.setGasPayment([gasPayment]);
+
+  tx.setGasBudget(100000000);
+
+  // Create the move call - matching your Move contract exactly
+  tx.moveCall({
+    target: `${packageId}::sensor_storage::store_sensor_data`,
+    arguments: [
+      tx.pure.u64(temperature), // temperature
+      tx.pure.u64(humidity), // humidity
+      tx.pure.u64(ec), // ec
+      tx.pure.u64(ph), // ph
+      tx.pure.string("esp32-device"), // device_id
+      tx.pure.string("soil"), // sensor_type
+      tx.pure.string(""), // location
+      tx.sharedObjectRef({
+        // clock object
+        objectId: clockObjectId,
+        initialSharedVersion: 1,
+        mutable: false,
+      }),
+    ],
+  });
+
+  // Build transaction bytes
+  const txBytes = await tx.build({
+    client,
+    onlyTransactionKind: false,
+  });
+
+  let txHex = Buffer.from(txBytes).toString("hex");
+  console.log("build: ", txHex);
+
+  const txBytesB64 = toBase64(txBytes);
+  console.log(
+    "[Execute Sponsored] Transaction built, length:",
+    txBytes.length
+  );
+
+  // Execute the transaction with the ESP32's signature
+  let result;
+  try {
+    result = await client.executeTransactionBlock({
+      transactionBlock: txBytesB64,
+      signature: signature,
+      options: {
+        showEffects: true,
+        showEvents: true,
+        showObjectChanges: true,
+      },
+    });
+  } catch (error: any) {
+    if (isVersionConflict(error)) {
+      throw new SponsorError(409, "Object version conflict", error.message);
+    }
+    throw error;
+  }
+
+  console.log("[Execute Sponsored] Transaction executed:", {
+    digest: result.digest,
+    status: result.effects?.status?.status,
+  });
+
+  // The gas coin's new ref comes straight from the effects
+  const gasRef = result.effects?.gasObject.reference;
+  if (!gasRef) {
+    throw new SponsorError(
+      500,
+      "Missing effects",
+      `No gas object in the effects of ${result.digest}`
+    );
+  }
+  const sensorObject = await fetchSensorObject(client);
+
+  const next: CycleObjects = {
+    sensorObjectId: sensorObject.objectId,
+    sensorVersion: sensorObject.version,
+    gasObjectId: gasRef.objectId,
+    gasVersion: String(gasRef.version),
+    gasDigest: gasRef.digest,
+  };
+
+  return { result, next };
+}
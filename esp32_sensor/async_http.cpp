@@ -0,0 +1,325 @@
+#include "async_http.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+
+// lwIP has no SIGPIPE to suppress
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+static bool would_block(void) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+static async_http_state_t fail(async_http_t *http, async_http_error_t error) {
+    if (http->fd >= 0) {
+        close(http->fd);
+        http->fd = -1;
+    }
+    http->error = error;
+    http->state = ASYNC_HTTP_FAILED;
+    return ASYNC_HTTP_FAILED;
+}
+
+static async_http_state_t finish(async_http_t *http) {
+    close(http->fd);
+    http->fd = -1;
+    http->state = ASYNC_HTTP_DONE;
+    return ASYNC_HTTP_DONE;
+}
+
+static bool resolve(const char *host, uint16_t port, struct sockaddr_in *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+
+    if (inet_pton(AF_INET, host, &addr->sin_addr) == 1) {
+        return true;
+    }
+
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0 || !result) {
+        return false;
+    }
+    addr->sin_addr = ((struct sockaddr_in *)result->ai_addr)->sin_addr;
+    freeaddrinfo(result);
+    return true;
+}
+
+// Offset just past the blank line ending the headers, or 0 if not received yet
+static size_t headers_end(const uint8_t *data, size_t length) {
+    for (size_t i = 3; i < length; i++) {
+        if (data[i] == '\n' && data[i - 1] == '\r' && data[i - 2] == '\n' && data[i - 3] == '\r') {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// One header line as a C string (the response buffer is not terminated)
+static void copy_line(const char *line, const char *eol, char *out, size_t out_size) {
+    size_t length = (size_t)(eol - line);
+    if (length >= out_size) {
+        length = out_size - 1;
+    }
+    memcpy(out, line, length);
+    out[length] = '\0';
+}
+
+// Status line and Content-Length; the headers end with CRLF CRLF, so every
+// line before end has its '\n'
+static bool parse_headers(async_http_t *http, size_t end) {
+    static const char name[] = "Content-Length:";
+    const char *line = (const char *)http->response;
+    const char *stop = line + end;
+    char text[48];
+
+    const char *eol = (const char *)memchr(line, '\n', end);
+    copy_line(line, eol, text, sizeof(text));
+    int status = 0;
+    if (sscanf(text, "HTTP/%*d.%*d %d", &status) != 1 || status < 100 || status > 999) {
+        return false;
+    }
+    http->status = status;
+    http->content_length = -1;
+
+    for (line = eol + 1; line < stop; line = eol + 1) {
+        eol = (const char *)memchr(line, '\n', (size_t)(stop - line));
+        copy_line(line, eol, text, sizeof(text));
+        if (strncasecmp(text, name, sizeof(name) - 1) == 0) {
+            char *digits_end = NULL;
+            long length = strtol(text + sizeof(name) - 1, &digits_end, 10);
+            if (digits_end != text + sizeof(name) - 1 && length >= 0) {
+                http->content_length = length;
+            }
+        }
+    }
+    return true;
+}
+
+static async_http_state_t poll_connect(async_http_t *http) {
+    fd_set writable;
+    FD_ZERO(&writable);
+    FD_SET(http->fd, &writable);
+    struct timeval now = { 0, 0 };
+
+    int ready = select(http->fd + 1, NULL, &writable, NULL, &now);
+    if (ready == 0 || (ready < 0 && errno == EINTR)) {
+        return ASYNC_HTTP_CONNECTING;
+    }
+
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (ready < 0 || getsockopt(http->fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+        return fail(http, ASYNC_HTTP_ERROR_CONNECT);
+    }
+
+    http->state = ASYNC_HTTP_SENDING;
+    return ASYNC_HTTP_SENDING;
+}
+
+static async_http_state_t poll_send(async_http_t *http) {
+    while (http->part_index < http->part_count) {
+        const async_http_part_t *part = &http->parts[http->part_index];
+        if (http->part_offset == part->length) {
+            http->part_index++;
+            http->part_offset = 0;
+            continue;
+        }
+
+        ssize_t sent = send(http->fd, part->data + http->part_offset, part->length - http->part_offset,
+                            MSG_NOSIGNAL);
+        if (sent < 0) {
+            return would_block() ? ASYNC_HTTP_SENDING : fail(http, ASYNC_HTTP_ERROR_SEND);
+        }
+        http->part_offset += (size_t)sent;
+    }
+
+    http->state = ASYNC_HTTP_RECEIVING;
+    return ASYNC_HTTP_RECEIVING;
+}
+
+static async_http_state_t poll_receive(async_http_t *http) {
+    for (;;) {
+        if (http->headers_done && http->content_length >= 0 &&
+            http->received >= (size_t)http->content_length) {
+            http->received = (size_t)http->content_length;
+            return finish(http);
+        }
+
+        if (http->received == http->response_capacity) {
+            if (!http->headers_done) {
+                return fail(http, ASYNC_HTTP_ERROR_TOO_LARGE);
+            }
+            // The caller keeps what fits; the rest is not waited for
+            http->truncated = true;
+            return finish(http);
+        }
+
+        ssize_t got = recv(http->fd, http->response + http->received,
+                           http->response_capacity - http->received, 0);
+        if (got < 0) {
+            return would_block() ? ASYNC_HTTP_RECEIVING : fail(http, ASYNC_HTTP_ERROR_RECEIVE);
+        }
+        if (got == 0) {
+            // EOF ends a reply without Content-Length; a short one is cut off
+            if (!http->headers_done) {
+                return fail(http, ASYNC_HTTP_ERROR_MALFORMED);
+            }
+            if (http->content_length >= 0) {
+                http->truncated = true;
+            }
+            return finish(http);
+        }
+        http->received += (size_t)got;
+
+        if (!http->headers_done) {
+            size_t end = headers_end(http->response, http->received);
+            if (end == 0) {
+                continue;
+            }
+            if (!parse_headers(http, end)) {
+                return fail(http, ASYNC_HTTP_ERROR_MALFORMED);
+            }
+            http->received -= end;
+            memmove(http->response, http->response + end, http->received);
+            http->headers_done = true;
+        }
+    }
+}
+
+// ============================================================================
+// Request implementation
+// ============================================================================
+
+void async_http_init(async_http_t *http) {
+    memset(http, 0, sizeof(*http));
+    http->fd = -1;
+}
+
+async_http_error_t async_http_start(async_http_t *http, const char *host, uint16_t port, const char *method,
+                                    const char *path, const char *content_type,
+                                    const async_http_part_t *body, size_t body_parts,
+                                    uint8_t *response, size_t response_capacity) {
+    if (!http || !host || !method || !path || !response || response_capacity == 0 ||
+        body_parts > ASYNC_HTTP_MAX_PARTS || (body_parts > 0 && !body)) {
+        return ASYNC_HTTP_ERROR_INVALID_INPUT;
+    }
+
+    async_http_close(http);
+
+    size_t body_length = 0;
+    for (size_t i = 0; i < body_parts; i++) {
+        body_length += body[i].length;
+    }
+
+    int head_length = snprintf(http->head, sizeof(http->head),
+                               "%s %s HTTP/1.0\r\nHost: %s:%u\r\nConnection: close\r\n", method, path, host,
+                               (unsigned)port);
+    if (head_length > 0 && (size_t)head_length < sizeof(http->head) && (content_type || body_parts > 0)) {
+        head_length += snprintf(http->head + head_length, sizeof(http->head) - head_length,
+                                "Content-Type: %s\r\nContent-Length: %u\r\n",
+                                content_type ? content_type : "application/octet-stream", (unsigned)body_length);
+    }
+    if (head_length > 0 && (size_t)head_length < sizeof(http->head)) {
+        head_length += snprintf(http->head + head_length, sizeof(http->head) - head_length, "\r\n");
+    }
+    if (head_length <= 0 || (size_t)head_length >= sizeof(http->head)) {
+        return ASYNC_HTTP_ERROR_INVALID_INPUT;
+    }
+
+    http->parts[0].data = (const uint8_t *)http->head;
+    http->parts[0].length = (size_t)head_length;
+    for (size_t i = 0; i < body_parts; i++) {
+        http->parts[i + 1] = body[i];
+    }
+    http->part_count = body_parts + 1;
+    http->response = response;
+    http->response_capacity = response_capacity;
+
+    struct sockaddr_in addr;
+    if (!resolve(host, port, &addr)) {
+        fail(http, ASYNC_HTTP_ERROR_RESOLVE);
+        return ASYNC_HTTP_ERROR_RESOLVE;
+    }
+
+    http->fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (http->fd < 0) {
+        fail(http, ASYNC_HTTP_ERROR_CONNECT);
+        return ASYNC_HTTP_ERROR_CONNECT;
+    }
+
+    int flags = fcntl(http->fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(http->fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        fail(http, ASYNC_HTTP_ERROR_CONNECT);
+        return ASYNC_HTTP_ERROR_CONNECT;
+    }
+
+    if (connect(http->fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        http->state = ASYNC_HTTP_SENDING;
+    } else if (errno == EINPROGRESS) {
+        http->state = ASYNC_HTTP_CONNECTING;
+    } else {
+        fail(http, ASYNC_HTTP_ERROR_CONNECT);
+        return ASYNC_HTTP_ERROR_CONNECT;
+    }
+
+    return ASYNC_HTTP_OK;
+}
+
+async_http_state_t async_http_poll(async_http_t *http) {
+    // Each stage falls through to the next as soon as it completes
+    if (http->state == ASYNC_HTTP_CONNECTING && poll_connect(http) != ASYNC_HTTP_SENDING) {
+        return (async_http_state_t)http->state;
+    }
+    if (http->state == ASYNC_HTTP_SENDING && poll_send(http) != ASYNC_HTTP_RECEIVING) {
+        return (async_http_state_t)http->state;
+    }
+    if (http->state == ASYNC_HTTP_RECEIVING) {
+        poll_receive(http);
+    }
+    return (async_http_state_t)http->state;
+}
+
+bool async_http_busy(const async_http_t *http) {
+    return http->state == ASYNC_HTTP_CONNECTING || http->state == ASYNC_HTTP_SENDING ||
+           http->state == ASYNC_HTTP_RECEIVING;
+}
+
+int async_http_status(const async_http_t *http) {
+    return http->state == ASYNC_HTTP_DONE ? http->status : 0;
+}
+
+const uint8_t *async_http_body(const async_http_t *http, size_t *length) {
+    if (http->state != ASYNC_HTTP_DONE) {
+        *length = 0;
+        return NULL;
+    }
+    *length = http->received;
+    return http->response;
+}
+
+void async_http_close(async_http_t *http) {
+    if (http->fd >= 0) {
+        close(http->fd);
+    }
+    async_http_init(http);
+}
@@ -0,0 +1,139 @@
+/**
+ * Async HTTP
+ * Non-blocking HTTP/1.0 client request over a BSD socket
+ *
+ * HTTPClient blocks the caller from connect until the last byte of the
+ * reply. Here a request is started once and then advanced by
+ * async_http_poll(), which only does the socket I/O that is possible
+ * without waiting and returns at once, so the main loop can keep sampling
+ * and firing timers while a slow server answers.
+ *
+ * The body is sent from caller-owned parts (e.g. a JSON head, the
+ * transaction hex already in the cycle arena and a tail) without being
+ * copied into one buffer; they must stay valid until the request finishes.
+ * The reply goes into a caller-owned buffer: once the headers are parsed
+ * the body is moved to its start. HTTP/1.0 with "Connection: close" keeps
+ * replies unchunked and ends them at EOF if there is no Content-Length.
+ *
+ * Works on the ESP32 (lwIP sockets) and on POSIX hosts. Host names other
+ * than IPv4 literals are resolved with getaddrinfo(), which blocks.
+ *
+ * Example:
+ *   async_http_t http;
+ *   async_http_init(&http);
+ *   async_http_part_t body = { frame, frame_length };
+ *   async_http_start(&http, "192.168.137.1", 3000, "POST", "/api/frame",
+ *                    "application/octet-stream", &body, 1, reply, sizeof(reply));
+ *   ...
+ *   if (async_http_poll(&http) == ASYNC_HTTP_DONE) {      // from loop()
+ *       size_t length;
+ *       const uint8_t *data = async_http_body(&http, &length);
+ *       ...
+ *       async_http_close(&http);
+ *   }
+ */
+
+#ifndef ASYNC_HTTP_H
+#define ASYNC_HTTP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ASYNC_HTTP_MAX_PARTS 6      // Body parts per request
+#define ASYNC_HTTP_HEAD_SIZE 256    // Request line and headers
+
+// Error codes
+typedef enum {
+    ASYNC_HTTP_OK = 0,
+    ASYNC_HTTP_ERROR_INVALID_INPUT = -1,
+    ASYNC_HTTP_ERROR_RESOLVE = -2,      // Host name not found
+    ASYNC_HTTP_ERROR_CONNECT = -3,
+    ASYNC_HTTP_ERROR_SEND = -4,
+    ASYNC_HTTP_ERROR_RECEIVE = -5,
+    ASYNC_HTTP_ERROR_TOO_LARGE = -6,    // Headers do not fit the response buffer
+    ASYNC_HTTP_ERROR_MALFORMED = -7,    // No valid status line before EOF
+} async_http_error_t;
+
+typedef enum {
+    ASYNC_HTTP_IDLE = 0,
+    ASYNC_HTTP_CONNECTING,
+    ASYNC_HTTP_SENDING,
+    ASYNC_HTTP_RECEIVING,
+    ASYNC_HTTP_DONE,        // Reply complete (see async_http_status/body)
+    ASYNC_HTTP_FAILED,      // See error
+} async_http_state_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+} async_http_part_t;
+
+/**
+ * Request state
+ */
+typedef struct {
+    int fd;
+    uint8_t state;              // async_http_state_t
+    async_http_error_t error;
+
+    // Outgoing: head, then the body parts
+    char head[ASYNC_HTTP_HEAD_SIZE];
+    async_http_part_t parts[ASYNC_HTTP_MAX_PARTS + 1];
+    size_t part_count;
+    size_t part_index;
+    size_t part_offset;
+
+    // Incoming
+    uint8_t *response;
+    size_t response_capacity;
+    size_t received;            // Bytes in response (body only once headers are parsed)
+    bool headers_done;
+    int status;
+    long content_length;        // -1 = until EOF
+    bool truncated;             // Body was cut to fit the response buffer
+} async_http_t;
+
+/**
+ * Set up an idle request
+ */
+void async_http_init(async_http_t *http);
+
+/**
+ * Open the connection and queue the request (does not wait for either)
+ * An unfinished previous request is closed first.
+ * @param content_type Content-Type header, or NULL without a body
+ * @param body Body parts sent in order (may be NULL with body_parts = 0)
+ * @param response Buffer for the reply headers, then its body
+ */
+async_http_error_t async_http_start(async_http_t *http, const char *host, uint16_t port, const char *method,
+                                    const char *path, const char *content_type,
+                                    const async_http_part_t *body, size_t body_parts,
+                                    uint8_t *response, size_t response_capacity);
+
+/**
+ * Advance the request as far as the socket allows without blocking
+ * @return Current state; DONE and FAILED close the socket
+ */
+async_http_state_t async_http_poll(async_http_t *http);
+
+/**
+ * True while the request is connecting, sending or receiving
+ */
+bool async_http_busy(const async_http_t *http);
+
+/**
+ * HTTP status of a DONE request (0 otherwise)
+ */
+int async_http_status(const async_http_t *http);
+
+/**
+ * Reply body of a DONE request, at the start of the response buffer
+ */
+const uint8_t *async_http_body(const async_http_t *http, size_t *length);
+
+/**
+ * Drop the connection (if any) and return to IDLE
+ */
+void async_http_close(async_http_t *http);
+
+#endif // ASYNC_HTTP_H
@@ -0,0 +1,300 @@
+#include "base_codec.h"
+#include <string.h>
+
+// 58^5, the largest power of 58 that fits in a 32-bit limb
+#define BASE58_LIMB_BASE 656356768u
+#define BASE58_LIMB_DIGITS 5
+
+#define BASE58_MAX_LIMBS ((BASE58_MAX_BYTES + 3) / 4)
+
+static const char base58_alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Digit value of each ASCII character, 0xFF for characters outside the alphabet
+#define X 0xFF
+static const uint8_t base58_decode_table[256] = {
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, 0, 1, 2, 3, 4, 5, 6, 7, 8, X, X, X, X, X, X,
+    X, 9, 10, 11, 12, 13, 14, 15, 16, X, 17, 18, 19, 20, 21, X,
+    22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, X, X, X, X, X,
+    X, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, X, 44, 45, 46,
+    47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+};
+
+static const uint8_t base64_decode_table[256] = {
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, 62, X, X, X, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, X, X, X, X, X, X,
+    X, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, X, X, X, X, X,
+    X, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+};
+#undef X
+
+// ============================================================================
+// Base58
+// ============================================================================
+
+bcs_error_t base58_decode(const char *input, size_t input_len, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes) {
+    if (!input || (!bytes && max_bytes > 0) || !actual_bytes) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    // Each leading '1' is a leading zero byte
+    size_t zeros = 0;
+    while (zeros < input_len && input[zeros] == '1') {
+        zeros++;
+    }
+
+    // Little-endian 32-bit limbs of the value
+    uint32_t limbs[BASE58_MAX_LIMBS];
+    size_t num_limbs = 0;
+
+    size_t i = zeros;
+    while (i < input_len) {
+        // Fold up to 5 digits into one multiply-add pass over the limbs
+        uint32_t multiplier = 1;
+        uint32_t chunk = 0;
+        for (int k = 0; k < BASE58_LIMB_DIGITS && i < input_len; k++, i++) {
+            uint8_t digit = base58_decode_table[(uint8_t)input[i]];
+            if (digit == 0xFF) {
+                return BCS_ERROR_INVALID_INPUT;
+            }
+            multiplier *= 58;
+            chunk = chunk * 58 + digit;
+        }
+
+        uint64_t carry = chunk;
+        for (size_t j = 0; j < num_limbs; j++) {
+            carry += (uint64_t)limbs[j] * multiplier;
+            limbs[j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        if (carry) {
+            if (num_limbs == BASE58_MAX_LIMBS) {
+                return BCS_ERROR_BUFFER_TOO_SMALL;
+            }
+            limbs[num_limbs++] = (uint32_t)carry;
+        }
+    }
+
+    // Significant bytes, ignoring zero bytes at the top of the last limb
+    size_t significant = num_limbs * 4;
+    if (num_limbs > 0) {
+        uint32_t top = limbs[num_limbs - 1];
+        while ((top >> 24) == 0) {
+            top <<= 8;
+            significant--;
+        }
+    }
+
+    if (zeros + significant > max_bytes) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    memset(bytes, 0, zeros);
+    for (size_t b = 0; b < significant; b++) {
+        size_t shift = significant - 1 - b;  // Byte index from the least significant end
+        bytes[zeros + b] = (limbs[shift / 4] >> ((shift % 4) * 8)) & 0xFF;
+    }
+
+    *actual_bytes = zeros + significant;
+    return BCS_OK;
+}
+
+bcs_error_t base58_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars) {
+    if ((!bytes && length > 0) || !output) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    if (length > BASE58_MAX_BYTES) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    size_t zeros = 0;
+    while (zeros < length && bytes[zeros] == 0) {
+        zeros++;
+    }
+
+    // Big-endian 32-bit limbs of the remaining bytes
+    uint32_t limbs[BASE58_MAX_LIMBS];
+    size_t num_limbs = (length - zeros + 3) / 4;
+    size_t lead = (length - zeros) % 4 ? (length - zeros) % 4 : 4;
+    const uint8_t *p = bytes + zeros;
+
+    for (size_t j = 0; j < num_limbs; j++) {
+        size_t n = (j == 0) ? lead : 4;
+        uint32_t limb = 0;
+        for (size_t k = 0; k < n; k++) {
+            limb = (limb << 8) | *p++;
+        }
+        limbs[j] = limb;
+    }
+
+    // Repeated division by 58^5 yields 5 digits per pass, least significant first
+    uint8_t digits[BASE58_ENCODED_SIZE(BASE58_MAX_BYTES) + BASE58_LIMB_DIGITS];
+    size_t num_digits = 0;
+    size_t first = 0;
+
+    while (first < num_limbs) {
+        uint64_t remainder = 0;
+        for (size_t j = first; j < num_limbs; j++) {
+            uint64_t value = (remainder << 32) | limbs[j];
+            limbs[j] = (uint32_t)(value / BASE58_LIMB_BASE);
+            remainder = value % BASE58_LIMB_BASE;
+        }
+        while (first < num_limbs && limbs[first] == 0) {
+            first++;
+        }
+
+        uint32_t chunk = (uint32_t)remainder;
+        for (int k = 0; k < BASE58_LIMB_DIGITS; k++) {
+            digits[num_digits++] = chunk % 58;
+            chunk /= 58;
+        }
+    }
+
+    // The last pass pads with zero digits at the most significant end
+    while (num_digits > 0 && digits[num_digits - 1] == 0) {
+        num_digits--;
+    }
+
+    size_t total = zeros + num_digits;
+    if (total + 1 > max_chars) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    memset(output, '1', zeros);
+    for (size_t k = 0; k < num_digits; k++) {
+        output[zeros + k] = base58_alphabet[digits[num_digits - 1 - k]];
+    }
+    output[total] = '\0';
+
+    if (actual_chars) *actual_chars = total;
+    return BCS_OK;
+}
+
+// ============================================================================
+// Base64
+// ============================================================================
+
+bcs_error_t base64_decode(const char *input, size_t input_len, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes) {
+    if (!input || (!bytes && max_bytes > 0) || !actual_bytes) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    // Padding only completes the last quantum
+    if (input_len > 0 && input[input_len - 1] == '=') {
+        if (input_len % 4 != 0) {
+            return BCS_ERROR_INVALID_INPUT;
+        }
+        input_len--;
+        if (input[input_len - 1] == '=') {
+            input_len--;
+        }
+    }
+
+    size_t tail = input_len % 4;
+    if (tail == 1) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    size_t byte_len = input_len / 4 * 3 + (tail ? tail - 1 : 0);
+    if (byte_len > max_bytes) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    const uint8_t *src = (const uint8_t *)input;
+    uint8_t *dst = bytes;
+    size_t full = input_len - tail;
+
+    for (size_t i = 0; i < full; i += 4) {
+        uint8_t a = base64_decode_table[src[i]];
+        uint8_t b = base64_decode_table[src[i + 1]];
+        uint8_t c = base64_decode_table[src[i + 2]];
+        uint8_t d = base64_decode_table[src[i + 3]];
+        if ((a | b | c | d) & 0xC0) {
+            return BCS_ERROR_INVALID_INPUT;
+        }
+
+        uint32_t triple = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | d;
+        *dst++ = (triple >> 16) & 0xFF;
+        *dst++ = (triple >> 8) & 0xFF;
+        *dst++ = triple & 0xFF;
+    }
+
+    if (tail) {
+        uint8_t a = base64_decode_table[src[full]];
+        uint8_t b = base64_decode_table[src[full + 1]];
+        uint8_t c = (tail == 3) ? base64_decode_table[src[full + 2]] : 0;
+        if ((a | b | c) & 0xC0) {
+            return BCS_ERROR_INVALID_INPUT;
+        }
+
+        uint32_t triple = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6);
+        *dst++ = (triple >> 16) & 0xFF;
+        if (tail == 3) {
+            *dst++ = (triple >> 8) & 0xFF;
+        }
+    }
+
+    *actual_bytes = byte_len;
+    return BCS_OK;
+}
+
+bcs_error_t base64_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars) {
+    if ((!bytes && length > 0) || !output) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    size_t total = BASE64_ENCODED_SIZE(length);
+    if (total + 1 > max_chars) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    char *dst = output;
+    size_t i = 0;
+
+    for (; i + 3 <= length; i += 3) {
+        uint32_t triple = ((uint32_t)bytes[i] << 16) | ((uint32_t)bytes[i + 1] << 8) | bytes[i + 2];
+        *dst++ = base64_alphabet[(triple >> 18) & 0x3F];
+        *dst++ = base64_alphabet[(triple >> 12) & 0x3F];
+        *dst++ = base64_alphabet[(triple >> 6) & 0x3F];
+        *dst++ = base64_alphabet[triple & 0x3F];
+    }
+
+    if (i < length) {
+        uint32_t triple = (uint32_t)bytes[i] << 16;
+        if (i + 1 < length) {
+            triple |= (uint32_t)bytes[i + 1] << 8;
+        }
+
+        *dst++ = base64_alphabet[(triple >> 18) & 0x3F];
+        *dst++ = base64_alphabet[(triple >> 12) & 0x3F];
+        *dst++ = (i + 1 < length) ? base64_alphabet[(triple >> 6) & 0x3F] : '=';
+        *dst++ = '=';
+    }
+
+    *dst = '\0';
+    if (actual_chars) *actual_chars = total;
+    return BCS_OK;
+}
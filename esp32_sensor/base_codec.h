@@ -0,0 +1,88 @@
+/**
+ * Base58 / Base64 Codec
+ * Table-driven encoders and decoders for Sui object digests (Base58) and
+ * signatures (Base64). Nothing is allocated; all scratch lives on the stack.
+ */
+
+#ifndef BASE_CODEC_H
+#define BASE_CODEC_H
+
+#include "bcs.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Largest binary value the Base58 codec handles (digests and addresses are 32)
+#define BASE58_MAX_BYTES 128
+
+// Base58 characters needed for n bytes, excluding the terminator (n * log(256) / log(58), rounded up)
+#define BASE58_ENCODED_SIZE(n) ((n) * 138 / 100 + 1)
+
+// Base64 characters needed for n bytes with padding, excluding the terminator
+#define BASE64_ENCODED_SIZE(n) ((((n) + 2) / 3) * 4)
+
+// ============================================================================
+// Base58 (Bitcoin alphabet)
+// ============================================================================
+
+/**
+ * Decode a Base58 string
+ * Leading '1' characters become leading zero bytes.
+ * @param input Base58 characters (need not be NUL-terminated)
+ * @param input_len Number of characters
+ * @param bytes Output buffer
+ * @param max_bytes Size of output buffer
+ * @param actual_bytes Output: number of bytes decoded
+ * @return BCS_OK on success, BCS_ERROR_INVALID_INPUT on a non-Base58 character,
+ *         BCS_ERROR_BUFFER_TOO_SMALL if the value does not fit
+ *
+ * Example:
+ *   uint8_t digest[32];
+ *   size_t n;
+ *   if (base58_decode(gas_digest, strlen(gas_digest), digest, 32, &n) == BCS_OK && n == 32) {
+ *       // digest holds the object digest
+ *   }
+ */
+bcs_error_t base58_decode(const char *input, size_t input_len, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes);
+
+/**
+ * Encode bytes as Base58
+ * @param bytes Input bytes (at most BASE58_MAX_BYTES)
+ * @param length Number of input bytes
+ * @param output Output buffer, NUL-terminated on success
+ * @param max_chars Size of output buffer including the terminator
+ *                  (BASE58_ENCODED_SIZE(length) + 1 is always enough)
+ * @param actual_chars Output: number of characters written (optional)
+ * @return BCS_OK on success, BCS_ERROR_BUFFER_TOO_SMALL if output is too small
+ */
+bcs_error_t base58_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars);
+
+// ============================================================================
+// Base64 (RFC 4648, standard alphabet, '=' padding)
+// ============================================================================
+
+/**
+ * Decode a Base64 string
+ * Padding is optional; whitespace is rejected.
+ * @param input Base64 characters (need not be NUL-terminated)
+ * @param input_len Number of characters
+ * @param bytes Output buffer
+ * @param max_bytes Size of output buffer
+ * @param actual_bytes Output: number of bytes decoded
+ * @return BCS_OK on success, BCS_ERROR_INVALID_INPUT on malformed input,
+ *         BCS_ERROR_BUFFER_TOO_SMALL if the value does not fit
+ */
+bcs_error_t base64_decode(const char *input, size_t input_len, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes);
+
+/**
+ * Encode bytes as padded Base64
+ * @param bytes Input bytes
+ * @param length Number of input bytes
+ * @param output Output buffer, NUL-terminated on success
+ * @param max_chars Size of output buffer including the terminator
+ *                  (BASE64_ENCODED_SIZE(length) + 1)
+ * @param actual_chars Output: number of characters written (optional)
+ * @return BCS_OK on success, BCS_ERROR_BUFFER_TOO_SMALL if output is too small
+ */
+bcs_error_t base64_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars);
+
+#endif // BASE_CODEC_H
@@ -1,22 +1,69 @@
 #include "bcs.h"
+#include "blake2b.h"
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
 // ============================================================================
 // Internal helper functions
 // ============================================================================
 
-static bcs_error_t ensure_capacity(bcs_writer_t *writer, size_t additional_bytes) {
+// Record the first failure; a latched writer refuses all further writes
+static inline bcs_error_t latch_error(bcs_writer_t *writer, bcs_error_t err) {
+    if (writer && writer->error == BCS_OK) {
+        writer->error = err;
+    }
+    return err;
+}
+
+// Feed everything written so far to the attached hash
+static inline void absorb_hash(bcs_writer_t *writer) {
+    blake2b_update(writer->hash, writer->buffer + writer->hashed, writer->position - writer->hashed);
+    writer->hashed = writer->position;
+}
+
+// Hand the chunk of a stream writer to its callback and start a new one
+static bcs_error_t flush_stream(bcs_writer_t *writer) {
+    if (writer->hash) {
+        absorb_hash(writer);
+    }
+
+    if (writer->position > 0 && writer->flush(writer->flush_ctx, writer->buffer, writer->position) != BCS_OK) {
+        return latch_error(writer, BCS_ERROR_SINK);
+    }
+
+    writer->flushed += writer->position;
+    writer->position = 0;
+    writer->hashed = 0;
+    return BCS_OK;
+}
+
+static bcs_error_t grow(bcs_writer_t *writer, size_t additional_bytes) {
+    if (writer->mode == BCS_WRITER_COUNTING) {
+        return BCS_OK;
+    }
+
     size_t required = writer->position + additional_bytes;
 
     if (required <= writer->capacity) {
         return BCS_OK;
     }
 
+    // Stream writers make room by flushing; one write must still fit a chunk
+    if (writer->mode == BCS_WRITER_STREAM) {
+        if (additional_bytes > writer->capacity) {
+            return latch_error(writer, BCS_ERROR_BUFFER_TOO_SMALL);
+        }
+        return flush_stream(writer);
+    }
+
+    // Caller-owned buffers never grow
+    if (writer->mode == BCS_WRITER_FIXED) {
+        return latch_error(writer, BCS_ERROR_BUFFER_TOO_SMALL);
+    }
+
     // Check max size limit
     if (writer->max_size > 0 && required > writer->max_size) {
-        return BCS_ERROR_BUFFER_TOO_SMALL;
+        return latch_error(writer, BCS_ERROR_BUFFER_TOO_SMALL);
     }
 
     // Calculate new capacity
@@ -30,13 +77,14 @@ static bcs_error_t ensure_capacity(bcs_writer_t *writer, size_t additional_bytes
     }
 
     if (new_capacity < required) {
-        return BCS_ERROR_BUFFER_TOO_SMALL;
+        return latch_error(writer, BCS_ERROR_BUFFER_TOO_SMALL);
     }
 
     // Reallocate buffer
-    uint8_t *new_buffer = (uint8_t*)realloc(writer->buffer, new_capacity);
+    const bcs_allocator_t *allocator = writer->allocator;
+    uint8_t *new_buffer = (uint8_t*)allocator->realloc(allocator->ctx, writer->buffer, new_capacity);
     if (!new_buffer) {
-        return BCS_ERROR_OUT_OF_MEMORY;
+        return latch_error(writer, BCS_ERROR_OUT_OF_MEMORY);
     }
 
     writer->buffer = new_buffer;
@@ -45,16 +93,134 @@ static bcs_error_t ensure_capacity(bcs_writer_t *writer, size_t additional_bytes
     return BCS_OK;
 }
 
+// Common entry of every append: the bytes before it are final, so a
+// hashing writer absorbs them here a block at a time
+static bcs_error_t ensure_capacity(bcs_writer_t *writer, size_t additional_bytes) {
+    if (writer->error != BCS_OK) {
+        return writer->error;
+    }
+
+    if (writer->hash && writer->position - writer->hashed >= BLAKE2B_BLOCK_SIZE) {
+        absorb_hash(writer);
+    }
+
+    return grow(writer, additional_bytes);
+}
+
+// Counting writers only advance the position; returns true if nothing should be stored
+static inline bool count_only(bcs_writer_t *writer, size_t length) {
+    if (writer->mode != BCS_WRITER_COUNTING) {
+        return false;
+    }
+
+    writer->position += length;
+    return true;
+}
+
+// Decode one ULEB128 value; the caller guarantees BCS_ULEB128_MAX_SIZE readable bytes
+static inline bcs_error_t decode_uleb128_unchecked(bcs_reader_t *reader, uint64_t *value) {
+    const uint8_t *p = reader->buffer + reader->position;
+
+    if (p[0] < 0x80) {
+        *value = p[0];
+        reader->position += 1;
+        return BCS_OK;
+    }
+    if (p[1] < 0x80) {
+        *value = (uint64_t)(p[0] & 0x7F) | ((uint64_t)p[1] << 7);
+        reader->position += 2;
+        return BCS_OK;
+    }
+
+    uint64_t result = (uint64_t)(p[0] & 0x7F) | ((uint64_t)(p[1] & 0x7F) << 7);
+    for (size_t i = 2; i < BCS_ULEB128_MAX_SIZE; i++) {
+        result |= (uint64_t)(p[i] & 0x7F) << (7 * i);
+        if (p[i] < 0x80) {
+            *value = result;
+            reader->position += i + 1;
+            return BCS_OK;
+        }
+    }
+
+    *value = result;
+    reader->position += BCS_ULEB128_MAX_SIZE;
+    return BCS_ERROR_OVERFLOW;
+}
+
+// ============================================================================
+// Allocator implementation
+// ============================================================================
+
+static void *heap_alloc(void *ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void *heap_realloc(void *ctx, void *ptr, size_t size) {
+    (void)ctx;
+    return realloc(ptr, size);
+}
+
+static void heap_free(void *ctx, void *ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+static const bcs_allocator_t heap_allocator = { heap_alloc, heap_realloc, heap_free, NULL };
+
+static const bcs_allocator_t *default_allocator = &heap_allocator;
+
+void bcs_set_default_allocator(const bcs_allocator_t *allocator) {
+    default_allocator = allocator ? allocator : &heap_allocator;
+}
+
+const bcs_allocator_t *bcs_get_default_allocator(void) {
+    return default_allocator;
+}
+
+void *bcs_alloc(size_t size) {
+    return bcs_allocator_alloc(NULL, size);
+}
+
+void bcs_free(void *ptr) {
+    bcs_allocator_free(NULL, ptr);
+}
+
+void *bcs_allocator_alloc(const bcs_allocator_t *allocator, size_t size) {
+    if (!allocator) {
+        allocator = default_allocator;
+    }
+    return allocator->alloc(allocator->ctx, size);
+}
+
+void bcs_allocator_free(const bcs_allocator_t *allocator, void *ptr) {
+    if (!allocator) {
+        allocator = default_allocator;
+    }
+    if (ptr) {
+        allocator->free(allocator->ctx, ptr);
+    }
+}
+
 // ============================================================================
 // Writer implementation
 // ============================================================================
 
 bcs_error_t bcs_writer_init(bcs_writer_t *writer, size_t initial_capacity, size_t max_size) {
+    return bcs_writer_init_with_allocator(writer, initial_capacity, max_size, NULL);
+}
+
+bcs_error_t bcs_writer_init_with_allocator(bcs_writer_t *writer, size_t initial_capacity, size_t max_size,
+                                           const bcs_allocator_t *allocator) {
     if (!writer || initial_capacity == 0) {
         return BCS_ERROR_INVALID_INPUT;
     }
 
-    writer->buffer = (uint8_t*)malloc(initial_capacity);
+    if (!allocator) {
+        allocator = default_allocator;
+    }
+
+    writer->buffer = (uint8_t*)allocator->alloc(allocator->ctx, initial_capacity);
     if (!writer->buffer) {
         return BCS_ERROR_OUT_OF_MEMORY;
     }
@@ -63,31 +229,214 @@ bcs_error_t bcs_writer_init(bcs_writer_t *writer, size_t initial_capacity, size_
     writer->position = 0;
     writer->max_size = max_size;
     writer->allocate_size = initial_capacity; // Grow by initial size each time
+    writer->mode = BCS_WRITER_GROWABLE;
+    writer->error = BCS_OK;
+    writer->allocator = allocator;
+    writer->hash = NULL;
+    writer->hashed = 0;
+    writer->flush = NULL;
+    writer->flush_ctx = NULL;
+    writer->flushed = 0;
+
+    return BCS_OK;
+}
+
+bcs_error_t bcs_writer_init_fixed(bcs_writer_t *writer, uint8_t *buffer, size_t capacity) {
+    if (!writer || !buffer || capacity == 0) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    writer->position = 0;
+    writer->max_size = capacity;
+    writer->allocate_size = 0;
+    writer->mode = BCS_WRITER_FIXED;
+    writer->error = BCS_OK;
+    writer->allocator = NULL;
+    writer->hash = NULL;
+    writer->hashed = 0;
+    writer->flush = NULL;
+    writer->flush_ctx = NULL;
+    writer->flushed = 0;
+
+    return BCS_OK;
+}
+
+bcs_error_t bcs_writer_init_stream(bcs_writer_t *writer, uint8_t *chunk, size_t capacity,
+                                   bcs_flush_fn flush, void *flush_ctx) {
+    bcs_error_t err = bcs_writer_init_fixed(writer, chunk, capacity);
+    if (err != BCS_OK) return err;
+    if (!flush) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    writer->max_size = 0;
+    writer->mode = BCS_WRITER_STREAM;
+    writer->flush = flush;
+    writer->flush_ctx = flush_ctx;
+
+    return BCS_OK;
+}
+
+bcs_error_t bcs_writer_init_counting(bcs_writer_t *writer) {
+    if (!writer) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    writer->buffer = NULL;
+    writer->capacity = 0;
+    writer->position = 0;
+    writer->max_size = 0;
+    writer->allocate_size = 0;
+    writer->mode = BCS_WRITER_COUNTING;
+    writer->error = BCS_OK;
+    writer->allocator = NULL;
+    writer->hash = NULL;
+    writer->hashed = 0;
+    writer->flush = NULL;
+    writer->flush_ctx = NULL;
+    writer->flushed = 0;
 
     return BCS_OK;
 }
 
 void bcs_writer_free(bcs_writer_t *writer) {
     if (writer && writer->buffer) {
-        free(writer->buffer);
+        if (writer->mode == BCS_WRITER_GROWABLE) {
+            writer->allocator->free(writer->allocator->ctx, writer->buffer);
+        }
         writer->buffer = NULL;
         writer->capacity = 0;
         writer->position = 0;
     }
 }
 
+void bcs_writer_reset(bcs_writer_t *writer) {
+    if (writer) {
+        writer->position = 0;
+        writer->error = BCS_OK;
+        writer->hash = NULL;
+        writer->hashed = 0;
+        writer->flushed = 0;
+    }
+}
+
+bcs_error_t bcs_writer_error(const bcs_writer_t *writer) {
+    return writer ? writer->error : BCS_ERROR_INVALID_INPUT;
+}
+
+uint8_t *bcs_writer_reserve(bcs_writer_t *writer, size_t length) {
+    if (!writer || ensure_capacity(writer, length) != BCS_OK) {
+        return NULL;
+    }
+    if (count_only(writer, length)) {
+        return NULL;
+    }
+
+    uint8_t *span = writer->buffer + writer->position;
+    writer->position += length;
+    return span;
+}
+
+bcs_error_t bcs_writer_attach_hash(bcs_writer_t *writer, struct blake2b_state *hash) {
+    if (!writer || !hash || writer->mode == BCS_WRITER_COUNTING) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    writer->hash = hash;
+    writer->hashed = writer->position;
+    return BCS_OK;
+}
+
+bcs_error_t bcs_writer_finish_hash(bcs_writer_t *writer, uint8_t *digest) {
+    if (!writer || !writer->hash || !digest) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    if (writer->error != BCS_OK) {
+        writer->hash = NULL;
+        return writer->error;
+    }
+
+    absorb_hash(writer);
+    blake2b_final(writer->hash, digest);
+    writer->hash = NULL;
+    return BCS_OK;
+}
+
+bcs_error_t bcs_writer_flush(bcs_writer_t *writer) {
+    if (!writer) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    if (writer->error != BCS_OK || writer->mode != BCS_WRITER_STREAM) {
+        return writer->error;
+    }
+
+    return flush_stream(writer);
+}
+
+size_t bcs_writer_size(const bcs_writer_t *writer) {
+    return writer ? writer->flushed + writer->position : 0;
+}
+
 const uint8_t *bcs_writer_get_bytes(const bcs_writer_t *writer, size_t *length) {
     if (!writer || !length) {
         return NULL;
     }
 
-    *length = writer->position;
-    return writer->buffer;
+    *length = bcs_writer_size(writer);
+    return writer->mode == BCS_WRITER_STREAM ? NULL : writer->buffer;
+}
+
+bcs_error_t bcs_writer_splice(bcs_writer_t *writer, size_t offset, size_t remove_length,
+                              const uint8_t *data, size_t insert_length) {
+    if (!writer || (!data && insert_length > 0) || writer->mode == BCS_WRITER_STREAM ||
+        offset > writer->position || remove_length > writer->position - offset) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    if (writer->error != BCS_OK) {
+        return writer->error;
+    }
+    // Absorbed bytes are final
+    if (writer->hash && offset < writer->hashed) {
+        return latch_error(writer, BCS_ERROR_INVALID_INPUT);
+    }
+
+    if (insert_length > remove_length) {
+        bcs_error_t err = grow(writer, insert_length - remove_length);
+        if (err != BCS_OK) return err;
+    }
+
+    if (writer->mode != BCS_WRITER_COUNTING) {
+        size_t tail = writer->position - offset - remove_length;
+        if (insert_length != remove_length) {
+            memmove(writer->buffer + offset + insert_length,
+                    writer->buffer + offset + remove_length, tail);
+        }
+        if (insert_length > 0) {
+            memcpy(writer->buffer + offset, data, insert_length);
+        }
+    }
+
+    writer->position = writer->position - remove_length + insert_length;
+    return BCS_OK;
+}
+
+bcs_error_t bcs_writer_ensure(bcs_writer_t *writer, size_t length) {
+    if (!writer || writer->mode == BCS_WRITER_STREAM) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    if (writer->error != BCS_OK) {
+        return writer->error;
+    }
+
+    return grow(writer, length);
 }
 
 bcs_error_t bcs_write_u8(bcs_writer_t *writer, uint8_t value) {
     bcs_error_t err = ensure_capacity(writer, 1);
     if (err != BCS_OK) return err;
+    if (count_only(writer, 1)) return BCS_OK;
 
     writer->buffer[writer->position++] = value;
     return BCS_OK;
@@ -96,6 +445,7 @@ bcs_error_t bcs_write_u8(bcs_writer_t *writer, uint8_t value) {
 bcs_error_t bcs_write_u16(bcs_writer_t *writer, uint16_t value) {
     bcs_error_t err = ensure_capacity(writer, 2);
     if (err != BCS_OK) return err;
+    if (count_only(writer, 2)) return BCS_OK;
 
     // Little endian
     writer->buffer[writer->position++] = value & 0xFF;
@@ -107,6 +457,7 @@ bcs_error_t bcs_write_u16(bcs_writer_t *writer, uint16_t value) {
 bcs_error_t bcs_write_u32(bcs_writer_t *writer, uint32_t value) {
     bcs_error_t err = ensure_capacity(writer, 4);
     if (err != BCS_OK) return err;
+    if (count_only(writer, 4)) return BCS_OK;
 
     // Little endian
     writer->buffer[writer->position++] = value & 0xFF;
@@ -120,6 +471,7 @@ bcs_error_t bcs_write_u32(bcs_writer_t *writer, uint32_t value) {
 bcs_error_t bcs_write_u64(bcs_writer_t *writer, uint64_t value) {
     bcs_error_t err = ensure_capacity(writer, 8);
     if (err != BCS_OK) return err;
+    if (count_only(writer, 8)) return BCS_OK;
 
     // Little endian
     for (int i = 0; i < 8; i++) {
@@ -145,7 +497,7 @@ bcs_error_t bcs_write_u128(bcs_writer_t *writer, uint64_t high, uint64_t low) {
 
 bcs_error_t bcs_write_u256(bcs_writer_t *writer, const uint8_t *bytes) {
     if (!bytes) {
-        return BCS_ERROR_INVALID_INPUT;
+        return latch_error(writer, BCS_ERROR_INVALID_INPUT);
     }
 
     return bcs_write_fixed_bytes(writer, bytes, 32);
@@ -155,26 +507,48 @@ bcs_error_t bcs_write_bool(bcs_writer_t *writer, bool value) {
     return bcs_write_u8(writer, value ? 1 : 0);
 }
 
-bcs_error_t bcs_write_uleb128(bcs_writer_t *writer, uint64_t value) {
-    do {
-        uint8_t byte = value & 0x7F;
+size_t bcs_uleb128_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
         value >>= 7;
+        size++;
+    }
+    return size;
+}
 
-        if (value != 0) {
-            byte |= 0x80;
-        }
+bcs_error_t bcs_write_uleb128(bcs_writer_t *writer, uint64_t value) {
+    size_t size = bcs_uleb128_size(value);
 
-        bcs_error_t err = bcs_write_u8(writer, byte);
-        if (err != BCS_OK) return err;
+    bcs_error_t err = ensure_capacity(writer, size);
+    if (err != BCS_OK) return err;
+    if (count_only(writer, size)) return BCS_OK;
 
-    } while (value != 0);
+    uint8_t *out = writer->buffer + writer->position;
+    writer->position += size;
+
+    // Lengths and enum tags almost always fit in one or two bytes
+    if (size == 1) {
+        out[0] = (uint8_t)value;
+        return BCS_OK;
+    }
+    if (size == 2) {
+        out[0] = (uint8_t)(value | 0x80);
+        out[1] = (uint8_t)(value >> 7);
+        return BCS_OK;
+    }
+
+    for (size_t i = 0; i < size - 1; i++) {
+        out[i] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[size - 1] = (uint8_t)value;
 
     return BCS_OK;
 }
 
 bcs_error_t bcs_write_bytes(bcs_writer_t *writer, const uint8_t *data, size_t length) {
     if (!data && length > 0) {
-        return BCS_ERROR_INVALID_INPUT;
+        return latch_error(writer, BCS_ERROR_INVALID_INPUT);
     }
 
     // Write length prefix
@@ -187,7 +561,7 @@ bcs_error_t bcs_write_bytes(bcs_writer_t *writer, const uint8_t *data, size_t le
 
 bcs_error_t bcs_write_string(bcs_writer_t *writer, const char *str) {
     if (!str) {
-        return BCS_ERROR_INVALID_INPUT;
+        return latch_error(writer, BCS_ERROR_INVALID_INPUT);
     }
 
     size_t length = strlen(str);
@@ -196,11 +570,29 @@ bcs_error_t bcs_write_string(bcs_writer_t *writer, const char *str) {
 
 bcs_error_t bcs_write_fixed_bytes(bcs_writer_t *writer, const uint8_t *data, size_t length) {
     if (!data && length > 0) {
-        return BCS_ERROR_INVALID_INPUT;
+        return latch_error(writer, BCS_ERROR_INVALID_INPUT);
+    }
+
+    // Stream writers take blocks larger than a chunk piece by piece
+    if (writer && writer->mode == BCS_WRITER_STREAM && length > writer->capacity) {
+        while (length > 0) {
+            size_t room = writer->capacity - writer->position;
+            size_t n = length < room ? length : room;
+            if (n == 0) {
+                n = length < writer->capacity ? length : writer->capacity;
+            }
+
+            bcs_error_t err = bcs_write_fixed_bytes(writer, data, n);
+            if (err != BCS_OK) return err;
+            data += n;
+            length -= n;
+        }
+        return BCS_OK;
     }
 
     bcs_error_t err = ensure_capacity(writer, length);
     if (err != BCS_OK) return err;
+    if (count_only(writer, length)) return BCS_OK;
 
     memcpy(writer->buffer + writer->position, data, length);
     writer->position += length;
@@ -349,6 +741,11 @@ bcs_error_t bcs_read_uleb128(bcs_reader_t *reader, uint64_t *value) {
         return BCS_ERROR_INVALID_INPUT;
     }
 
+    // A maximal encoding fits, so skip the per-byte bounds checks
+    if (reader->position <= reader->length && reader->length - reader->position >= BCS_ULEB128_MAX_SIZE) {
+        return decode_uleb128_unchecked(reader, value);
+    }
+
     *value = 0;
     uint64_t shift = 0;
 
@@ -373,6 +770,49 @@ bcs_error_t bcs_read_uleb128(bcs_reader_t *reader, uint64_t *value) {
     return BCS_OK;
 }
 
+bcs_error_t bcs_read_uleb128_run(bcs_reader_t *reader, uint64_t *values, size_t count) {
+    if (!reader || (!values && count > 0)) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    size_t i = 0;
+
+    // Bulk of the run: one bounds check per value
+    while (i < count && reader->position <= reader->length &&
+           reader->length - reader->position >= BCS_ULEB128_MAX_SIZE) {
+        bcs_error_t err = decode_uleb128_unchecked(reader, &values[i++]);
+        if (err != BCS_OK) return err;
+    }
+
+    // Last few bytes of the buffer
+    for (; i < count; i++) {
+        bcs_error_t err = bcs_read_uleb128(reader, &values[i]);
+        if (err != BCS_OK) return err;
+    }
+
+    return BCS_OK;
+}
+
+bcs_error_t bcs_read_uleb128_vector(bcs_reader_t *reader, uint64_t *values, size_t max_values, size_t *count) {
+    if (!reader || !count) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    uint64_t length;
+    bcs_error_t err = bcs_read_uleb128(reader, &length);
+    if (err != BCS_OK) return err;
+
+    if (length > max_values) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    err = bcs_read_uleb128_run(reader, values, (size_t)length);
+    if (err != BCS_OK) return err;
+
+    *count = (size_t)length;
+    return BCS_OK;
+}
+
 bcs_error_t bcs_read_bytes(bcs_reader_t *reader, uint8_t *buffer, size_t length) {
     if (!buffer && length > 0) {
         return BCS_ERROR_INVALID_INPUT;
@@ -442,10 +882,174 @@ bcs_error_t bcs_read_option_tag(bcs_reader_t *reader, bool *has_value) {
     return BCS_OK;
 }
 
+// ============================================================================
+// Zero-copy reads and skips
+// ============================================================================
+
+bcs_error_t bcs_read_fixed_view(bcs_reader_t *reader, size_t length, bcs_view_t *view) {
+    if (!view) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    if (length > bcs_reader_remaining(reader)) {
+        return BCS_ERROR_BUFFER_UNDERFLOW;
+    }
+
+    view->data = reader->buffer + reader->position;
+    view->length = length;
+    reader->position += length;
+
+    return BCS_OK;
+}
+
+bcs_error_t bcs_read_bytes_view(bcs_reader_t *reader, bcs_view_t *view) {
+    uint64_t length;
+    bcs_error_t err = bcs_read_uleb128(reader, &length);
+    if (err != BCS_OK) return err;
+
+    // Compare as u64 so a huge prefix cannot wrap on 32-bit size_t
+    if (length > bcs_reader_remaining(reader)) {
+        return BCS_ERROR_BUFFER_UNDERFLOW;
+    }
+
+    return bcs_read_fixed_view(reader, (size_t)length, view);
+}
+
+bcs_error_t bcs_read_rest_view(bcs_reader_t *reader, bcs_view_t *view) {
+    return bcs_read_fixed_view(reader, bcs_reader_remaining(reader), view);
+}
+
+bcs_error_t bcs_skip_fixed(bcs_reader_t *reader, size_t length) {
+    if (length > bcs_reader_remaining(reader)) {
+        return BCS_ERROR_BUFFER_UNDERFLOW;
+    }
+
+    reader->position += length;
+    return BCS_OK;
+}
+
+bcs_error_t bcs_skip_u64(bcs_reader_t *reader) {
+    return bcs_skip_fixed(reader, 8);
+}
+
+bcs_error_t bcs_skip_bytes(bcs_reader_t *reader) {
+    uint64_t length;
+    bcs_error_t err = bcs_read_uleb128(reader, &length);
+    if (err != BCS_OK) return err;
+
+    if (length > bcs_reader_remaining(reader)) {
+        return BCS_ERROR_BUFFER_UNDERFLOW;
+    }
+
+    reader->position += (size_t)length;
+    return BCS_OK;
+}
+
+bcs_error_t bcs_skip_option(bcs_reader_t *reader, size_t value_length, bool *has_value) {
+    bool present;
+    bcs_error_t err = bcs_read_option_tag(reader, &present);
+    if (err != BCS_OK) return err;
+
+    if (present) {
+        err = bcs_skip_fixed(reader, value_length);
+        if (err != BCS_OK) return err;
+    }
+
+    if (has_value) {
+        *has_value = present;
+    }
+    return BCS_OK;
+}
+
 // ============================================================================
 // Utility functions
 // ============================================================================
 
+// Nibble value of each ASCII character, 0xFF for non-hex characters
+static const uint8_t hex_decode_table[256] = {
+#define X 0xFF
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, X, X, X, X, X, X,
+    X, 10, 11, 12, 13, 14, 15, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, 10, 11, 12, 13, 14, 15, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+    X, X, X, X, X, X, X, X, X, X, X, X, X, X, X, X,
+#undef X
+};
+
+// Two lowercase hex characters for each byte value (the tail of bcs_bytes_to_hex())
+static const char hex_pair_table[513] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_HIGH 0x8080808080808080ULL
+
+// Little-endian loads; compilers fold these into a single load on LE targets
+static inline uint64_t load_u64_le(const uint8_t *src) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | src[i];
+    }
+    return value;
+}
+
+static inline void store_u64_le(uint8_t *dst, uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(dst, &value, 8);
+#else
+    for (int i = 0; i < 8; i++) {
+        dst[i] = (value >> (i * 8)) & 0xFF;
+    }
+#endif
+}
+
+// High bit of each byte lane set where the lane is >= n (lanes must be < 0x80)
+static inline uint64_t swar_ge(uint64_t x, uint8_t n) {
+    return (x + (0x80 - n) * SWAR_ONES) & SWAR_HIGH;
+}
+
+// Decode 8 hex characters into 4 bytes; returns false on any non-hex character
+static inline bool hex_decode_8(const uint8_t *src, uint8_t *dst) {
+    uint64_t x = load_u64_le(src);
+    uint64_t folded = x | (0x20 * SWAR_ONES);
+
+    uint64_t digit = swar_ge(x, '0') & ~swar_ge(x, '9' + 1);
+    uint64_t letter = swar_ge(folded, 'a') & ~swar_ge(folded, 'f' + 1);
+    if ((x & SWAR_HIGH) || (digit | letter) != SWAR_HIGH) {
+        return false;
+    }
+
+    // '0'-'9' -> 0-9 via the low nibble, 'a'-'f'/'A'-'F' -> 1-6, +9
+    uint64_t nibbles = (x & (0x0F * SWAR_ONES)) + (letter >> 7) * 9;
+
+    // Merge character pairs: lane byte 2k = high nibble, byte 2k+1 = low nibble
+    uint64_t pairs = ((nibbles & 0x000F000F000F000FULL) << 4) | ((nibbles >> 8) & 0x000F000F000F000FULL);
+    pairs = (pairs | (pairs >> 8)) & 0x0000FFFF0000FFFFULL;
+    pairs = (pairs | (pairs >> 16)) & 0x00000000FFFFFFFFULL;
+
+    for (int i = 0; i < 4; i++) {
+        dst[i] = (pairs >> (i * 8)) & 0xFF;
+    }
+    return true;
+}
+
 bcs_error_t bcs_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes) {
     if (!hex || !bytes || !actual_bytes) {
         return BCS_ERROR_INVALID_INPUT;
@@ -466,16 +1070,23 @@ bcs_error_t bcs_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_bytes,
         return BCS_ERROR_BUFFER_TOO_SMALL;
     }
 
-    for (size_t i = 0; i < byte_len; i++) {
-        char high = hex[i * 2];
-        char low = hex[i * 2 + 1];
+    const uint8_t *src = (const uint8_t *)hex;
+    size_t i = 0;
 
-        if (!isxdigit(high) || !isxdigit(low)) {
+    // 16 characters (8 bytes) per step
+    for (; i + 8 <= byte_len; i += 8) {
+        if (!hex_decode_8(src + i * 2, bytes + i) || !hex_decode_8(src + i * 2 + 8, bytes + i + 4)) {
             return BCS_ERROR_INVALID_INPUT;
         }
+    }
 
-        uint8_t h = (high <= '9') ? (high - '0') : (tolower(high) - 'a' + 10);
-        uint8_t l = (low <= '9') ? (low - '0') : (tolower(low) - 'a' + 10);
+    for (; i < byte_len; i++) {
+        uint8_t h = hex_decode_table[src[i * 2]];
+        uint8_t l = hex_decode_table[src[i * 2 + 1]];
+
+        if ((h | l) & 0xF0) {
+            return BCS_ERROR_INVALID_INPUT;
+        }
 
         bytes[i] = (h << 4) | l;
     }
@@ -484,13 +1095,44 @@ bcs_error_t bcs_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_bytes,
     return BCS_OK;
 }
 
+// Encode the 4 bytes in the low half of x as 8 hex characters, first
+// character in the lowest lane
+static inline uint64_t hex_encode_4(uint64_t x) {
+    // Spread the bytes to one per 16-bit lane, then split each into its
+    // high nibble (low byte of the lane) and low nibble (high byte)
+    x &= 0x00000000FFFFFFFFULL;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    uint64_t nibbles = ((x >> 4) & 0x000F000F000F000FULL) | ((x & 0x000F000F000F000FULL) << 8);
+
+    // 0-9 -> '0'-'9', 10-15 -> 'a'-'f'
+    return nibbles + '0' * SWAR_ONES + (swar_ge(nibbles, 10) >> 7) * ('a' - '0' - 10);
+}
+
 void bcs_bytes_to_hex(const uint8_t *bytes, size_t length, char *hex) {
-    const char hex_chars[] = "0123456789abcdef";
+    size_t i = 0;
 
-    for (size_t i = 0; i < length; i++) {
-        hex[i * 2] = hex_chars[(bytes[i] >> 4) & 0x0F];
-        hex[i * 2 + 1] = hex_chars[bytes[i] & 0x0F];
+    // 8 bytes (16 characters) per step, built in two registers
+    for (; i + 8 <= length; i += 8) {
+        uint64_t x = load_u64_le(bytes + i);
+        store_u64_le((uint8_t *)hex + i * 2, hex_encode_4(x));
+        store_u64_le((uint8_t *)hex + i * 2 + 8, hex_encode_4(x >> 32));
+    }
+
+    for (; i < length; i++) {
+        memcpy(hex + i * 2, hex_pair_table + bytes[i] * 2, 2);
     }
 
     hex[length * 2] = '\0';
-}
\ No newline at end of file
+}
+
+void bcs_store_u16(uint8_t *dst, uint16_t value) {
+    dst[0] = value & 0xFF;
+    dst[1] = (value >> 8) & 0xFF;
+}
+
+void bcs_store_u64(uint8_t *dst, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        dst[i] = (value >> (i * 8)) & 0xFF;
+    }
+}
@@ -5,6 +5,41 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+// Longest ULEB128 encoding of a u64
+#define BCS_ULEB128_MAX_SIZE 10
+
+// Error codes
+typedef enum {
+    BCS_OK = 0,
+    BCS_ERROR_OUT_OF_MEMORY = -1,
+    BCS_ERROR_BUFFER_TOO_SMALL = -2,
+    BCS_ERROR_INVALID_INPUT = -3,
+    BCS_ERROR_OVERFLOW = -4,
+    BCS_ERROR_BUFFER_UNDERFLOW = -5,
+    BCS_ERROR_SINK = -6,          // A stream writer's flush callback could not deliver the bytes
+} bcs_error_t;
+
+// Memory allocator used for writer buffers and library-allocated outputs
+typedef struct {
+    void *(*alloc)(void *ctx, size_t size);
+    void *(*realloc)(void *ctx, void *ptr, size_t size);
+    void (*free)(void *ctx, void *ptr);
+    void *ctx;
+} bcs_allocator_t;
+
+// Writer buffer modes
+typedef enum {
+    BCS_WRITER_GROWABLE = 0,  // Buffer owned by the writer, grown through its allocator
+    BCS_WRITER_FIXED = 1,     // Caller-owned buffer, never allocated or freed
+    BCS_WRITER_COUNTING = 2,  // No buffer, only counts the bytes that would be written
+    BCS_WRITER_STREAM = 3,    // Caller-owned chunk, handed to a flush callback whenever it fills
+} bcs_writer_mode_t;
+
+// Receives the bytes of a stream writer, in order, one chunk per call
+typedef bcs_error_t (*bcs_flush_fn)(void *ctx, const uint8_t *data, size_t length);
+
+struct blake2b_state;
+
 // BCS Writer for serialization
 typedef struct {
     uint8_t *buffer;
@@ -12,6 +47,14 @@ typedef struct {
     size_t position;
     size_t max_size;
     size_t allocate_size;
+    bcs_writer_mode_t mode;
+    bcs_error_t error;        // First failed write (see bcs_writer_error)
+    const bcs_allocator_t *allocator;  // Growable writers: grows and frees the buffer
+    struct blake2b_state *hash;   // Absorbs written bytes (see bcs_writer_attach_hash)
+    size_t hashed;                // Bytes before this offset are already absorbed
+    bcs_flush_fn flush;           // Stream writers only
+    void *flush_ctx;
+    size_t flushed;               // Stream writers: bytes already handed to flush
 } bcs_writer_t;
 
 // BCS Reader for deserialization
@@ -21,15 +64,58 @@ typedef struct {
     size_t position;
 } bcs_reader_t;
 
-// Error codes
-typedef enum {
-    BCS_OK = 0,
-    BCS_ERROR_OUT_OF_MEMORY = -1,
-    BCS_ERROR_BUFFER_TOO_SMALL = -2,
-    BCS_ERROR_INVALID_INPUT = -3,
-    BCS_ERROR_OVERFLOW = -4,
-    BCS_ERROR_BUFFER_UNDERFLOW = -5,
-} bcs_error_t;
+// Borrowed slice of a reader's buffer (valid as long as that buffer is)
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+} bcs_view_t;
+
+// ============================================================================
+// Allocator API
+// ============================================================================
+
+/**
+ * Set the allocator used when none is given explicitly
+ *
+ * Applies to bcs_writer_init() and to the buffers the sui_* functions
+ * without an allocator parameter return (hex strings, transaction bytes,
+ * templates). Set it once at startup, before anything is allocated:
+ * bcs_free() releases through whatever the default is when it is called.
+ * Code that needs another allocator while the default is in use should
+ * pass it explicitly (bcs_writer_init_with_allocator(), the
+ * sui_*_with_allocator() functions) and release with bcs_allocator_free().
+ *
+ * @param allocator Allocator (must outlive its allocations), or NULL for malloc/realloc/free
+ */
+void bcs_set_default_allocator(const bcs_allocator_t *allocator);
+
+/**
+ * Get the current default allocator
+ */
+const bcs_allocator_t *bcs_get_default_allocator(void);
+
+/**
+ * Allocate through the default allocator
+ */
+void *bcs_alloc(size_t size);
+
+/**
+ * Release memory returned by bcs_alloc() or by a sui_* function
+ * (hex strings and transaction bytes) under the current default allocator
+ */
+void bcs_free(void *ptr);
+
+/**
+ * Allocate through allocator
+ * @param allocator Allocator, or NULL for the default
+ */
+void *bcs_allocator_alloc(const bcs_allocator_t *allocator, size_t size);
+
+/**
+ * Release memory through the allocator that returned it
+ * @param allocator Allocator ptr came from, or NULL for the default
+ */
+void bcs_allocator_free(const bcs_allocator_t *allocator, void *ptr);
 
 // ============================================================================
 // Writer API - for serializing data
@@ -44,20 +130,190 @@ typedef enum {
  */
 bcs_error_t bcs_writer_init(bcs_writer_t *writer, size_t initial_capacity, size_t max_size);
 
+/**
+ * Initialize a growable BCS writer that allocates through allocator
+ * @param writer Pointer to writer structure
+ * @param initial_capacity Initial buffer capacity in bytes
+ * @param max_size Maximum allowed buffer size (0 for unlimited)
+ * @param allocator Allocator for the buffer, or NULL for the default allocator
+ * @return BCS_OK on success, error code otherwise
+ */
+bcs_error_t bcs_writer_init_with_allocator(bcs_writer_t *writer, size_t initial_capacity, size_t max_size,
+                                           const bcs_allocator_t *allocator);
+
+/**
+ * Initialize a BCS writer over a caller-owned buffer
+ *
+ * The writer never allocates: writes that do not fit return
+ * BCS_ERROR_BUFFER_TOO_SMALL and leave the buffer unchanged.
+ * The buffer may live on the stack or in static storage.
+ *
+ * @param writer Pointer to writer structure
+ * @param buffer Caller-owned storage (must outlive the writer)
+ * @param capacity Size of buffer in bytes
+ * @return BCS_OK on success, error code otherwise
+ */
+bcs_error_t bcs_writer_init_fixed(bcs_writer_t *writer, uint8_t *buffer, size_t capacity);
+
+/**
+ * Initialize a measuring writer
+ *
+ * Accepts the same bcs_write_* calls as any other writer but stores
+ * nothing; writer->position (or bcs_writer_get_bytes' length) ends up as
+ * the exact serialized size, ULEB128 prefixes included. Run a serializer
+ * against it first to allocate the real output once at the right size.
+ *
+ * @param writer Pointer to writer structure
+ * @return BCS_OK on success, error code otherwise
+ */
+bcs_error_t bcs_writer_init_counting(bcs_writer_t *writer);
+
+/**
+ * Initialize a writer that streams through a small chunk buffer
+ *
+ * Bytes collect in chunk; whenever the next write does not fit, the
+ * chunk is handed to flush and reused, so memory stays bounded by
+ * capacity however long the output is. Each single write or reserved
+ * block must fit in capacity (bcs_write_fixed_bytes() and the
+ * bcs_write_bytes()/string() payloads are split automatically), so size
+ * the chunk above the largest reserved block (256 bytes covers the Sui
+ * builders). writer->position is relative to the current chunk; use
+ * bcs_writer_size() for the total. Splicing is not supported.
+ *
+ * @param writer Pointer to writer structure
+ * @param chunk Caller-owned chunk buffer (must outlive the writer)
+ * @param capacity Size of chunk in bytes
+ * @param flush Callback receiving each full chunk (see bcs_sink.h)
+ * @param flush_ctx Passed to flush
+ * @return BCS_OK on success, error code otherwise
+ *
+ * Example:
+ *   uint8_t chunk[256];
+ *   bcs_writer_t writer;
+ *   bcs_writer_init_stream(&writer, chunk, sizeof(chunk), bcs_fd_sink_write, &fd);
+ *   sui_build_sensor_batch_transaction_into(&params, readings, n, &writer);
+ *   bcs_writer_flush(&writer);  // Hand over the last partial chunk
+ */
+bcs_error_t bcs_writer_init_stream(bcs_writer_t *writer, uint8_t *chunk, size_t capacity,
+                                   bcs_flush_fn flush, void *flush_ctx);
+
 /**
  * Free resources allocated by the writer
+ * Fixed-buffer writers are detached from their buffer but nothing is freed.
  * @param writer Pointer to writer structure
  */
 void bcs_writer_free(bcs_writer_t *writer);
 
+/**
+ * Discard written data but keep the buffer for reuse
+ * Also clears a latched error.
+ * @param writer Pointer to writer structure
+ */
+void bcs_writer_reset(bcs_writer_t *writer);
+
+/**
+ * Get the first error a write on this writer failed with
+ *
+ * The first failure is latched: every later write (and reserve/splice)
+ * fails with the same error until bcs_writer_reset(). A sequence of writes
+ * can therefore ignore the individual return codes and check this once
+ * at the end.
+ *
+ * @param writer Pointer to writer structure
+ * @return BCS_OK if no write has failed, the latched error otherwise
+ */
+bcs_error_t bcs_writer_error(const bcs_writer_t *writer);
+
+/**
+ * Reserve a fixed-size block and return it for direct stores
+ *
+ * Does one capacity check for the whole block and advances the position;
+ * fill every byte of the span (e.g. with bcs_store_u64()) before the
+ * next write. Pointers into the buffer are invalidated by the next write
+ * that grows a growable writer.
+ *
+ * @param writer Pointer to writer structure
+ * @param length Size of the block in bytes
+ * @return Span to fill, or NULL if nothing should be stored: the writer is
+ *         counting (the position still advances) or the reservation failed
+ *         (the error is latched, see bcs_writer_error())
+ */
+uint8_t *bcs_writer_reserve(bcs_writer_t *writer, size_t length);
+
+/**
+ * Hash bytes while they are written
+ *
+ * Everything written after this call is fed to hash as the build goes,
+ * while it is still in cache, so the digest is ready without a second
+ * pass. Bytes are absorbed once a later write starts; they must not be
+ * changed after that (bcs_writer_splice() refuses to). Patch fields in
+ * place only in the bytes written by the latest call.
+ *
+ * @param writer Growable or fixed writer
+ * @param hash Started hash (blake2b_init()), e.g. with a prefix already absorbed
+ * @return BCS_OK on success, BCS_ERROR_INVALID_INPUT for counting writers
+ */
+bcs_error_t bcs_writer_attach_hash(bcs_writer_t *writer, struct blake2b_state *hash);
+
+/**
+ * Absorb the remaining bytes, finish the hash and detach it
+ * @param writer Writer with an attached hash
+ * @param digest Output buffer of the hash's digest length
+ * @return BCS_OK on success, the latched error if a write failed
+ *         (the digest would not match the bytes)
+ */
+bcs_error_t bcs_writer_finish_hash(bcs_writer_t *writer, uint8_t *digest);
+
+/**
+ * Hand any buffered bytes of a stream writer to its flush callback
+ * Call once after the last write. A no-op for other writers.
+ * @return BCS_OK on success, the latched error otherwise
+ */
+bcs_error_t bcs_writer_flush(bcs_writer_t *writer);
+
+/**
+ * Total bytes written so far, including bytes a stream writer has flushed
+ */
+size_t bcs_writer_size(const bcs_writer_t *writer);
+
 /**
  * Get the serialized bytes from the writer
  * @param writer Pointer to writer structure
  * @param length Output parameter for the length of serialized data
- * @return Pointer to serialized data (valid until writer is freed)
+ * @return Pointer to serialized data (valid until writer is freed), NULL for counting
+ *         and stream writers (length is still the total size)
  */
 const uint8_t *bcs_writer_get_bytes(const bcs_writer_t *writer, size_t *length);
 
+/**
+ * Replace a range of already-written bytes, shifting the tail as needed
+ *
+ * Same-length replacements are a plain copy; otherwise the bytes after the
+ * range are moved and the writer grows or shrinks by the difference.
+ *
+ * @param writer Pointer to writer structure
+ * @param offset Start of the range to replace
+ * @param remove_length Number of existing bytes to remove
+ * @param data Replacement bytes
+ * @param insert_length Number of replacement bytes
+ * @return BCS_OK on success, error code otherwise
+ */
+bcs_error_t bcs_writer_splice(bcs_writer_t *writer, size_t offset, size_t remove_length,
+                              const uint8_t *data, size_t insert_length);
+
+/**
+ * Make sure length more bytes fit without writing them
+ *
+ * Grows a growable writer now, so a sequence of writes or splices adding
+ * up to length cannot fail halfway for lack of space.
+ *
+ * @param writer Growable, fixed or counting writer
+ * @param length Additional bytes needed beyond the current position
+ * @return BCS_OK on success, BCS_ERROR_BUFFER_TOO_SMALL or
+ *         BCS_ERROR_OUT_OF_MEMORY (latched) otherwise
+ */
+bcs_error_t bcs_writer_ensure(bcs_writer_t *writer, size_t length);
+
 /**
  * Write a single byte (u8)
  */
@@ -101,6 +357,11 @@ bcs_error_t bcs_write_bool(bcs_writer_t *writer, bool value);
  */
 bcs_error_t bcs_write_uleb128(bcs_writer_t *writer, uint64_t value);
 
+/**
+ * Number of bytes bcs_write_uleb128() emits for value (1..BCS_ULEB128_MAX_SIZE)
+ */
+size_t bcs_uleb128_size(uint64_t value);
+
 /**
  * Write raw bytes
  */
@@ -192,6 +453,24 @@ bcs_error_t bcs_read_bool(bcs_reader_t *reader, bool *value);
  */
 bcs_error_t bcs_read_uleb128(bcs_reader_t *reader, uint64_t *value);
 
+/**
+ * Read count consecutive ULEB128 values
+ * @param reader Pointer to reader
+ * @param values Output array (at least count entries)
+ * @param count Number of values to read
+ */
+bcs_error_t bcs_read_uleb128_run(bcs_reader_t *reader, uint64_t *values, size_t count);
+
+/**
+ * Read a ULEB128 length followed by that many ULEB128 values
+ * @param reader Pointer to reader
+ * @param values Output array
+ * @param max_values Capacity of values
+ * @param count Output: number of values read
+ * @return BCS_OK on success, BCS_ERROR_BUFFER_TOO_SMALL if the vector has more than max_values entries
+ */
+bcs_error_t bcs_read_uleb128_vector(bcs_reader_t *reader, uint64_t *values, size_t max_values, size_t *count);
+
 /**
  * Read raw bytes into a buffer
  * @param reader Pointer to reader
@@ -220,6 +499,49 @@ bcs_error_t bcs_read_vec_length(bcs_reader_t *reader, size_t *length);
  */
 bcs_error_t bcs_read_option_tag(bcs_reader_t *reader, bool *has_value);
 
+// ============================================================================
+// Zero-copy reads and skips - views point into the reader's buffer
+// ============================================================================
+
+/**
+ * Borrow the next length bytes without copying
+ * @param view Output: slice of the reader's buffer
+ */
+bcs_error_t bcs_read_fixed_view(bcs_reader_t *reader, size_t length, bcs_view_t *view);
+
+/**
+ * Borrow a length-prefixed (ULEB128) byte vector or string without copying
+ * @param view Output: the payload, excluding the length prefix
+ */
+bcs_error_t bcs_read_bytes_view(bcs_reader_t *reader, bcs_view_t *view);
+
+/**
+ * Borrow everything from the current position to the end of the buffer
+ * The reader is left at the end.
+ */
+bcs_error_t bcs_read_rest_view(bcs_reader_t *reader, bcs_view_t *view);
+
+/**
+ * Skip length bytes
+ */
+bcs_error_t bcs_skip_fixed(bcs_reader_t *reader, size_t length);
+
+/**
+ * Skip a u64
+ */
+bcs_error_t bcs_skip_u64(bcs_reader_t *reader);
+
+/**
+ * Skip a length-prefixed (ULEB128) byte vector or string
+ */
+bcs_error_t bcs_skip_bytes(bcs_reader_t *reader);
+
+/**
+ * Skip an Option<T> whose payload is value_length bytes when present
+ * @param has_value Output: true if Some (optional)
+ */
+bcs_error_t bcs_skip_option(bcs_reader_t *reader, size_t value_length, bool *has_value);
+
 // ============================================================================
 // Utility functions
 // ============================================================================
@@ -242,4 +564,17 @@ bcs_error_t bcs_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_bytes,
  */
 void bcs_bytes_to_hex(const uint8_t *bytes, size_t length, char *hex);
 
+/**
+ * Store a 16-bit unsigned integer (u16) - little endian, no bounds checks
+ * @param dst Destination (at least 2 bytes)
+ */
+void bcs_store_u16(uint8_t *dst, uint16_t value);
+
+/**
+ * Store a 64-bit unsigned integer (u64) - little endian, no bounds checks
+ * For patching already-serialized fields in place
+ * @param dst Destination (at least 8 bytes)
+ */
+void bcs_store_u64(uint8_t *dst, uint64_t value);
+
 #endif // BCS_H
\ No newline at end of file
@@ -0,0 +1,290 @@
+/**
+ * BCS Schema
+ * Compile-time encoders and decoders for fixed-layout BCS messages
+ *
+ * A type declares its fields once by specializing bcs::schema. The
+ * templates below derive the encoder and the decoder, plus constexpr
+ * encoded sizes and field offsets. Every field has a fixed size, so an
+ * encode is a run of straight-line stores into one reserved span, and a
+ * layout change surfaces as a failed static_assert instead of a
+ * malformed transaction.
+ *
+ * Example:
+ *   namespace bcs {
+ *   template <> struct schema<gas_object_t> {
+ *       typedef fields<
+ *           BCS_FIELD(gas_object_t, object_id),
+ *           BCS_FIELD(gas_object_t, version),
+ *           BCS_FIELD_AS(gas_object_t, digest, prefixed<32>)
+ *       > type;
+ *   };
+ *   }
+ *
+ *   static_assert(bcs::encoded_size<gas_object_t>() == 73, "ObjectRef layout");
+ *   bcs::write(&writer, gas);  // 73 bytes, no per-field bounds checks
+ */
+
+#ifndef BCS_SCHEMA_H
+#define BCS_SCHEMA_H
+
+#include "bcs.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace bcs {
+
+// Specialize with `typedef fields<...> type;` to describe a struct
+template <typename T>
+struct schema;
+
+template <typename T>
+struct codec;
+
+// ============================================================================
+// Field codecs
+// Each provides size, store(dst, value) and load(src, value); load returns
+// false for bytes that are not a valid encoding.
+// ============================================================================
+
+// Little-endian unsigned integers
+template <typename T>
+struct uint_codec {
+    static constexpr size_t size = sizeof(T);
+
+    static void store(uint8_t *dst, T value) {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            dst[i] = (uint8_t)(value >> (8 * i));
+        }
+    }
+
+    static bool load(const uint8_t *src, T &value) {
+        value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= (T)src[i] << (8 * i);
+        }
+        return true;
+    }
+};
+
+template <> struct codec<uint8_t> : uint_codec<uint8_t> {};
+template <> struct codec<uint16_t> : uint_codec<uint16_t> {};
+template <> struct codec<uint32_t> : uint_codec<uint32_t> {};
+template <> struct codec<uint64_t> : uint_codec<uint64_t> {};
+
+template <>
+struct codec<bool> {
+    static constexpr size_t size = 1;
+
+    static void store(uint8_t *dst, bool value) {
+        dst[0] = value ? 1 : 0;
+    }
+
+    static bool load(const uint8_t *src, bool &value) {
+        value = src[0] != 0;
+        return src[0] <= 1;
+    }
+};
+
+// Fixed byte arrays (addresses, object IDs) are copied verbatim
+template <size_t N>
+struct codec<uint8_t[N]> {
+    static constexpr size_t size = N;
+
+    static void store(uint8_t *dst, const uint8_t (&value)[N]) {
+        memcpy(dst, value, N);
+    }
+
+    static bool load(const uint8_t *src, uint8_t (&value)[N]) {
+        memcpy(value, src, N);
+        return true;
+    }
+};
+
+// Byte array serialized as a vector<u8> of known length (e.g. ObjectDigest)
+template <size_t N>
+struct prefixed {
+    static_assert(N < 0x80, "length prefix must fit in one ULEB128 byte");
+
+    static constexpr size_t prefix_size = 1;
+    static constexpr size_t size = prefix_size + N;
+
+    static void store(uint8_t *dst, const uint8_t (&value)[N]) {
+        dst[0] = (uint8_t)N;
+        memcpy(dst + prefix_size, value, N);
+    }
+
+    static bool load(const uint8_t *src, uint8_t (&value)[N]) {
+        memcpy(value, src + prefix_size, N);
+        return src[0] == N;
+    }
+};
+
+// Any type with a schema is encoded as its fields in order
+template <typename T>
+struct codec {
+    typedef typename schema<T>::type layout;
+
+    static constexpr size_t size = layout::size;
+
+    static void store(uint8_t *dst, const T &value) {
+        layout::store(dst, value);
+    }
+
+    static bool load(const uint8_t *src, T &value) {
+        return layout::load(src, value);
+    }
+};
+
+// ============================================================================
+// Field lists
+// ============================================================================
+
+// Struct member encoded with Codec (defaults to the member type's codec)
+template <typename S, typename T, T S::*Member, typename Codec = codec<T> >
+struct field {
+    typedef Codec codec_type;
+
+    static constexpr size_t size = Codec::size;
+
+    static void store(uint8_t *dst, const S &s) {
+        Codec::store(dst, s.*Member);
+    }
+
+    static bool load(const uint8_t *src, S &s) {
+        return Codec::load(src, s.*Member);
+    }
+};
+
+// Literal byte with no backing member (enum tags, fixed lengths)
+template <uint8_t Value>
+struct constant {
+    static constexpr size_t size = 1;
+
+    template <typename S>
+    static void store(uint8_t *dst, const S &) {
+        dst[0] = Value;
+    }
+
+    template <typename S>
+    static bool load(const uint8_t *src, S &) {
+        return src[0] == Value;
+    }
+};
+
+template <typename... F>
+struct fields;
+
+template <>
+struct fields<> {
+    static constexpr size_t size = 0;
+
+    template <typename S>
+    static void store(uint8_t *, const S &) {}
+
+    template <typename S>
+    static bool load(const uint8_t *, S &) {
+        return true;
+    }
+};
+
+template <typename F, typename... Rest>
+struct fields<F, Rest...> {
+    static constexpr size_t size = F::size + fields<Rest...>::size;
+
+    template <typename S>
+    static void store(uint8_t *dst, const S &s) {
+        F::store(dst, s);
+        fields<Rest...>::store(dst + F::size, s);
+    }
+
+    template <typename S>
+    static bool load(const uint8_t *src, S &s) {
+        return F::load(src, s) && fields<Rest...>::load(src + F::size, s);
+    }
+};
+
+// Offset of field I within a field list
+template <size_t I, typename L>
+struct field_offset;
+
+template <typename F, typename... Rest>
+struct field_offset<0, fields<F, Rest...> > {
+    static constexpr size_t value = 0;
+};
+
+template <size_t I, typename F, typename... Rest>
+struct field_offset<I, fields<F, Rest...> > {
+    static constexpr size_t value = F::size + field_offset<I - 1, fields<Rest...> >::value;
+};
+
+#define BCS_FIELD(S, member) bcs::field<S, decltype(S::member), &S::member>
+#define BCS_FIELD_AS(S, member, codec) bcs::field<S, decltype(S::member), &S::member, codec>
+
+// ============================================================================
+// Entry points
+// ============================================================================
+
+/**
+ * Encoded size of T in bytes
+ */
+template <typename T>
+constexpr size_t encoded_size() {
+    return codec<T>::size;
+}
+
+/**
+ * Offset of field I in the encoding of T
+ */
+template <typename T, size_t I>
+constexpr size_t offset_of() {
+    return field_offset<I, typename schema<T>::type>::value;
+}
+
+/**
+ * Encode value into dst (encoded_size<T>() bytes, no bounds checks)
+ */
+template <typename T>
+inline void store(uint8_t *dst, const T &value) {
+    codec<T>::store(dst, value);
+}
+
+/**
+ * Decode value from src (encoded_size<T>() bytes)
+ * @return false if a constant, bool or length prefix does not match
+ */
+template <typename T>
+inline bool load(const uint8_t *src, T &value) {
+    return codec<T>::load(src, value);
+}
+
+/**
+ * Append value to writer as a single reserved block
+ * Counting writers only advance; errors latch like any other write.
+ */
+template <typename T>
+inline bcs_error_t write(bcs_writer_t *writer, const T &value) {
+    uint8_t *dst = bcs_writer_reserve(writer, encoded_size<T>());
+    if (dst) {
+        store(dst, value);
+    }
+    return bcs_writer_error(writer);
+}
+
+/**
+ * Read value from reader
+ * @return BCS_ERROR_BUFFER_UNDERFLOW if too few bytes remain,
+ *         BCS_ERROR_INVALID_INPUT if the bytes do not match the schema
+ */
+template <typename T>
+inline bcs_error_t read(bcs_reader_t *reader, T &value) {
+    bcs_view_t view;
+    bcs_error_t err = bcs_read_fixed_view(reader, encoded_size<T>(), &view);
+    if (err != BCS_OK) return err;
+
+    return load(view.data, value) ? BCS_OK : BCS_ERROR_INVALID_INPUT;
+}
+
+} // namespace bcs
+
+#endif // BCS_SCHEMA_H
@@ -0,0 +1,104 @@
+#include "bcs_sink.h"
+#include <errno.h>
+#include <unistd.h>
+
+// ============================================================================
+// Hex sink
+// ============================================================================
+
+void bcs_hex_sink_init(bcs_hex_sink_t *sink, bcs_flush_fn next, void *next_ctx) {
+    sink->next = next;
+    sink->next_ctx = next_ctx;
+}
+
+bcs_error_t bcs_hex_sink_write(void *ctx, const uint8_t *data, size_t length) {
+    bcs_hex_sink_t *sink = (bcs_hex_sink_t *)ctx;
+    char hex[BCS_HEX_SINK_BLOCK * 2 + 1];
+
+    while (length > 0) {
+        size_t n = length < BCS_HEX_SINK_BLOCK ? length : BCS_HEX_SINK_BLOCK;
+        bcs_bytes_to_hex(data, n, hex);
+
+        bcs_error_t err = sink->next(sink->next_ctx, (const uint8_t *)hex, n * 2);
+        if (err != BCS_OK) return err;
+
+        data += n;
+        length -= n;
+    }
+
+    return BCS_OK;
+}
+
+// ============================================================================
+// File descriptor sink
+// ============================================================================
+
+bcs_error_t bcs_fd_sink_write(void *ctx, const uint8_t *data, size_t length) {
+    int fd = *(const int *)ctx;
+
+    while (length > 0) {
+        ssize_t written = write(fd, data, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return BCS_ERROR_SINK;
+        }
+        if (written == 0) {
+            return BCS_ERROR_SINK;
+        }
+
+        data += written;
+        length -= (size_t)written;
+    }
+
+    return BCS_OK;
+}
+
+// ============================================================================
+// HTTP/1.1 chunked transfer-encoding sink
+// ============================================================================
+
+void bcs_chunked_sink_init(bcs_chunked_sink_t *sink, bcs_flush_fn next, void *next_ctx) {
+    sink->next = next;
+    sink->next_ctx = next_ctx;
+}
+
+bcs_error_t bcs_chunked_sink_write(void *ctx, const uint8_t *data, size_t length) {
+    static const char digits[] = "0123456789abcdef";
+    bcs_chunked_sink_t *sink = (bcs_chunked_sink_t *)ctx;
+
+    // A zero-length chunk would end the body early
+    if (length == 0) {
+        return BCS_OK;
+    }
+
+    // Chunk size line: hex length, CRLF
+    uint8_t header[2 * sizeof(size_t) + 2];
+    size_t pos = sizeof(header) - 2;
+    header[pos] = '\r';
+    header[pos + 1] = '\n';
+    for (size_t n = length; n > 0; n >>= 4) {
+        header[--pos] = (uint8_t)digits[n & 0x0F];
+    }
+
+    bcs_error_t err = sink->next(sink->next_ctx, header + pos, sizeof(header) - pos);
+    if (err != BCS_OK) return err;
+
+    err = sink->next(sink->next_ctx, data, length);
+    if (err != BCS_OK) return err;
+
+    return sink->next(sink->next_ctx, (const uint8_t *)"\r\n", 2);
+}
+
+bcs_error_t bcs_chunked_sink_end(bcs_chunked_sink_t *sink) {
+    return sink->next(sink->next_ctx, (const uint8_t *)"0\r\n\r\n", 5);
+}
+
+// ============================================================================
+// Writer sink
+// ============================================================================
+
+bcs_error_t bcs_writer_sink_write(void *ctx, const uint8_t *data, size_t length) {
+    return bcs_write_fixed_bytes((bcs_writer_t *)ctx, data, length);
+}
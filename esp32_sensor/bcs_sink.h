@@ -0,0 +1,102 @@
+/**
+ * BCS Sinks
+ * Stock flush callbacks for stream writers (bcs_writer_init_stream)
+ *
+ * Sinks chain: each takes the bytes of a chunk, transforms them with a
+ * small fixed buffer and passes them on to the next bcs_flush_fn. A
+ * transaction can go out as hex, straight to a file, or as an HTTP/1.1
+ * chunked request body without ever being resident in memory as a whole.
+ *
+ * Example (hex in a chunked HTTP body):
+ *   bcs_chunked_sink_t chunked;
+ *   bcs_hex_sink_t hex;
+ *   bcs_chunked_sink_init(&chunked, client_write, &client);
+ *   bcs_hex_sink_init(&hex, bcs_chunked_sink_write, &chunked);
+ *
+ *   bcs_writer_init_stream(&writer, chunk, sizeof(chunk), bcs_hex_sink_write, &hex);
+ *   sui_build_sensor_batch_transaction_into(&params, readings, n, &writer);
+ *   bcs_writer_flush(&writer);
+ *   bcs_chunked_sink_end(&chunked);
+ */
+
+#ifndef BCS_SINK_H
+#define BCS_SINK_H
+
+#include "bcs.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Bytes hex-encoded per downstream call (uses twice this on the stack)
+#define BCS_HEX_SINK_BLOCK 64
+
+// ============================================================================
+// Hex sink - lowercase hex, no prefix, no terminator
+// ============================================================================
+
+typedef struct {
+    bcs_flush_fn next;    // Receives the hex characters
+    void *next_ctx;
+} bcs_hex_sink_t;
+
+/**
+ * Set up a hex sink in front of next
+ */
+void bcs_hex_sink_init(bcs_hex_sink_t *sink, bcs_flush_fn next, void *next_ctx);
+
+/**
+ * Flush callback: hex-encode data and pass it on
+ * @param ctx Pointer to a bcs_hex_sink_t
+ */
+bcs_error_t bcs_hex_sink_write(void *ctx, const uint8_t *data, size_t length);
+
+// ============================================================================
+// File descriptor sink
+// ============================================================================
+
+/**
+ * Flush callback: write data to a file descriptor, retrying short writes
+ * @param ctx Pointer to an int holding an open file descriptor
+ * @return BCS_OK on success, BCS_ERROR_SINK if write() fails
+ */
+bcs_error_t bcs_fd_sink_write(void *ctx, const uint8_t *data, size_t length);
+
+// ============================================================================
+// HTTP/1.1 chunked transfer-encoding sink
+// ============================================================================
+
+typedef struct {
+    bcs_flush_fn next;    // Receives the framed body (e.g. a socket write)
+    void *next_ctx;
+} bcs_chunked_sink_t;
+
+/**
+ * Set up a chunked-body sink in front of next
+ * The request must carry "Transfer-Encoding: chunked" and no Content-Length.
+ */
+void bcs_chunked_sink_init(bcs_chunked_sink_t *sink, bcs_flush_fn next, void *next_ctx);
+
+/**
+ * Flush callback: emit data as one HTTP chunk (empty data emits nothing)
+ * @param ctx Pointer to a bcs_chunked_sink_t
+ */
+bcs_error_t bcs_chunked_sink_write(void *ctx, const uint8_t *data, size_t length);
+
+/**
+ * Emit the terminating zero-length chunk; the body is complete after this
+ */
+bcs_error_t bcs_chunked_sink_end(bcs_chunked_sink_t *sink);
+
+// ============================================================================
+// Writer sink - re-buffer through another writer
+// ============================================================================
+
+/**
+ * Flush callback: append data to a writer
+ * Chains a stream writer behind a sink that emits small pieces (such as
+ * the hex sink) so the next stage sees chunks of that writer's capacity.
+ * @param ctx Pointer to an initialized bcs_writer_t
+ * @return The writer's latched error
+ */
+bcs_error_t bcs_writer_sink_write(void *ctx, const uint8_t *data, size_t length);
+
+#endif // BCS_SINK_H
@@ -0,0 +1,526 @@
+/**
+ * BCS Benchmarks
+ * Writer and reader primitives, hex helpers, transaction build, patch and
+ * digest paths, and the Base58/Base64 codec
+ *
+ * Usage: bcs_bench [--quick] [filter] > results.json
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "base_codec.h"
+#include "scalar_reference.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Shared state
+// ============================================================================
+
+typedef struct {
+    transaction_builder_t params;
+    sensor_data_t readings[SUI_MAX_BATCH_READINGS];
+    uint8_t tx[4096];             // Output buffer for fixed writers
+    uint8_t template_bytes[512];  // Single-reading transaction
+    size_t template_length;
+    char template_hex[1025];
+    sui_pure_index_t pure_index;
+    sui_sensor_template_t tpl;
+    uint8_t tpl_buffer[512];
+    uint8_t scratch[8192];
+    char hex[8192 * 2 + 1];
+    uint32_t counter;
+} bench_state_t;
+
+static bench_state_t state;
+
+static void setup_state(void) {
+    fixture_params(&state.params);
+    for (uint32_t i = 0; i < SUI_MAX_BATCH_READINGS; i++) {
+        state.readings[i] = fixture_reading(i);
+    }
+
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.template_bytes, sizeof(state.template_bytes));
+    sui_build_sensor_transaction_into(&state.params, &writer);
+    state.template_length = writer.position;
+    bcs_bytes_to_hex(state.template_bytes, state.template_length, state.template_hex);
+    sui_index_pure_inputs(state.template_bytes, state.template_length, &state.pure_index);
+
+    sui_compile_sensor_template(&state.params, state.tpl_buffer, sizeof(state.tpl_buffer), &state.tpl);
+
+    for (size_t i = 0; i < sizeof(state.scratch); i++) {
+        state.scratch[i] = (uint8_t)(i * 131 + 7);
+    }
+}
+
+// ============================================================================
+// Primitives
+// ============================================================================
+
+static void write_u64(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.scratch, sizeof(state.scratch));
+    for (uint64_t i = 0; i < 64; i++) {
+        bcs_write_u64(&writer, i * 0x9E3779B97F4A7C15ull);
+    }
+    bench_consume(state.scratch);
+}
+
+static void write_uleb128(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.scratch, sizeof(state.scratch));
+    for (uint64_t i = 0; i < 64; i++) {
+        bcs_write_uleb128(&writer, (i & 3) == 3 ? i << 20 : i);  // Mostly 1 byte, like lengths and tags
+    }
+    bench_consume(state.scratch);
+}
+
+static void write_bytes(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.scratch, sizeof(state.scratch));
+    for (int i = 0; i < 16; i++) {
+        bcs_write_bytes(&writer, state.template_bytes, 32);
+    }
+    bench_consume(state.scratch);
+}
+
+static void write_growable(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init(&writer, 64, 0);
+    for (int i = 0; i < 16; i++) {
+        bcs_write_bytes(&writer, state.template_bytes, 32);
+    }
+    bench_consume(writer.buffer);
+    bcs_writer_free(&writer);
+}
+
+static void read_u64(void *ctx) {
+    (void)ctx;
+    bcs_reader_t reader;
+    bcs_reader_init(&reader, state.scratch, 64 * 8);
+    uint64_t sum = 0;
+    for (int i = 0; i < 64; i++) {
+        uint64_t value;
+        bcs_read_u64(&reader, &value);
+        sum += value;
+    }
+    bench_consume(&sum);
+}
+
+static void write_uleb128_scalar(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.scratch, sizeof(state.scratch));
+    for (uint64_t i = 0; i < 64; i++) {
+        ref_write_uleb128(&writer, (i & 3) == 3 ? i << 20 : i);
+    }
+    bench_consume(state.scratch);
+}
+
+// Same values as write_uleb128
+static const uint8_t *uleb128_input(size_t *length) {
+    static uint8_t encoded[1024];
+    static size_t encoded_length;
+    if (encoded_length == 0) {
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, encoded, sizeof(encoded));
+        for (uint64_t i = 0; i < 64; i++) {
+            bcs_write_uleb128(&writer, (i & 3) == 3 ? i << 20 : i);
+        }
+        encoded_length = writer.position;
+    }
+    *length = encoded_length;
+    return encoded;
+}
+
+static void read_uleb128(void *ctx) {
+    (void)ctx;
+    size_t length;
+    const uint8_t *encoded = uleb128_input(&length);
+
+    bcs_reader_t reader;
+    bcs_reader_init(&reader, encoded, length);
+    uint64_t sum = 0;
+    for (int i = 0; i < 64; i++) {
+        uint64_t value;
+        bcs_read_uleb128(&reader, &value);
+        sum += value;
+    }
+    bench_consume(&sum);
+}
+
+static void read_uleb128_scalar(void *ctx) {
+    (void)ctx;
+    size_t length;
+    const uint8_t *encoded = uleb128_input(&length);
+
+    bcs_reader_t reader;
+    bcs_reader_init(&reader, encoded, length);
+    uint64_t sum = 0;
+    for (int i = 0; i < 64; i++) {
+        uint64_t value;
+        ref_read_uleb128(&reader, &value);
+        sum += value;
+    }
+    bench_consume(&sum);
+}
+
+static void read_uleb128_run(void *ctx) {
+    (void)ctx;
+    size_t length;
+    const uint8_t *encoded = uleb128_input(&length);
+
+    bcs_reader_t reader;
+    bcs_reader_init(&reader, encoded, length);
+    uint64_t values[64];
+    bcs_read_uleb128_run(&reader, values, 64);
+    bench_consume(values);
+}
+
+// ============================================================================
+// Hex helpers
+// ============================================================================
+
+static void hex_encode_tx(void *ctx) {
+    (void)ctx;
+    bcs_bytes_to_hex(state.template_bytes, state.template_length, state.hex);
+    bench_consume(state.hex);
+}
+
+static void hex_decode_tx(void *ctx) {
+    (void)ctx;
+    size_t length;
+    bcs_hex_to_bytes(state.template_hex, state.scratch, sizeof(state.scratch), &length);
+    bench_consume(state.scratch);
+}
+
+// 300 B (a transaction) and 64 KiB, against the scalar code they replaced
+#define HEX_LARGE 65536
+
+static uint8_t hex_bytes[HEX_LARGE];
+static char hex_small[300 * 2 + 1];
+static char hex_large[HEX_LARGE * 2 + 1];
+static char hex_out[HEX_LARGE * 2 + 1];
+
+static void setup_hex(void) {
+    for (size_t i = 0; i < HEX_LARGE; i++) {
+        hex_bytes[i] = (uint8_t)(i * 167 + 13);
+    }
+    ref_bytes_to_hex(hex_bytes, 300, hex_small);
+    ref_bytes_to_hex(hex_bytes, HEX_LARGE, hex_large);
+}
+
+static void hex_encode(void *ctx) {
+    bcs_bytes_to_hex(hex_bytes, *(const size_t *)ctx, hex_out);
+    bench_consume(hex_out);
+}
+
+static void hex_encode_scalar(void *ctx) {
+    ref_bytes_to_hex(hex_bytes, *(const size_t *)ctx, hex_out);
+    bench_consume(hex_out);
+}
+
+static void hex_decode(void *ctx) {
+    size_t length;
+    bcs_hex_to_bytes((const char *)ctx, hex_bytes, sizeof(hex_bytes), &length);
+    bench_consume(hex_bytes);
+}
+
+static void hex_decode_scalar(void *ctx) {
+    size_t length;
+    ref_hex_to_bytes((const char *)ctx, hex_bytes, sizeof(hex_bytes), &length);
+    bench_consume(hex_bytes);
+}
+
+// ============================================================================
+// Transaction build
+// ============================================================================
+
+static void build_hex(void *ctx) {
+    (void)ctx;
+    char *hex;
+    size_t length;
+    if (sui_build_sensor_transaction(&state.params, &hex, &length) == BCS_OK) {
+        bench_consume(hex);
+        bcs_free(hex);
+    }
+}
+
+static void build_bytes(void *ctx) {
+    (void)ctx;
+    uint8_t *tx;
+    size_t length;
+    if (sui_build_sensor_transaction_bytes(&state.params, &tx, &length) == BCS_OK) {
+        bench_consume(tx);
+        bcs_free(tx);
+    }
+}
+
+static void build_fixed(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.tx, sizeof(state.tx));
+    sui_build_sensor_transaction_into(&state.params, &writer);
+    bench_consume(state.tx);
+}
+
+static void measure(void *ctx) {
+    (void)ctx;
+    size_t length;
+    sui_measure_sensor_transaction(&state.params, &length);
+    bench_consume(&length);
+}
+
+static void build_batch_16(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.tx, sizeof(state.tx));
+    sui_build_sensor_batch_transaction_into(&state.params, state.readings, 16, &writer);
+    bench_consume(state.tx);
+}
+
+// ============================================================================
+// Patch paths
+// ============================================================================
+
+static void modify_pure_values_hex(void *ctx) {
+    (void)ctx;
+    uint8_t values[4][8];
+    const uint8_t *pure_values[4];
+    size_t pure_lengths[4];
+    for (int i = 0; i < 4; i++) {
+        bcs_store_u64(values[i], state.counter++);
+        pure_values[i] = values[i];
+        pure_lengths[i] = 8;
+    }
+
+    char *hex;
+    size_t length;
+    if (sui_modify_transaction_with_pure_values(state.template_hex, pure_values, pure_lengths, 4, &hex,
+                                                &length) == BCS_OK) {
+        bench_consume(hex);
+        bcs_free(hex);
+    }
+}
+
+static void modify_pure_values_bytes(void *ctx) {
+    (void)ctx;
+    uint8_t values[4][8];
+    const uint8_t *pure_values[4];
+    size_t pure_lengths[4];
+    for (int i = 0; i < 4; i++) {
+        bcs_store_u64(values[i], state.counter++);
+        pure_values[i] = values[i];
+        pure_lengths[i] = 8;
+    }
+
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.tx, sizeof(state.tx));
+    sui_modify_transaction_with_pure_values_bytes(state.template_bytes, state.template_length, pure_values,
+                                                  pure_lengths, 4, &writer);
+    bench_consume(state.tx);
+}
+
+static void patch_pure_values(void *ctx) {
+    (void)ctx;
+    uint8_t values[4][8];
+    const uint8_t *pure_values[4];
+    size_t pure_lengths[4];
+    for (int i = 0; i < 4; i++) {
+        bcs_store_u64(values[i], state.counter++);
+        pure_values[i] = values[i];
+        pure_lengths[i] = 8;
+    }
+
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.template_bytes, sizeof(state.template_bytes));
+    writer.position = state.template_length;
+    sui_patch_pure_values(&writer, &state.pure_index, pure_values, pure_lengths, 4);
+    bench_consume(state.template_bytes);
+}
+
+static void template_patch(void *ctx) {
+    (void)ctx;
+    sensor_data_t reading = fixture_reading(state.counter++);
+    gas_object_t gas = fixture_gas((uint8_t)state.counter);
+    sui_sensor_template_set_sensor_data(&state.tpl, &reading);
+    sui_sensor_template_set_gas_object(&state.tpl, &gas);
+    bench_consume(state.tpl.writer.buffer);
+}
+
+// ============================================================================
+// Digests
+// ============================================================================
+
+static void digest_tx(void *ctx) {
+    (void)ctx;
+    uint8_t digest[SUI_DIGEST_LENGTH];
+    sui_transaction_digest(state.template_bytes, state.template_length, SUI_DIGEST_INTENT, digest);
+    bench_consume(digest);
+}
+
+static void build_then_digest(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.tx, sizeof(state.tx));
+    sui_build_sensor_transaction_into(&state.params, &writer);
+
+    uint8_t digest[SUI_DIGEST_LENGTH];
+    sui_transaction_digest(state.tx, writer.position, SUI_DIGEST_INTENT, digest);
+    bench_consume(digest);
+}
+
+static void build_hashing(void *ctx) {
+    (void)ctx;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, state.tx, sizeof(state.tx));
+
+    blake2b_state_t hash;
+    uint8_t digest[SUI_DIGEST_LENGTH];
+    sui_digest_begin(&writer, &hash, SUI_DIGEST_INTENT);
+    sui_build_sensor_transaction_into(&state.params, &writer);
+    bcs_writer_finish_hash(&writer, digest);
+    bench_consume(digest);
+}
+
+// ============================================================================
+// Codec
+// ============================================================================
+
+// A real transaction digest, and a signature-sized (97-byte) value
+static uint8_t codec_digest[SUI_DIGEST_LENGTH];
+static char codec_digest_b58[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+static size_t codec_digest_b58_length;
+static uint8_t codec_signature[97];
+static char codec_signature_b64[BASE64_ENCODED_SIZE(97) + 1];
+static size_t codec_signature_b64_length;
+
+static void setup_codec(void) {
+    sui_transaction_digest(state.template_bytes, state.template_length, SUI_DIGEST_TRANSACTION, codec_digest);
+    ref_base58_encode(codec_digest, sizeof(codec_digest), codec_digest_b58, sizeof(codec_digest_b58),
+                      &codec_digest_b58_length);
+    for (size_t i = 0; i < sizeof(codec_signature); i++) {
+        codec_signature[i] = (uint8_t)(i * 131 + 7);
+    }
+    ref_base64_encode(codec_signature, sizeof(codec_signature), codec_signature_b64, sizeof(codec_signature_b64),
+                      &codec_signature_b64_length);
+}
+
+static void base58_encode_digest(void *ctx) {
+    (void)ctx;
+    char text[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+    base58_encode(codec_digest, sizeof(codec_digest), text, sizeof(text), NULL);
+    bench_consume(text);
+}
+
+static void base58_encode_digest_scalar(void *ctx) {
+    (void)ctx;
+    char text[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+    ref_base58_encode(codec_digest, sizeof(codec_digest), text, sizeof(text), NULL);
+    bench_consume(text);
+}
+
+static void base58_decode_digest(void *ctx) {
+    (void)ctx;
+    uint8_t digest[SUI_DIGEST_LENGTH];
+    size_t decoded;
+    base58_decode(codec_digest_b58, codec_digest_b58_length, digest, sizeof(digest), &decoded);
+    bench_consume(digest);
+}
+
+static void base58_decode_digest_scalar(void *ctx) {
+    (void)ctx;
+    uint8_t digest[SUI_DIGEST_LENGTH];
+    ref_base58_to_bytes(codec_digest_b58, codec_digest_b58_length, digest, sizeof(digest));
+    bench_consume(digest);
+}
+
+static void base64_encode_signature(void *ctx) {
+    (void)ctx;
+    char text[BASE64_ENCODED_SIZE(97) + 1];
+    base64_encode(codec_signature, sizeof(codec_signature), text, sizeof(text), NULL);
+    bench_consume(text);
+}
+
+static void base64_encode_signature_scalar(void *ctx) {
+    (void)ctx;
+    char text[BASE64_ENCODED_SIZE(97) + 1];
+    ref_base64_encode(codec_signature, sizeof(codec_signature), text, sizeof(text), NULL);
+    bench_consume(text);
+}
+
+static void base64_decode_signature(void *ctx) {
+    (void)ctx;
+    uint8_t signature[97];
+    size_t decoded;
+    base64_decode(codec_signature_b64, codec_signature_b64_length, signature, sizeof(signature), &decoded);
+    bench_consume(signature);
+}
+
+static void base64_decode_signature_scalar(void *ctx) {
+    (void)ctx;
+    uint8_t signature[97];
+    size_t decoded;
+    ref_base64_decode(codec_signature_b64, codec_signature_b64_length, signature, sizeof(signature), &decoded);
+    bench_consume(signature);
+}
+
+int main(int argc, char **argv) {
+    setup_state();
+    setup_hex();
+    setup_codec();
+    bench_begin("bcs", argc, argv);
+
+    bench_run("write_u64_x64", write_u64, NULL);
+    bench_run("write_uleb128_x64", write_uleb128, NULL);
+    bench_run("write_uleb128_x64_scalar", write_uleb128_scalar, NULL);
+    bench_run("write_bytes32_x16", write_bytes, NULL);
+    bench_run("write_bytes32_x16_growable", write_growable, NULL);
+    bench_run("read_u64_x64", read_u64, NULL);
+    bench_run("read_uleb128_x64", read_uleb128, NULL);
+    bench_run("read_uleb128_x64_scalar", read_uleb128_scalar, NULL);
+    bench_run("read_uleb128_run_x64", read_uleb128_run, NULL);
+
+    bench_run("hex_encode_tx", hex_encode_tx, NULL);
+    bench_run("hex_decode_tx", hex_decode_tx, NULL);
+    static const size_t hex_small_length = 300, hex_large_length = HEX_LARGE;
+    bench_run("hex_encode_300", hex_encode, (void *)&hex_small_length);
+    bench_run("hex_encode_300_scalar", hex_encode_scalar, (void *)&hex_small_length);
+    bench_run("hex_decode_300", hex_decode, hex_small);
+    bench_run("hex_decode_300_scalar", hex_decode_scalar, hex_small);
+    bench_run("hex_encode_64k", hex_encode, (void *)&hex_large_length);
+    bench_run("hex_encode_64k_scalar", hex_encode_scalar, (void *)&hex_large_length);
+    bench_run("hex_decode_64k", hex_decode, hex_large);
+    bench_run("hex_decode_64k_scalar", hex_decode_scalar, hex_large);
+
+    bench_run("build_tx_hex", build_hex, NULL);
+    bench_run("build_tx_bytes", build_bytes, NULL);
+    bench_run("build_tx_fixed", build_fixed, NULL);
+    bench_run("measure_tx", measure, NULL);
+    bench_run("build_batch16_fixed", build_batch_16, NULL);
+
+    bench_run("modify_pure_values_hex", modify_pure_values_hex, NULL);
+    bench_run("modify_pure_values_bytes", modify_pure_values_bytes, NULL);
+    bench_run("patch_pure_values", patch_pure_values, NULL);
+    bench_run("template_patch", template_patch, NULL);
+
+    bench_run("digest_tx", digest_tx, NULL);
+    bench_run("build_then_digest", build_then_digest, NULL);
+    bench_run("build_hashing", build_hashing, NULL);
+
+    bench_run("base58_encode_digest", base58_encode_digest, NULL);
+    bench_run("base58_encode_digest_scalar", base58_encode_digest_scalar, NULL);
+    bench_run("base58_decode_digest", base58_decode_digest, NULL);
+    bench_run("base58_decode_digest_scalar", base58_decode_digest_scalar, NULL);
+    bench_run("base64_encode_signature", base64_encode_signature, NULL);
+    bench_run("base64_encode_signature_scalar", base64_encode_signature_scalar, NULL);
+    bench_run("base64_decode_signature", base64_decode_signature, NULL);
+    bench_run("base64_decode_signature_scalar", base64_decode_signature_scalar, NULL);
+
+    return bench_end();
+}
@@ -0,0 +1,330 @@
+/**
+ * Host tests for stream writers and bcs_sink
+ *
+ * The sensor and batch transactions are streamed through each sink with
+ * chunks of 1, 33 and 256 bytes and of the whole transaction, and must
+ * arrive byte-for-byte (or hex-for-hex) as a fixed writer builds them.
+ * A hash attached to the stream writer must match the digest of the whole
+ * transaction although every flush starts the chunk (and its hashed
+ * offset) over. A failing sink latches BCS_ERROR_SINK.
+ *
+ * The builders reserve blocks of up to a transaction footer, so chunks
+ * smaller than that are fed the finished transaction through
+ * bcs_write_fixed_bytes() instead, in pieces of every size around the
+ * chunk.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "bcs_sink.h"
+#include "blake2b.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TX_MAX 16384
+#define BATCH_READINGS 12
+
+// Smallest chunk the builders can stream into
+#define BUILDER_MIN_CHUNK 256
+
+// ============================================================================
+// Recording sink
+// ============================================================================
+
+// Checks the calls a stream writer makes, then passes them on; fails
+// once fail_after bytes went through (0: never)
+typedef struct {
+    bcs_flush_fn next;
+    void *next_ctx;
+    size_t capacity;            // Of the stream writer's chunk
+    size_t calls;
+    size_t bytes;
+    size_t bad_calls;           // Empty, or larger than a chunk
+    size_t fail_after;
+    size_t calls_after_failure;
+    bool failed;
+} recorder_t;
+
+static void recorder_init(recorder_t *recorder, size_t capacity, bcs_flush_fn next, void *next_ctx) {
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->capacity = capacity;
+    recorder->next = next;
+    recorder->next_ctx = next_ctx;
+}
+
+static bcs_error_t recorder_write(void *ctx, const uint8_t *data, size_t length) {
+    recorder_t *recorder = (recorder_t *)ctx;
+    if (recorder->failed) {
+        recorder->calls_after_failure++;
+        return BCS_ERROR_SINK;
+    }
+    recorder->calls++;
+    recorder->bad_calls += length == 0 || length > recorder->capacity;
+    if (recorder->fail_after && recorder->bytes + length > recorder->fail_after) {
+        recorder->failed = true;
+        return BCS_ERROR_SINK;
+    }
+    recorder->bytes += length;
+    return recorder->next ? recorder->next(recorder->next_ctx, data, length) : BCS_OK;
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+typedef struct {
+    const char *name;
+    const uint8_t *bytes;       // As a fixed writer builds it
+    size_t length;
+    const transaction_builder_t *params;
+    const sensor_data_t *readings;      // NULL: single reading
+    size_t count;
+} tx_t;
+
+// Stream tx into flush through a chunk of capacity bytes with a hash
+// attached; returns the writer's error and the digest of the streamed bytes
+static bcs_error_t stream(const tx_t *tx, size_t capacity, bcs_flush_fn flush, void *flush_ctx,
+                          uint8_t digest[SUI_DIGEST_LENGTH]) {
+    static uint8_t chunk[TX_MAX];
+    recorder_t recorder;
+    recorder_init(&recorder, capacity, flush, flush_ctx);
+
+    bcs_writer_t writer;
+    CHECK(bcs_writer_init_stream(&writer, chunk, capacity, recorder_write, &recorder) == BCS_OK);
+    blake2b_state_t hash;
+    CHECK(blake2b_init(&hash, SUI_DIGEST_LENGTH));
+    CHECK(bcs_writer_attach_hash(&writer, &hash) == BCS_OK);
+
+    if (capacity >= BUILDER_MIN_CHUNK) {
+        if (tx->readings) {
+            sui_build_sensor_batch_transaction_into(tx->params, tx->readings, tx->count, &writer);
+        } else {
+            sui_build_sensor_transaction_into(tx->params, &writer);
+        }
+    } else {
+        // Pieces of 1 .. 2 * capacity + 1 bytes, so they straddle chunks
+        // in every way, and one write of much more than a chunk
+        size_t offset = 0, piece = 1;
+        while (offset < tx->length / 2) {
+            size_t n = piece < tx->length / 2 - offset ? piece : tx->length / 2 - offset;
+            bcs_write_fixed_bytes(&writer, tx->bytes + offset, n);
+            offset += n;
+            piece = piece % (2 * capacity + 1) + 1;
+        }
+        bcs_write_fixed_bytes(&writer, tx->bytes + offset, tx->length - offset);
+    }
+
+    CHECK(bcs_writer_size(&writer) == tx->length);
+    CHECK(bcs_writer_get_bytes(&writer, NULL) == NULL);
+    bcs_error_t err = bcs_writer_flush(&writer);
+    CHECK(bcs_writer_finish_hash(&writer, digest) == err);
+
+    CHECK(recorder.bad_calls == 0);
+    CHECK(recorder.bytes == tx->length);
+    if (capacity == 1) {
+        CHECK(recorder.calls == tx->length);
+    }
+    if (capacity >= tx->length) {
+        CHECK(recorder.calls == 1);
+    }
+    return err;
+}
+
+// Undo the chunked framing of body; false if it is malformed
+static bool unchunk(const uint8_t *body, size_t length, uint8_t *out, size_t *out_length) {
+    size_t pos = 0;
+    *out_length = 0;
+    for (;;) {
+        size_t size = 0, digits = 0;
+        for (; pos < length && body[pos] != '\r'; pos++, digits++) {
+            const char *digit = strchr("0123456789abcdef", body[pos]);
+            if (!digit || !body[pos]) return false;
+            size = size * 16 + (size_t)(digit - "0123456789abcdef");
+        }
+        if (digits == 0 || pos + 2 > length || body[pos + 1] != '\n') return false;
+        pos += 2;
+        if (size == 0) {
+            return pos + 2 == length && body[pos] == '\r' && body[pos + 1] == '\n';
+        }
+        if (pos + size + 2 > length || body[pos + size] != '\r' || body[pos + size + 1] != '\n') return false;
+        memcpy(out + *out_length, body + pos, size);
+        *out_length += size;
+        pos += size + 2;
+    }
+}
+
+static void check_sinks(const tx_t *tx, size_t capacity) {
+    static uint8_t out[TX_MAX * 2 + 64], decoded[TX_MAX];
+    uint8_t expected_digest[SUI_DIGEST_LENGTH], digest[SUI_DIGEST_LENGTH];
+    blake2b_state_t hash;
+    blake2b_init(&hash, SUI_DIGEST_LENGTH);
+    blake2b_update(&hash, tx->bytes, tx->length);
+    blake2b_final(&hash, expected_digest);
+
+    // Writer sink
+    bcs_writer_t target;
+    bcs_writer_init_fixed(&target, out, sizeof(out));
+    CHECK(stream(tx, capacity, bcs_writer_sink_write, &target, digest) == BCS_OK);
+    CHECK(target.position == tx->length && memcmp(out, tx->bytes, tx->length) == 0);
+    CHECK(memcmp(digest, expected_digest, sizeof(digest)) == 0);
+
+    // Hex sink, compared with the FIXED bytes as hex
+    static char hex[TX_MAX * 2 + 1];
+    bcs_bytes_to_hex(tx->bytes, tx->length, hex);
+    bcs_hex_sink_t hex_sink;
+    bcs_writer_init_fixed(&target, out, sizeof(out));
+    bcs_hex_sink_init(&hex_sink, bcs_writer_sink_write, &target);
+    CHECK(stream(tx, capacity, bcs_hex_sink_write, &hex_sink, digest) == BCS_OK);
+    CHECK(target.position == tx->length * 2 && memcmp(out, hex, tx->length * 2) == 0);
+    CHECK(memcmp(digest, expected_digest, sizeof(digest)) == 0);
+
+    // File descriptor sink
+    FILE *file = tmpfile();
+    CHECK(file != NULL);
+    if (file) {
+        int fd = fileno(file);
+        CHECK(stream(tx, capacity, bcs_fd_sink_write, &fd, digest) == BCS_OK);
+        CHECK(memcmp(digest, expected_digest, sizeof(digest)) == 0);
+        rewind(file);
+        CHECK(fread(out, 1, sizeof(out), file) == tx->length && memcmp(out, tx->bytes, tx->length) == 0);
+        fclose(file);
+    }
+
+    // Chunked body
+    bcs_chunked_sink_t chunked;
+    bcs_writer_init_fixed(&target, out, sizeof(out));
+    bcs_chunked_sink_init(&chunked, bcs_writer_sink_write, &target);
+    CHECK(stream(tx, capacity, bcs_chunked_sink_write, &chunked, digest) == BCS_OK);
+    CHECK(bcs_chunked_sink_end(&chunked) == BCS_OK);
+    size_t decoded_length = 0;
+    CHECK(unchunk(out, target.position, decoded, &decoded_length));
+    CHECK(decoded_length == tx->length && memcmp(decoded, tx->bytes, tx->length) == 0);
+}
+
+static void test_streaming(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+    static sensor_data_t readings[BATCH_READINGS];
+    for (uint32_t i = 0; i < BATCH_READINGS; i++) {
+        readings[i] = fixture_reading(i * 13);
+    }
+
+    static uint8_t single_bytes[TX_MAX], batch_bytes[TX_MAX];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, single_bytes, sizeof(single_bytes));
+    CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+    tx_t single = { "single", single_bytes, writer.position, &params, NULL, 0 };
+    bcs_writer_init_fixed(&writer, batch_bytes, sizeof(batch_bytes));
+    CHECK(sui_build_sensor_batch_transaction_into(&params, readings, BATCH_READINGS, &writer) == BCS_OK);
+    tx_t batch = { "batch", batch_bytes, writer.position, &params, readings, BATCH_READINGS };
+    CHECK(single.length > BUILDER_MIN_CHUNK / 2 && batch.length > BUILDER_MIN_CHUNK * 2);
+
+    const tx_t *txs[] = { &single, &batch };
+    for (size_t t = 0; t < 2; t++) {
+        const size_t capacities[] = { 1, 33, BUILDER_MIN_CHUNK, txs[t]->length };
+        for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); c++) {
+            check_sinks(txs[t], capacities[c]);
+        }
+    }
+
+    // The sui digest, hashed while streaming, matches the fixed build's
+    uint8_t chunk[BUILDER_MIN_CHUNK], fused[SUI_DIGEST_LENGTH], expected[SUI_DIGEST_LENGTH];
+    bcs_writer_t target;
+    static uint8_t out[TX_MAX];
+    bcs_writer_init_fixed(&target, out, sizeof(out));
+    bcs_writer_init_stream(&writer, chunk, sizeof(chunk), bcs_writer_sink_write, &target);
+    blake2b_state_t hash;
+    CHECK(sui_digest_begin(&writer, &hash, SUI_DIGEST_INTENT) == BCS_OK);
+    CHECK(sui_build_sensor_batch_transaction_into(&params, readings, BATCH_READINGS, &writer) == BCS_OK);
+    CHECK(bcs_writer_flush(&writer) == BCS_OK);
+    CHECK(bcs_writer_finish_hash(&writer, fused) == BCS_OK);
+    CHECK(sui_transaction_digest(batch.bytes, batch.length, SUI_DIGEST_INTENT, expected) == BCS_OK);
+    CHECK(memcmp(fused, expected, sizeof(fused)) == 0);
+
+    // A chunk below the largest reserved block makes the builder fail
+    // cleanly, with only whole writes handed on
+    bcs_writer_init_fixed(&target, out, sizeof(out));
+    bcs_writer_init_stream(&writer, chunk, 33, bcs_writer_sink_write, &target);
+    CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_ERROR_BUFFER_TOO_SMALL);
+    CHECK(bcs_writer_error(&writer) == BCS_ERROR_BUFFER_TOO_SMALL);
+    CHECK(bcs_writer_flush(&writer) == BCS_ERROR_BUFFER_TOO_SMALL);
+    CHECK(memcmp(out, single.bytes, target.position) == 0);
+}
+
+// ============================================================================
+// Errors
+// ============================================================================
+
+static void test_sink_error(void) {
+    static uint8_t tx_bytes[TX_MAX];
+    transaction_builder_t params;
+    fixture_params(&params);
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, tx_bytes, sizeof(tx_bytes));
+    CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+    size_t tx_length = writer.position;
+
+    // The sink fails part way: the error latches, the sink is not called
+    // again, and the hash refuses to finish
+    uint8_t chunk[BUILDER_MIN_CHUNK], digest[SUI_DIGEST_LENGTH];
+    recorder_t recorder;
+    recorder_init(&recorder, 64, NULL, NULL);
+    recorder.fail_after = 100;
+    bcs_writer_init_stream(&writer, chunk, 64, recorder_write, &recorder);
+    blake2b_state_t hash;
+    blake2b_init(&hash, SUI_DIGEST_LENGTH);
+    bcs_writer_attach_hash(&writer, &hash);
+    CHECK(bcs_write_fixed_bytes(&writer, tx_bytes, tx_length) == BCS_ERROR_SINK);
+    CHECK(bcs_writer_error(&writer) == BCS_ERROR_SINK);
+    CHECK(bcs_write_u8(&writer, 1) == BCS_ERROR_SINK);
+    CHECK(bcs_writer_reserve(&writer, 4) == NULL);
+    CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_ERROR_SINK);
+    CHECK(bcs_writer_flush(&writer) == BCS_ERROR_SINK);
+    CHECK(bcs_writer_finish_hash(&writer, digest) == BCS_ERROR_SINK);
+    CHECK(recorder.failed && recorder.bytes == 64 && recorder.calls_after_failure == 0);
+
+    // The final flush fails too
+    recorder_init(&recorder, sizeof(chunk), NULL, NULL);
+    recorder.fail_after = 1;
+    bcs_writer_init_stream(&writer, chunk, sizeof(chunk), recorder_write, &recorder);
+    CHECK(bcs_write_u64(&writer, 7) == BCS_OK);
+    CHECK(bcs_writer_flush(&writer) == BCS_ERROR_SINK);
+    CHECK(bcs_write_u8(&writer, 1) == BCS_ERROR_SINK);
+
+    // Reset clears the latch
+    bcs_writer_reset(&writer);
+    recorder_init(&recorder, sizeof(chunk), NULL, NULL);
+    CHECK(bcs_write_u64(&writer, 7) == BCS_OK && bcs_writer_flush(&writer) == BCS_OK);
+    CHECK(recorder.bytes == 8);
+
+    // A downstream writer that fills up, and a bad descriptor
+    uint8_t small[40];
+    bcs_writer_t target;
+    bcs_writer_init_fixed(&target, small, sizeof(small));
+    bcs_writer_init_stream(&writer, chunk, 16, bcs_writer_sink_write, &target);
+    CHECK(bcs_write_fixed_bytes(&writer, tx_bytes, 100) == BCS_ERROR_SINK);
+    CHECK(target.position == 32 && memcmp(small, tx_bytes, 32) == 0);
+
+    int bad_fd = -1;
+    bcs_writer_init_stream(&writer, chunk, sizeof(chunk), bcs_fd_sink_write, &bad_fd);
+    CHECK(bcs_write_u64(&writer, 7) == BCS_OK);
+    CHECK(bcs_writer_flush(&writer) == BCS_ERROR_SINK);
+
+    // Stream writers take no splices and no block larger than a chunk
+    bcs_writer_init_stream(&writer, chunk, 16, bcs_writer_sink_write, &target);
+    CHECK(bcs_writer_reserve(&writer, 17) == NULL);
+    CHECK(bcs_writer_error(&writer) == BCS_ERROR_BUFFER_TOO_SMALL);
+    bcs_writer_init_stream(&writer, chunk, 16, bcs_writer_sink_write, &target);
+    CHECK(bcs_write_u8(&writer, 1) == BCS_OK);
+    CHECK(bcs_writer_splice(&writer, 0, 1, tx_bytes, 1) != BCS_OK);
+    CHECK(bcs_writer_init_stream(&writer, chunk, 16, NULL, NULL) == BCS_ERROR_INVALID_INPUT);
+}
+
+int main() {
+    test_streaming();
+    test_sink_error();
+    return test_report("bcs_sink_test");
+}
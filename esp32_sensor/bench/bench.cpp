@@ -0,0 +1,183 @@
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Every block is preceded by its requested size so free can account for it
+#define HEADER_SIZE 16
+
+int test_failures = 0;
+
+// ============================================================================
+// Counting allocator
+// ============================================================================
+
+static void *counting_alloc(void *ctx, size_t size) {
+    counting_allocator_t *counter = (counting_allocator_t *)ctx;
+    uint8_t *block = (uint8_t *)malloc(HEADER_SIZE + size);
+    if (!block) {
+        return NULL;
+    }
+
+    memcpy(block, &size, sizeof(size));
+    counter->allocs++;
+    counter->bytes += size;
+    counter->live += size;
+    if (counter->live > counter->peak) {
+        counter->peak = counter->live;
+    }
+    return block + HEADER_SIZE;
+}
+
+static void counting_free(void *ctx, void *ptr) {
+    counting_allocator_t *counter = (counting_allocator_t *)ctx;
+    if (!ptr) {
+        return;
+    }
+
+    uint8_t *block = (uint8_t *)ptr - HEADER_SIZE;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    counter->frees++;
+    counter->live -= size;
+    free(block);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t size) {
+    counting_allocator_t *counter = (counting_allocator_t *)ctx;
+    if (!ptr) {
+        return counting_alloc(ctx, size);
+    }
+
+    uint8_t *block = (uint8_t *)ptr - HEADER_SIZE;
+    size_t old_size;
+    memcpy(&old_size, block, sizeof(old_size));
+
+    block = (uint8_t *)realloc(block, HEADER_SIZE + size);
+    if (!block) {
+        return NULL;
+    }
+
+    memcpy(block, &size, sizeof(size));
+    counter->allocs++;
+    counter->bytes += size;
+    counter->live = counter->live - old_size + size;
+    if (counter->live > counter->peak) {
+        counter->peak = counter->live;
+    }
+    return block + HEADER_SIZE;
+}
+
+void counting_allocator_init(counting_allocator_t *counter) {
+    memset(counter, 0, sizeof(*counter));
+    counter->allocator.alloc = counting_alloc;
+    counter->allocator.realloc = counting_realloc;
+    counter->allocator.free = counting_free;
+    counter->allocator.ctx = counter;
+}
+
+void counting_allocator_reset(counting_allocator_t *counter) {
+    counter->allocs = 0;
+    counter->frees = 0;
+    counter->bytes = 0;
+    counter->peak = counter->live;
+}
+
+// ============================================================================
+// Timing
+// ============================================================================
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void bench_consume(const void *ptr) {
+    // An empty asm the optimizer has to assume reads *ptr
+    asm volatile("" : : "g"(ptr) : "memory");
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+static counting_allocator_t counter;
+static const char *filter;
+static uint64_t min_time_ns;
+static size_t results;
+
+void bench_begin(const char *suite, int argc, char **argv) {
+    filter = NULL;
+    min_time_ns = 200000000ull;
+    results = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            min_time_ns = 2000000ull;
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    counting_allocator_init(&counter);
+    bcs_set_default_allocator(&counter.allocator);
+    printf("{\"suite\": \"%s\", \"results\": [", suite);
+}
+
+void bench_run(const char *name, void (*fn)(void *ctx), void *ctx) {
+    if (filter && !strstr(name, filter)) {
+        return;
+    }
+
+    fn(ctx);
+
+    // Double the batch until one batch takes min_time_ns
+    uint64_t iterations = 1;
+    uint64_t elapsed;
+    size_t live_before;
+    for (;;) {
+        live_before = counter.live;
+        counting_allocator_reset(&counter);
+
+        uint64_t start = bench_now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            fn(ctx);
+        }
+        elapsed = bench_now_ns() - start;
+
+        if (elapsed >= min_time_ns || iterations >= (1ull << 32)) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    printf("%s\n  {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f, "
+           "\"bytes_per_op\": %.1f, \"peak_heap_bytes\": %zu}",
+           results++ ? "," : "", name, (unsigned long long)iterations, (double)elapsed / iterations,
+           (double)counter.allocs / iterations, (double)counter.bytes / iterations, counter.peak - live_before);
+    fflush(stdout);
+}
+
+int bench_end(void) {
+    printf("\n]}\n");
+    bcs_set_default_allocator(NULL);
+    return counter.live == 0 ? 0 : 1;
+}
+
+counting_allocator_t *bench_allocator(void) {
+    return &counter;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+int test_report(const char *name) {
+    if (test_failures) {
+        fprintf(stderr, "%s: %d check(s) failed\n", name, test_failures);
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * Host Harness
+ * Counting allocator, timing and JSON output for the Linux benchmarks and
+ * tests under esp32_sensor/bench
+ *
+ * Nothing here is built for the ESP32. The library sources are compiled
+ * unchanged; every buffer they allocate goes through a bcs_allocator_t,
+ * so installing counting_allocator_t as the default is enough to see
+ * allocations per call, bytes per call and the peak heap.
+ *
+ * Benchmarks print one JSON document on stdout:
+ *   {"suite": "bcs", "results": [
+ *     {"name": "...", "iterations": N, "ns_per_op": ..., "allocs_per_op": ...,
+ *      "bytes_per_op": ..., "peak_heap_bytes": ...}, ...]}
+ *
+ * Example:
+ *   static void build(void *ctx) { ... }
+ *
+ *   int main(int argc, char **argv) {
+ *       bench_begin("bcs", argc, argv);
+ *       bench_run("build", build, &params);
+ *       return bench_end();
+ *   }
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "bcs.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// ============================================================================
+// Counting allocator
+// ============================================================================
+
+/**
+ * Heap allocator that counts every call made through it
+ */
+typedef struct {
+    bcs_allocator_t allocator;   // Pass &counter.allocator to the library
+    size_t allocs;               // alloc and realloc calls
+    size_t frees;                // free calls with a non-NULL pointer
+    size_t bytes;                // Bytes requested by alloc and realloc
+    size_t live;                 // Bytes currently allocated
+    size_t peak;                 // Highest live value since the last reset
+} counting_allocator_t;
+
+void counting_allocator_init(counting_allocator_t *counter);
+
+/**
+ * Zero the call and byte counts; live bytes are kept, peak restarts from them
+ */
+void counting_allocator_reset(counting_allocator_t *counter);
+
+// ============================================================================
+// Timing
+// ============================================================================
+
+/**
+ * Monotonic clock in nanoseconds
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * Keep the compiler from discarding a result
+ */
+void bench_consume(const void *ptr);
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+/**
+ * Parse options and open the JSON document
+ *   --quick    run each benchmark briefly (smoke test under ctest)
+ *   <filter>   only run benchmarks whose name contains filter
+ * Installs the harness allocator as the bcs default.
+ */
+void bench_begin(const char *suite, int argc, char **argv);
+
+/**
+ * Time fn(ctx) and append its result
+ * fn runs once untimed first, so one-off setup does not count.
+ */
+void bench_run(const char *name, void (*fn)(void *ctx), void *ctx);
+
+/**
+ * Close the JSON document and restore the default allocator
+ * @return Exit status for main()
+ */
+int bench_end(void);
+
+/**
+ * Counter installed as the default allocator between bench_begin() and bench_end()
+ */
+counting_allocator_t *bench_allocator(void);
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+extern int test_failures;
+
+// Report a failed expectation and keep going
+#define CHECK(expr)                                                            \
+    do {                                                                       \
+        if (!(expr)) {                                                         \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #expr); \
+            test_failures++;                                                   \
+        }                                                                      \
+    } while (0)
+
+/**
+ * Print a summary line
+ * @return Exit status for main(): 0 if every CHECK passed
+ */
+int test_report(const char *name);
+
+#endif // BENCH_H
@@ -0,0 +1,416 @@
+/**
+ * Host tests for the byte codecs
+ *
+ * Each optimized codec is checked against the scalar code it replaced
+ * (scalar_reference.h) on valid, boundary and malformed input.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "scalar_reference.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HEX_MAX_BYTES 65536
+
+static uint8_t bytes[HEX_MAX_BYTES];
+static uint8_t decoded[HEX_MAX_BYTES];
+static uint8_t ref_decoded[HEX_MAX_BYTES];
+static char hex[HEX_MAX_BYTES * 2 + 3];
+static char ref_hex[HEX_MAX_BYTES * 2 + 3];
+
+// xorshift32, so failures reproduce
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// ============================================================================
+// Hex
+// ============================================================================
+
+// Both decoders agree on result, length and bytes
+static void check_hex_decode(const char *input, size_t max_bytes) {
+    size_t length = 0, ref_length = 0;
+    bcs_error_t err = bcs_hex_to_bytes(input, decoded, max_bytes, &length);
+    bcs_error_t ref_err = ref_hex_to_bytes(input, ref_decoded, max_bytes, &ref_length);
+
+    CHECK(err == ref_err);
+    if (err == BCS_OK && ref_err == BCS_OK) {
+        CHECK(length == ref_length);
+        CHECK(memcmp(decoded, ref_decoded, length) == 0);
+    }
+}
+
+static void test_hex_encode(void) {
+    for (size_t i = 0; i < HEX_MAX_BYTES; i++) {
+        bytes[i] = (uint8_t)rng();
+    }
+
+    // Every length up to a few SWAR blocks past a transaction, then 64 KiB
+    for (size_t length = 0; length <= 300; length++) {
+        bcs_bytes_to_hex(bytes, length, hex);
+        ref_bytes_to_hex(bytes, length, ref_hex);
+        CHECK(strcmp(hex, ref_hex) == 0);
+    }
+    bcs_bytes_to_hex(bytes, HEX_MAX_BYTES, hex);
+    ref_bytes_to_hex(bytes, HEX_MAX_BYTES, ref_hex);
+    CHECK(strcmp(hex, ref_hex) == 0);
+
+    // All byte values
+    for (size_t i = 0; i < 256; i++) {
+        bytes[i] = (uint8_t)i;
+    }
+    bcs_bytes_to_hex(bytes, 256, hex);
+    ref_bytes_to_hex(bytes, 256, ref_hex);
+    CHECK(strcmp(hex, ref_hex) == 0);
+}
+
+static void test_hex_decode(void) {
+    static const char digits[] = "0123456789abcdefABCDEF";
+
+    // Mixed case, with and without the 0x prefix
+    for (size_t length = 0; length <= 300; length++) {
+        for (size_t i = 0; i < length * 2; i++) {
+            hex[i] = digits[rng() % (sizeof(digits) - 1)];
+        }
+        hex[length * 2] = '\0';
+        check_hex_decode(hex, HEX_MAX_BYTES);
+
+        memmove(hex + 2, hex, length * 2 + 1);
+        hex[0] = '0';
+        hex[1] = (length & 1) ? 'X' : 'x';
+        check_hex_decode(hex, HEX_MAX_BYTES);
+    }
+
+    for (size_t i = 0; i < HEX_MAX_BYTES * 2; i++) {
+        hex[i] = digits[rng() % (sizeof(digits) - 1)];
+    }
+    hex[HEX_MAX_BYTES * 2] = '\0';
+    check_hex_decode(hex, HEX_MAX_BYTES);
+    check_hex_decode(hex, HEX_MAX_BYTES - 1);  // Buffer too small
+
+    // Odd length
+    hex[301] = '\0';
+    check_hex_decode(hex, HEX_MAX_BYTES);
+
+    // Every character value at every position of a 40-character input,
+    // which covers both SWAR lanes and the table tail
+    for (size_t position = 0; position < 40; position++) {
+        for (int c = 1; c < 256; c++) {
+            memset(hex, 'a', 40);
+            hex[40] = '\0';
+            hex[position] = (char)c;
+            check_hex_decode(hex, HEX_MAX_BYTES);
+        }
+    }
+}
+
+// ============================================================================
+// ULEB128
+// ============================================================================
+
+// Powers of two and their neighbours cover every encoded length and both
+// sides of each 7-bit boundary
+static size_t uleb_values(uint64_t *values) {
+    size_t n = 0;
+    values[n++] = 0;
+    values[n++] = UINT64_MAX;
+    for (int bit = 0; bit < 64; bit++) {
+        values[n++] = (1ull << bit) - 1;
+        values[n++] = 1ull << bit;
+        values[n++] = (1ull << bit) + 1;
+    }
+    for (int i = 0; i < 256; i++) {
+        uint64_t value = ((uint64_t)rng() << 32) | rng();
+        values[n++] = value >> (rng() % 64);
+    }
+    return n;
+}
+
+// Decode one value from input with both readers and compare everything
+static void check_uleb_decode(const uint8_t *input, size_t length) {
+    bcs_reader_t reader, ref_reader;
+    bcs_reader_init(&reader, input, length);
+    bcs_reader_init(&ref_reader, input, length);
+
+    uint64_t value = 0, ref_value = 0;
+    bcs_error_t err = bcs_read_uleb128(&reader, &value);
+    bcs_error_t ref_err = ref_read_uleb128(&ref_reader, &ref_value);
+    CHECK(err == ref_err);
+    if (err == BCS_OK && ref_err == BCS_OK) {
+        CHECK(value == ref_value);
+        CHECK(reader.position == ref_reader.position);
+    }
+}
+
+static void test_uleb_encode(void) {
+    static uint64_t values[512];
+    size_t n = uleb_values(values);
+
+    for (size_t i = 0; i < n; i++) {
+        uint8_t out[BCS_ULEB128_MAX_SIZE], ref_out[BCS_ULEB128_MAX_SIZE];
+        bcs_writer_t writer, ref_writer;
+        bcs_writer_init_fixed(&writer, out, sizeof(out));
+        bcs_writer_init_fixed(&ref_writer, ref_out, sizeof(ref_out));
+
+        CHECK(bcs_write_uleb128(&writer, values[i]) == BCS_OK);
+        CHECK(ref_write_uleb128(&ref_writer, values[i]) == BCS_OK);
+        CHECK(writer.position == ref_writer.position);
+        CHECK(memcmp(out, ref_out, writer.position) == 0);
+        CHECK(bcs_uleb128_size(values[i]) == ref_writer.position);
+
+        // One byte short fails for both (fixed writers need at least one byte)
+        if (ref_writer.position > 1) {
+            bcs_writer_init_fixed(&writer, out, ref_writer.position - 1);
+            bcs_writer_init_fixed(&ref_writer, ref_out, writer.capacity);
+            CHECK(bcs_write_uleb128(&writer, values[i]) == BCS_ERROR_BUFFER_TOO_SMALL);
+            CHECK(ref_write_uleb128(&ref_writer, values[i]) == BCS_ERROR_BUFFER_TOO_SMALL);
+        }
+
+        // Counting writers only advance
+        bcs_writer_init_counting(&writer);
+        CHECK(bcs_write_uleb128(&writer, values[i]) == BCS_OK);
+        CHECK(writer.position == bcs_uleb128_size(values[i]));
+    }
+}
+
+static void test_uleb_decode(void) {
+    static uint64_t values[512];
+    size_t n = uleb_values(values);
+
+    // Each value with 0..12 bytes after it, so the checked path near the end
+    // of the buffer and the unchecked bulk path both run
+    for (size_t i = 0; i < n; i++) {
+        uint8_t input[BCS_ULEB128_MAX_SIZE + 12];
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, input, sizeof(input));
+        ref_write_uleb128(&writer, values[i]);
+        size_t length = writer.position;
+        memset(input + length, 0xA5, sizeof(input) - length);
+
+        for (size_t trailing = 0; trailing <= 12; trailing++) {
+            check_uleb_decode(input, length + trailing);
+        }
+        // Truncated encodings
+        for (size_t cut = 0; cut < length; cut++) {
+            check_uleb_decode(input, cut);
+        }
+    }
+
+    // Malformed: continuation bits up to and past ten bytes, non-canonical
+    // zero padding, and high bits in the tenth byte
+    for (size_t run = 1; run <= 12; run++) {
+        uint8_t input[24];
+        memset(input, 0x80, sizeof(input));
+        input[run] = 0x00;
+        for (size_t length = run; length <= sizeof(input); length++) {
+            check_uleb_decode(input, length);
+        }
+        input[run] = 0x7F;
+        check_uleb_decode(input, sizeof(input));
+    }
+
+    // Random byte strings
+    for (int i = 0; i < 4096; i++) {
+        uint8_t input[16];
+        for (size_t j = 0; j < sizeof(input); j++) {
+            input[j] = (uint8_t)(rng() | ((i & 1) ? 0x80 : 0));
+        }
+        check_uleb_decode(input, rng() % (sizeof(input) + 1));
+    }
+}
+
+// The bulk readers return what a loop of single reads would
+static void test_uleb_run(void) {
+    static uint64_t values[512];
+    size_t n = uleb_values(values);
+
+    static uint8_t input[512 * BCS_ULEB128_MAX_SIZE + BCS_ULEB128_MAX_SIZE];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, input, sizeof(input));
+    ref_write_uleb128(&writer, n);
+    for (size_t i = 0; i < n; i++) {
+        ref_write_uleb128(&writer, values[i]);
+    }
+
+    static uint64_t decoded_values[512];
+    size_t count = 0;
+    bcs_reader_t reader;
+    bcs_reader_init(&reader, input, writer.position);
+    CHECK(bcs_read_uleb128_vector(&reader, decoded_values, 512, &count) == BCS_OK);
+    CHECK(count == n);
+    CHECK(memcmp(decoded_values, values, n * sizeof(values[0])) == 0);
+    CHECK(reader.position == writer.position);
+
+    bcs_reader_init(&reader, input, writer.position);
+    CHECK(bcs_read_uleb128_vector(&reader, decoded_values, n - 1, &count) == BCS_ERROR_BUFFER_TOO_SMALL);
+
+    // Ending one byte early fails in the tail, like the single reader
+    bcs_reader_init(&reader, input, writer.position - 1);
+    CHECK(bcs_read_uleb128_vector(&reader, decoded_values, 512, &count) == BCS_ERROR_BUFFER_UNDERFLOW);
+}
+
+// ============================================================================
+// Base58 / Base64
+// ============================================================================
+
+#define NUM_DIGESTS (256 + 33 + 1)
+
+// Transaction digests of the fixture transaction over 256 readings, then
+// the first one with 0..32 leading zero bytes (leading '1's in Base58),
+// then all 0xFF
+static size_t real_digests(uint8_t (*digests)[SUI_DIGEST_LENGTH]) {
+    size_t n = 0;
+    transaction_builder_t params;
+    fixture_params(&params);
+    for (uint32_t i = 0; i < 256; i++) {
+        params.sensor_data = fixture_reading(i);
+        uint8_t *tx = NULL;
+        size_t tx_length = 0;
+        CHECK(sui_build_sensor_transaction_bytes(&params, &tx, &tx_length) == BCS_OK);
+        CHECK(sui_transaction_digest(tx, tx_length, SUI_DIGEST_TRANSACTION, digests[n++]) == BCS_OK);
+        bcs_free(tx);
+    }
+    for (size_t zeros = 0; zeros <= SUI_DIGEST_LENGTH; zeros++) {
+        memcpy(digests[n], digests[0], SUI_DIGEST_LENGTH);
+        memset(digests[n++], 0, zeros);
+    }
+    memset(digests[n++], 0xFF, SUI_DIGEST_LENGTH);
+    return n;
+}
+
+static void test_base58(void) {
+    static uint8_t digests[NUM_DIGESTS][SUI_DIGEST_LENGTH];
+    size_t n = real_digests(digests);
+
+    for (size_t i = 0; i < n; i++) {
+        char text[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 3];
+        char ref_text[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+        size_t length = 0, ref_length = 0;
+        CHECK(base58_encode(digests[i], SUI_DIGEST_LENGTH, text, sizeof(text), &length) == BCS_OK);
+        CHECK(ref_base58_encode(digests[i], SUI_DIGEST_LENGTH, ref_text, sizeof(ref_text), &ref_length) == BCS_OK);
+        CHECK(length == ref_length);
+        CHECK(strcmp(text, ref_text) == 0);
+
+        // One character short fails for both
+        CHECK(base58_encode(digests[i], SUI_DIGEST_LENGTH, text, length, NULL) == BCS_ERROR_BUFFER_TOO_SMALL);
+        CHECK(ref_base58_encode(digests[i], SUI_DIGEST_LENGTH, ref_text, ref_length, NULL) ==
+              BCS_ERROR_BUFFER_TOO_SMALL);
+
+        // Decoding gives the 32 bytes the sketch's old decoder put in the
+        // gas object, and exactly 32 of them
+        uint8_t digest[SUI_DIGEST_LENGTH], ref_digest[SUI_DIGEST_LENGTH];
+        size_t decoded_length = 0;
+        CHECK(base58_decode(text, length, digest, sizeof(digest), &decoded_length) == BCS_OK);
+        CHECK(decoded_length == SUI_DIGEST_LENGTH);
+        CHECK(ref_base58_to_bytes(text, length, ref_digest, sizeof(ref_digest)) == 0);
+        CHECK(memcmp(digest, ref_digest, SUI_DIGEST_LENGTH) == 0);
+        CHECK(memcmp(digest, digests[i], SUI_DIGEST_LENGTH) == 0);
+
+        // Two more digits make a value wider than the output; both fail
+        if (digests[i][0] != 0) {
+            memcpy(text + length, "zz", 3);
+            CHECK(base58_decode(text, length + 2, digest, sizeof(digest), &decoded_length) ==
+                  BCS_ERROR_BUFFER_TOO_SMALL);
+            CHECK(ref_base58_to_bytes(text, length + 2, ref_digest, sizeof(ref_digest)) == -1);
+            text[length] = '\0';
+        }
+
+        // Characters outside the alphabet at every position
+        static const char bad[] = {'0', 'O', 'I', 'l', '+', '/', '=', ' ', '\0', (char)0x80};
+        for (size_t position = 0; position < length; position++) {
+            char corrupt[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+            memcpy(corrupt, text, length);
+            corrupt[position] = bad[(i + position) % sizeof(bad)];
+            CHECK(base58_decode(corrupt, length, digest, sizeof(digest), &decoded_length) == BCS_ERROR_INVALID_INPUT);
+            CHECK(ref_base58_to_bytes(corrupt, length, ref_digest, sizeof(ref_digest)) == -1);
+        }
+    }
+}
+
+// Encode with both, decode with both, compare everything
+static void check_base64(const uint8_t *input, size_t length) {
+    static char text[BASE64_ENCODED_SIZE(HEX_MAX_BYTES) + 1];
+    static char ref_text[BASE64_ENCODED_SIZE(HEX_MAX_BYTES) + 1];
+    size_t chars = 0, ref_chars = 0;
+    CHECK(base64_encode(input, length, text, sizeof(text), &chars) == BCS_OK);
+    CHECK(ref_base64_encode(input, length, ref_text, sizeof(ref_text), &ref_chars) == BCS_OK);
+    CHECK(chars == ref_chars);
+    CHECK(strcmp(text, ref_text) == 0);
+
+    // Padded and unpadded
+    for (int pass = 0; pass < 2; pass++) {
+        size_t text_length = chars;
+        if (pass == 1) {
+            while (text_length > 0 && text[text_length - 1] == '=') {
+                text_length--;
+            }
+        }
+        size_t n = 0, ref_n = 0;
+        CHECK(base64_decode(text, text_length, decoded, HEX_MAX_BYTES, &n) == BCS_OK);
+        CHECK(ref_base64_decode(text, text_length, ref_decoded, HEX_MAX_BYTES, &ref_n) == BCS_OK);
+        CHECK(n == length && ref_n == length);
+        CHECK(memcmp(decoded, input, length) == 0);
+        CHECK(memcmp(ref_decoded, input, length) == 0);
+    }
+}
+
+static void test_base64(void) {
+    static uint8_t digests[NUM_DIGESTS][SUI_DIGEST_LENGTH];
+    size_t n = real_digests(digests);
+
+    for (size_t i = 0; i < n; i++) {
+        check_base64(digests[i], SUI_DIGEST_LENGTH);
+    }
+
+    // Signature-sized (flag || signature || public key) and every tail length
+    for (size_t i = 0; i < HEX_MAX_BYTES; i++) {
+        bytes[i] = (uint8_t)rng();
+    }
+    for (size_t length = 0; length <= 300; length++) {
+        check_base64(bytes, length);
+    }
+    check_base64(bytes, HEX_MAX_BYTES);
+
+    // Every character value at every position of a 44-character input,
+    // with and without padding
+    char text[BASE64_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+    size_t chars = 0;
+    CHECK(base64_encode(digests[0], SUI_DIGEST_LENGTH, text, sizeof(text), &chars) == BCS_OK);
+    for (size_t position = 0; position < chars; position++) {
+        for (int c = 0; c < 256; c++) {
+            char corrupt[BASE64_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+            memcpy(corrupt, text, chars);
+            corrupt[position] = (char)c;
+            for (size_t length = chars - 1; length <= chars; length++) {
+                if (position >= length) continue;
+                size_t dn = 0, ref_n = 0;
+                bcs_error_t err = base64_decode(corrupt, length, decoded, HEX_MAX_BYTES, &dn);
+                bcs_error_t ref_err = ref_base64_decode(corrupt, length, ref_decoded, HEX_MAX_BYTES, &ref_n);
+                CHECK(err == ref_err);
+                if (err == BCS_OK && ref_err == BCS_OK) {
+                    CHECK(dn == ref_n);
+                    CHECK(memcmp(decoded, ref_decoded, dn) == 0);
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    test_hex_encode();
+    test_hex_decode();
+    test_uleb_encode();
+    test_uleb_decode();
+    test_uleb_run();
+    test_base58();
+    test_base64();
+    return test_report("codec_test");
+}
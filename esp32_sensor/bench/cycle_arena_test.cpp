@@ -0,0 +1,194 @@
+/**
+ * Host tests for cycle_arena
+ *
+ * test_steady_state runs the library side of the digest-sign sketch's
+ * cycle a million times with the arena as its only scratch memory and a
+ * counting allocator installed as the BCS default, and fails if anything
+ * reaches the heap after the first (warm-up) cycle.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "cycle_arena.h"
+#include "sensor_frame.h"
+#include "base_codec.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CYCLE_ARENA_SIZE 32768   // As in the digest-sign sketch
+#define NUM_CYCLES 1000000
+#define BATCH_EVERY 16           // Cycles between replayed batches
+#define BATCH_READINGS 8
+
+static uint8_t arena_buffer[CYCLE_ARENA_SIZE];
+
+static void test_alloc(void) {
+    cycle_arena_t arena;
+    cycle_arena_init(&arena, arena_buffer, 256);
+
+    // Blocks are 8-byte aligned and do not overlap
+    uint8_t *a = (uint8_t *)cycle_arena_alloc(&arena, 3);
+    uint8_t *b = (uint8_t *)cycle_arena_alloc(&arena, 17);
+    CHECK(a && b);
+    CHECK((uintptr_t)a % 8 == 0 && (uintptr_t)b % 8 == 0);
+    CHECK(b >= a + 3);
+
+    // The newest block grows in place; an older one moves and keeps its bytes
+    memset(b, 0xB5, 17);
+    CHECK(cycle_arena_realloc(&arena, b, 40) == b);
+    memset(a, 0xA5, 3);
+    uint8_t *moved = (uint8_t *)cycle_arena_realloc(&arena, a, 24);
+    CHECK(moved && moved != a);
+    CHECK(moved[0] == 0xA5 && moved[2] == 0xA5);
+
+    // Exhaustion fails without disturbing anything and is counted
+    CHECK(cycle_arena_alloc(&arena, 1024) == NULL);
+    CHECK(cycle_arena_realloc(&arena, moved, 1024) == NULL);
+    CHECK(moved[0] == 0xA5);
+    CHECK(arena.failures == 2);
+
+    // Reset gives the whole buffer back; the peak is kept
+    size_t peak = arena.peak;
+    cycle_arena_reset(&arena);
+    CHECK(arena.used == 0);
+    CHECK(arena.peak == peak);
+    CHECK(cycle_arena_alloc(&arena, 200) == a);
+}
+
+// Everything one cycle keeps between its steps
+typedef struct {
+    cycle_arena_t arena;
+    transaction_builder_t params;
+    sui_sensor_template_t tpl;
+    uint8_t tpl_buffer[512];
+    bool tpl_ready;
+    sensor_frame_digest_t objects;
+    uint32_t counter;
+} cycle_t;
+
+// Library calls of one digest -> build -> sign -> submit cycle, taking
+// scratch memory from the arena where the sketch does
+static bool run_cycle(cycle_t *cycle) {
+    cycle_arena_t *arena = &cycle->arena;
+    uint32_t n = cycle->counter++;
+    bool ok = true;
+
+    // Request URL
+    char *url = (char *)cycle_arena_alloc(arena, 96);
+    ok &= url != NULL;
+    if (url) snprintf(url, 96, "http://192.168.1.10:3000/api/execute-frame?n=%u", (unsigned)n);
+
+    // DIGEST_RESPONSE from the server, parsed in place
+    uint8_t *frame = (uint8_t *)cycle_arena_alloc(arena, SENSOR_FRAME_MAX_SIZE);
+    ok &= frame != NULL;
+    if (!frame) return false;
+    cycle->objects.sensor_version = 5882390 + n;
+    cycle->objects.gas_object = fixture_gas((uint8_t)n);
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, frame, SENSOR_FRAME_MAX_SIZE);
+    ok &= sensor_frame_write_digest_response(&writer, &cycle->objects) == BCS_OK;
+    sensor_frame_t reply;
+    sensor_frame_digest_t info;
+    ok &= sensor_frame_parse(frame, writer.position, &reply) == BCS_OK;
+    ok &= sensor_frame_read_digest_response(&reply, &info) == BCS_OK;
+
+    // Build: compile the template once, patch it afterwards
+    cycle->params.sensor_data = fixture_reading(n);
+    cycle->params.gas_object = info.gas_object;
+    if (!cycle->tpl_ready) {
+        ok &= sui_compile_sensor_template(&cycle->params, cycle->tpl_buffer, sizeof(cycle->tpl_buffer),
+                                          &cycle->tpl) == BCS_OK;
+        cycle->tpl_ready = true;
+    } else {
+        sui_sensor_template_set_sensor_data(&cycle->tpl, &cycle->params.sensor_data);
+        sui_sensor_template_set_gas_object(&cycle->tpl, &cycle->params.gas_object);
+    }
+    size_t tx_length;
+    const uint8_t *tx = sui_sensor_template_bytes(&cycle->tpl, &tx_length);
+    uint8_t digest[SUI_DIGEST_LENGTH];
+    ok &= sui_transaction_digest(tx, tx_length, SUI_DIGEST_TRANSACTION, digest) == BCS_OK;
+
+    // Transaction hex for the signer
+    char *hex = (char *)cycle_arena_alloc(arena, tx_length * 2 + 1);
+    ok &= hex != NULL;
+    if (hex) bcs_bytes_to_hex(tx, tx_length, hex);
+
+    // The signer returns Base64, which is decoded into the EXECUTE_REQUEST
+    uint8_t signature[SUI_SIGNATURE_LENGTH];
+    for (size_t i = 0; i < sizeof(signature); i++) {
+        signature[i] = digest[i % SUI_DIGEST_LENGTH];
+    }
+    char signature_b64[BASE64_ENCODED_SIZE(SUI_SIGNATURE_LENGTH) + 1];
+    size_t chars, decoded;
+    ok &= base64_encode(signature, sizeof(signature), signature_b64, sizeof(signature_b64), &chars) == BCS_OK;
+    ok &= base64_decode(signature_b64, chars, signature, sizeof(signature), &decoded) == BCS_OK;
+
+    bcs_writer_init_fixed(&writer, frame, SENSOR_FRAME_MAX_SIZE);
+    ok &= sensor_frame_write_execute_request(&writer, &cycle->params.sensor_data, &info.gas_object, signature) ==
+          BCS_OK;
+
+    char digest_b58[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+    ok &= base58_encode(digest, sizeof(digest), digest_b58, sizeof(digest_b58), NULL) == BCS_OK;
+
+    // Every so often a replayed batch, built through arena-backed writers
+    if (n % BATCH_EVERY == 0) {
+        sensor_data_t readings[BATCH_READINGS];
+        for (uint32_t i = 0; i < BATCH_READINGS; i++) {
+            readings[i] = fixture_reading(n + i);
+        }
+        const bcs_allocator_t *allocator = cycle_arena_allocator(arena);
+        bcs_writer_t batch;
+        ok &= bcs_writer_init_with_allocator(&batch, 64, 0, allocator) == BCS_OK;
+        ok &= sui_build_sensor_batch_transaction_into(&cycle->params, readings, BATCH_READINGS, &batch) == BCS_OK;
+        bcs_writer_free(&batch);
+
+        char *batch_hex = NULL;
+        size_t batch_length = 0;
+        ok &= sui_build_sensor_batch_transaction_with_allocator(&cycle->params, readings, BATCH_READINGS, allocator,
+                                                                &batch_hex, &batch_length) == BCS_OK;
+        bcs_allocator_free(allocator, batch_hex);
+    }
+
+    cycle_arena_reset(arena);
+    return ok;
+}
+
+static void test_steady_state(void) {
+    static cycle_t cycle;
+    memset(&cycle, 0, sizeof(cycle));
+    cycle_arena_init(&cycle.arena, arena_buffer, sizeof(arena_buffer));
+    fixture_params(&cycle.params);
+
+    counting_allocator_t counter;
+    counting_allocator_init(&counter);
+    bcs_set_default_allocator(&counter.allocator);
+
+    // Warm-up: compiles the template and runs the first batch
+    CHECK(run_cycle(&cycle));
+    counting_allocator_reset(&counter);
+
+    size_t failed = 0;
+    for (uint32_t i = 1; i < NUM_CYCLES; i++) {
+        if (!run_cycle(&cycle)) {
+            failed++;
+        }
+    }
+    bcs_set_default_allocator(NULL);
+
+    CHECK(failed == 0);
+    CHECK(cycle.arena.failures == 0);
+    CHECK(cycle.arena.used == 0);
+    CHECK(cycle.arena.peak <= cycle.arena.capacity);
+    if (counter.allocs != 0 || counter.frees != 0) {
+        fprintf(stderr, "heap calls after warm-up: %zu allocs, %zu frees\n", counter.allocs, counter.frees);
+        test_failures++;
+    }
+}
+
+int main() {
+    test_alloc();
+    test_steady_state();
+    return test_report("cycle_arena_test");
+}
@@ -0,0 +1,209 @@
+/**
+ * Host tests for cycle_engine on a simulated clock
+ *
+ * The network steps take seconds (some longer than the state timeout) and
+ * build/sign burn simulated CPU time, while the loop polls every POLL_MS.
+ * Every sample must still land within one poll plus the slowest step of
+ * its due time, with the period intact. The same run is repeated across
+ * the 32-bit millis() wrap and must match the run from 0 exactly.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "cycle_engine.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SAMPLE_INTERVAL_MS 5000
+#define STATE_TIMEOUT_MS 15000
+#define RETRY_DELAY_MS 2000
+#define POLL_MS 10
+#define BUILD_MS 30
+#define SIGN_MS 60
+#define NUM_SAMPLES 2000
+
+// Worst sample lateness: the poll interval plus the slowest step
+#define JITTER_BOUND_MS (POLL_MS + SIGN_MS)
+
+// Simulated application: network states wait 1-20 s for their reply
+typedef struct {
+    cycle_engine_t *engine;
+    uint32_t start_ms;
+    uint32_t rng;
+    uint32_t busy_ms;               // CPU time the last step used
+    bool request_open;
+    uint32_t reply_at_ms;
+
+    uint32_t sample_times[NUM_SAMPLES];     // Relative to start_ms
+    uint32_t samples;
+    uint32_t samples_while_pending;         // Taken while a request was open
+    uint32_t finished;
+    uint32_t timeouts;
+} sim_t;
+
+static uint32_t next_latency(sim_t *sim) {
+    sim->rng = sim->rng * 1103515245u + 12345u;
+    return 1000 + (sim->rng >> 8) % 19001;
+}
+
+static bool sim_sample(void *ctx, uint32_t now_ms) {
+    sim_t *sim = (sim_t *)ctx;
+    if (sim->samples < NUM_SAMPLES) {
+        sim->sample_times[sim->samples] = now_ms - sim->start_ms;
+    }
+    sim->samples++;
+    if (sim->request_open) {
+        sim->samples_while_pending++;
+    }
+    return true;
+}
+
+static cycle_step_t sim_step(void *ctx, cycle_state_t state, uint32_t now_ms) {
+    sim_t *sim = (sim_t *)ctx;
+    switch (state) {
+    case CYCLE_STATE_BUILD:
+        sim->busy_ms = BUILD_MS;
+        return CYCLE_STEP_DONE;
+    case CYCLE_STATE_SIGN:
+        sim->busy_ms = SIGN_MS;
+        return CYCLE_STEP_DONE;
+    default:
+        break;
+    }
+
+    // FETCH_REFS, SUBMIT and CONFIRM: one slow request each
+    if (!sim->request_open) {
+        sim->request_open = true;
+        sim->reply_at_ms = now_ms + next_latency(sim);
+        return CYCLE_STEP_PENDING;
+    }
+    if ((int32_t)(now_ms - sim->reply_at_ms) < 0) {
+        return CYCLE_STEP_PENDING;
+    }
+    sim->request_open = false;
+    return CYCLE_STEP_DONE;
+}
+
+static bool sim_finish(void *ctx, cycle_state_t state, bool ok, uint32_t now_ms) {
+    sim_t *sim = (sim_t *)ctx;
+    (void)state;
+    (void)now_ms;
+    if (!ok && sim->request_open) {
+        sim->timeouts++;
+    }
+    sim->request_open = false;
+    sim->finished++;
+    return !ok;
+}
+
+// Poll until NUM_SAMPLES samples were taken; stall_at_sample > 0 skips
+// stall_ms of polling once that many samples were taken
+static void run(sim_t *sim, cycle_engine_t *engine, uint32_t start_ms, uint32_t stall_at_sample, uint32_t stall_ms) {
+    memset(sim, 0, sizeof(*sim));
+    sim->engine = engine;
+    sim->start_ms = start_ms;
+    sim->rng = 1;
+
+    static timer_wheel_t wheel;
+    timer_wheel_init(&wheel, 4, start_ms);
+    cycle_engine_config_t config = { SAMPLE_INTERVAL_MS, STATE_TIMEOUT_MS, RETRY_DELAY_MS };
+    cycle_engine_ops_t ops = { sim, sim_sample, sim_step, sim_finish };
+    cycle_engine_init(engine, &wheel, &config, &ops, start_ms);
+
+    uint32_t now = start_ms;
+    bool stalled = false;
+    while (sim->samples < NUM_SAMPLES) {
+        sim->busy_ms = 0;
+        cycle_engine_poll(engine, now);
+        now += sim->busy_ms + POLL_MS;
+
+        if (stall_at_sample && !stalled && sim->samples == stall_at_sample) {
+            now += stall_ms;
+            stalled = true;
+        }
+    }
+}
+
+// ============================================================================
+// Slow network
+// ============================================================================
+
+static void check_jitter(const sim_t *sim, const cycle_engine_t *engine) {
+    uint32_t worst = 0;
+    for (uint32_t i = 0; i < NUM_SAMPLES; i++) {
+        uint32_t lateness = sim->sample_times[i] - i * SAMPLE_INTERVAL_MS;
+        if (lateness > worst) {
+            worst = lateness;
+        }
+        if (i > 0) {
+            uint32_t period = sim->sample_times[i] - sim->sample_times[i - 1];
+            CHECK(period + JITTER_BOUND_MS >= SAMPLE_INTERVAL_MS);
+            CHECK(period <= SAMPLE_INTERVAL_MS + JITTER_BOUND_MS);
+        }
+    }
+    CHECK(worst <= JITTER_BOUND_MS);
+    CHECK(engine->stats.max_sample_lateness_ms == worst);
+    CHECK(engine->stats.samples_missed == 0);
+    printf("cycle_engine_test: %u samples, worst lateness %u ms (bound %u), %u cycles ok, %u failed, %u timeouts\n",
+           (unsigned)NUM_SAMPLES, (unsigned)worst, (unsigned)JITTER_BOUND_MS, (unsigned)engine->stats.cycles_ok,
+           (unsigned)engine->stats.cycles_failed, (unsigned)engine->stats.timeouts);
+}
+
+static void test_slow_network(void) {
+    static sim_t sim, wrapped;
+    static cycle_engine_t engine, wrapped_engine;
+
+    run(&sim, &engine, 0, 0, 0);
+    check_jitter(&sim, &engine);
+
+    // The network really was slow: cycles span samples, and some time out
+    CHECK(sim.samples_while_pending > NUM_SAMPLES / 2);
+    CHECK(engine.stats.cycles_ok > 0);
+    CHECK(engine.stats.timeouts > 0);
+    CHECK(engine.stats.timeouts == sim.timeouts);
+    CHECK(engine.stats.cycles_ok + engine.stats.cycles_failed == sim.finished);
+
+    // Halfway through the run millis() wraps; nothing may change
+    uint32_t start = 0u - (uint32_t)(NUM_SAMPLES / 2) * SAMPLE_INTERVAL_MS;
+    run(&wrapped, &wrapped_engine, start, 0, 0);
+    check_jitter(&wrapped, &wrapped_engine);
+    CHECK(memcmp(wrapped.sample_times, sim.sample_times, sizeof(sim.sample_times)) == 0);
+    CHECK(memcmp(&wrapped_engine.stats, &engine.stats, sizeof(engine.stats)) == 0);
+    CHECK(wrapped.finished == sim.finished);
+}
+
+// ============================================================================
+// Stalls
+// ============================================================================
+
+// A loop that stalls (e.g. in a blocking call) skips the samples it slept
+// through and resumes on the original grid, across the wrap too
+static void test_stall(void) {
+    static sim_t sim;
+    static cycle_engine_t engine;
+    const uint32_t stall_ms = SAMPLE_INTERVAL_MS * 7 / 2;
+
+    for (int k = 0; k < 2; k++) {
+        uint32_t start = k ? 0u - 10 * SAMPLE_INTERVAL_MS : 0;
+        run(&sim, &engine, start, 10, stall_ms);
+
+        // Samples 10-12 fell in the stall: 10 is taken late, 11 and 12 are skipped
+        uint32_t late = stall_ms - SAMPLE_INTERVAL_MS;
+        CHECK(engine.stats.samples_missed == 2);
+        CHECK(engine.stats.max_sample_lateness_ms >= late);
+        CHECK(engine.stats.max_sample_lateness_ms <= late + JITTER_BOUND_MS);
+
+        // From then on they are back on the original grid
+        for (uint32_t i = 11; i < NUM_SAMPLES; i++) {
+            uint32_t lateness = sim.sample_times[i] - (i + 2) * SAMPLE_INTERVAL_MS;
+            CHECK(lateness <= JITTER_BOUND_MS);
+        }
+    }
+}
+
+int main() {
+    test_slow_network();
+    test_stall();
+    return test_report("cycle_engine_test");
+}
@@ -0,0 +1,203 @@
+/**
+ * Host tests for blake2b and the transaction digests
+ *
+ * The expected digests were computed independently with Python's
+ * hashlib.blake2b. The transaction vector is the fixture transaction as
+ * built today; its bytes are checked too, so a builder change shows up
+ * here as a byte mismatch rather than as a digest mismatch.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "blake2b.h"
+#include "base_codec.h"
+#include <string.h>
+
+static void check_hex(const uint8_t *digest, size_t length, const char *expected) {
+    char hex[BLAKE2B_MAX_DIGEST_SIZE * 2 + 1];
+    bcs_bytes_to_hex(digest, length, hex);
+    CHECK(strcmp(hex, expected) == 0);
+}
+
+// ============================================================================
+// Blake2b
+// ============================================================================
+
+// Bytes k * 7 + 3, the message of the length vectors below
+static void fill_message(uint8_t *message, size_t length) {
+    for (size_t k = 0; k < length; k++) {
+        message[k] = (uint8_t)(k * 7 + 3);
+    }
+}
+
+static const struct {
+    size_t length;
+    const char *digest;
+} length_vectors[] = {
+    { 127, "c9ae3859964b35f04c54b36d33cf299d7290ee621005d28e51598a943560aaaa" },
+    { 128, "f0501d06597880592bc49234eef100ec1ff349058d0e9d9b753504e24af86dd6" },
+    { 129, "a34a4e1e03c541dfbf3099c4b6c143c022ced65c28bd7e8a10e0a098461aecf0" },
+    { 255, "f2d64a40e9412a3414161ff6250075225418fd7c271c1123e162e1bca0de9f93" },
+    { 256, "d93ebb9c802f5630ab22516fd82b6c21bc8bd551d531349b715f046ed11ed871" },
+    { 257, "4ce481b24d387422d2bc2baa03d1afd55a1327939ff537c71eb9b38709268649" },
+    { 1000, "d62b6c768ce1afc8367e0498ab2f8e3f7c178c35b1429f14c4604b545d200f52" },
+};
+
+static void test_blake2b_vectors(void) {
+    uint8_t digest[BLAKE2B_MAX_DIGEST_SIZE];
+
+    // RFC 7693 Appendix A
+    CHECK(blake2b(digest, 64, (const uint8_t *)"abc", 3));
+    check_hex(digest, 64,
+              "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+              "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923");
+
+    // Blake2b-256, the size Sui uses
+    CHECK(blake2b(digest, BLAKE2B_256_SIZE, (const uint8_t *)"abc", 3));
+    check_hex(digest, BLAKE2B_256_SIZE, "bddd813c634239723171ef3fee98579b94964e3bb1cb3e427262c8c068d52319");
+    CHECK(blake2b(digest, BLAKE2B_256_SIZE, NULL, 0));
+    check_hex(digest, BLAKE2B_256_SIZE, "0e5751c026e543b2e8ab2eb06099daa1d1e5df47778f7787faab45cdf12fe3a8");
+
+    // Around the block boundaries, one shot and split at every offset
+    static uint8_t message[1000];
+    fill_message(message, sizeof(message));
+    for (size_t v = 0; v < sizeof(length_vectors) / sizeof(length_vectors[0]); v++) {
+        size_t length = length_vectors[v].length;
+        CHECK(blake2b(digest, BLAKE2B_256_SIZE, message, length));
+        check_hex(digest, BLAKE2B_256_SIZE, length_vectors[v].digest);
+
+        for (size_t split = 0; split <= length; split++) {
+            blake2b_state_t state;
+            CHECK(blake2b_init(&state, BLAKE2B_256_SIZE));
+            blake2b_update(&state, message, split);
+            blake2b_update(&state, message + split, length - split);
+            blake2b_final(&state, digest);
+            check_hex(digest, BLAKE2B_256_SIZE, length_vectors[v].digest);
+        }
+    }
+
+    blake2b_state_t state;
+    CHECK(!blake2b_init(&state, 0));
+    CHECK(!blake2b_init(&state, BLAKE2B_MAX_DIGEST_SIZE + 1));
+}
+
+// ============================================================================
+// Transaction digests
+// ============================================================================
+
+// fixture_params() built with sui_build_sensor_transaction_into()
+static const char fixture_tx_hex[] =
+    "00000800082e0900000000000000088c190000000000000008f50300000000000000085203000000000000000d0c6573"
+    "7033322d646576696365000504736f696c00010001010000000000000000000000000000000000000000000000000000"
+    "000000000006010000000000000000010011181f262d343b424950575e656c737a81888f969da4abb2b9c0c7ced5dce3"
+    "ea0e73656e736f725f73746f726167651173746f72655f73656e736f725f646174610008010000010100010200010300"
+    "010400010500010600010700333a41484f565d646b727980878e959ca3aab1b8bfc6cdd4dbe2e9f0f7fe050c01444b52"
+    "5960676e757c838a91989fa6adb4bbc2c9d0d7dee5ecf3fa01080f161d449b65180000000020c4cbd2d9e0e7eef5fc03"
+    "0a11181f262d343b424950575e656c737a81888f969d333a41484f565d646b727980878e959ca3aab1b8bfc6cdd4dbe2"
+    "e9f0f7fe050ce80300000000000000e1f5050000000000";
+
+// Blake2b-256("TransactionData::" || tx), as explorers show it
+static const char fixture_tx_digest_b58[] = "7RaZujqNtpi1kAf4KoER5xy36R96M7ejqsiYkNEXtkKU";
+static const char fixture_tx_digest_hex[] = "5f720408b32e8d0c020f08f261f453af316963476f6f84d12614b52c53b1a7f3";
+
+// Blake2b-256(00 00 00 || tx), the message that is signed
+static const char fixture_intent_digest_hex[] = "7749fec85be43d92c180d72d415345b621c830fc6ed7907e410d7888d159c226";
+
+static void test_transaction_vectors(void) {
+    static uint8_t tx[sizeof(fixture_tx_hex) / 2];
+    size_t tx_length = 0;
+    CHECK(bcs_hex_to_bytes(fixture_tx_hex, tx, sizeof(tx), &tx_length) == BCS_OK);
+
+    transaction_builder_t params;
+    fixture_params(&params);
+    uint8_t built[512];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, built, sizeof(built));
+    CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+    CHECK(writer.position == tx_length);
+    CHECK(memcmp(built, tx, tx_length) == 0);
+
+    uint8_t digest[SUI_DIGEST_LENGTH];
+    CHECK(sui_transaction_digest(tx, tx_length, SUI_DIGEST_TRANSACTION, digest) == BCS_OK);
+    check_hex(digest, SUI_DIGEST_LENGTH, fixture_tx_digest_hex);
+    char b58[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+    CHECK(base58_encode(digest, sizeof(digest), b58, sizeof(b58), NULL) == BCS_OK);
+    CHECK(strcmp(b58, fixture_tx_digest_b58) == 0);
+
+    CHECK(sui_transaction_digest(tx, tx_length, SUI_DIGEST_INTENT, digest) == BCS_OK);
+    check_hex(digest, SUI_DIGEST_LENGTH, fixture_intent_digest_hex);
+
+    CHECK(sui_transaction_digest(tx, tx_length, (sui_digest_kind_t)2, digest) == BCS_ERROR_INVALID_INPUT);
+}
+
+// ============================================================================
+// Hash while writing
+// ============================================================================
+
+// Hash a build through the writer and compare with hashing the result
+static void check_fused(bcs_writer_t *writer, sui_digest_kind_t kind, const transaction_builder_t *params,
+                        const sensor_data_t *readings, size_t count) {
+    blake2b_state_t hash;
+    uint8_t fused[SUI_DIGEST_LENGTH], after[SUI_DIGEST_LENGTH];
+    CHECK(sui_digest_begin(writer, &hash, kind) == BCS_OK);
+    if (readings) {
+        CHECK(sui_build_sensor_batch_transaction_into(params, readings, count, writer) == BCS_OK);
+    } else {
+        CHECK(sui_build_sensor_transaction_into(params, writer) == BCS_OK);
+    }
+    CHECK(bcs_writer_finish_hash(writer, fused) == BCS_OK);
+
+    CHECK(sui_transaction_digest(writer->buffer, writer->position, kind, after) == BCS_OK);
+    CHECK(memcmp(fused, after, sizeof(fused)) == 0);
+}
+
+static void test_hash_while_writing(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    static sensor_data_t readings[SUI_MAX_BATCH_READINGS];
+    for (uint32_t i = 0; i < SUI_MAX_BATCH_READINGS; i++) {
+        readings[i] = fixture_reading(i);
+    }
+
+    static uint8_t buffer[16384];
+    for (int k = 0; k < 2; k++) {
+        sui_digest_kind_t kind = k ? SUI_DIGEST_TRANSACTION : SUI_DIGEST_INTENT;
+
+        // Single readings into fixed and growable writers; a small initial
+        // capacity makes the growable writer reallocate mid-build
+        for (uint32_t i = 0; i < 64; i++) {
+            params.sensor_data = fixture_reading(i * 37);
+            params.gas_object = fixture_gas((uint8_t)i);
+
+            bcs_writer_t writer;
+            bcs_writer_init_fixed(&writer, buffer, sizeof(buffer));
+            check_fused(&writer, kind, &params, NULL, 0);
+
+            CHECK(bcs_writer_init(&writer, 16, 0) == BCS_OK);
+            check_fused(&writer, kind, &params, NULL, 0);
+            bcs_writer_free(&writer);
+        }
+
+        // Every batch size, so the hash crosses block boundaries at
+        // different points of the transaction
+        for (size_t count = 1; count <= SUI_MAX_BATCH_READINGS; count++) {
+            bcs_writer_t writer;
+            bcs_writer_init_fixed(&writer, buffer, sizeof(buffer));
+            check_fused(&writer, kind, &params, readings, count);
+
+            CHECK(bcs_writer_init(&writer, 16, 0) == BCS_OK);
+            check_fused(&writer, kind, &params, readings, count);
+            bcs_writer_free(&writer);
+        }
+    }
+}
+
+int main() {
+    test_blake2b_vectors();
+    test_transaction_vectors();
+    test_hash_while_writing();
+    return test_report("digest_test");
+}
@@ -0,0 +1,53 @@
+/**
+ * Fixtures
+ * Deterministic transaction parameters shared by the host benchmarks and
+ * tests, shaped like the ones the digest-sign sketch sends
+ */
+
+#ifndef FIXTURES_H
+#define FIXTURES_H
+
+#include "sui_transaction.h"
+#include <string.h>
+
+// Bytes 0x00, 0x01, ... offset by seed, so every ID differs
+static inline void fixture_bytes(uint8_t *out, size_t length, uint8_t seed) {
+    for (size_t i = 0; i < length; i++) {
+        out[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+static inline gas_object_t fixture_gas(uint8_t seed) {
+    gas_object_t gas;
+    fixture_bytes(gas.object_id, sizeof(gas.object_id), seed);
+    gas.version = 409312000ull + seed;
+    fixture_bytes(gas.digest, sizeof(gas.digest), (uint8_t)(seed + 0x80));
+    return gas;
+}
+
+static inline sensor_data_t fixture_reading(uint32_t i) {
+    sensor_data_t data;
+    data.value1 = (uint16_t)(2350 + i % 40);
+    data.value2 = (uint16_t)(6540 - i % 25);
+    data.value3 = (uint16_t)(1013 + i % 3);
+    data.value4 = (uint16_t)(850 + i % 60);
+    data.timestamp = 1730822400ull + i * 60;
+    return data;
+}
+
+static inline void fixture_params(transaction_builder_t *params) {
+    memset(params, 0, sizeof(*params));
+    fixture_bytes(params->package_id, 32, 0x11);
+    params->module_name = "sensor_storage";
+    params->function_name = "store_sensor_data";
+    fixture_bytes(params->sensor_object_id, 32, 0x22);
+    params->sensor_initial_shared_version = 5882390;
+    params->sensor_mutable = true;
+    params->sensor_data = fixture_reading(0);
+    fixture_bytes(params->sender, 32, 0x33);
+    params->gas_object = fixture_gas(0x44);
+    params->gas_budget = 100000000;
+    params->gas_price = 1000;
+}
+
+#endif // FIXTURES_H
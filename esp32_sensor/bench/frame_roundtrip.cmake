@@ -0,0 +1,25 @@
+# Frames written by the C codec are decoded and re-encoded by the dapp's
+# TypeScript codec (lib/sensor-frame.test.ts), then parsed again in C.
+#
+#   cmake -DFRAME_TEST=... -DNPM=... -DDAPP_DIR=... -DWORK_DIR=... -P frame_roundtrip.cmake
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+execute_process(COMMAND ${FRAME_TEST} --write ${WORK_DIR} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "frame_test --write failed")
+endif()
+
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E env FRAME_VECTORS_DIR=${WORK_DIR} ${NPM} test
+  WORKING_DIRECTORY ${DAPP_DIR}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "npm test failed")
+endif()
+
+execute_process(COMMAND ${FRAME_TEST} --check ${WORK_DIR} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "frame_test --check failed")
+endif()
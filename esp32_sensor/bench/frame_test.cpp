@@ -0,0 +1,404 @@
+/**
+ * Host tests for sensor_frame
+ *
+ * Without arguments, checks the C codec on its own: every frame type
+ * round-trips, truncated and malformed frames are rejected and ERROR
+ * messages are cut to fit.
+ *
+ * The C -> TypeScript -> C round trip (frame_roundtrip.cmake) uses the
+ * other two modes around dapp/lib/sensor-frame.test.ts:
+ *   frame_test --write DIR   C frames and the values in them (vectors.json)
+ *   frame_test --check DIR   parse the frames the TypeScript codec wrote
+ *                            back (ts_*.bin) and compare with the values
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "sensor_frame.h"
+#include "base_codec.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LONG_MESSAGE_LENGTH 600
+
+// Values carried by the test frames
+typedef struct {
+    uint8_t sender[32];
+    sensor_frame_digest_t objects;
+    sensor_data_t reading;
+    uint8_t signature[SUI_SIGNATURE_LENGTH];
+    uint8_t digest[32];
+    sensor_frame_digest_t next;
+    sensor_frame_gas_coins_t coins;
+    uint8_t coin_count;
+    uint16_t error_status;
+    const char *error_message;
+    char long_message[LONG_MESSAGE_LENGTH + 1];
+} frame_values_t;
+
+static frame_values_t values;
+
+static void setup_values(void) {
+    fixture_bytes(values.sender, 32, 0x33);
+    fixture_bytes(values.objects.sensor_object_id, 32, 0x22);
+    values.objects.sensor_version = 5882390;
+    values.objects.gas_object = fixture_gas(0x44);
+    values.reading = fixture_reading(7);
+    fixture_bytes(values.signature, SUI_SIGNATURE_LENGTH, 0x01);
+    values.signature[0] = 0x00;  // Ed25519 flag
+    fixture_bytes(values.digest, 32, 0x55);
+    values.next = values.objects;
+    values.next.sensor_version++;
+    values.next.gas_object = fixture_gas(0x45);
+    memcpy(values.coins.sensor_object_id, values.objects.sensor_object_id, 32);
+    values.coins.sensor_version = values.objects.sensor_version;
+    values.coins.gas_count = 3;
+    for (size_t i = 0; i < values.coins.gas_count; i++) {
+        values.coins.gas_objects[i] = fixture_gas((uint8_t)(0x60 + i));
+    }
+    values.coin_count = 3;
+    values.error_status = 409;
+    values.error_message = "Gas coin version conflict";
+    for (size_t i = 0; i < LONG_MESSAGE_LENGTH; i++) {
+        values.long_message[i] = (char)('a' + i % 26);
+    }
+    values.long_message[LONG_MESSAGE_LENGTH] = '\0';
+}
+
+// One frame of every kind, in a fixed order
+static const char *frame_names[] = {
+    "digest_request", "digest_response", "execute_request", "execute_response",
+    "gas_coins_request", "gas_coins_response", "error", "error_long",
+};
+#define NUM_FRAMES (sizeof(frame_names) / sizeof(frame_names[0]))
+
+static bcs_error_t write_named_frame(size_t n, bcs_writer_t *writer) {
+    switch (n) {
+        case 0: return sensor_frame_write_digest_request(writer, values.sender);
+        case 1: return sensor_frame_write_digest_response(writer, &values.objects);
+        case 2: return sensor_frame_write_execute_request(writer, &values.reading, &values.objects.gas_object,
+                                                          values.signature);
+        case 3: return sensor_frame_write_execute_response(writer, values.digest, &values.next);
+        case 4: return sensor_frame_write_gas_coins_request(writer, values.sender, values.coin_count);
+        case 5: return sensor_frame_write_gas_coins_response(writer, &values.coins);
+        case 6: return sensor_frame_write_error(writer, values.error_status, values.error_message);
+        default: return sensor_frame_write_error(writer, values.error_status, values.long_message);
+    }
+}
+
+static bool same_gas(const gas_object_t *a, const gas_object_t *b) {
+    return memcmp(a->object_id, b->object_id, 32) == 0 && a->version == b->version &&
+           memcmp(a->digest, b->digest, 32) == 0;
+}
+
+static bool same_objects(const sensor_frame_digest_t *a, const sensor_frame_digest_t *b) {
+    return memcmp(a->sensor_object_id, b->sensor_object_id, 32) == 0 && a->sensor_version == b->sensor_version &&
+           same_gas(&a->gas_object, &b->gas_object);
+}
+
+// Read frame n back and compare it with the values it was written from
+static void check_named_frame(size_t n, const sensor_frame_t *frame) {
+    switch (n) {
+        case 0: {
+            uint8_t sender[32];
+            CHECK(sensor_frame_read_digest_request(frame, sender) == BCS_OK);
+            CHECK(memcmp(sender, values.sender, 32) == 0);
+            break;
+        }
+        case 1: {
+            sensor_frame_digest_t info;
+            CHECK(sensor_frame_read_digest_response(frame, &info) == BCS_OK);
+            CHECK(same_objects(&info, &values.objects));
+            break;
+        }
+        case 2: {
+            sensor_data_t reading;
+            gas_object_t gas;
+            uint8_t signature[SUI_SIGNATURE_LENGTH];
+            CHECK(sensor_frame_read_execute_request(frame, &reading, &gas, signature) == BCS_OK);
+            CHECK(memcmp(&reading, &values.reading, sizeof(reading)) == 0);
+            CHECK(same_gas(&gas, &values.objects.gas_object));
+            CHECK(memcmp(signature, values.signature, sizeof(signature)) == 0);
+            break;
+        }
+        case 3: {
+            uint8_t digest[32];
+            sensor_frame_digest_t next;
+            CHECK(sensor_frame_read_execute_response(frame, digest, &next) == BCS_OK);
+            CHECK(memcmp(digest, values.digest, 32) == 0);
+            CHECK(same_objects(&next, &values.next));
+            break;
+        }
+        case 4: {
+            uint8_t sender[32], count = 0;
+            CHECK(sensor_frame_read_gas_coins_request(frame, sender, &count) == BCS_OK);
+            CHECK(memcmp(sender, values.sender, 32) == 0);
+            CHECK(count == values.coin_count);
+            break;
+        }
+        case 5: {
+            sensor_frame_gas_coins_t coins;
+            CHECK(sensor_frame_read_gas_coins_response(frame, &coins) == BCS_OK);
+            CHECK(memcmp(coins.sensor_object_id, values.coins.sensor_object_id, 32) == 0);
+            CHECK(coins.sensor_version == values.coins.sensor_version);
+            CHECK(coins.gas_count == values.coins.gas_count);
+            for (size_t i = 0; i < coins.gas_count && i < values.coins.gas_count; i++) {
+                CHECK(same_gas(&coins.gas_objects[i], &values.coins.gas_objects[i]));
+            }
+            break;
+        }
+        default: {
+            const char *message = n == 6 ? values.error_message : values.long_message;
+            size_t expected = strlen(message);
+            if (expected > SENSOR_FRAME_MAX_PAYLOAD - 2) {
+                expected = SENSOR_FRAME_MAX_PAYLOAD - 2;
+            }
+            uint16_t status = 0;
+            bcs_view_t text;
+            CHECK(sensor_frame_read_error(frame, &status, &text) == BCS_OK);
+            CHECK(status == values.error_status);
+            CHECK(text.length == expected);
+            CHECK(memcmp(text.data, message, expected) == 0);
+            break;
+        }
+    }
+}
+
+// ============================================================================
+// C codec
+// ============================================================================
+
+static void test_round_trip(void) {
+    for (size_t n = 0; n < NUM_FRAMES; n++) {
+        uint8_t data[SENSOR_FRAME_MAX_SIZE + 8];
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, data, sizeof(data));
+        CHECK(write_named_frame(n, &writer) == BCS_OK);
+        CHECK(writer.position <= SENSOR_FRAME_MAX_SIZE);
+        CHECK(sensor_frame_size(data) == writer.position);
+
+        sensor_frame_t frame;
+        CHECK(sensor_frame_parse(data, writer.position, &frame) == BCS_OK);
+        CHECK(frame.frame_length == writer.position);
+        check_named_frame(n, &frame);
+
+        // Bytes after the frame belong to the next one
+        memset(data + writer.position, 0xEE, 8);
+        CHECK(sensor_frame_parse(data, writer.position + 8, &frame) == BCS_OK);
+        CHECK(frame.frame_length == writer.position);
+
+        // Every truncation is an underflow, never a shorter frame
+        for (size_t length = 0; length < writer.position; length++) {
+            CHECK(sensor_frame_parse(data, length, &frame) == BCS_ERROR_BUFFER_UNDERFLOW);
+        }
+
+        // A writer one byte short latches the error
+        if (writer.position > 1) {
+            bcs_writer_t small;
+            bcs_writer_init_fixed(&small, data, writer.position - 1);
+            CHECK(write_named_frame(n, &small) == BCS_ERROR_BUFFER_TOO_SMALL);
+        }
+    }
+}
+
+static void test_malformed(void) {
+    uint8_t data[SENSOR_FRAME_MAX_SIZE + 1];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, data, sizeof(data));
+    CHECK(sensor_frame_write_digest_response(&writer, &values.objects) == BCS_OK);
+    size_t length = writer.position;
+
+    sensor_frame_t frame;
+    sensor_frame_digest_t info;
+    uint8_t sender[32];
+
+    // Another type's reader
+    CHECK(sensor_frame_parse(data, length, &frame) == BCS_OK);
+    CHECK(sensor_frame_read_digest_request(&frame, sender) == BCS_ERROR_INVALID_INPUT);
+
+    // Unsupported version
+    data[0] = SENSOR_FRAME_VERSION + 1;
+    CHECK(sensor_frame_parse(data, length, &frame) == BCS_ERROR_INVALID_INPUT);
+    data[0] = SENSOR_FRAME_VERSION;
+
+    // Payload one byte longer than the layout
+    data[2]++;
+    data[length] = 0;
+    CHECK(sensor_frame_parse(data, length + 1, &frame) == BCS_OK);
+    CHECK(sensor_frame_read_digest_response(&frame, &info) == BCS_ERROR_INVALID_INPUT);
+    data[2]--;
+
+    // ObjectRef digests must be 32 bytes
+    data[SENSOR_FRAME_HEADER_SIZE + 40 + 40] = 31;
+    CHECK(sensor_frame_parse(data, length, &frame) == BCS_OK);
+    CHECK(sensor_frame_read_digest_response(&frame, &info) == BCS_ERROR_INVALID_INPUT);
+
+    // More gas coins than a frame carries
+    sensor_frame_gas_coins_t coins = values.coins;
+    coins.gas_count = SENSOR_FRAME_MAX_GAS_COINS + 1;
+    bcs_writer_init_fixed(&writer, data, sizeof(data));
+    CHECK(sensor_frame_write_gas_coins_response(&writer, &coins) == BCS_ERROR_INVALID_INPUT);
+    bcs_writer_init_fixed(&writer, data, sizeof(data));
+    CHECK(sensor_frame_write_gas_coins_response(&writer, &values.coins) == BCS_OK);
+    data[SENSOR_FRAME_HEADER_SIZE + 40] = (uint8_t)(values.coins.gas_count + 1);
+    CHECK(sensor_frame_parse(data, writer.position, &frame) == BCS_OK);
+    CHECK(sensor_frame_read_gas_coins_response(&frame, &coins) == BCS_ERROR_INVALID_INPUT);
+
+    // ERROR frames: empty message, and a payload too short for the status
+    uint16_t status;
+    bcs_view_t message;
+    bcs_writer_init_fixed(&writer, data, sizeof(data));
+    CHECK(sensor_frame_write_error(&writer, 500, NULL) == BCS_OK);
+    CHECK(sensor_frame_parse(data, writer.position, &frame) == BCS_OK);
+    CHECK(sensor_frame_read_error(&frame, &status, &message) == BCS_OK);
+    CHECK(status == 500 && message.length == 0);
+    data[2] = 1;
+    CHECK(sensor_frame_parse(data, SENSOR_FRAME_HEADER_SIZE + 1, &frame) == BCS_OK);
+    CHECK(sensor_frame_read_error(&frame, &status, &message) == BCS_ERROR_INVALID_INPUT);
+}
+
+// ============================================================================
+// Round trip through the TypeScript codec
+// ============================================================================
+
+static bool write_file(const char *dir, const char *name, const char *suffix, const uint8_t *data, size_t length) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s%s", dir, name, suffix);
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(data, 1, length, file) == length;
+    return fclose(file) == 0 && ok;
+}
+
+static long read_file(const char *dir, const char *name, uint8_t *data, size_t capacity) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/ts_%s.bin", dir, name);
+    FILE *file = fopen(path, "rb");
+    if (!file) return -1;
+    size_t length = fread(data, 1, capacity, file);
+    fclose(file);
+    return (long)length;
+}
+
+static void json_id(FILE *out, const char *key, const uint8_t id[32]) {
+    char hex[65];
+    bcs_bytes_to_hex(id, 32, hex);
+    fprintf(out, "\"%s\": \"0x%s\"", key, hex);
+}
+
+static void json_digest(FILE *out, const char *key, const uint8_t digest[32]) {
+    char text[BASE58_ENCODED_SIZE(32) + 1];
+    base58_encode(digest, 32, text, sizeof(text), NULL);
+    fprintf(out, "\"%s\": \"%s\"", key, text);
+}
+
+static void json_gas(FILE *out, const gas_object_t *gas) {
+    fprintf(out, "{");
+    json_id(out, "objectId", gas->object_id);
+    fprintf(out, ", \"version\": \"%llu\", ", (unsigned long long)gas->version);
+    json_digest(out, "digest", gas->digest);
+    fprintf(out, "}");
+}
+
+// CycleObjects in dapp/lib/sponsor.ts
+static void json_objects(FILE *out, const sensor_frame_digest_t *objects) {
+    fprintf(out, "{");
+    json_id(out, "sensorObjectId", objects->sensor_object_id);
+    fprintf(out, ", \"sensorVersion\": \"%llu\", ", (unsigned long long)objects->sensor_version);
+    json_id(out, "gasObjectId", objects->gas_object.object_id);
+    fprintf(out, ", \"gasVersion\": \"%llu\", ", (unsigned long long)objects->gas_object.version);
+    json_digest(out, "gasDigest", objects->gas_object.digest);
+    fprintf(out, "}");
+}
+
+static bool write_vectors(const char *dir) {
+    for (size_t n = 0; n < NUM_FRAMES; n++) {
+        uint8_t data[SENSOR_FRAME_MAX_SIZE];
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, data, sizeof(data));
+        if (write_named_frame(n, &writer) != BCS_OK || !write_file(dir, frame_names[n], ".bin", data, writer.position)) {
+            return false;
+        }
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/vectors.json", dir);
+    FILE *out = fopen(path, "w");
+    if (!out) return false;
+
+    char signature[BASE64_ENCODED_SIZE(SUI_SIGNATURE_LENGTH) + 1];
+    base64_encode(values.signature, SUI_SIGNATURE_LENGTH, signature, sizeof(signature), NULL);
+
+    fprintf(out, "{\n  ");
+    json_id(out, "sender", values.sender);
+    fprintf(out, ",\n  \"objects\": ");
+    json_objects(out, &values.objects);
+    fprintf(out, ",\n  \"reading\": {\"temperature\": %u, \"humidity\": %u, \"ec\": %u, \"ph\": %u, \"timestamp\": %llu}",
+            values.reading.value1, values.reading.value2, values.reading.value3, values.reading.value4,
+            (unsigned long long)values.reading.timestamp);
+    fprintf(out, ",\n  \"gas\": ");
+    json_gas(out, &values.objects.gas_object);
+    fprintf(out, ",\n  \"signature\": \"%s\",\n  ", signature);
+    json_digest(out, "digest", values.digest);
+    fprintf(out, ",\n  \"next\": ");
+    json_objects(out, &values.next);
+    fprintf(out, ",\n  \"coins\": {");
+    json_id(out, "sensorObjectId", values.coins.sensor_object_id);
+    fprintf(out, ", \"sensorVersion\": \"%llu\", \"gasCoins\": [", (unsigned long long)values.coins.sensor_version);
+    for (size_t i = 0; i < values.coins.gas_count; i++) {
+        fprintf(out, i ? ", " : "");
+        json_gas(out, &values.coins.gas_objects[i]);
+    }
+    fprintf(out, "]},\n  \"coinCount\": %u", values.coin_count);
+    fprintf(out, ",\n  \"error\": {\"status\": %u, \"message\": \"%s\"}", values.error_status, values.error_message);
+    fprintf(out, ",\n  \"longError\": {\"status\": %u, \"message\": \"%s\"}\n}\n", values.error_status,
+            values.long_message);
+    return fclose(out) == 0;
+}
+
+// Frames written by the TypeScript codec parse to the same values and are
+// byte-identical to ours
+static void check_vectors(const char *dir) {
+    for (size_t n = 0; n < NUM_FRAMES; n++) {
+        uint8_t data[SENSOR_FRAME_MAX_SIZE + 1];
+        long length = read_file(dir, frame_names[n], data, sizeof(data));
+        if (length < 0) {
+            fprintf(stderr, "missing ts_%s.bin\n", frame_names[n]);
+            test_failures++;
+            continue;
+        }
+
+        sensor_frame_t frame;
+        CHECK(sensor_frame_parse(data, (size_t)length, &frame) == BCS_OK);
+        CHECK(frame.frame_length == (size_t)length);
+        check_named_frame(n, &frame);
+
+        uint8_t expected[SENSOR_FRAME_MAX_SIZE];
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, expected, sizeof(expected));
+        write_named_frame(n, &writer);
+        CHECK(writer.position == (size_t)length && memcmp(expected, data, writer.position) == 0);
+    }
+}
+
+int main(int argc, char **argv) {
+    setup_values();
+
+    if (argc == 3 && strcmp(argv[1], "--write") == 0) {
+        if (!write_vectors(argv[2])) {
+            fprintf(stderr, "cannot write vectors to %s\n", argv[2]);
+            return 1;
+        }
+        return 0;
+    }
+    if (argc == 3 && strcmp(argv[1], "--check") == 0) {
+        check_vectors(argv[2]);
+        return test_report("frame_test --check");
+    }
+
+    test_round_trip();
+    test_malformed();
+    return test_report("frame_test");
+}
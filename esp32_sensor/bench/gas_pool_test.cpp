@@ -0,0 +1,267 @@
+/**
+ * Host tests for gas_pool
+ *
+ * Walks the lease state machine: coins are handed out round robin, every
+ * lease settles exactly once, effects of another coin leave the coin
+ * UNKNOWN, READY refs expire on the unsigned millis() difference (also
+ * across the wrap), and lease IDs never come out as 0.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "gas_pool.h"
+#include <string.h>
+
+#define MAX_AGE_MS 600000
+
+// Fill the pool with coins seeded 1 .. count, fetched at now_ms
+static void fill(gas_pool_t *pool, size_t count, uint32_t now_ms) {
+    for (size_t i = 0; i < count; i++) {
+        gas_object_t gas = fixture_gas((uint8_t)(i + 1));
+        CHECK(gas_pool_put(pool, &gas, now_ms) == GAS_POOL_OK);
+    }
+}
+
+static bool same_coin(const gas_object_t *a, const gas_object_t *b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+// ============================================================================
+// Acquire and release
+// ============================================================================
+
+static void test_round_robin(void) {
+    gas_pool_t pool;
+    gas_pool_init(&pool, MAX_AGE_MS);
+    gas_object_t ref;
+    gas_pool_lease_t lease;
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_ERROR_EMPTY);
+    CHECK(lease.id == 0);
+
+    fill(&pool, GAS_POOL_MAX_COINS, 0);
+    CHECK(gas_pool_count(&pool, GAS_COIN_READY) == GAS_POOL_MAX_COINS);
+
+    // Each acquire starts after the previous coin, even when it is back
+    for (uint32_t round = 0; round < 3 * GAS_POOL_MAX_COINS; round++) {
+        CHECK(gas_pool_acquire(&pool, 1000, &ref, &lease) == GAS_POOL_OK);
+        gas_object_t expected = fixture_gas((uint8_t)(round % GAS_POOL_MAX_COINS + 1));
+        CHECK(same_coin(&ref, &expected));
+        CHECK(lease.index == round % GAS_POOL_MAX_COINS);
+        CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_OK);
+    }
+
+    // With every coin in flight there is none to give
+    gas_pool_lease_t leases[GAS_POOL_MAX_COINS];
+    for (size_t i = 0; i < GAS_POOL_MAX_COINS; i++) {
+        CHECK(gas_pool_acquire(&pool, 1000, &ref, &leases[i]) == GAS_POOL_OK);
+    }
+    CHECK(gas_pool_count(&pool, GAS_COIN_IN_FLIGHT) == GAS_POOL_MAX_COINS);
+    CHECK(gas_pool_acquire(&pool, 1000, &ref, &lease) == GAS_POOL_ERROR_EMPTY);
+
+    // Released out of order, the coins come back in slot order
+    CHECK(gas_pool_cancel(&pool, &leases[2]) == GAS_POOL_OK);
+    CHECK(gas_pool_cancel(&pool, &leases[0]) == GAS_POOL_OK);
+    CHECK(gas_pool_acquire(&pool, 1000, &ref, &lease) == GAS_POOL_OK && lease.index == 0);
+    CHECK(gas_pool_acquire(&pool, 1000, &ref, &lease) == GAS_POOL_OK && lease.index == 2);
+}
+
+static void test_stale_lease(void) {
+    gas_pool_t pool;
+    gas_pool_init(&pool, MAX_AGE_MS);
+    fill(&pool, 2, 0);
+    gas_object_t ref, next;
+    gas_pool_lease_t lease, copy;
+
+    // Release twice, with the lease and with a copy taken before
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK);
+    copy = lease;
+    next = ref;
+    next.version++;
+    CHECK(gas_pool_release(&pool, &lease, &next, 10) == GAS_POOL_OK);
+    CHECK(lease.id == 0);
+    CHECK(gas_pool_release(&pool, &lease, &next, 10) == GAS_POOL_ERROR_STALE_LEASE);
+    CHECK(gas_pool_release(&pool, &copy, &next, 10) == GAS_POOL_ERROR_STALE_LEASE);
+    CHECK(gas_pool_cancel(&pool, &copy) == GAS_POOL_ERROR_STALE_LEASE);
+
+    // Cancel twice
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK);
+    copy = lease;
+    CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_OK);
+    CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_ERROR_STALE_LEASE);
+    CHECK(gas_pool_release(&pool, &copy, NULL, 10) == GAS_POOL_ERROR_STALE_LEASE);
+
+    // An old lease of a slot that was leased again does not settle the new one
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK);
+    copy = lease;
+    CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_OK);
+    for (;;) {
+        CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK);
+        if (lease.index == copy.index) break;
+        gas_pool_cancel(&pool, &lease);
+    }
+    CHECK(lease.id != copy.id);
+    CHECK(gas_pool_release(&pool, &copy, NULL, 10) == GAS_POOL_ERROR_STALE_LEASE);
+    CHECK(gas_pool_count(&pool, GAS_COIN_IN_FLIGHT) == 1);
+    CHECK(gas_pool_release(&pool, &lease, NULL, 10) == GAS_POOL_OK);
+
+    // Leases that were never handed out
+    gas_pool_lease_t none = { 0, 0 };
+    gas_pool_lease_t out_of_range = { GAS_POOL_MAX_COINS, 1 };
+    CHECK(gas_pool_release(&pool, &none, NULL, 10) == GAS_POOL_ERROR_STALE_LEASE);
+    CHECK(gas_pool_cancel(&pool, &out_of_range) == GAS_POOL_ERROR_STALE_LEASE);
+    CHECK(gas_pool_release(&pool, NULL, NULL, 10) == GAS_POOL_ERROR_INVALID_INPUT);
+    CHECK(gas_pool_acquire(&pool, 0, NULL, &lease) == GAS_POOL_ERROR_INVALID_INPUT);
+}
+
+static void test_release_other_coin(void) {
+    gas_pool_t pool;
+    gas_pool_init(&pool, MAX_AGE_MS);
+    fill(&pool, 1, 0);
+    gas_object_t ref;
+    gas_pool_lease_t lease;
+
+    // Effects of this coin: READY with the new ref
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK);
+    gas_object_t next = ref;
+    next.version += 1;
+    next.digest[0] ^= 0xFF;
+    CHECK(gas_pool_release(&pool, &lease, &next, 500) == GAS_POOL_OK);
+    CHECK(gas_pool_acquire(&pool, 600, &ref, &lease) == GAS_POOL_OK && same_coin(&ref, &next));
+
+    // Effects naming another object: the coin's version is now unknown,
+    // and the other object is not taken into the pool
+    gas_object_t other = fixture_gas(0x70);
+    CHECK(gas_pool_release(&pool, &lease, &other, 700) == GAS_POOL_OK);
+    CHECK(gas_pool_count(&pool, GAS_COIN_UNKNOWN) == 1);
+    CHECK(gas_pool_count(&pool, GAS_COIN_READY) == 0);
+    CHECK(gas_pool_acquire(&pool, 800, &ref, &lease) == GAS_POOL_ERROR_EMPTY);
+
+    // No effects at all: the same
+    gas_object_t fetched = next;
+    fetched.version += 1;
+    CHECK(gas_pool_put(&pool, &fetched, 900) == GAS_POOL_OK);
+    CHECK(gas_pool_acquire(&pool, 900, &ref, &lease) == GAS_POOL_OK && same_coin(&ref, &fetched));
+    CHECK(gas_pool_release(&pool, &lease, NULL, 1000) == GAS_POOL_OK);
+    CHECK(gas_pool_count(&pool, GAS_COIN_UNKNOWN) == 1);
+}
+
+// ============================================================================
+// Expiry
+// ============================================================================
+
+static void test_expiry(void) {
+    for (int k = 0; k < 3; k++) {
+        // From 0, across the wrap, and ending exactly at it
+        const uint32_t starts[] = { 0, 0xFFFFFFFFu - MAX_AGE_MS / 2, 0u - MAX_AGE_MS };
+        uint32_t start = starts[k];
+        gas_pool_t pool;
+        gas_pool_init(&pool, MAX_AGE_MS);
+        fill(&pool, 1, start);
+        gas_object_t ref;
+        gas_pool_lease_t lease;
+
+        CHECK(gas_pool_acquire(&pool, start + MAX_AGE_MS, &ref, &lease) == GAS_POOL_OK);
+        CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_OK);
+        CHECK(gas_pool_acquire(&pool, start + MAX_AGE_MS + 1, &ref, &lease) == GAS_POOL_ERROR_EMPTY);
+        CHECK(gas_pool_count(&pool, GAS_COIN_UNKNOWN) == 1);
+
+        // A release restarts the age from the release time
+        fill(&pool, 1, start);
+        CHECK(gas_pool_acquire(&pool, start + 1000, &ref, &lease) == GAS_POOL_OK);
+        CHECK(gas_pool_release(&pool, &lease, &ref, start + MAX_AGE_MS) == GAS_POOL_OK);
+        CHECK(gas_pool_acquire(&pool, start + 2 * MAX_AGE_MS, &ref, &lease) == GAS_POOL_OK);
+        CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_OK);
+        CHECK(gas_pool_acquire(&pool, start + 2 * MAX_AGE_MS + 1, &ref, &lease) == GAS_POOL_ERROR_EMPTY);
+    }
+
+    // No limit: a ref older than half the clock range is still good
+    gas_pool_t pool;
+    gas_pool_init(&pool, 0);
+    fill(&pool, 1, 5);
+    gas_object_t ref;
+    gas_pool_lease_t lease;
+    CHECK(gas_pool_acquire(&pool, 0x90000000u, &ref, &lease) == GAS_POOL_OK);
+}
+
+// ============================================================================
+// Put
+// ============================================================================
+
+static void test_put(void) {
+    gas_pool_t pool;
+    gas_pool_init(&pool, MAX_AGE_MS);
+    fill(&pool, 2, 0);
+    gas_object_t ref;
+    gas_pool_lease_t lease;
+
+    // A fetch of a coin in flight may predate the transaction: ignored
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK);
+    gas_object_t fetched = ref;
+    fetched.version -= 1;
+    CHECK(gas_pool_put(&pool, &fetched, 100) == GAS_POOL_OK);
+    CHECK(gas_pool_count(&pool, GAS_COIN_IN_FLIGHT) == 1);
+    CHECK(same_coin(&pool.coins[lease.index].ref, &ref));
+    CHECK(pool.coins[lease.index].lease_id == lease.id);
+    CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_OK);
+    CHECK(same_coin(&pool.coins[lease.index].ref, &ref));
+
+    // Refreshing a READY coin updates it in place
+    fetched.version += 5;
+    CHECK(gas_pool_put(&pool, &fetched, 200) == GAS_POOL_OK);
+    CHECK(gas_pool_count(&pool, GAS_COIN_READY) == 2);
+    CHECK(same_coin(&pool.coins[0].ref, &fetched) && pool.coins[0].updated_ms == 200);
+
+    // Full of READY and in-flight coins: no room
+    fill(&pool, GAS_POOL_MAX_COINS, 300);
+    gas_object_t extra = fixture_gas(0x60);
+    CHECK(gas_pool_put(&pool, &extra, 300) == GAS_POOL_ERROR_FULL);
+    CHECK(gas_pool_put(NULL, &extra, 300) == GAS_POOL_ERROR_INVALID_INPUT);
+
+    // Full, but slot 2 went UNKNOWN: the new coin takes that slot
+    gas_pool_lease_t leases[3];
+    for (size_t i = 0; i < 3; i++) {
+        CHECK(gas_pool_acquire(&pool, 400, &ref, &leases[i]) == GAS_POOL_OK);
+        CHECK(leases[i].index == i + 1);
+    }
+    CHECK(gas_pool_release(&pool, &leases[1], NULL, 500) == GAS_POOL_OK);
+    CHECK(gas_pool_count(&pool, GAS_COIN_UNKNOWN) == 1);
+    CHECK(gas_pool_put(&pool, &extra, 600) == GAS_POOL_OK);
+    CHECK(same_coin(&pool.coins[2].ref, &extra) && pool.coins[2].state == GAS_COIN_READY);
+    CHECK(gas_pool_count(&pool, GAS_COIN_UNKNOWN) == 0);
+}
+
+// ============================================================================
+// Lease IDs
+// ============================================================================
+
+static void test_lease_id_wrap(void) {
+    gas_pool_t pool;
+    gas_pool_init(&pool, MAX_AGE_MS);
+    fill(&pool, 2, 0);
+    gas_object_t ref;
+    gas_pool_lease_t lease;
+
+    pool.next_lease_id = 0xFFFFFFFEu;
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK && lease.id == 0xFFFFFFFEu);
+    CHECK(gas_pool_cancel(&pool, &lease) == GAS_POOL_OK);
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK && lease.id == 0xFFFFFFFFu);
+    gas_pool_lease_t last = lease;
+
+    // 0 means "no lease", so the counter goes from 0xFFFFFFFF to 1
+    CHECK(pool.next_lease_id == 1);
+    CHECK(gas_pool_acquire(&pool, 0, &ref, &lease) == GAS_POOL_OK && lease.id == 1);
+    CHECK(gas_pool_release(&pool, &last, NULL, 0) == GAS_POOL_OK);
+    CHECK(gas_pool_release(&pool, &lease, NULL, 0) == GAS_POOL_OK);
+}
+
+int main() {
+    test_round_robin();
+    test_stale_lease();
+    test_release_other_coin();
+    test_expiry();
+    test_put();
+    test_lease_id_wrap();
+    return test_report("gas_pool_test");
+}
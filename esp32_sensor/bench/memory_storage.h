@@ -0,0 +1,141 @@
+/**
+ * Memory Storage
+ * In-memory reading_log_storage_t for the host tests and benchmarks
+ *
+ * Every byte written to a segment or cursor slot is charged against an
+ * optional budget. When the budget runs out the write in progress is
+ * torn at that byte and the storage goes dead: later calls change nothing
+ * and fail, as if power was cut. Clearing dead "reboots" the device with
+ * whatever reached storage.
+ *
+ * Segment N lives in slot N % MEMORY_STORAGE_SEGMENTS, which is enough as
+ * long as fewer segments than that exist at once.
+ */
+
+#ifndef MEMORY_STORAGE_H
+#define MEMORY_STORAGE_H
+
+#include "reading_log.h"
+#include <string.h>
+
+#define MEMORY_STORAGE_SEGMENTS 64
+#define MEMORY_STORAGE_SEGMENT_SIZE 8192
+#define MEMORY_STORAGE_CURSOR_SIZE 32
+
+typedef struct {
+    uint8_t segments[MEMORY_STORAGE_SEGMENTS][MEMORY_STORAGE_SEGMENT_SIZE];
+    long segment_length[MEMORY_STORAGE_SEGMENTS];   // -1 = segment does not exist
+    uint8_t cursors[2][MEMORY_STORAGE_CURSOR_SIZE];
+    long cursor_length[2];                          // -1 = slot does not exist
+    bool limited;                                   // Budget applies
+    size_t budget;                                  // Bytes left before the power cut
+    size_t written;                                 // Bytes written so far
+    bool dead;                                      // Power is cut
+} memory_storage_t;
+
+// Bytes of a length-byte write that reach storage before the power cut
+static inline size_t memory_storage_charge(memory_storage_t *mem, size_t length) {
+    if (mem->limited && length > mem->budget) {
+        length = mem->budget;
+        mem->dead = true;
+    }
+    if (mem->limited) {
+        mem->budget -= length;
+    }
+    mem->written += length;
+    return length;
+}
+
+static inline int memory_append(void *ctx, uint32_t segment, const uint8_t *data, size_t length) {
+    memory_storage_t *mem = (memory_storage_t *)ctx;
+    if (mem->dead) return -1;
+
+    segment %= MEMORY_STORAGE_SEGMENTS;
+    long *size = &mem->segment_length[segment];
+    if (*size < 0) *size = 0;
+    if ((size_t)*size + length > MEMORY_STORAGE_SEGMENT_SIZE) return -1;
+
+    size_t stored = memory_storage_charge(mem, length);
+    memcpy(mem->segments[segment] + *size, data, stored);
+    *size += (long)stored;
+    return stored == length ? 0 : -1;
+}
+
+static inline long memory_read(void *ctx, uint32_t segment, size_t offset, uint8_t *data, size_t length) {
+    memory_storage_t *mem = (memory_storage_t *)ctx;
+    segment %= MEMORY_STORAGE_SEGMENTS;
+    if (mem->dead || mem->segment_length[segment] < 0) return -1;
+
+    size_t size = (size_t)mem->segment_length[segment];
+    if (offset >= size) return 0;
+    if (length > size - offset) length = size - offset;
+    memcpy(data, mem->segments[segment] + offset, length);
+    return (long)length;
+}
+
+static inline int memory_truncate(void *ctx, uint32_t segment, size_t length) {
+    memory_storage_t *mem = (memory_storage_t *)ctx;
+    if (mem->dead) return -1;
+
+    segment %= MEMORY_STORAGE_SEGMENTS;
+    if (mem->segment_length[segment] > (long)length) {
+        mem->segment_length[segment] = (long)length;
+    }
+    return 0;
+}
+
+static inline int memory_remove(void *ctx, uint32_t segment) {
+    memory_storage_t *mem = (memory_storage_t *)ctx;
+    segment %= MEMORY_STORAGE_SEGMENTS;
+    if (mem->dead || mem->segment_length[segment] < 0) return -1;
+
+    mem->segment_length[segment] = -1;
+    return 0;
+}
+
+static inline int memory_sync(void *ctx, uint32_t segment) {
+    (void)segment;
+    return ((memory_storage_t *)ctx)->dead ? -1 : 0;
+}
+
+static inline long memory_read_cursor(void *ctx, int slot, uint8_t *data, size_t length) {
+    memory_storage_t *mem = (memory_storage_t *)ctx;
+    if (mem->dead || mem->cursor_length[slot] < 0) return -1;
+
+    if (length > (size_t)mem->cursor_length[slot]) length = (size_t)mem->cursor_length[slot];
+    memcpy(data, mem->cursors[slot], length);
+    return (long)length;
+}
+
+// Replaces the slot; a torn write leaves only the bytes that made it
+static inline int memory_write_cursor(void *ctx, int slot, const uint8_t *data, size_t length) {
+    memory_storage_t *mem = (memory_storage_t *)ctx;
+    if (mem->dead || length > MEMORY_STORAGE_CURSOR_SIZE) return -1;
+
+    size_t stored = memory_storage_charge(mem, length);
+    memcpy(mem->cursors[slot], data, stored);
+    mem->cursor_length[slot] = (long)stored;
+    return stored == length ? 0 : -1;
+}
+
+static inline void memory_storage_init(memory_storage_t *mem, reading_log_storage_t *storage) {
+    for (int i = 0; i < MEMORY_STORAGE_SEGMENTS; i++) {
+        mem->segment_length[i] = -1;
+    }
+    mem->cursor_length[0] = mem->cursor_length[1] = -1;
+    mem->limited = false;
+    mem->budget = 0;
+    mem->written = 0;
+    mem->dead = false;
+
+    storage->ctx = mem;
+    storage->append = memory_append;
+    storage->read = memory_read;
+    storage->truncate = memory_truncate;
+    storage->remove = memory_remove;
+    storage->sync = memory_sync;
+    storage->read_cursor = memory_read_cursor;
+    storage->write_cursor = memory_write_cursor;
+}
+
+#endif // MEMORY_STORAGE_H
@@ -0,0 +1,106 @@
+/**
+ * Reading Log Benchmarks
+ * Append, peek and commit on in-memory and file storage
+ *
+ * The file benchmarks run in a temporary directory, so they measure the
+ * host filesystem (fsync included), not flash; compare them with each
+ * other rather than with the ESP32.
+ *
+ * Usage: reading_log_bench [--quick] [filter] > results.json
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "memory_storage.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RECORDS_PER_SEGMENT 256  // As in the sketches
+#define MAX_SEGMENTS 16
+#define COMMIT_BATCH 64
+
+typedef struct {
+    reading_log_t log;
+    uint32_t counter;
+    uint32_t failures;            // Calls that did not return READING_LOG_OK
+} log_bench_t;
+
+static memory_storage_t mem;
+static reading_log_file_storage_t files;
+
+// One append; every COMMIT_BATCH appends the batch is committed, as after
+// a successful submission, so the log never fills up
+static void append(void *ctx) {
+    log_bench_t *bench = (log_bench_t *)ctx;
+    sensor_data_t reading = fixture_reading(bench->counter++);
+    if (reading_log_append(&bench->log, &reading) != READING_LOG_OK) {
+        bench->failures++;
+    }
+    if (reading_log_pending(&bench->log) >= COMMIT_BATCH &&
+        reading_log_commit(&bench->log, COMMIT_BATCH) != READING_LOG_OK) {
+        bench->failures++;
+    }
+}
+
+// Read a 16-reading replay batch from a log holding COMMIT_BATCH readings
+static void peek16(void *ctx) {
+    log_bench_t *bench = (log_bench_t *)ctx;
+    sensor_data_t readings[16];
+    size_t count;
+    if (reading_log_peek_at(&bench->log, bench->counter++ % (COMMIT_BATCH - 16), readings, 16, &count) !=
+            READING_LOG_OK || count != 16) {
+        bench->failures++;
+    }
+    bench_consume(readings);
+}
+
+static void fill(log_bench_t *bench) {
+    for (uint32_t i = 0; i < COMMIT_BATCH; i++) {
+        sensor_data_t reading = fixture_reading(i);
+        if (reading_log_append(&bench->log, &reading) != READING_LOG_OK) {
+            bench->failures++;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    bench_begin("reading_log", argc, argv);
+
+    reading_log_storage_t storage;
+    log_bench_t bench;
+    memset(&bench, 0, sizeof(bench));
+
+    memory_storage_init(&mem, &storage);
+    reading_log_open(&bench.log, &storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS);
+    bench_run("append_memory", append, &bench);
+    memory_storage_init(&mem, &storage);
+    reading_log_open(&bench.log, &storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS);
+    fill(&bench);
+    bench_run("peek16_memory", peek16, &bench);
+
+    char dir[] = "/tmp/reading_log_benchXXXXXX";
+    if (!mkdtemp(dir) || reading_log_file_storage_init(&files, dir, &storage) != READING_LOG_OK) {
+        fprintf(stderr, "cannot create %s\n", dir);
+        return 1;
+    }
+    reading_log_open(&bench.log, &storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS);
+    bench_run("append_file", append, &bench);
+    reading_log_commit(&bench.log, reading_log_pending(&bench.log));
+    fill(&bench);
+    bench_run("peek16_file", peek16, &bench);
+    reading_log_file_storage_close(&files);
+
+    char command[128];
+    snprintf(command, sizeof(command), "rm -rf %s", dir);
+    if (system(command) != 0) {
+        fprintf(stderr, "cannot remove %s\n", dir);
+    }
+
+    int status = bench_end();
+    if (bench.failures) {
+        fprintf(stderr, "%u log call(s) failed\n", (unsigned)bench.failures);
+        return 1;
+    }
+    return status;
+}
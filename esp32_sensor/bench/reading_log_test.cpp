@@ -0,0 +1,175 @@
+/**
+ * Host tests for reading_log
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "memory_storage.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RECORDS_PER_SEGMENT 4
+#define MAX_SEGMENTS 8
+#define NUM_READINGS 40
+#define SUBMIT_EVERY 3
+#define SUBMIT_BATCH 2
+
+static memory_storage_t mem;
+
+typedef struct {
+    bool acked[NUM_READINGS];       // reading_log_append() returned OK
+    bool delivered[NUM_READINGS];   // Seen by a peek, before or after the reset
+} delivery_t;
+
+static void mark_delivered(delivery_t *run, const sensor_data_t *readings, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t n = (readings[i].timestamp - fixture_reading(0).timestamp) / 60;
+        CHECK(n < NUM_READINGS);
+        if (n < NUM_READINGS) {
+            sensor_data_t expected = fixture_reading((uint32_t)n);
+            CHECK(memcmp(&readings[i], &expected, sizeof(expected)) == 0);
+            run->delivered[n] = true;
+        }
+    }
+}
+
+// Log readings and submit them in batches until the storage dies
+static void run_workload(const reading_log_storage_t *storage, delivery_t *run) {
+    reading_log_t log;
+    if (reading_log_open(&log, storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS) != READING_LOG_OK) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < NUM_READINGS; i++) {
+        sensor_data_t reading = fixture_reading(i);
+        if (reading_log_append(&log, &reading) != READING_LOG_OK) {
+            return;
+        }
+        run->acked[i] = true;
+
+        if (i % SUBMIT_EVERY == SUBMIT_EVERY - 1) {
+            sensor_data_t batch[SUBMIT_BATCH];
+            size_t count = 0;
+            if (reading_log_peek(&log, batch, SUBMIT_BATCH, &count) != READING_LOG_OK) {
+                return;
+            }
+            // Submitted: on chain even if the commit below never lands
+            mark_delivered(run, batch, count);
+            if (reading_log_commit(&log, count) != READING_LOG_OK) {
+                return;
+            }
+        }
+    }
+}
+
+// Reboot and submit everything left in the log
+static void drain(const reading_log_storage_t *storage, delivery_t *run) {
+    reading_log_t log;
+    CHECK(reading_log_open(&log, storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS) == READING_LOG_OK);
+
+    while (reading_log_pending(&log) > 0) {
+        sensor_data_t batch[SUBMIT_BATCH];
+        size_t count = 0;
+        CHECK(reading_log_peek(&log, batch, SUBMIT_BATCH, &count) == READING_LOG_OK);
+        CHECK(count > 0);
+        if (count == 0) {
+            break;
+        }
+        mark_delivered(run, batch, count);
+        CHECK(reading_log_commit(&log, count) == READING_LOG_OK);
+    }
+
+    // A second reboot finds nothing pending and appends still work
+    CHECK(reading_log_open(&log, storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS) == READING_LOG_OK);
+    CHECK(reading_log_pending(&log) == 0);
+    sensor_data_t reading = fixture_reading(0);
+    CHECK(reading_log_append(&log, &reading) == READING_LOG_OK);
+}
+
+// Cut power after every byte offset of the workload's writes; every reading
+// whose append was acknowledged must be delivered at least once
+static void test_power_loss(void) {
+    reading_log_storage_t storage;
+
+    memory_storage_init(&mem, &storage);
+    delivery_t full;
+    memset(&full, 0, sizeof(full));
+    run_workload(&storage, &full);
+    size_t total = mem.written;
+    drain(&storage, &full);
+    for (uint32_t i = 0; i < NUM_READINGS; i++) {
+        CHECK(full.acked[i] && full.delivered[i]);
+    }
+
+    for (size_t cut = 0; cut <= total; cut++) {
+        memory_storage_init(&mem, &storage);
+        mem.limited = true;
+        mem.budget = cut;
+
+        delivery_t run;
+        memset(&run, 0, sizeof(run));
+        run_workload(&storage, &run);
+
+        mem.limited = false;
+        mem.dead = false;
+        drain(&storage, &run);
+
+        for (uint32_t i = 0; i < NUM_READINGS; i++) {
+            if (run.acked[i] && !run.delivered[i]) {
+                fprintf(stderr, "cut at byte %zu: reading %u lost\n", cut, (unsigned)i);
+                test_failures++;
+            }
+        }
+    }
+}
+
+// Readings survive closing the storage and reopening the log from disk
+static void test_file_storage(void) {
+    char dir[] = "/tmp/reading_log_testXXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+
+    reading_log_file_storage_t fs;
+    reading_log_storage_t storage;
+    reading_log_t log;
+    CHECK(reading_log_file_storage_init(&fs, dir, &storage) == READING_LOG_OK);
+    CHECK(reading_log_open(&log, &storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS) == READING_LOG_OK);
+
+    for (uint32_t i = 0; i < 10; i++) {
+        sensor_data_t reading = fixture_reading(i);
+        CHECK(reading_log_append(&log, &reading) == READING_LOG_OK);
+    }
+    // Peeking the open tail segment sees the buffered appends
+    sensor_data_t readings[10];
+    size_t count = 0;
+    CHECK(reading_log_peek(&log, readings, 10, &count) == READING_LOG_OK);
+    CHECK(count == 10);
+    CHECK(reading_log_commit(&log, 6) == READING_LOG_OK);
+    reading_log_file_storage_close(&fs);
+
+    CHECK(reading_log_file_storage_init(&fs, dir, &storage) == READING_LOG_OK);
+    CHECK(reading_log_open(&log, &storage, RECORDS_PER_SEGMENT, MAX_SEGMENTS) == READING_LOG_OK);
+    CHECK(reading_log_pending(&log) == 4);
+    CHECK(reading_log_peek(&log, readings, 10, &count) == READING_LOG_OK);
+    CHECK(count == 4);
+    CHECK(readings[0].timestamp == fixture_reading(6).timestamp);
+
+    // Appends continue the sequence in the reopened tail segment
+    sensor_data_t reading = fixture_reading(10);
+    CHECK(reading_log_append(&log, &reading) == READING_LOG_OK);
+    CHECK(reading_log_commit(&log, 5) == READING_LOG_OK);
+    CHECK(reading_log_pending(&log) == 0);
+    reading_log_file_storage_close(&fs);
+
+    char command[128];
+    snprintf(command, sizeof(command), "rm -rf %s", dir);
+    CHECK(system(command) == 0);
+}
+
+int main() {
+    test_power_loss();
+    test_file_storage();
+    return test_report("reading_log_test");
+}
@@ -0,0 +1,289 @@
+/**
+ * Host tests for rtc_snapshot
+ *
+ * A snapshot is saved, copied as RTC memory would keep it and checked the
+ * way a wake does: corrupted, foreign and stale snapshots must be
+ * rejected, a restored template must be byte-identical to a fresh compile
+ * (before and after patching), and restored coins must age correctly
+ * although millis() starts again from 0 after the wake.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "rtc_snapshot.h"
+#include <string.h>
+
+#define MAX_AGE_MS 600000       // Gas pool ref lifetime
+#define SLEEP_MS 300000
+
+static const char *const config_fields[] = { "suiprivkey1...", "0x2f5c...", "sensor_storage", "store_sensor_data" };
+
+static uint32_t config_hash(void) {
+    return rtc_snapshot_config_hash(config_fields, sizeof(config_fields) / sizeof(config_fields[0]));
+}
+
+static void fixture_identity(rtc_snapshot_identity_t *identity) {
+    memset(identity, 0, sizeof(*identity));
+    fixture_bytes(identity->sender, sizeof(identity->sender), 0x33);
+    fixture_bytes(identity->package_id, sizeof(identity->package_id), 0x11);
+    bcs_bytes_to_hex(identity->sender, sizeof(identity->sender), identity->address + 2);
+    identity->address[0] = '0';
+    identity->address[1] = 'x';
+}
+
+// ============================================================================
+// Validation
+// ============================================================================
+
+static void test_config_hash(void) {
+    const char *a[] = { "ab", "c" };
+    const char *b[] = { "a", "bc" };
+    const char *with_null[] = { "ab", NULL };
+    const char *with_empty[] = { "ab", "" };
+    CHECK(rtc_snapshot_config_hash(a, 2) != rtc_snapshot_config_hash(b, 2));
+    CHECK(rtc_snapshot_config_hash(with_null, 2) == rtc_snapshot_config_hash(with_empty, 2));
+    CHECK(rtc_snapshot_config_hash(a, 1) != rtc_snapshot_config_hash(with_empty, 2));
+
+    const char *other_key[] = { "suiprivkey2...", "0x2f5c...", "sensor_storage", "store_sensor_data" };
+    CHECK(rtc_snapshot_config_hash(other_key, 4) != config_hash());
+}
+
+static void test_check(void) {
+    static rtc_snapshot_t snapshot, copy;
+    rtc_snapshot_identity_t identity;
+    fixture_identity(&identity);
+    gas_pool_t pool;
+    gas_pool_init(&pool, MAX_AGE_MS);
+    gas_object_t gas = fixture_gas(1);
+    CHECK(gas_pool_put(&pool, &gas, 1000) == GAS_POOL_OK);
+    uint8_t sensor_id[32];
+    fixture_bytes(sensor_id, sizeof(sensor_id), 0x22);
+
+    // Power-on garbage, and memory that was never written
+    memset(&snapshot, 0xA5, sizeof(snapshot));
+    CHECK(rtc_snapshot_check(&snapshot, config_hash()) == RTC_SNAPSHOT_ERROR_EMPTY);
+    memset(&snapshot, 0, sizeof(snapshot));
+    CHECK(rtc_snapshot_check(&snapshot, config_hash()) == RTC_SNAPSHOT_ERROR_EMPTY);
+    CHECK(rtc_snapshot_check(NULL, config_hash()) == RTC_SNAPSHOT_ERROR_INVALID_INPUT);
+    CHECK(rtc_snapshot_save(&snapshot, config_hash(), NULL, NULL, NULL, 0, &pool, 0, 0) ==
+          RTC_SNAPSHOT_ERROR_INVALID_INPUT);
+
+    CHECK(rtc_snapshot_save(&snapshot, config_hash(), &identity, NULL, sensor_id, 5882390, &pool, 2000, SLEEP_MS) ==
+          RTC_SNAPSHOT_OK);
+    CHECK(rtc_snapshot_check(&snapshot, config_hash()) == RTC_SNAPSHOT_OK);
+    CHECK(memcmp(&snapshot.identity, &identity, sizeof(identity)) == 0);
+    CHECK(snapshot.sensor_valid && snapshot.sensor_version == 5882390);
+    CHECK(snapshot.coin_count == 1 && snapshot.coins[0].age_ms == 1000);
+
+    // Another key or package
+    const char *other[] = { "suiprivkey1...", "0x9999...", "sensor_storage", "store_sensor_data" };
+    CHECK(rtc_snapshot_check(&snapshot, rtc_snapshot_config_hash(other, 4)) == RTC_SNAPSHOT_ERROR_CONFIG);
+
+    // Another layout
+    memcpy(&copy, &snapshot, sizeof(copy));
+    copy.version = RTC_SNAPSHOT_VERSION + 1;
+    CHECK(rtc_snapshot_check(&copy, config_hash()) == RTC_SNAPSHOT_ERROR_VERSION);
+    memcpy(&copy, &snapshot, sizeof(copy));
+    copy.size = (uint16_t)(sizeof(copy) - 8);
+    CHECK(rtc_snapshot_check(&copy, config_hash()) == RTC_SNAPSHOT_ERROR_VERSION);
+
+    // Any flipped bit past the header fails the checksum, including a
+    // reset part way through the save
+    size_t bad = 0;
+    for (size_t offset = offsetof(rtc_snapshot_t, config_hash); offset < sizeof(copy); offset++) {
+        for (int bit = 0; bit < 8; bit += 3) {
+            memcpy(&copy, &snapshot, sizeof(copy));
+            ((uint8_t *)&copy)[offset] ^= (uint8_t)(1u << bit);
+            bad += rtc_snapshot_check(&copy, config_hash()) != RTC_SNAPSHOT_ERROR_EMPTY;
+        }
+    }
+    CHECK(bad == 0);
+    memcpy(&copy, &snapshot, sizeof(copy));
+    copy.magic ^= 1;
+    CHECK(rtc_snapshot_check(&copy, config_hash()) == RTC_SNAPSHOT_ERROR_EMPTY);
+
+    rtc_snapshot_invalidate(&snapshot);
+    CHECK(rtc_snapshot_check(&snapshot, config_hash()) == RTC_SNAPSHOT_ERROR_EMPTY);
+
+    // A template that does not fit leaves the snapshot invalid
+    static uint8_t large[RTC_SNAPSHOT_TEMPLATE_SIZE + 1];
+    sui_sensor_template_t tpl;
+    memset(&tpl, 0, sizeof(tpl));
+    bcs_writer_init_fixed(&tpl.writer, large, sizeof(large));
+    tpl.writer.position = sizeof(large);
+    CHECK(rtc_snapshot_save(&snapshot, config_hash(), &identity, &tpl, NULL, 0, &pool, 2000, 0) ==
+          RTC_SNAPSHOT_ERROR_TOO_LARGE);
+    CHECK(rtc_snapshot_check(&snapshot, config_hash()) != RTC_SNAPSHOT_OK);
+}
+
+// ============================================================================
+// Template
+// ============================================================================
+
+static void check_same_template(const sui_sensor_template_t *a, const sui_sensor_template_t *b) {
+    size_t a_length, b_length;
+    const uint8_t *a_bytes = sui_sensor_template_bytes(a, &a_length);
+    const uint8_t *b_bytes = sui_sensor_template_bytes(b, &b_length);
+    CHECK(a_length == b_length && memcmp(a_bytes, b_bytes, a_length) == 0);
+    CHECK(memcmp(a->reading_offsets, b->reading_offsets, sizeof(a->reading_offsets)) == 0);
+    CHECK(a->gas_object_id_offset == b->gas_object_id_offset);
+    CHECK(a->gas_version_offset == b->gas_version_offset);
+    CHECK(a->gas_digest_offset == b->gas_digest_offset);
+    CHECK(a->gas_price_offset == b->gas_price_offset);
+    CHECK(a->gas_budget_offset == b->gas_budget_offset);
+}
+
+static void test_template_round_trip(void) {
+    static rtc_snapshot_t snapshot, rtc;
+    transaction_builder_t params;
+    fixture_params(&params);
+    rtc_snapshot_identity_t identity;
+    fixture_identity(&identity);
+    gas_pool_t pool;
+    gas_pool_init(&pool, MAX_AGE_MS);
+
+    // Before sleep: compile and patch a few cycles, then save
+    uint8_t before_buffer[RTC_SNAPSHOT_TEMPLATE_SIZE];
+    sui_sensor_template_t before;
+    CHECK(sui_compile_sensor_template(&params, before_buffer, sizeof(before_buffer), &before) == BCS_OK);
+    for (uint32_t i = 1; i < 4; i++) {
+        sensor_data_t reading = fixture_reading(i);
+        gas_object_t gas = fixture_gas((uint8_t)i);
+        sui_sensor_template_set_sensor_data(&before, &reading);
+        sui_sensor_template_set_gas_object(&before, &gas);
+    }
+    CHECK(rtc_snapshot_save(&snapshot, config_hash(), &identity, &before, NULL, 0, &pool, 0, SLEEP_MS) ==
+          RTC_SNAPSHOT_OK);
+    memcpy(&rtc, &snapshot, sizeof(rtc));
+    memset(before_buffer, 0, sizeof(before_buffer));   // Main RAM is lost
+
+    // After the wake: restore, and compile afresh for comparison
+    CHECK(rtc_snapshot_check(&rtc, config_hash()) == RTC_SNAPSHOT_OK);
+    CHECK(!rtc.sensor_valid && rtc.coin_count == 0);
+    uint8_t restored_buffer[RTC_SNAPSHOT_TEMPLATE_SIZE], fresh_buffer[RTC_SNAPSHOT_TEMPLATE_SIZE];
+    sui_sensor_template_t restored, fresh;
+    uint8_t small[64];
+    CHECK(rtc_snapshot_restore_template(&rtc, small, sizeof(small), &restored) == RTC_SNAPSHOT_ERROR_TOO_LARGE);
+    CHECK(rtc_snapshot_restore_template(&rtc, restored_buffer, sizeof(restored_buffer), &restored) ==
+          RTC_SNAPSHOT_OK);
+
+    params.sensor_data = fixture_reading(3);
+    params.gas_object = fixture_gas(3);
+    CHECK(sui_compile_sensor_template(&params, fresh_buffer, sizeof(fresh_buffer), &fresh) == BCS_OK);
+    check_same_template(&restored, &fresh);
+
+    // And they stay identical, to each other and to a full build, as the
+    // next cycles patch them
+    uint8_t built[RTC_SNAPSHOT_TEMPLATE_SIZE];
+    for (uint32_t i = 4; i < 64; i++) {
+        sensor_data_t reading = fixture_reading(i * 13);
+        gas_object_t gas = fixture_gas((uint8_t)(i * 7));
+        sui_sensor_template_set_sensor_data(&restored, &reading);
+        sui_sensor_template_set_gas_object(&restored, &gas);
+        sui_sensor_template_set_sensor_data(&fresh, &reading);
+        sui_sensor_template_set_gas_object(&fresh, &gas);
+        check_same_template(&restored, &fresh);
+
+        params.sensor_data = reading;
+        params.gas_object = gas;
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, built, sizeof(built));
+        CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+        size_t length;
+        const uint8_t *bytes = sui_sensor_template_bytes(&restored, &length);
+        CHECK(writer.position == length && memcmp(built, bytes, length) == 0);
+    }
+
+    // No template saved
+    CHECK(rtc_snapshot_save(&snapshot, config_hash(), &identity, NULL, NULL, 0, &pool, 0, 0) == RTC_SNAPSHOT_OK);
+    CHECK(rtc_snapshot_restore_template(&snapshot, restored_buffer, sizeof(restored_buffer), &restored) ==
+          RTC_SNAPSHOT_ERROR_EMPTY);
+}
+
+// ============================================================================
+// Gas coin ageing
+// ============================================================================
+
+// Whether the coin with the given seed can be acquired at now_ms
+static bool coin_ready(gas_pool_t *pool, uint8_t seed, uint32_t now_ms) {
+    gas_pool_t probe = *pool;
+    gas_object_t ref, want = fixture_gas(seed);
+    gas_pool_lease_t lease;
+    while (gas_pool_acquire(&probe, now_ms, &ref, &lease) == GAS_POOL_OK) {
+        if (memcmp(ref.object_id, want.object_id, sizeof(want.object_id)) == 0) {
+            return ref.version == want.version;
+        }
+    }
+    return false;
+}
+
+static void test_gas_ageing(void) {
+    static rtc_snapshot_t snapshot;
+    rtc_snapshot_identity_t identity;
+    fixture_identity(&identity);
+
+    // Saved after 10 minutes of uptime, and after 49.7 days (millis() about
+    // to wrap); in both cases millis() restarts near 0 after the wake
+    const uint32_t save_times[] = { 600000, 0xFFFFFFF0u };
+    for (size_t t = 0; t < 2; t++) {
+        uint32_t save_ms = save_times[t];
+
+        // Coins last known current 100 s, 250 s and 350 s before the save,
+        // and one in flight, which is not kept
+        gas_pool_t pool;
+        gas_pool_init(&pool, MAX_AGE_MS);
+        gas_object_t coins[4];
+        for (uint8_t i = 0; i < 4; i++) {
+            coins[i] = fixture_gas(i);
+        }
+        CHECK(gas_pool_put(&pool, &coins[0], save_ms - 100000) == GAS_POOL_OK);
+        CHECK(gas_pool_put(&pool, &coins[1], save_ms - 250000) == GAS_POOL_OK);
+        CHECK(gas_pool_put(&pool, &coins[2], save_ms - 350000) == GAS_POOL_OK);
+        CHECK(gas_pool_put(&pool, &coins[3], save_ms - 1000) == GAS_POOL_OK);
+        gas_object_t ref;
+        gas_pool_lease_t lease;
+        while (gas_pool_acquire(&pool, save_ms, &ref, &lease) == GAS_POOL_OK &&
+               memcmp(ref.object_id, coins[3].object_id, 32) != 0) {
+            gas_pool_cancel(&pool, &lease);
+        }
+        CHECK(gas_pool_count(&pool, GAS_COIN_IN_FLIGHT) == 1);
+
+        CHECK(rtc_snapshot_save(&snapshot, config_hash(), &identity, NULL, NULL, 0, &pool, save_ms, SLEEP_MS) ==
+              RTC_SNAPSHOT_OK);
+        CHECK(snapshot.coin_count == 3);
+
+        // Wake 120 ms after reset; now_ms - age wraps below 0. With the
+        // 300 s sleep the coins are 400 s, 550 s and 650 s old: the last is
+        // past the 600 s limit and dropped
+        const uint32_t wake_ms = 120;
+        gas_pool_t restored;
+        gas_pool_init(&restored, MAX_AGE_MS);
+        CHECK(rtc_snapshot_check(&snapshot, config_hash()) == RTC_SNAPSHOT_OK);
+        CHECK(rtc_snapshot_restore_gas(&snapshot, &restored, wake_ms) == 2);
+        CHECK(gas_pool_count(&restored, GAS_COIN_READY) == 2);
+        CHECK(coin_ready(&restored, 0, wake_ms));
+        CHECK(coin_ready(&restored, 1, wake_ms));
+        CHECK(!coin_ready(&restored, 2, wake_ms));
+        CHECK(!coin_ready(&restored, 3, wake_ms));
+
+        // They keep ageing from there: coin 1 has 50 s left, coin 0 200 s
+        CHECK(coin_ready(&restored, 1, wake_ms + 50000));
+        CHECK(!coin_ready(&restored, 1, wake_ms + 50001));
+        CHECK(coin_ready(&restored, 0, wake_ms + 200000));
+        CHECK(!coin_ready(&restored, 0, wake_ms + 200001));
+
+        // A pool without an age limit keeps everything
+        gas_pool_init(&restored, 0);
+        CHECK(rtc_snapshot_restore_gas(&snapshot, &restored, wake_ms) == 3);
+    }
+}
+
+int main() {
+    test_config_hash();
+    test_check();
+    test_template_round_trip();
+    test_gas_ageing();
+    return test_report("rtc_snapshot_test");
+}
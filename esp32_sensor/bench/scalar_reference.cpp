@@ -0,0 +1,293 @@
+#include "scalar_reference.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Hex
+// ============================================================================
+
+bcs_error_t ref_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes) {
+    if (!hex || !bytes || !actual_bytes) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    // Skip 0x prefix if present
+    if (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+        hex += 2;
+    }
+
+    size_t hex_len = strlen(hex);
+    if (hex_len % 2 != 0) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    size_t byte_len = hex_len / 2;
+    if (byte_len > max_bytes) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    for (size_t i = 0; i < byte_len; i++) {
+        // The old code passed plain char, undefined for bytes >= 0x80
+        unsigned char high = (unsigned char)hex[i * 2];
+        unsigned char low = (unsigned char)hex[i * 2 + 1];
+
+        if (!isxdigit(high) || !isxdigit(low)) {
+            return BCS_ERROR_INVALID_INPUT;
+        }
+
+        uint8_t h = (high <= '9') ? (high - '0') : (tolower(high) - 'a' + 10);
+        uint8_t l = (low <= '9') ? (low - '0') : (tolower(low) - 'a' + 10);
+
+        bytes[i] = (h << 4) | l;
+    }
+
+    *actual_bytes = byte_len;
+    return BCS_OK;
+}
+
+void ref_bytes_to_hex(const uint8_t *bytes, size_t length, char *hex) {
+    const char hex_chars[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < length; i++) {
+        hex[i * 2] = hex_chars[(bytes[i] >> 4) & 0x0F];
+        hex[i * 2 + 1] = hex_chars[bytes[i] & 0x0F];
+    }
+
+    hex[length * 2] = '\0';
+}
+
+// ============================================================================
+// ULEB128
+// ============================================================================
+
+bcs_error_t ref_write_uleb128(bcs_writer_t *writer, uint64_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+
+        if (value != 0) {
+            byte |= 0x80;
+        }
+
+        bcs_error_t err = bcs_write_u8(writer, byte);
+        if (err != BCS_OK) return err;
+
+    } while (value != 0);
+
+    return BCS_OK;
+}
+
+bcs_error_t ref_read_uleb128(bcs_reader_t *reader, uint64_t *value) {
+    if (!value) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    *value = 0;
+    uint64_t shift = 0;
+
+    while (true) {
+        if (reader->position >= reader->length) {
+            return BCS_ERROR_BUFFER_UNDERFLOW;
+        }
+
+        uint8_t byte = reader->buffer[reader->position++];
+        *value |= ((uint64_t)(byte & 0x7F)) << shift;
+
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+
+        shift += 7;
+        if (shift >= 64) {
+            return BCS_ERROR_OVERFLOW;
+        }
+    }
+
+    return BCS_OK;
+}
+
+// ============================================================================
+// Base58 / Base64
+// ============================================================================
+
+static const char base58_table[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+static const char base64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static int base58_char_value(char c) {
+    // The old code let strchr() match the terminator, reading NUL as digit 58
+    if (c == '\0') return -1;
+    const char *pos = strchr(base58_table, c);
+    if (pos == NULL) return -1;
+    return pos - base58_table;
+}
+
+int ref_base58_to_bytes(const char *input, size_t input_len, uint8_t *output, size_t output_size) {
+    if (input_len == 0) {
+        return -1;
+    }
+
+    uint8_t *temp = (uint8_t *)malloc(output_size * 2);
+    if (!temp) {
+        return -1;
+    }
+
+    memset(temp, 0, output_size * 2);
+    size_t temp_len = 0;
+
+    for (size_t i = 0; i < input_len; i++) {
+        int char_value = base58_char_value(input[i]);
+        if (char_value < 0) {
+            free(temp);
+            return -1;
+        }
+
+        // Multiply current value by 58 and add new digit
+        uint32_t carry = char_value;
+        for (size_t j = 0; j < temp_len || carry > 0; j++) {
+            if (j >= output_size * 2) {
+                free(temp);
+                return -1;
+            }
+            carry += (uint32_t)temp[j] * 58;
+            temp[j] = carry & 0xFF;
+            carry >>= 8;
+            if (j >= temp_len) temp_len = j + 1;
+        }
+    }
+
+    size_t actual_len = temp_len;
+    while (actual_len > 0 && temp[actual_len - 1] == 0) {
+        actual_len--;
+    }
+
+    if (actual_len > output_size) {
+        free(temp);
+        return -1;
+    }
+
+    memset(output, 0, output_size);
+    for (size_t i = 0; i < actual_len; i++) {
+        output[output_size - actual_len + i] = temp[actual_len - 1 - i];
+    }
+
+    free(temp);
+    return 0;
+}
+
+bcs_error_t ref_base58_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars) {
+    uint8_t number[256];
+    char digits[BASE58_ENCODED_SIZE(256)];
+    if (length > sizeof(number)) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    memcpy(number, bytes, length);
+
+    size_t zeros = 0;
+    while (zeros < length && bytes[zeros] == 0) {
+        zeros++;
+    }
+
+    // Divide the big-endian number by 58 until nothing is left; the
+    // remainders are the digits, least significant first
+    size_t count = 0;
+    size_t start = zeros;
+    while (start < length) {
+        uint32_t remainder = 0;
+        for (size_t i = start; i < length; i++) {
+            uint32_t value = (remainder << 8) | number[i];
+            number[i] = (uint8_t)(value / 58);
+            remainder = value % 58;
+        }
+        digits[count++] = base58_table[remainder];
+        while (start < length && number[start] == 0) {
+            start++;
+        }
+    }
+
+    if (zeros + count + 1 > max_chars) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+    for (size_t i = 0; i < zeros; i++) {
+        output[i] = '1';
+    }
+    for (size_t i = 0; i < count; i++) {
+        output[zeros + i] = digits[count - 1 - i];
+    }
+    output[zeros + count] = '\0';
+    if (actual_chars) *actual_chars = zeros + count;
+    return BCS_OK;
+}
+
+static int base64_char_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+bcs_error_t ref_base64_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars) {
+    size_t chars = BASE64_ENCODED_SIZE(length);
+    if (chars + 1 > max_chars) {
+        return BCS_ERROR_BUFFER_TOO_SMALL;
+    }
+
+    // Six bits at a time through an accumulator
+    uint32_t bits = 0;
+    int count = 0;
+    size_t out = 0;
+    for (size_t i = 0; i < length; i++) {
+        bits = (bits << 8) | bytes[i];
+        count += 8;
+        while (count >= 6) {
+            count -= 6;
+            output[out++] = base64_table[(bits >> count) & 0x3F];
+        }
+    }
+    if (count > 0) {
+        output[out++] = base64_table[(bits << (6 - count)) & 0x3F];
+    }
+    while (out < chars) {
+        output[out++] = '=';
+    }
+    output[out] = '\0';
+    if (actual_chars) *actual_chars = out;
+    return BCS_OK;
+}
+
+bcs_error_t ref_base64_decode(const char *input, size_t input_len, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes) {
+    // Up to two '=' are allowed, and only on a whole number of quads
+    size_t length = input_len;
+    if (length % 4 == 0) {
+        for (int i = 0; i < 2 && length > 0 && input[length - 1] == '='; i++) {
+            length--;
+        }
+    }
+    if (length % 4 == 1) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    uint32_t bits = 0;
+    int count = 0;
+    size_t out = 0;
+    for (size_t i = 0; i < length; i++) {
+        int value = base64_char_value(input[i]);
+        if (value < 0) {
+            return BCS_ERROR_INVALID_INPUT;
+        }
+        bits = (bits << 6) | (uint32_t)value;
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            if (out >= max_bytes) {
+                return BCS_ERROR_BUFFER_TOO_SMALL;
+            }
+            bytes[out++] = (uint8_t)(bits >> count);
+        }
+    }
+
+    *actual_bytes = out;
+    return BCS_OK;
+}
@@ -0,0 +1,45 @@
+/**
+ * Scalar Reference
+ * The straightforward codecs the optimized library versions replaced, kept
+ * as oracles for the equivalence tests and as baselines for the benchmarks
+ *
+ * Behaviour matches the old library code byte for byte, except where the
+ * old code was undefined (noted inline). They live in their own
+ * translation unit, like the library, so benchmarks compare calls with calls.
+ */
+
+#ifndef SCALAR_REFERENCE_H
+#define SCALAR_REFERENCE_H
+
+#include "base_codec.h"
+#include "bcs.h"
+
+// ============================================================================
+// Hex
+// ============================================================================
+
+bcs_error_t ref_hex_to_bytes(const char *hex, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes);
+void ref_bytes_to_hex(const uint8_t *bytes, size_t length, char *hex);
+
+// ============================================================================
+// ULEB128
+// ============================================================================
+
+bcs_error_t ref_write_uleb128(bcs_writer_t *writer, uint64_t value);
+bcs_error_t ref_read_uleb128(bcs_reader_t *reader, uint64_t *value);
+
+// ============================================================================
+// Base58 / Base64
+// ============================================================================
+
+// The sketch's old gas digest decoder: right-aligns the value in output and
+// returns 0, or -1 on a bad character or a value wider than output_size
+int ref_base58_to_bytes(const char *input, size_t input_len, uint8_t *output, size_t output_size);
+
+// The sketches had no Base58 encoder or Base64 codec; these are the textbook
+// digit-at-a-time versions, with the library's argument conventions
+bcs_error_t ref_base58_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars);
+bcs_error_t ref_base64_encode(const uint8_t *bytes, size_t length, char *output, size_t max_chars, size_t *actual_chars);
+bcs_error_t ref_base64_decode(const char *input, size_t input_len, uint8_t *bytes, size_t max_bytes, size_t *actual_bytes);
+
+#endif // SCALAR_REFERENCE_H
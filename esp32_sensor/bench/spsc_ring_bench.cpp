@@ -0,0 +1,189 @@
+/**
+ * SPSC Ring Benchmarks
+ * Record hand-off between two std::threads
+ *
+ * Each op moves a burst of records from the benchmark thread to a
+ * consumer thread and waits until the last one was taken, so it measures
+ * throughput including the wake-up of an idle consumer. The _mutex
+ * variants move the same records through a ring guarded by a std::mutex,
+ * the obvious alternative. Both sides yield instead of spinning when they
+ * have to wait, as the FreeRTOS tasks do, so single-core hosts give
+ * meaningful (if slower) numbers.
+ *
+ * Usage: spsc_ring_bench [--quick] [filter] > results.json
+ */
+
+#include "bench.h"
+#include "tx_pipeline.h"
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#define BURST 1024
+#define CAPACITY 64
+
+// A 64-byte record, the size of a small sample record
+typedef struct {
+    uint32_t seq;
+    uint8_t data[60];
+} record_t;
+
+// Ring guarded by one lock: the baseline
+typedef struct {
+    std::mutex lock;
+    record_t records[CAPACITY];
+    uint32_t head;
+    uint32_t tail;
+} mutex_ring_t;
+
+static bool mutex_push(mutex_ring_t *ring, const record_t *record) {
+    std::lock_guard<std::mutex> guard(ring->lock);
+    if (ring->head - ring->tail == CAPACITY) {
+        return false;
+    }
+    ring->records[ring->head++ % CAPACITY] = *record;
+    return true;
+}
+
+static bool mutex_pop(mutex_ring_t *ring, record_t *record) {
+    std::lock_guard<std::mutex> guard(ring->lock);
+    if (ring->head == ring->tail) {
+        return false;
+    }
+    *record = ring->records[ring->tail++ % CAPACITY];
+    return true;
+}
+
+typedef struct {
+    spsc_ring_t ring;
+    record_t storage[CAPACITY];
+    mutex_ring_t mutex_ring;
+    bool use_mutex;
+
+    std::atomic<bool> stop;
+    std::atomic<uint32_t> consumed;
+    uint32_t sent;
+    uint64_t checksum;          // Consumer side
+} transfer_t;
+
+static void consume(transfer_t *t) {
+    record_t record;
+    while (!t->stop.load(std::memory_order_relaxed)) {
+        bool got = t->use_mutex ? mutex_pop(&t->mutex_ring, &record)
+                                : spsc_ring_pop(&t->ring, &record) == SPSC_RING_OK;
+        if (!got) {
+            std::this_thread::yield();
+            continue;
+        }
+        t->checksum += record.seq;
+        t->consumed.store(t->consumed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+}
+
+// Send BURST records and wait until the consumer has taken them all
+static void transfer(void *ctx) {
+    transfer_t *t = (transfer_t *)ctx;
+    record_t record;
+    memset(&record, 0, sizeof(record));
+
+    for (uint32_t i = 0; i < BURST; i++) {
+        record.seq = t->sent++;
+        if (t->use_mutex) {
+            while (!mutex_push(&t->mutex_ring, &record)) {
+                std::this_thread::yield();
+            }
+        } else {
+            record_t *slot;
+            while (!(slot = (record_t *)spsc_ring_reserve(&t->ring))) {
+                std::this_thread::yield();
+            }
+            *slot = record;
+            spsc_ring_commit(&t->ring);
+        }
+    }
+    while (t->consumed.load(std::memory_order_acquire) != t->sent) {
+        std::this_thread::yield();
+    }
+}
+
+static void run_transfer(const char *name, bool use_mutex) {
+    static transfer_t t;
+    spsc_ring_init(&t.ring, t.storage, sizeof(record_t), CAPACITY);
+    t.mutex_ring.head = t.mutex_ring.tail = 0;
+    t.use_mutex = use_mutex;
+    t.stop.store(false);
+    t.consumed.store(0);
+    t.sent = 0;
+    t.checksum = 0;
+
+    std::thread consumer(consume, &t);
+    bench_run(name, transfer, &t);
+    t.stop.store(true);
+    consumer.join();
+    bench_consume(&t.checksum);
+}
+
+// ============================================================================
+// Pipeline records
+// ============================================================================
+
+// tx_pipeline's request ring with the records filled and read in place:
+// the per-record cost without the network
+typedef struct {
+    tx_pipeline_t pipeline;
+    std::atomic<bool> stop;
+    std::atomic<uint32_t> served;
+    uint32_t sent;
+} pipeline_transfer_t;
+
+static void drain_requests(pipeline_transfer_t *t) {
+    while (!t->stop.load(std::memory_order_relaxed)) {
+        const tx_pipeline_request_t *request =
+            (const tx_pipeline_request_t *)spsc_ring_peek(&t->pipeline.requests);
+        if (!request) {
+            std::this_thread::yield();
+            continue;
+        }
+        bench_consume(request->tx_bytes);
+        spsc_ring_release(&t->pipeline.requests);
+        t->served.store(t->served.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+}
+
+static void pipeline_requests(void *ctx) {
+    pipeline_transfer_t *t = (pipeline_transfer_t *)ctx;
+    for (uint32_t i = 0; i < TX_PIPELINE_DEPTH * 16; i++) {
+        tx_pipeline_request_t *request;
+        while (!(request = tx_pipeline_reserve(&t->pipeline))) {
+            std::this_thread::yield();
+        }
+        request->kind = TX_PIPELINE_SUBMIT_TX;
+        request->tx_length = 512;
+        memset(request->tx_bytes, (int)i, request->tx_length);
+        tx_pipeline_commit(&t->pipeline);
+        t->sent++;
+    }
+    while (t->served.load(std::memory_order_acquire) != t->sent) {
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char **argv) {
+    bench_begin("spsc_ring", argc, argv);
+
+    run_transfer("transfer_1024", false);
+    run_transfer("transfer_1024_mutex", true);
+
+    static pipeline_transfer_t t;
+    tx_pipeline_init(&t.pipeline);
+    t.stop.store(false);
+    t.served.store(0);
+    t.sent = 0;
+    std::thread network(drain_requests, &t);
+    bench_run("pipeline_requests_x64", pipeline_requests, &t);
+    t.stop.store(true);
+    network.join();
+
+    return bench_end();
+}
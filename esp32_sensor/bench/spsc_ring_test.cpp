@@ -0,0 +1,427 @@
+/**
+ * Host tests for spsc_ring and tx_pipeline across two std::threads
+ *
+ * test_stress hands records between a producer thread and the main thread
+ * through every access pattern (reserve/commit and push on one side,
+ * peek/release and pop on the other), with the indices starting just
+ * below the 2^32 wrap. test_pipeline runs tx_pipeline_serve() in a
+ * network thread against a loopback server that fails some transactions,
+ * and checks that the epochs keep readings in order: nothing queued behind
+ * a failure reaches the server, and everything queued after the device
+ * saw it does.
+ *
+ * CMakeLists.txt also builds this file with -fsanitize=thread
+ * (spsc_ring_tsan_test), which is where a missing barrier shows up.
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include "spsc_ring.h"
+#include "tx_pipeline.h"
+#include <string.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifdef __SANITIZE_THREAD__
+#define STRESS_RECORDS 100000
+#else
+#define STRESS_RECORDS 1000000
+#endif
+
+#define PIPELINE_READINGS 300
+#define GAS_COINS_EVERY 8       // Every 8th request refetches coins
+
+// ============================================================================
+// Single thread
+// ============================================================================
+
+static void test_ring(void) {
+    uint32_t storage[8];
+    spsc_ring_t ring;
+    CHECK(spsc_ring_init(&ring, storage, sizeof(uint32_t), 6) == SPSC_RING_ERROR_INVALID_INPUT);
+    CHECK(spsc_ring_init(&ring, storage, sizeof(uint32_t), 0) == SPSC_RING_ERROR_INVALID_INPUT);
+    CHECK(spsc_ring_init(&ring, storage, sizeof(uint32_t), 8) == SPSC_RING_OK);
+
+    uint32_t value = 0;
+    CHECK(spsc_ring_peek(&ring) == NULL);
+    CHECK(spsc_ring_pop(&ring, &value) == SPSC_RING_ERROR_EMPTY);
+
+    // Reserve returns the same slot until commit
+    void *slot = spsc_ring_reserve(&ring);
+    CHECK(slot != NULL && spsc_ring_reserve(&ring) == slot);
+    CHECK(spsc_ring_size(&ring) == 0);
+
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(spsc_ring_push(&ring, &i) == SPSC_RING_OK);
+    }
+    CHECK(spsc_ring_size(&ring) == 8);
+    CHECK(spsc_ring_reserve(&ring) == NULL);
+    CHECK(spsc_ring_push(&ring, &value) == SPSC_RING_ERROR_FULL);
+
+    // In place: the record can be changed before it is released
+    uint32_t *first = (uint32_t *)spsc_ring_peek(&ring);
+    CHECK(first == storage && *first == 0);
+    *first = 100;
+    spsc_ring_release(&ring);
+    CHECK(spsc_ring_reserve(&ring) == storage);
+
+    for (uint32_t i = 1; i < 8; i++) {
+        CHECK(spsc_ring_pop(&ring, &value) == SPSC_RING_OK && value == i);
+    }
+    CHECK(spsc_ring_size(&ring) == 0);
+}
+
+// ============================================================================
+// Two threads
+// ============================================================================
+
+typedef struct {
+    uint32_t seq;
+    uint32_t check;
+    uint8_t fill[56];
+} record_t;
+
+static void make_record(record_t *record, uint32_t seq) {
+    record->seq = seq;
+    record->check = seq * 2654435761u;
+    memset(record->fill, (uint8_t)seq, sizeof(record->fill));
+}
+
+static bool record_ok(const record_t *record, uint32_t seq) {
+    if (record->seq != seq || record->check != seq * 2654435761u) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(record->fill); i++) {
+        if (record->fill[i] != (uint8_t)seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Move STRESS_RECORDS records from a producer thread to this one; in_place
+// uses reserve/commit and peek/release, otherwise push and pop
+static void stress(uint32_t capacity, uint32_t start_index, bool in_place) {
+    static record_t storage[64];
+    spsc_ring_t ring;
+    CHECK(spsc_ring_init(&ring, storage, sizeof(record_t), capacity) == SPSC_RING_OK);
+
+    // Start the free-running indices near the wrap (before any thread runs)
+    ring.head.store(start_index, std::memory_order_relaxed);
+    ring.tail.store(start_index, std::memory_order_relaxed);
+    ring.tail_cache = start_index;
+    ring.head_cache = start_index;
+
+    std::thread producer([&ring, in_place]() {
+        for (uint32_t seq = 0; seq < STRESS_RECORDS; seq++) {
+            if (in_place) {
+                record_t *record;
+                while (!(record = (record_t *)spsc_ring_reserve(&ring))) {
+                    std::this_thread::yield();
+                }
+                make_record(record, seq);
+                spsc_ring_commit(&ring);
+            } else {
+                record_t record;
+                make_record(&record, seq);
+                while (spsc_ring_push(&ring, &record) != SPSC_RING_OK) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+
+    uint32_t bad = 0;
+    for (uint32_t seq = 0; seq < STRESS_RECORDS; seq++) {
+        if (in_place) {
+            record_t *record;
+            while (!(record = (record_t *)spsc_ring_peek(&ring))) {
+                std::this_thread::yield();
+            }
+            bad += !record_ok(record, seq);
+            memset(record, 0xEE, sizeof(*record));  // The consumer owns it until release
+            spsc_ring_release(&ring);
+        } else {
+            record_t record;
+            while (spsc_ring_pop(&ring, &record) != SPSC_RING_OK) {
+                std::this_thread::yield();
+            }
+            bad += !record_ok(&record, seq);
+        }
+    }
+    producer.join();
+
+    CHECK(bad == 0);
+    CHECK(spsc_ring_size(&ring) == 0);
+    CHECK(ring.head.load() == start_index + STRESS_RECORDS);
+}
+
+static void test_stress(void) {
+    for (int in_place = 0; in_place < 2; in_place++) {
+        stress(4, 0, in_place != 0);
+        stress(64, 0u - STRESS_RECORDS / 2, in_place != 0);
+        stress(1, 0u - 7, in_place != 0);
+    }
+}
+
+// ============================================================================
+// Pipeline
+// ============================================================================
+
+// Loopback frame server. EXECUTE fails on the first attempt of every 5th
+// reading (alternately a 409 ERROR frame and a plain HTTP 500); GAS_COINS
+// always fails with 503.
+typedef struct {
+    int fd;
+    uint16_t port;
+    uint32_t attempts[PIPELINE_READINGS];
+    uint32_t executed;          // Readings executed, in order
+    uint32_t out_of_order;      // EXECUTEs for any other reading than the next
+    uint32_t requests;
+} server_t;
+
+static uint32_t reading_index(const sensor_data_t *reading) {
+    return (uint32_t)((reading->timestamp - fixture_reading(0).timestamp) / 60);
+}
+
+static bool read_request(int fd, uint8_t *buffer, size_t capacity, const uint8_t **body, size_t *body_length) {
+    size_t received = 0;
+    for (;;) {
+        ssize_t n = recv(fd, buffer + received, capacity - received - 1, 0);
+        if (n <= 0) {
+            return false;
+        }
+        received += (size_t)n;
+        buffer[received] = 0;
+
+        const char *end = strstr((const char *)buffer, "\r\n\r\n");
+        const char *length = strstr((const char *)buffer, "Content-Length: ");
+        if (end && length) {
+            size_t head = (size_t)(end + 4 - (const char *)buffer);
+            size_t expected = head + (size_t)atoi(length + 16);
+            if (received >= expected) {
+                *body = buffer + head;
+                *body_length = expected - head;
+                return true;
+            }
+        }
+        if (received + 1 >= capacity) {
+            return false;
+        }
+    }
+}
+
+static void reply(int fd, int status, const uint8_t *body, size_t length) {
+    char head[128];
+    int n = snprintf(head, sizeof(head), "HTTP/1.0 %d X\r\nContent-Length: %u\r\n\r\n", status, (unsigned)length);
+    send(fd, head, (size_t)n, 0);
+    send(fd, body, length, 0);
+}
+
+static void serve_connection(server_t *server, int fd) {
+    static uint8_t buffer[4096];
+    const uint8_t *body;
+    size_t length;
+    sensor_frame_t frame;
+    if (!read_request(fd, buffer, sizeof(buffer), &body, &length) ||
+        sensor_frame_parse(body, length, &frame) != BCS_OK) {
+        reply(fd, 400, (const uint8_t *)"bad", 3);
+        return;
+    }
+    server->requests++;
+
+    uint8_t out[SENSOR_FRAME_MAX_SIZE];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, out, sizeof(out));
+
+    if (frame.type == SENSOR_FRAME_GAS_COINS_REQUEST) {
+        reply(fd, 503, (const uint8_t *)"busy", 4);
+        return;
+    }
+
+    sensor_data_t reading;
+    gas_object_t gas;
+    uint8_t signature[SUI_SIGNATURE_LENGTH];
+    if (sensor_frame_read_execute_request(&frame, &reading, &gas, signature) != BCS_OK) {
+        reply(fd, 400, (const uint8_t *)"bad", 3);
+        return;
+    }
+
+    uint32_t index = reading_index(&reading);
+    if (index != server->executed || index >= PIPELINE_READINGS) {
+        server->out_of_order++;
+    } else if (index % 5 == 2 && server->attempts[index]++ == 0) {
+        if (index % 10 == 2) {
+            sensor_frame_write_error(&writer, 409, "Gas coin version conflict");
+            reply(fd, 200, out, writer.position);
+        } else {
+            reply(fd, 500, (const uint8_t *)"error", 5);
+        }
+        return;
+    }
+
+    server->executed++;
+    uint8_t digest[32];
+    fixture_bytes(digest, sizeof(digest), (uint8_t)index);
+    sensor_frame_digest_t next;
+    memset(&next, 0, sizeof(next));
+    next.sensor_version = index + 1;
+    next.gas_object = gas;
+    next.gas_object.version++;
+    sensor_frame_write_execute_response(&writer, digest, &next);
+    reply(fd, 200, out, writer.position);
+}
+
+static uint32_t steady_ms(void) {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void yield(void) {
+    std::this_thread::yield();
+}
+
+typedef struct {
+    uint8_t kind;
+    uint32_t index;
+} in_flight_t;
+
+static void test_pipeline(void) {
+    static server_t server;
+    memset(&server, 0, sizeof(server));
+    server.fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_length = sizeof(addr);
+    CHECK(bind(server.fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    CHECK(listen(server.fd, 8) == 0);
+    CHECK(getsockname(server.fd, (struct sockaddr *)&addr, &addr_length) == 0);
+    server.port = ntohs(addr.sin_port);
+
+    std::thread server_thread([]() {
+        int fd;
+        while ((fd = accept(server.fd, NULL, NULL)) >= 0) {
+            serve_connection(&server, fd);
+            close(fd);
+        }
+    });
+
+    static tx_pipeline_t pipeline;
+    static tx_pipeline_network_t network;
+    tx_pipeline_server_t config = { "127.0.0.1", server.port, "/api/frame", "/api/submit-tx", 5000, steady_ms, yield };
+    tx_pipeline_init(&pipeline);
+    tx_pipeline_network_init(&network, &config);
+
+    std::atomic<bool> stop(false);
+    std::thread network_thread([&stop]() {
+        while (!stop.load()) {
+            if (!tx_pipeline_serve(&pipeline, &network)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // Device side: queue readings in order, rewind to the first unconfirmed
+    // one when a transaction fails
+    // Both rings full: DEPTH requests and DEPTH results outstanding
+    in_flight_t in_flight[TX_PIPELINE_DEPTH * 2];
+    uint32_t first = 0, pending = 0;
+    uint32_t next = 0, confirmed = 0, queued = 0;
+    uint32_t failed = 0, conflicts = 0, skipped = 0, bad = 0;
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    while (confirmed < PIPELINE_READINGS) {
+        tx_pipeline_request_t *request;
+        while (next < PIPELINE_READINGS && (request = tx_pipeline_reserve(&pipeline)) != NULL) {
+            in_flight_t *entry = &in_flight[(first + pending++) % (TX_PIPELINE_DEPTH * 2)];
+            if (++queued % GAS_COINS_EVERY == 0) {
+                request->kind = TX_PIPELINE_GAS_COINS;
+                memcpy(request->sender, params.sender, sizeof(request->sender));
+                request->coins = 4;
+                entry->index = next;
+            } else {
+                request->kind = TX_PIPELINE_EXECUTE;
+                request->count = 1;
+                request->reading = fixture_reading(next);
+                request->gas = fixture_gas((uint8_t)next);
+                memset(request->signature, 0x5A, sizeof(request->signature));
+                entry->index = next++;
+            }
+            entry->kind = request->kind;
+            tx_pipeline_commit(&pipeline);
+        }
+
+        tx_pipeline_result_t result;
+        if (!tx_pipeline_poll_result(&pipeline, &result)) {
+            std::this_thread::yield();
+            continue;
+        }
+        CHECK(pending > 0 && pending <= TX_PIPELINE_DEPTH * 2);
+        in_flight_t entry = in_flight[first];
+        first = (first + 1) % (TX_PIPELINE_DEPTH * 2);
+        pending--;
+        CHECK(result.kind == entry.kind);
+
+        if (result.kind == TX_PIPELINE_GAS_COINS) {
+            // Served even behind a failure, and never moves the epoch
+            bad += result.status != TX_PIPELINE_FAILED || result.http_status != 503;
+            continue;
+        }
+
+        switch (result.status) {
+        case TX_PIPELINE_OK:
+            bad += entry.index != confirmed || !result.have_next || result.next.sensor_version != confirmed + 1;
+            confirmed++;
+            break;
+        case TX_PIPELINE_FAILED:
+        case TX_PIPELINE_CONFLICT:
+            bad += entry.index != confirmed || !result.sent;
+            failed++;
+            conflicts += result.status == TX_PIPELINE_CONFLICT;
+            next = confirmed;
+            break;
+        case TX_PIPELINE_SKIPPED:
+            // Only requests queued before the device saw the failure
+            bad += entry.index <= confirmed || result.sent || result.epoch == pipeline.epoch;
+            skipped++;
+            break;
+        default:
+            bad++;
+            break;
+        }
+    }
+
+    stop.store(true);
+    network_thread.join();
+    shutdown(server.fd, SHUT_RDWR);
+    server_thread.join();
+    close(server.fd);
+
+    CHECK(bad == 0);
+    CHECK(server.executed == PIPELINE_READINGS);
+    CHECK(server.out_of_order == 0);
+    CHECK(failed == PIPELINE_READINGS / 5);
+    CHECK(conflicts == PIPELINE_READINGS / 10);
+    CHECK(skipped > 0);
+    CHECK(pending == 0);
+}
+
+int main() {
+    signal(SIGPIPE, SIG_IGN);
+    test_ring();
+    test_stress();
+    test_pipeline();
+    return test_report("spsc_ring_test");
+}
@@ -0,0 +1,561 @@
+/**
+ * Host tests for sui_transaction
+ *
+ * Build: see CMakeLists.txt in this directory, then run ctest.
+ */
+
+#include "bench.h"
+#include "fixtures.h"
+#include <string.h>
+
+// ============================================================================
+// Allocators
+// ============================================================================
+
+// Buffers returned by the *_with_allocator() functions come from the given
+// allocator and go back to it even if the default changes in between
+static void test_explicit_allocator(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    counting_allocator_t owner, other;
+    counting_allocator_init(&owner);
+    counting_allocator_init(&other);
+    bcs_set_default_allocator(&other.allocator);
+
+    char *hex = NULL;
+    size_t hex_length = 0;
+    CHECK(sui_build_sensor_transaction_with_allocator(
+        &params, &owner.allocator, &hex, &hex_length) == BCS_OK);
+
+    uint8_t *bytes = NULL;
+    size_t bytes_length = 0;
+    CHECK(sui_build_sensor_transaction_bytes_with_allocator(
+        &params, &owner.allocator, &bytes, &bytes_length) == BCS_OK);
+
+    sensor_data_t readings[4];
+    for (uint32_t i = 0; i < 4; i++) {
+        readings[i] = fixture_reading(i);
+    }
+    uint8_t *batch = NULL;
+    size_t batch_length = 0;
+    CHECK(sui_build_sensor_batch_transaction_bytes_with_allocator(
+        &params, readings, 4, &owner.allocator, &batch, &batch_length) == BCS_OK);
+    char *batch_hex = NULL;
+    size_t batch_hex_length = 0;
+    CHECK(sui_build_sensor_batch_transaction_with_allocator(
+        &params, readings, 4, &owner.allocator, &batch_hex, &batch_hex_length) == BCS_OK);
+
+    sensor_data_t reading = fixture_reading(7);
+    char *modified = NULL;
+    size_t modified_length = 0;
+    CHECK(sui_modify_transaction_with_sensor_data_with_allocator(
+        hex, &reading, &owner.allocator, &modified, &modified_length) == BCS_OK);
+
+    sui_sensor_template_t tpl;
+    CHECK(sui_compile_sensor_template_with_allocator(
+        &params, NULL, 0, &owner.allocator, &tpl) == BCS_OK);
+
+    CHECK(other.allocs == 0);
+    CHECK(owner.allocs >= 7);
+    CHECK(owner.live > 0);
+
+    // Default switched back to the heap before anything is released
+    bcs_set_default_allocator(NULL);
+
+    bcs_allocator_free(&owner.allocator, hex);
+    bcs_allocator_free(&owner.allocator, bytes);
+    bcs_allocator_free(&owner.allocator, batch);
+    bcs_allocator_free(&owner.allocator, batch_hex);
+    bcs_allocator_free(&owner.allocator, modified);
+    sui_sensor_template_free(&tpl);
+
+    CHECK(owner.live == 0);
+    CHECK(owner.frees == owner.allocs);
+    CHECK(other.frees == 0);
+}
+
+// Without an allocator the default at call time is used, as before
+static void test_default_allocator(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    counting_allocator_t counter;
+    counting_allocator_init(&counter);
+    bcs_set_default_allocator(&counter.allocator);
+
+    char *hex = NULL;
+    size_t hex_length = 0;
+    CHECK(sui_build_sensor_transaction(&params, &hex, &hex_length) == BCS_OK);
+    CHECK(counter.allocs == 1);
+    CHECK(counter.live == hex_length + 1);
+    bcs_free(hex);
+    CHECK(counter.live == 0);
+
+    bcs_set_default_allocator(NULL);
+}
+
+// ============================================================================
+// Exact sizes
+// ============================================================================
+
+// Name lengths either side of the one/two byte ULEB128 boundary
+static const size_t name_lengths[] = { 1, 14, 127, 128, 200 };
+
+static void set_names(transaction_builder_t *params, char *module, char *function, size_t length) {
+    memset(module, 'm', length);
+    module[length] = '\0';
+    memset(function, 'f', length);
+    function[length] = '\0';
+    params->module_name = module;
+    params->function_name = function;
+}
+
+static void test_single_exact_size(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+    char module[256], function[256];
+
+    for (size_t n = 0; n < sizeof(name_lengths) / sizeof(name_lengths[0]); n++) {
+        set_names(&params, module, function, name_lengths[n]);
+        params.gas_budget = n & 1 ? 1 : UINT64_MAX;
+
+        size_t measured = 0;
+        CHECK(sui_measure_sensor_transaction(&params, &measured) == BCS_OK);
+
+        uint8_t buffer[1024];
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, buffer, sizeof(buffer));
+        CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+        CHECK(writer.position == measured);
+
+        uint8_t *bytes = NULL;
+        size_t length = 0;
+        CHECK(sui_build_sensor_transaction_bytes(&params, &bytes, &length) == BCS_OK);
+        CHECK(length == measured);
+        CHECK(bytes && memcmp(bytes, buffer, measured) == 0);
+        bcs_free(bytes);
+
+        char *hex = NULL;
+        CHECK(sui_build_sensor_transaction(&params, &hex, &length) == BCS_OK);
+        CHECK(length == measured * 2);
+        CHECK(hex && strlen(hex) == measured * 2);
+        bcs_free(hex);
+
+        // Exactly measured bytes is enough; one less is not
+        bcs_writer_init_fixed(&writer, buffer, measured);
+        CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+        bcs_writer_init_fixed(&writer, buffer, measured - 1);
+        CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_ERROR_BUFFER_TOO_SMALL);
+    }
+}
+
+static void test_batch_exact_size(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    static sensor_data_t readings[SUI_MAX_BATCH_READINGS];
+    for (uint32_t i = 0; i < SUI_MAX_BATCH_READINGS; i++) {
+        readings[i] = fixture_reading(i);
+    }
+    // Repeated values share a Pure input, which changes the layout
+    readings[5] = readings[3];
+
+    static uint8_t buffer[16384];
+    for (size_t count = 1; count <= SUI_MAX_BATCH_READINGS; count++) {
+        bcs_writer_t counter;
+        bcs_writer_init_counting(&counter);
+        CHECK(sui_build_sensor_batch_transaction_into(&params, readings, count, &counter) == BCS_OK);
+
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, buffer, sizeof(buffer));
+        CHECK(sui_build_sensor_batch_transaction_into(&params, readings, count, &writer) == BCS_OK);
+        CHECK(writer.position == counter.position);
+
+        uint8_t *bytes = NULL;
+        size_t length = 0;
+        CHECK(sui_build_sensor_batch_transaction_bytes(&params, readings, count, &bytes, &length) == BCS_OK);
+        CHECK(length == counter.position);
+        CHECK(bytes && memcmp(bytes, buffer, length) == 0);
+        bcs_free(bytes);
+
+        char *hex = NULL;
+        CHECK(sui_build_sensor_batch_transaction(&params, readings, count, &hex, &length) == BCS_OK);
+        CHECK(length == counter.position * 2);
+        CHECK(hex && strlen(hex) == length);
+        bcs_free(hex);
+
+        size_t fit = 0;
+        CHECK(sui_sensor_batch_fit(&params, readings, count, counter.position, &fit) == BCS_OK);
+        CHECK(fit == count);
+    }
+}
+
+static void test_template_exact_size(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+    char module[256], function[256];
+
+    for (size_t n = 0; n < sizeof(name_lengths) / sizeof(name_lengths[0]); n++) {
+        set_names(&params, module, function, name_lengths[n]);
+
+        size_t measured = 0;
+        CHECK(sui_measure_sensor_transaction(&params, &measured) == BCS_OK);
+
+        sui_sensor_template_t tpl;
+        CHECK(sui_compile_sensor_template(&params, NULL, 0, &tpl) == BCS_OK);
+        size_t length = 0;
+        CHECK(sui_sensor_template_bytes(&tpl, &length) != NULL);
+        CHECK(length == measured);
+        CHECK(tpl.writer.capacity == measured);
+        sui_sensor_template_free(&tpl);
+
+        uint8_t buffer[1024];
+        CHECK(sui_compile_sensor_template(&params, buffer, measured, &tpl) == BCS_OK);
+        CHECK(sui_compile_sensor_template(&params, buffer, measured - 1, &tpl) == BCS_ERROR_BUFFER_TOO_SMALL);
+    }
+}
+
+// ============================================================================
+// Pure patching
+// ============================================================================
+
+// A patch that does not fit fails before touching the transaction, even
+// when the value splice alone would have fit but its length prefix not
+static void test_patch_atomic(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    uint8_t tx[1024];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, tx, sizeof(tx));
+    CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+    size_t length = writer.position;
+
+    sui_pure_index_t index;
+    CHECK(sui_index_pure_inputs(tx, length, &index) == BCS_OK);
+    CHECK(index.num_pures == 7);
+
+    // location (slot 6) holds an empty string, one byte; 128 bytes grow the
+    // value by 127 and its prefix by one
+    CHECK(index.slots[6].length == 1);
+    uint8_t empty_location = tx[index.slots[6].offset];
+    static uint8_t location[128];
+    memset(location, 'x', sizeof(location));
+    const size_t growth = sizeof(location) - 1 + 1;
+    const uint8_t *values[7];
+    size_t lengths[7];
+    for (size_t i = 0; i < 7; i++) {
+        values[i] = tx + index.slots[i].offset;
+        lengths[i] = index.slots[i].length;
+    }
+    values[6] = location;
+    lengths[6] = sizeof(location);
+
+    uint8_t before[1024];
+    memcpy(before, tx, length);
+    sui_pure_index_t index_before = index;
+
+    bcs_writer_t tight;
+    bcs_writer_init_fixed(&tight, tx, length + growth - 1);
+    tight.position = length;
+    CHECK(sui_patch_pure_values(&tight, &index, values, lengths, 7) == BCS_ERROR_BUFFER_TOO_SMALL);
+    CHECK(tight.position == length);
+    CHECK(memcmp(tx, before, length) == 0);
+    CHECK(memcmp(&index, &index_before, sizeof(index)) == 0);
+
+    // One more byte and it fits; the result re-indexes to the same layout
+    bcs_writer_init_fixed(&tight, tx, length + growth);
+    tight.position = length;
+    CHECK(sui_patch_pure_values(&tight, &index, values, lengths, 7) == BCS_OK);
+    CHECK(tight.position == length + growth);
+
+    sui_pure_index_t reindexed;
+    CHECK(sui_index_pure_inputs(tx, tight.position, &reindexed) == BCS_OK);
+    CHECK(reindexed.num_pures == index.num_pures);
+    CHECK(memcmp(reindexed.slots, index.slots, index.num_pures * sizeof(index.slots[0])) == 0);
+    CHECK(index.slots[6].length == sizeof(location));
+    CHECK(memcmp(tx + index.slots[6].offset, location, sizeof(location)) == 0);
+
+    // Shrinking back restores the original bytes
+    values[6] = &empty_location;
+    lengths[6] = 1;
+    CHECK(sui_patch_pure_values(&tight, &index, values, lengths, 7) == BCS_OK);
+    CHECK(tight.position == length);
+    CHECK(memcmp(tx, before, length) == 0);
+}
+
+// ============================================================================
+// Templates
+// ============================================================================
+
+// Patched template bytes equal a fresh build with the same values
+static void test_template_matches_build(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    uint8_t tpl_buffer[512];
+    sui_sensor_template_t tpl;
+    CHECK(sui_compile_sensor_template(&params, tpl_buffer, sizeof(tpl_buffer), &tpl) == BCS_OK);
+
+    for (uint32_t i = 0; i < 200; i++) {
+        params.sensor_data = fixture_reading(i * 37);
+        params.gas_object = fixture_gas((uint8_t)i);
+        params.gas_object.version += (uint64_t)i << 40;
+        if (i % 7 == 0) {
+            params.gas_price = 1000 + i;
+            params.gas_budget = 100000000ull * (i + 1);
+        }
+        // Extremes of every patched field
+        if (i == 199) {
+            params.sensor_data.value1 = params.sensor_data.value4 = 0xFFFF;
+            params.sensor_data.value2 = params.sensor_data.value3 = 0;
+            params.gas_object.version = UINT64_MAX;
+            params.gas_price = UINT64_MAX;
+            params.gas_budget = 0;
+        }
+
+        sui_sensor_template_set_sensor_data(&tpl, &params.sensor_data);
+        sui_sensor_template_set_gas_object(&tpl, &params.gas_object);
+        sui_sensor_template_set_gas(&tpl, params.gas_price, params.gas_budget);
+
+        uint8_t fresh[512];
+        bcs_writer_t writer;
+        bcs_writer_init_fixed(&writer, fresh, sizeof(fresh));
+        CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+
+        size_t length = 0;
+        const uint8_t *patched = sui_sensor_template_bytes(&tpl, &length);
+        CHECK(length == writer.position);
+        CHECK(memcmp(patched, fresh, length) == 0);
+    }
+    sui_sensor_template_free(&tpl);
+}
+
+// ============================================================================
+// Indexing
+// ============================================================================
+
+// The largest batch the builder accepts, with no value shared between
+// readings, fits the index exactly and passes the signing policy
+static void test_index_max_batch(void) {
+    transaction_builder_t params;
+    fixture_params(&params);
+
+    static sensor_data_t readings[SUI_MAX_BATCH_READINGS];
+    for (uint32_t i = 0; i < SUI_MAX_BATCH_READINGS; i++) {
+        readings[i] = fixture_reading(i);
+        readings[i].value1 = (uint16_t)(10000 + i * 4);
+        readings[i].value2 = (uint16_t)(10001 + i * 4);
+        readings[i].value3 = (uint16_t)(10002 + i * 4);
+        readings[i].value4 = (uint16_t)(10003 + i * 4);
+    }
+
+    static uint8_t buffer[16384];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, buffer, sizeof(buffer));
+    CHECK(sui_build_sensor_batch_transaction_into(&params, readings, SUI_MAX_BATCH_READINGS, &writer) == BCS_OK);
+
+    static sui_tx_index_t index;
+    CHECK(sui_index_transaction(buffer, writer.position, &index) == BCS_OK);
+    CHECK(index.length == writer.position);
+    CHECK(index.num_inputs == SUI_MAX_TX_INPUTS);
+    CHECK(index.num_commands == SUI_MAX_TX_COMMANDS);
+
+    // Readings in first-use order, then the strings, then Clock
+    for (size_t k = 0; k < SUI_MAX_BATCH_READINGS * 4; k++) {
+        const sui_tx_input_t *input = &index.inputs[k];
+        CHECK(input->kind == 0 && input->value_length == 8);
+        uint64_t value = 0;
+        memcpy(&value, buffer + input->value_offset, sizeof(value));
+        CHECK(value == 10000 + k);
+    }
+    const sui_tx_input_t *clock = &index.inputs[SUI_MAX_TX_INPUTS - 1];
+    CHECK(clock->kind == 1 && clock->object_kind == 1 && clock->version == 1);
+    CHECK(buffer[clock->value_offset + 31] == 0x06);
+
+    for (size_t i = 0; i < index.num_commands; i++) {
+        CHECK(index.commands[i].kind == 0);
+        CHECK(index.commands[i].num_arguments == 8);
+    }
+    CHECK(index.gas_budget == params.gas_budget);
+    CHECK(index.gas_price == params.gas_price);
+    CHECK(memcmp(buffer + index.sender_offset, params.sender, 32) == 0);
+
+    sui_tx_policy_t policy;
+    memset(&policy, 0, sizeof(policy));
+    policy.sender = params.sender;
+    policy.package_id = params.package_id;
+    policy.module_name = params.module_name;
+    policy.function_name = params.function_name;
+    policy.max_gas_budget = params.gas_budget;
+    CHECK(sui_check_transaction(buffer, &index, &policy) == SUI_TX_CHECK_OK);
+
+    // Every command is checked, including the last
+    policy.function_name = "store_other_data";
+    CHECK(sui_check_transaction(buffer, &index, &policy) == SUI_TX_CHECK_COMMAND);
+
+    // One command more than the index holds overflows instead of writing past it
+    size_t commands_offset = index.commands[0].offset - 1;
+    CHECK(buffer[commands_offset] == SUI_MAX_TX_COMMANDS);
+    buffer[commands_offset] = SUI_MAX_TX_COMMANDS + 1;
+    CHECK(sui_index_transaction(buffer, writer.position, &index) == BCS_ERROR_OVERFLOW);
+}
+
+// ImmOrOwned or Receiving CallArg: ObjectID, version and the digest with
+// its ULEB128 length, as Sui encodes an ObjectRef; prefixed = false writes
+// the bare 32-byte digest the indexer used to expect
+static void write_object_ref(bcs_writer_t *writer, uint8_t object_kind, uint8_t seed, uint64_t version,
+                             bool prefixed) {
+    uint8_t id[32], digest[32];
+    fixture_bytes(id, sizeof(id), seed);
+    fixture_bytes(digest, sizeof(digest), (uint8_t)(seed + 0x40));
+    bcs_write_u8(writer, 1);
+    bcs_write_u8(writer, object_kind);
+    bcs_write_fixed_bytes(writer, id, sizeof(id));
+    bcs_write_u64(writer, version);
+    if (prefixed) {
+        bcs_write_uleb128(writer, sizeof(digest));
+    }
+    bcs_write_fixed_bytes(writer, digest, sizeof(digest));
+}
+
+// The fixture transaction with an owned object before the Pure inputs and
+// a receiving one before Clock, the MoveCall renumbered to match
+static size_t build_with_objects(uint8_t *tx, size_t capacity, bool prefixed) {
+    transaction_builder_t params;
+    fixture_params(&params);
+    uint8_t plain[1024];
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, plain, sizeof(plain));
+    CHECK(sui_build_sensor_transaction_into(&params, &writer) == BCS_OK);
+    size_t plain_length = writer.position;
+
+    static sui_tx_index_t index;
+    CHECK(sui_index_transaction(plain, plain_length, &index) == BCS_OK);
+    CHECK(index.num_inputs == 8 && index.inputs[7].object_kind == 1);
+
+    bcs_writer_init_fixed(&writer, tx, capacity);
+    bcs_write_fixed_bytes(&writer, plain, 2);
+    bcs_write_uleb128(&writer, index.num_inputs + 2);
+    write_object_ref(&writer, 0, 0x50, 77, prefixed);
+    bcs_write_fixed_bytes(&writer, plain + index.inputs[0].offset, index.inputs[7].offset - index.inputs[0].offset);
+    write_object_ref(&writer, 2, 0x60, 88, prefixed);
+    size_t rest = writer.position;
+    bcs_write_fixed_bytes(&writer, plain + index.inputs[7].offset, plain_length - index.inputs[7].offset);
+    CHECK(bcs_writer_error(&writer) == BCS_OK);
+
+    // Input(i) arguments: the Pure inputs moved up one, Clock two
+    const sui_tx_command_t *call = &index.commands[0];
+    size_t shift = rest - index.inputs[7].offset;
+    uint8_t *arguments = tx + call->offset + shift + call->length - call->num_arguments * 3;
+    for (size_t i = 0; i < call->num_arguments; i++) {
+        uint8_t *argument = arguments + i * 3;
+        CHECK(argument[0] == 1 && argument[2] == 0);
+        argument[1] = (uint8_t)(argument[1] + (argument[1] == 7 ? 2 : 1));
+    }
+    return writer.position;
+}
+
+static void check_object_input(const uint8_t *tx, const sui_tx_input_t *input, uint8_t object_kind, uint8_t seed,
+                               uint64_t version) {
+    uint8_t id[32], digest[32];
+    fixture_bytes(id, sizeof(id), seed);
+    fixture_bytes(digest, sizeof(digest), (uint8_t)(seed + 0x40));
+    CHECK(input->kind == 1 && input->object_kind == object_kind);
+    CHECK(input->version == version);
+    CHECK(tx[input->offset] == 1 && tx[input->offset + 1] == object_kind);
+    CHECK(input->value_offset == input->offset + 2 && input->value_length == 32);
+    CHECK(memcmp(tx + input->value_offset, id, sizeof(id)) == 0);
+    CHECK(tx[input->value_offset + 40] == 32);
+    CHECK(memcmp(tx + input->value_offset + 41, digest, sizeof(digest)) == 0);
+}
+
+// Owned and receiving inputs carry a length-prefixed digest; indexing
+// finds them, and patching Pure values around them leaves them intact
+static void test_index_object_inputs(void) {
+    const size_t object_arg_size = 2 + 32 + 8 + 1 + 32;
+    uint8_t tx[1024];
+    size_t length = build_with_objects(tx, sizeof(tx), true);
+
+    static sui_tx_index_t index;
+    CHECK(sui_index_transaction(tx, length, &index) == BCS_OK);
+    CHECK(index.length == length);
+    CHECK(index.num_inputs == 10);
+    check_object_input(tx, &index.inputs[0], 0, 0x50, 77);
+    check_object_input(tx, &index.inputs[8], 2, 0x60, 88);
+    CHECK(index.inputs[1].kind == 0 && index.inputs[1].offset == index.inputs[0].offset + object_arg_size);
+    CHECK(index.inputs[9].offset == index.inputs[8].offset + object_arg_size);
+    CHECK(index.inputs[9].kind == 1 && index.inputs[9].object_kind == 1 && index.inputs[9].version == 1);
+
+    transaction_builder_t params;
+    fixture_params(&params);
+    sui_tx_policy_t policy;
+    memset(&policy, 0, sizeof(policy));
+    policy.sender = params.sender;
+    policy.package_id = params.package_id;
+    policy.module_name = params.module_name;
+    policy.function_name = params.function_name;
+    CHECK(sui_check_transaction(tx, &index, &policy) == SUI_TX_CHECK_OK);
+
+    // The bare 32-byte digest is not an ObjectRef
+    uint8_t bare[1024];
+    size_t bare_length = build_with_objects(bare, sizeof(bare), false);
+    CHECK(bare_length == length - 2);
+    CHECK(sui_index_transaction(bare, bare_length, &index) != BCS_OK);
+    sui_pure_index_t bare_pures;
+    CHECK(sui_index_pure_inputs(bare, bare_length, &bare_pures) != BCS_OK);
+
+    // Grow location (slot 6) and change a reading in place
+    CHECK(sui_index_transaction(tx, length, &index) == BCS_OK);
+    uint8_t owned[object_arg_size], receiving[object_arg_size];
+    memcpy(owned, tx + index.inputs[0].offset, sizeof(owned));
+    memcpy(receiving, tx + index.inputs[8].offset, sizeof(receiving));
+    size_t receiving_offset = index.inputs[8].offset;
+
+    sui_pure_index_t pures;
+    CHECK(sui_index_pure_inputs(tx, length, &pures) == BCS_OK);
+    CHECK(pures.num_pures == 7);
+    CHECK(pures.slots[0].offset == index.inputs[1].value_offset);
+    const uint8_t *values[7];
+    size_t lengths[7];
+    for (size_t i = 0; i < 7; i++) {
+        values[i] = tx + pures.slots[i].offset;
+        lengths[i] = pures.slots[i].length;
+    }
+    uint64_t reading = 4242;
+    static const uint8_t location[] = "\x16" "greenhouse 3, bench 12";   // BCS string
+    values[0] = (const uint8_t *)&reading;
+    values[6] = location;
+    lengths[6] = sizeof(location) - 1;
+
+    size_t growth = lengths[6] - pures.slots[6].length;
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, tx, sizeof(tx));
+    writer.position = length;
+    CHECK(sui_patch_pure_values(&writer, &pures, values, lengths, 7) == BCS_OK);
+    CHECK(writer.position == length + growth);
+
+    CHECK(sui_index_transaction(tx, writer.position, &index) == BCS_OK);
+    CHECK(index.num_inputs == 10);
+    CHECK(memcmp(tx + index.inputs[0].offset, owned, sizeof(owned)) == 0);
+    CHECK(index.inputs[8].offset == receiving_offset + growth);
+    CHECK(memcmp(tx + index.inputs[8].offset, receiving, sizeof(receiving)) == 0);
+    check_object_input(tx, &index.inputs[0], 0, 0x50, 77);
+    check_object_input(tx, &index.inputs[8], 2, 0x60, 88);
+    CHECK(memcmp(tx + index.inputs[1].value_offset, &reading, sizeof(reading)) == 0);
+    CHECK(sui_check_transaction(tx, &index, &policy) == SUI_TX_CHECK_OK);
+}
+
+int main() {
+    test_explicit_allocator();
+    test_default_allocator();
+    test_single_exact_size();
+    test_batch_exact_size();
+    test_template_exact_size();
+    test_patch_atomic();
+    test_template_matches_build();
+    test_index_max_batch();
+    test_index_object_inputs();
+    return test_report("sui_transaction_test");
+}
@@ -0,0 +1,159 @@
+#include "blake2b.h"
+#include <string.h>
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+static const uint64_t blake2b_iv[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL,
+};
+
+static const uint8_t blake2b_sigma[12][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+};
+
+static inline uint64_t rotr64(uint64_t x, unsigned n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+static inline uint64_t load_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+#define G(a, b, c, d, x, y)               \
+    do {                                  \
+        a = a + b + (x);                  \
+        d = rotr64(d ^ a, 32);            \
+        c = c + d;                        \
+        b = rotr64(b ^ c, 24);            \
+        a = a + b + (y);                  \
+        d = rotr64(d ^ a, 16);            \
+        c = c + d;                        \
+        b = rotr64(b ^ c, 63);            \
+    } while (0)
+
+static void compress(blake2b_state_t *state, const uint8_t *block, bool last) {
+    uint64_t m[16];
+    uint64_t v[16];
+
+    for (int i = 0; i < 16; i++) {
+        m[i] = load_u64(block + i * 8);
+    }
+    for (int i = 0; i < 8; i++) {
+        v[i] = state->h[i];
+        v[i + 8] = blake2b_iv[i];
+    }
+    v[12] ^= state->t[0];
+    v[13] ^= state->t[1];
+    if (last) {
+        v[14] = ~v[14];
+    }
+
+    for (int r = 0; r < 12; r++) {
+        const uint8_t *s = blake2b_sigma[r];
+        G(v[0], v[4], v[8],  v[12], m[s[0]],  m[s[1]]);
+        G(v[1], v[5], v[9],  v[13], m[s[2]],  m[s[3]]);
+        G(v[2], v[6], v[10], v[14], m[s[4]],  m[s[5]]);
+        G(v[3], v[7], v[11], v[15], m[s[6]],  m[s[7]]);
+        G(v[0], v[5], v[10], v[15], m[s[8]],  m[s[9]]);
+        G(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        G(v[2], v[7], v[8],  v[13], m[s[12]], m[s[13]]);
+        G(v[3], v[4], v[9],  v[14], m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        state->h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+static inline void increment_counter(blake2b_state_t *state, size_t length) {
+    state->t[0] += length;
+    if (state->t[0] < length) {
+        state->t[1]++;
+    }
+}
+
+// ============================================================================
+// BLAKE2b implementation
+// ============================================================================
+
+bool blake2b_init(blake2b_state_t *state, size_t digest_length) {
+    if (!state || digest_length == 0 || digest_length > BLAKE2B_MAX_DIGEST_SIZE) {
+        return false;
+    }
+
+    memcpy(state->h, blake2b_iv, sizeof(state->h));
+    // Parameter block: digest length, no key, fanout 1, depth 1
+    state->h[0] ^= 0x01010000ULL ^ (uint64_t)digest_length;
+    state->t[0] = 0;
+    state->t[1] = 0;
+    state->buffer_length = 0;
+    state->digest_length = digest_length;
+    return true;
+}
+
+void blake2b_update(blake2b_state_t *state, const uint8_t *data, size_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    // The final block must stay buffered, so only compress once more input follows
+    size_t free_space = BLAKE2B_BLOCK_SIZE - state->buffer_length;
+    if (length > free_space) {
+        memcpy(state->buffer + state->buffer_length, data, free_space);
+        increment_counter(state, BLAKE2B_BLOCK_SIZE);
+        compress(state, state->buffer, false);
+        state->buffer_length = 0;
+        data += free_space;
+        length -= free_space;
+
+        // Whole blocks straight from the input
+        while (length > BLAKE2B_BLOCK_SIZE) {
+            increment_counter(state, BLAKE2B_BLOCK_SIZE);
+            compress(state, data, false);
+            data += BLAKE2B_BLOCK_SIZE;
+            length -= BLAKE2B_BLOCK_SIZE;
+        }
+    }
+
+    memcpy(state->buffer + state->buffer_length, data, length);
+    state->buffer_length += length;
+}
+
+void blake2b_final(blake2b_state_t *state, uint8_t *digest) {
+    increment_counter(state, state->buffer_length);
+    memset(state->buffer + state->buffer_length, 0, BLAKE2B_BLOCK_SIZE - state->buffer_length);
+    compress(state, state->buffer, true);
+
+    for (size_t i = 0; i < state->digest_length; i++) {
+        digest[i] = (uint8_t)(state->h[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+bool blake2b(uint8_t *digest, size_t digest_length, const uint8_t *data, size_t length) {
+    blake2b_state_t state;
+    if (!blake2b_init(&state, digest_length)) {
+        return false;
+    }
+
+    blake2b_update(&state, data, length);
+    blake2b_final(&state, digest);
+    return true;
+}
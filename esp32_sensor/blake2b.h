@@ -0,0 +1,58 @@
+/**
+ * BLAKE2b
+ * Unkeyed BLAKE2b (RFC 7693) for Sui transaction and intent digests
+ *
+ * Streaming: blake2b_init(), any number of blake2b_update() calls, then
+ * blake2b_final(). The state is about 200 bytes and never allocates.
+ */
+
+#ifndef BLAKE2B_H
+#define BLAKE2B_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BLAKE2B_BLOCK_SIZE 128
+#define BLAKE2B_MAX_DIGEST_SIZE 64
+
+// Digest size used by Sui (Blake2b-256)
+#define BLAKE2B_256_SIZE 32
+
+/**
+ * Hash state
+ */
+typedef struct blake2b_state {
+    uint64_t h[8];                        // Chained state
+    uint64_t t[2];                        // Bytes compressed so far (128-bit counter)
+    uint8_t buffer[BLAKE2B_BLOCK_SIZE];   // Pending input
+    size_t buffer_length;                 // Bytes in buffer
+    size_t digest_length;                 // Requested digest size
+} blake2b_state_t;
+
+/**
+ * Start a hash
+ * @param state Pointer to hash state
+ * @param digest_length Digest size in bytes (1..BLAKE2B_MAX_DIGEST_SIZE)
+ * @return false if digest_length is out of range
+ */
+bool blake2b_init(blake2b_state_t *state, size_t digest_length);
+
+/**
+ * Absorb more input
+ */
+void blake2b_update(blake2b_state_t *state, const uint8_t *data, size_t length);
+
+/**
+ * Finish the hash
+ * @param digest Output buffer of the digest_length given to blake2b_init()
+ */
+void blake2b_final(blake2b_state_t *state, uint8_t *digest);
+
+/**
+ * One-shot hash
+ * @return false if digest_length is out of range
+ */
+bool blake2b(uint8_t *digest, size_t digest_length, const uint8_t *data, size_t length);
+
+#endif // BLAKE2B_H
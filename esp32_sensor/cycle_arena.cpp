@@ -0,0 +1,125 @@
+#include "cycle_arena.h"
+#include <string.h>
+
+// Every block is preceded by its requested size so realloc can copy it
+#define BLOCK_ALIGN 8
+#define HEADER_SIZE 8
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+static inline size_t align_up(size_t size) {
+    return (size + BLOCK_ALIGN - 1) & ~(size_t)(BLOCK_ALIGN - 1);
+}
+
+static inline size_t block_size(const uint8_t *block) {
+    size_t size;
+    memcpy(&size, block - HEADER_SIZE, sizeof(size));
+    return size;
+}
+
+static inline void set_block_size(uint8_t *block, size_t size) {
+    memcpy(block - HEADER_SIZE, &size, sizeof(size));
+}
+
+static void *arena_alloc_cb(void *ctx, size_t size) {
+    return cycle_arena_alloc((cycle_arena_t *)ctx, size);
+}
+
+static void *arena_realloc_cb(void *ctx, void *ptr, size_t size) {
+    return cycle_arena_realloc((cycle_arena_t *)ctx, ptr, size);
+}
+
+static void arena_free_cb(void *ctx, void *ptr) {
+    // Blocks are released together by cycle_arena_reset()
+    (void)ctx;
+    (void)ptr;
+}
+
+// ============================================================================
+// Arena implementation
+// ============================================================================
+
+void cycle_arena_init(cycle_arena_t *arena, void *buffer, size_t capacity) {
+    // Align the start so every block is 8-byte aligned
+    uintptr_t start = (uintptr_t)buffer;
+    size_t skip = align_up(start) - start;
+
+    arena->base = (uint8_t *)buffer + (skip < capacity ? skip : capacity);
+    arena->capacity = skip < capacity ? capacity - skip : 0;
+    arena->used = 0;
+    arena->last = 0;
+    arena->peak = 0;
+    arena->failures = 0;
+
+    arena->allocator.alloc = arena_alloc_cb;
+    arena->allocator.realloc = arena_realloc_cb;
+    arena->allocator.free = arena_free_cb;
+    arena->allocator.ctx = arena;
+}
+
+void *cycle_arena_alloc(cycle_arena_t *arena, size_t size) {
+    size_t needed = HEADER_SIZE + align_up(size);
+    if (size > arena->capacity || needed > arena->capacity - arena->used) {
+        arena->failures++;
+        return NULL;
+    }
+
+    uint8_t *block = arena->base + arena->used + HEADER_SIZE;
+    set_block_size(block, size);
+
+    arena->last = arena->used;
+    arena->used += needed;
+    if (arena->used > arena->peak) {
+        arena->peak = arena->used;
+    }
+
+    return block;
+}
+
+void *cycle_arena_realloc(cycle_arena_t *arena, void *ptr, size_t size) {
+    if (!ptr) {
+        return cycle_arena_alloc(arena, size);
+    }
+
+    uint8_t *block = (uint8_t *)ptr;
+    size_t offset = (size_t)(block - arena->base) - HEADER_SIZE;
+
+    // Most recent block: move the bump pointer instead of copying
+    if (offset == arena->last) {
+        size_t needed = HEADER_SIZE + align_up(size);
+        if (size > arena->capacity || needed > arena->capacity - offset) {
+            arena->failures++;
+            return NULL;
+        }
+
+        set_block_size(block, size);
+        arena->used = offset + needed;
+        if (arena->used > arena->peak) {
+            arena->peak = arena->used;
+        }
+        return block;
+    }
+
+    size_t old_size = block_size(block);
+    if (size <= old_size) {
+        set_block_size(block, size);
+        return block;
+    }
+
+    void *grown = cycle_arena_alloc(arena, size);
+    if (grown) {
+        memcpy(grown, block, old_size);
+    }
+    return grown;
+}
+
+void cycle_arena_reset(cycle_arena_t *arena) {
+    arena->used = 0;
+    arena->last = 0;
+}
+
+const bcs_allocator_t *cycle_arena_allocator(cycle_arena_t *arena) {
+    return &arena->allocator;
+}
@@ -0,0 +1,65 @@
+/**
+ * Cycle Arena
+ * Bump-pointer allocator for memory that lives for one sensor cycle
+ *
+ * The arena hands out 8-byte aligned blocks from a buffer reserved once at
+ * startup. Individual frees are no-ops; cycle_arena_reset() releases
+ * everything in O(1) at the end of the cycle, so the steady state never
+ * touches the general heap or fragments it.
+ */
+
+#ifndef CYCLE_ARENA_H
+#define CYCLE_ARENA_H
+
+#include "bcs.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Arena state
+ */
+typedef struct {
+    uint8_t *base;               // Backing buffer
+    size_t capacity;             // Size of the backing buffer
+    size_t used;                 // Bytes handed out this cycle (headers included)
+    size_t last;                 // Offset of the most recent block, for in-place growth
+    size_t peak;                 // Highest used value since init
+    size_t failures;             // Allocations that did not fit since init
+    bcs_allocator_t allocator;   // bcs_allocator_t view of this arena
+} cycle_arena_t;
+
+/**
+ * Set up an arena over a caller-owned buffer
+ * @param arena Pointer to arena structure
+ * @param buffer Backing storage (must outlive the arena)
+ * @param capacity Size of buffer in bytes
+ */
+void cycle_arena_init(cycle_arena_t *arena, void *buffer, size_t capacity);
+
+/**
+ * Allocate an 8-byte aligned block
+ * @return Pointer to the block, or NULL if the arena is exhausted
+ */
+void *cycle_arena_alloc(cycle_arena_t *arena, size_t size);
+
+/**
+ * Resize a block from this arena
+ * The most recent block grows or shrinks in place; older blocks are copied.
+ * @param ptr Block to resize, or NULL to allocate
+ * @return Pointer to the resized block, or NULL if the arena is exhausted
+ *         (ptr stays valid)
+ */
+void *cycle_arena_realloc(cycle_arena_t *arena, void *ptr, size_t size);
+
+/**
+ * Release every block handed out since the last reset
+ */
+void cycle_arena_reset(cycle_arena_t *arena);
+
+/**
+ * Get a bcs_allocator_t that allocates from the arena
+ * Usable with bcs_writer_init_with_allocator() for per-cycle writers.
+ */
+const bcs_allocator_t *cycle_arena_allocator(cycle_arena_t *arena);
+
+#endif // CYCLE_ARENA_H
@@ -0,0 +1,154 @@
+#include "cycle_engine.h"
+#include <string.h>
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+static void enter(cycle_engine_t *engine, cycle_state_t state) {
+    engine->state = state;
+    engine->timed_out = false;
+    if (engine->config.state_timeout_ms > 0) {
+        timer_wheel_schedule(engine->wheel, &engine->timeout_timer, engine->config.state_timeout_ms);
+    }
+}
+
+static void end_cycle(cycle_engine_t *engine, bool ok, uint32_t now_ms) {
+    cycle_state_t state = (cycle_state_t)engine->state;
+
+    timer_wheel_cancel(engine->wheel, &engine->timeout_timer);
+    engine->state = CYCLE_STATE_IDLE;
+    engine->timed_out = false;
+
+    if (ok) {
+        engine->stats.cycles_ok++;
+    } else {
+        engine->stats.cycles_failed++;
+    }
+
+    if (!engine->ops.finish(engine->ops.ctx, state, ok, now_ms)) {
+        return;
+    }
+    if (ok || engine->config.retry_delay_ms == 0) {
+        engine->start_requested = true;
+    } else {
+        timer_wheel_schedule(engine->wheel, &engine->retry_timer, engine->config.retry_delay_ms);
+    }
+}
+
+static void on_sample(void *ctx, uint32_t now_ms) {
+    cycle_engine_t *engine = (cycle_engine_t *)ctx;
+    uint32_t interval = engine->config.sample_interval_ms;
+
+    uint32_t lateness = now_ms - engine->next_sample_ms;
+    if (lateness > engine->stats.max_sample_lateness_ms) {
+        engine->stats.max_sample_lateness_ms = lateness;
+    }
+    engine->stats.samples++;
+
+    if (engine->ops.sample(engine->ops.ctx, now_ms)) {
+        engine->start_requested = true;
+    }
+
+    // The schedule follows due times, not fire times, so lateness does not
+    // accumulate; intervals that already passed are skipped, not made up
+    engine->next_sample_ms += interval;
+    if (interval > 0 && (int32_t)(engine->next_sample_ms - now_ms) <= 0) {
+        uint32_t missed = (now_ms - engine->next_sample_ms) / interval + 1;
+        engine->next_sample_ms += missed * interval;
+        engine->stats.samples_missed += missed;
+    }
+    timer_wheel_schedule_at(engine->wheel, &engine->sample_timer, engine->next_sample_ms);
+}
+
+static void on_timeout(void *ctx, uint32_t now_ms) {
+    (void)now_ms;
+    ((cycle_engine_t *)ctx)->timed_out = true;
+}
+
+static void on_retry(void *ctx, uint32_t now_ms) {
+    (void)now_ms;
+    ((cycle_engine_t *)ctx)->start_requested = true;
+}
+
+// ============================================================================
+// Engine implementation
+// ============================================================================
+
+void cycle_engine_init(cycle_engine_t *engine, timer_wheel_t *wheel, const cycle_engine_config_t *config,
+                       const cycle_engine_ops_t *ops, uint32_t now_ms) {
+    memset(engine, 0, sizeof(*engine));
+    engine->wheel = wheel;
+    engine->config = *config;
+    engine->ops = *ops;
+
+    timer_wheel_timer_init(&engine->sample_timer, on_sample, engine);
+    timer_wheel_timer_init(&engine->timeout_timer, on_timeout, engine);
+    timer_wheel_timer_init(&engine->retry_timer, on_retry, engine);
+
+    engine->next_sample_ms = now_ms;
+    timer_wheel_schedule_at(wheel, &engine->sample_timer, now_ms);
+}
+
+void cycle_engine_poll(cycle_engine_t *engine, uint32_t now_ms) {
+    timer_wheel_advance(engine->wheel, now_ms);
+
+    if (engine->state == CYCLE_STATE_IDLE) {
+        if (!engine->start_requested || engine->retry_timer.armed) {
+            return;
+        }
+        engine->start_requested = false;
+        enter(engine, CYCLE_STATE_FETCH_REFS);
+    }
+
+    if (engine->timed_out) {
+        engine->stats.timeouts++;
+        end_cycle(engine, false, now_ms);
+        return;
+    }
+
+    cycle_state_t state = (cycle_state_t)engine->state;
+    switch (engine->ops.step(engine->ops.ctx, state, now_ms)) {
+    case CYCLE_STEP_DONE:
+        if (state == CYCLE_STATE_CONFIRM) {
+            end_cycle(engine, true, now_ms);
+        } else {
+            enter(engine, (cycle_state_t)(state + 1));
+        }
+        break;
+    case CYCLE_STEP_PENDING:
+        break;
+    case CYCLE_STEP_FINISHED:
+        end_cycle(engine, true, now_ms);
+        break;
+    case CYCLE_STEP_FAILED:
+    default:
+        end_cycle(engine, false, now_ms);
+        break;
+    }
+}
+
+void cycle_engine_trigger(cycle_engine_t *engine) {
+    engine->start_requested = true;
+}
+
+cycle_state_t cycle_engine_state(const cycle_engine_t *engine) {
+    return (cycle_state_t)engine->state;
+}
+
+bool cycle_engine_idle_until_sample(const cycle_engine_t *engine, uint32_t now_ms, uint32_t *delay_ms) {
+    if (engine->state != CYCLE_STATE_IDLE || engine->start_requested || engine->retry_timer.armed) {
+        return false;
+    }
+
+    int32_t remaining = (int32_t)(engine->next_sample_ms - now_ms);
+    *delay_ms = remaining > 0 ? (uint32_t)remaining : 0;
+    return true;
+}
+
+const char *cycle_engine_state_name(cycle_state_t state) {
+    static const char *const names[CYCLE_STATE_COUNT] = {
+        "idle", "fetch refs", "build", "sign", "submit", "confirm",
+    };
+    return (unsigned)state < CYCLE_STATE_COUNT ? names[state] : "?";
+}
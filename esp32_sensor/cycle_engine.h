@@ -0,0 +1,149 @@
+/**
+ * Cycle Engine
+ * Cooperative state machine for sample -> fetch refs -> build -> sign ->
+ * submit -> confirm
+ *
+ * Sampling runs from a periodic timer that is independent of the cycle:
+ * a poll never waits, and each poll runs at most one step of the
+ * transaction cycle, so a sample is taken at most one poll (plus one slow
+ * step) after it is due however long the network takes. A step that waits
+ * on I/O returns CYCLE_STEP_PENDING and is called again on the next poll;
+ * a state that stays pending longer than state_timeout_ms fails the cycle.
+ *
+ * The engine never reads a clock or touches the network itself: pass
+ * millis() to cycle_engine_poll() on the device, or a simulated clock in
+ * host builds, and do the I/O in the ops callbacks.
+ *
+ * Example:
+ *   cycle_engine_ops_t ops = { &app, sample, step, finish };
+ *   cycle_engine_config_t config = { 60000, 15000, 5000 };
+ *   cycle_engine_init(&engine, &wheel, &config, &ops, millis());
+ *
+ *   void loop() {
+ *       cycle_engine_poll(&engine, millis());
+ *   }
+ */
+
+#ifndef CYCLE_ENGINE_H
+#define CYCLE_ENGINE_H
+
+#include "timer_wheel.h"
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    CYCLE_STATE_IDLE = 0,       // No cycle running
+    CYCLE_STATE_FETCH_REFS,     // Gas coin and sensor refs
+    CYCLE_STATE_BUILD,
+    CYCLE_STATE_SIGN,
+    CYCLE_STATE_SUBMIT,
+    CYCLE_STATE_CONFIRM,        // Wait for and read the server's reply
+} cycle_state_t;
+
+#define CYCLE_STATE_COUNT 6
+
+// Result of one step
+typedef enum {
+    CYCLE_STEP_DONE = 0,        // State complete; go to the next one
+    CYCLE_STEP_PENDING,         // Waiting on I/O; call again on the next poll
+    CYCLE_STEP_FINISHED,        // Nothing (more) to do; end the cycle successfully
+    CYCLE_STEP_FAILED,          // End the cycle unsuccessfully
+} cycle_step_t;
+
+/**
+ * Application callbacks
+ */
+typedef struct {
+    void *ctx;
+
+    /**
+     * Take a sample (called from the sample timer)
+     * @return true if a cycle should run for it
+     */
+    bool (*sample)(void *ctx, uint32_t now_ms);
+
+    /**
+     * Run one step of the given state; must not block on I/O
+     */
+    cycle_step_t (*step)(void *ctx, cycle_state_t state, uint32_t now_ms);
+
+    /**
+     * Cycle ended (also after a timeout, with state the one that timed
+     * out); release whatever the cycle held
+     * @param ok false if a step failed or timed out
+     * @return true to start another cycle (after retry_delay_ms if !ok)
+     */
+    bool (*finish)(void *ctx, cycle_state_t state, bool ok, uint32_t now_ms);
+} cycle_engine_ops_t;
+
+typedef struct {
+    uint32_t sample_interval_ms;
+    uint32_t state_timeout_ms;  // Longest a state may stay pending (0 = no limit)
+    uint32_t retry_delay_ms;    // Pause before a cycle that follows a failed one
+} cycle_engine_config_t;
+
+typedef struct {
+    uint32_t samples;
+    uint32_t samples_missed;            // Whole intervals skipped after a stall
+    uint32_t cycles_ok;
+    uint32_t cycles_failed;
+    uint32_t timeouts;
+    uint32_t max_sample_lateness_ms;    // Worst delay of a sample past its due time
+} cycle_engine_stats_t;
+
+/**
+ * Engine state
+ */
+typedef struct {
+    timer_wheel_t *wheel;
+    cycle_engine_config_t config;
+    cycle_engine_ops_t ops;
+    cycle_engine_stats_t stats;
+
+    timer_wheel_timer_t sample_timer;
+    timer_wheel_timer_t timeout_timer;
+    timer_wheel_timer_t retry_timer;
+    uint32_t next_sample_ms;
+
+    uint8_t state;              // cycle_state_t
+    bool timed_out;             // Set by the timeout timer, handled by the next poll
+    bool start_requested;       // Start a cycle once the current one ends
+} cycle_engine_t;
+
+/**
+ * Set up the engine; the first sample is due now
+ * @param wheel Timer wheel the engine arms its timers on; cycle_engine_poll()
+ *              advances it, so other timers on it fire from there too
+ */
+void cycle_engine_init(cycle_engine_t *engine, timer_wheel_t *wheel, const cycle_engine_config_t *config,
+                       const cycle_engine_ops_t *ops, uint32_t now_ms);
+
+/**
+ * Fire due timers and run at most one cycle step; call from loop()
+ */
+void cycle_engine_poll(cycle_engine_t *engine, uint32_t now_ms);
+
+/**
+ * Start a cycle without a sample (e.g. to drain a backlog after boot)
+ * If one is running, another follows it.
+ */
+void cycle_engine_trigger(cycle_engine_t *engine);
+
+/**
+ * Current state (CYCLE_STATE_IDLE between cycles)
+ */
+cycle_state_t cycle_engine_state(const cycle_engine_t *engine);
+
+/**
+ * Whether nothing is due before the next sample (no cycle running, queued
+ * or waiting to retry), e.g. to sleep through the wait
+ * @param delay_ms Output: time until the next sample is due
+ */
+bool cycle_engine_idle_until_sample(const cycle_engine_t *engine, uint32_t now_ms, uint32_t *delay_ms);
+
+/**
+ * Name of a state for logging
+ */
+const char *cycle_engine_state_name(cycle_state_t state);
+
+#endif // CYCLE_ENGINE_H
@@ -1,6 +1,8 @@
 #include <WiFi.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include "timer_wheel.h"
+#include "cycle_engine.h"
+#include "async_http.h"
 
 // ===== CONFIGURATION =====
 const char* ssid = "bruh";
@@ -8,7 +10,7 @@ const char* password = "megabruh";
 
 // Your Next.js development server URL
 // For local development: http://192.168.x.x:3000 (your computer's IP)
-// For production: https://your-domain.com
+// Plain http only: the request goes out over a raw socket
 const char* apiUrl = "http://192.168.137.1:3000/api/sensor-data";
 
 // Sensor configuration
@@ -18,80 +20,290 @@ const char* location = "Greenhouse A";
 
 // Data generation settings
 unsigned long sendInterval = 60000; // 60 seconds
-unsigned long lastSendTime = 0;
+
+// Non-blocking main loop: sampling runs from a timer and the POST is
+// advanced a step per loop(), so a slow server does not hold up either
+#define TIMER_WHEEL_TICK_SHIFT 4    // 16 ms ticks
+#define CYCLE_STATE_TIMEOUT 15000   // Longest a cycle state may wait on WiFi or the server
+#define CYCLE_RETRY_DELAY 5000      // Unused: failed readings are not retried
+#define HTTP_RESPONSE_BUFFER 1024   // Reply headers and body
+#define LOOP_POLL_INTERVAL 5        // ms between polls
+
+struct SensorReading {
+  float temperature;
+  float humidity;
+  int ec;
+  float ph;
+};
+
+// Main loop state
+timer_wheel_t timerWheel;
+cycle_engine_t cycleEngine;
+wl_status_t wifiStatus = WL_IDLE_STATUS;
+
+// Latest reading, waiting for the next cycle to send it
+SensorReading pendingReading;
+bool readingPending = false;
+
+// The reading being sent; the request body and reply stay here until the
+// POST completes
+SensorReading sending;
+char requestBody[256];
+size_t requestLength = 0;
+async_http_t http;
+uint8_t response[HTTP_RESPONSE_BUFFER];
+
+// Serial commands are collected a character at a time
+char commandLine[32];
+size_t commandLength = 0;
+bool awaitingInterval = false;
 
 // ===== HELPER FUNCTIONS =====
 float randomFloat(float min, float max) {
   return min + static_cast<float>(random(0, 1000)) / 1000.0 * (max - min);
 }
 
-void generateAndSendData() {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected. Attempting to reconnect...");
-    WiFi.reconnect();
-    delay(1000);
-    return;
+// Split apiUrl ("http://host[:port]/path") for the socket-level request
+bool parseApiUrl(char* host, size_t hostSize, uint16_t* port, const char** path) {
+  const char* start = strstr(apiUrl, "://");
+  start = start ? start + 3 : apiUrl;
+
+  size_t hostLen = strcspn(start, ":/");
+  if (hostLen == 0 || hostLen >= hostSize) {
+    return false;
   }
+  memcpy(host, start, hostLen);
+  host[hostLen] = '\0';
+
+  *port = 80;
+  if (start[hostLen] == ':') {
+    long value = strtol(start + hostLen + 1, nullptr, 10);
+    if (value <= 0 || value > 65535) {
+      return false;
+    }
+    *port = (uint16_t)value;
+  }
+  *path = strchr(start, '/');
+  if (!*path) {
+    *path = "/";
+  }
+  return true;
+}
+
+// Sample timer: generate a reading for the next cycle
+bool sampleSensor(void* ctx, uint32_t now) {
+  (void)ctx;
+  (void)now;
 
   // Generate random sensor data
-  float temperature = randomFloat(20.0, 30.0);      // 20-30°C
-  float humidity = randomFloat(40.0, 80.0);         // 40-80%
-  int ec = random(500, 1500);                       // 500-1500 µS/cm
-  float ph = randomFloat(6.0, 7.5);                 // 6.0-7.5 pH
+  if (readingPending) {
+    Serial.println("Previous reading not sent yet - replacing it");
+  }
+  pendingReading.temperature = randomFloat(20.0, 30.0);  // 20-30°C
+  pendingReading.humidity = randomFloat(40.0, 80.0);     // 40-80%
+  pendingReading.ec = random(500, 1500);                 // 500-1500 µS/cm
+  pendingReading.ph = randomFloat(6.0, 7.5);             // 6.0-7.5 pH
+  readingPending = true;
+  return true;
+}
 
-  // Create JSON document
+// Step 1: Take the pending reading once WiFi is up
+cycle_step_t stepTakeReading() {
+  if (!readingPending) {
+    return CYCLE_STEP_FINISHED;
+  }
+  // The state timeout bounds the wait for a (re)connection
+  if (WiFi.status() != WL_CONNECTED) {
+    return CYCLE_STEP_PENDING;
+  }
+
+  sending = pendingReading;
+  readingPending = false;
+  return CYCLE_STEP_DONE;
+}
+
+// Step 2: Serialize the request body
+cycle_step_t stepBuildJson() {
   StaticJsonDocument<256> doc;
-  doc["temperature"] = temperature;
-  doc["humidity"] = humidity;
-  doc["ec"] = ec;
-  doc["ph"] = ph;
+  doc["temperature"] = sending.temperature;
+  doc["humidity"] = sending.humidity;
+  doc["ec"] = sending.ec;
+  doc["ph"] = sending.ph;
   doc["deviceId"] = deviceId;
   doc["sensorType"] = sensorType;
   doc["location"] = location;
 
-  // Serialize JSON
-  String jsonString;
-  serializeJson(doc, jsonString);
+  if (measureJson(doc) >= sizeof(requestBody)) {
+    Serial.println("❌ Sensor data does not fit the request buffer");
+    return CYCLE_STEP_FAILED;
+  }
+  requestLength = serializeJson(doc, requestBody, sizeof(requestBody));
 
   // Print to Serial
   Serial.println("\n=== Generated Sensor Data ===");
-  Serial.println("Temperature: " + String(temperature) + "°C");
-  Serial.println("Humidity: " + String(humidity) + "%");
-  Serial.println("EC: " + String(ec) + " µS/cm");
-  Serial.println("pH: " + String(ph));
-  Serial.println("JSON: " + jsonString);
+  Serial.println("Temperature: " + String(sending.temperature) + "°C");
+  Serial.println("Humidity: " + String(sending.humidity) + "%");
+  Serial.println("EC: " + String(sending.ec) + " µS/cm");
+  Serial.println("pH: " + String(sending.ph));
+  Serial.println("JSON: " + String(requestBody));
+  return CYCLE_STEP_DONE;
+}
 
-  // Send HTTP POST request
-  HTTPClient http;
-  http.begin(apiUrl);
-  http.addHeader("Content-Type", "application/json");
+// Step 4: Start the POST; the socket is only touched when it is ready
+cycle_step_t stepPost() {
+  char host[64];
+  uint16_t port;
+  const char* path;
+  if (!parseApiUrl(host, sizeof(host), &port, &path)) {
+    Serial.println("❌ Invalid API URL");
+    return CYCLE_STEP_FAILED;
+  }
 
   Serial.println("Sending to: " + String(apiUrl));
-  int httpCode = http.POST(jsonString);
-
-  if (httpCode > 0) {
-    String response = http.getString();
-    Serial.println("Response Code: " + String(httpCode));
-    Serial.println("Response: " + response);
-
-    // Parse response
-    StaticJsonDocument<256> responseDoc;
-    DeserializationError error = deserializeJson(responseDoc, response);
-
-    if (!error) {
-      bool success = responseDoc["success"];
-      if (success) {
-        Serial.println("✅ Data stored on Sui!");
-        Serial.println("TX Digest: " + String(responseDoc["transactionDigest"].as<const char*>()));
-      } else {
-        Serial.println("❌ Error: " + String(responseDoc["error"].as<const char*>()));
-      }
+  async_http_part_t body = { (const uint8_t*)requestBody, requestLength };
+  async_http_error_t err = async_http_start(&http, host, port, "POST", path, "application/json", &body, 1,
+                                            response, sizeof(response));
+  if (err != ASYNC_HTTP_OK) {
+    Serial.println("HTTP Error: " + String(err));
+    return CYCLE_STEP_FAILED;
+  }
+  return CYCLE_STEP_DONE;
+}
+
+// Step 5: Read the server's reply
+cycle_step_t stepReadReply() {
+  if (async_http_busy(&http)) {
+    async_http_poll(&http);
+  }
+  if (async_http_busy(&http)) {
+    return CYCLE_STEP_PENDING;
+  }
+
+  int httpCode = async_http_status(&http);
+  if (httpCode <= 0) {
+    Serial.println("HTTP Error: " + String(http.error));
+    return CYCLE_STEP_FAILED;
+  }
+
+  size_t length;
+  const char* body = (const char*)async_http_body(&http, &length);
+  Serial.println("Response Code: " + String(httpCode));
+  Serial.printf("Response: %.*s\n", (int)length, body);
+
+  // Parse response
+  StaticJsonDocument<256> responseDoc;
+  DeserializationError error = deserializeJson(responseDoc, body, length);
+
+  if (!error) {
+    bool success = responseDoc["success"];
+    if (success) {
+      Serial.println("✅ Data stored on Sui!");
+      Serial.println("TX Digest: " + String(responseDoc["transactionDigest"].as<const char*>()));
+      return CYCLE_STEP_DONE;
+    }
+    Serial.println("❌ Error: " + String(responseDoc["error"].as<const char*>()));
+  }
+  return CYCLE_STEP_FAILED;
+}
+
+cycle_step_t runCycleStep(void* ctx, cycle_state_t state, uint32_t now) {
+  (void)ctx;
+  (void)now;
+  switch (state) {
+    case CYCLE_STATE_FETCH_REFS:
+      return stepTakeReading();
+    case CYCLE_STATE_BUILD:
+      return stepBuildJson();
+    case CYCLE_STATE_SIGN:
+      // The server builds and signs the transaction
+      return CYCLE_STEP_DONE;
+    case CYCLE_STATE_SUBMIT:
+      return stepPost();
+    case CYCLE_STATE_CONFIRM:
+      return stepReadReply();
+    default:
+      return CYCLE_STEP_FAILED;
+  }
+}
+
+// A failed reading is dropped, as the next sample follows shortly
+bool finishCycle(void* ctx, cycle_state_t state, bool ok, uint32_t now) {
+  (void)ctx;
+  (void)now;
+  if (!ok) {
+    Serial.printf("Send failed in state: %s\n", cycle_engine_state_name(state));
+  }
+  async_http_close(&http);
+  return false;
+}
+
+// Log connection changes; a cycle waits for the connection to come back
+void checkWiFi() {
+  wl_status_t status = WiFi.status();
+  if (status == wifiStatus) {
+    return;
+  }
+  bool wasConnected = wifiStatus == WL_CONNECTED;
+  wifiStatus = status;
+
+  if (status == WL_CONNECTED) {
+    Serial.println("\n✅ WiFi Connected!");
+    Serial.print("IP Address: ");
+    Serial.println(WiFi.localIP());
+    Serial.print("API Endpoint: ");
+    Serial.println(apiUrl);
+  } else if (wasConnected) {
+    Serial.println("WiFi not connected. Attempting to reconnect...");
+    WiFi.reconnect();
+  }
+}
+
+void handleCommand(const char* command) {
+  if (awaitingInterval) {
+    awaitingInterval = false;
+    long seconds = atol(command);
+    if (seconds <= 0) {
+      Serial.println("Invalid interval");
+      return;
     }
-  } else {
-    Serial.println("HTTP Error: " + String(httpCode));
+    // Takes effect after the sample already scheduled
+    sendInterval = seconds * 1000;
+    cycleEngine.config.sample_interval_ms = sendInterval;
+    Serial.print("Interval set to: ");
+    Serial.print(sendInterval / 1000);
+    Serial.println(" seconds");
+    return;
   }
 
-  http.end();
+  if (strcmp(command, "send") == 0) {
+    sampleSensor(NULL, millis());
+    cycle_engine_trigger(&cycleEngine);
+  } else if (strcmp(command, "interval") == 0) {
+    Serial.print("Current interval: ");
+    Serial.print(sendInterval / 1000);
+    Serial.println(" seconds");
+    Serial.println("Enter new interval in seconds:");
+    awaitingInterval = true;
+  }
+}
+
+// Manual trigger via Serial; only the characters already received are read
+void pollSerial() {
+  while (Serial.available() > 0) {
+    int c = Serial.read();
+    if (c == '\r') {
+      continue;
+    }
+    if (c != '\n') {
+      if (commandLength < sizeof(commandLine) - 1) {
+        commandLine[commandLength++] = (char)c;
+      }
+      continue;
+    }
+    commandLine[commandLength] = '\0';
+    commandLength = 0;
+    handleCommand(commandLine);
+  }
 }
 
 // ===== SETUP & LOOP =====
@@ -100,65 +312,30 @@ void setup() {
   delay(1000);
 
   Serial.println("\n=== ESP32 Sui Sensor Data Sender ===");
-  
-  // Connect to WiFi
+
+  // Connect to WiFi; loop() reports when the connection is up
   Serial.print("Connecting to: ");
   Serial.println(ssid);
-  
   WiFi.begin(ssid, password);
-  
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
-  }
-  
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\n✅ WiFi Connected!");
-    Serial.print("IP Address: ");
-    Serial.println(WiFi.localIP());
-    Serial.print("API Endpoint: ");
-    Serial.println(apiUrl);
-  } else {
-    Serial.println("\n❌ WiFi Connection Failed!");
-  }
 
   // Initialize random seed
   randomSeed(analogRead(0));
+
+  // The first sample is due now
+  unsigned long now = millis();
+  async_http_init(&http);
+  timer_wheel_init(&timerWheel, TIMER_WHEEL_TICK_SHIFT, now);
+  cycle_engine_ops_t ops = { NULL, sampleSensor, runCycleStep, finishCycle };
+  cycle_engine_config_t config = { (uint32_t)sendInterval, CYCLE_STATE_TIMEOUT, CYCLE_RETRY_DELAY };
+  cycle_engine_init(&cycleEngine, &timerWheel, &config, &ops, now);
 }
 
 void loop() {
-  unsigned long currentTime = millis();
-
-  // Check if it's time to send data
-  if (currentTime - lastSendTime >= sendInterval) {
-    generateAndSendData();
-    lastSendTime = currentTime;
-  }
-
-  // Optional: Add manual trigger via Serial
-  if (Serial.available() > 0) {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-    
-    if (command == "send") {
-      generateAndSendData();
-      lastSendTime = currentTime;
-    } else if (command == "interval") {
-      Serial.print("Current interval: ");
-      Serial.print(sendInterval / 1000);
-      Serial.println(" seconds");
-      Serial.println("Enter new interval in seconds:");
-      
-      while (!Serial.available());
-      String newInterval = Serial.readStringUntil('\n');
-      sendInterval = newInterval.toInt() * 1000;
-      Serial.print("Interval set to: ");
-      Serial.print(sendInterval / 1000);
-      Serial.println(" seconds");
-    }
-  }
+  // Fires the sample timer and runs at most one cycle step
+  cycle_engine_poll(&cycleEngine, millis());
 
-  delay(100);
-}
\ No newline at end of file
+  checkWiFi();
+  pollSerial();
+
+  delay(LOOP_POLL_INTERVAL);
+}
@@ -1,10 +1,20 @@
 #include <Arduino.h>
 #include <WiFi.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <MicroSui.h>
 #include "bcs.h"
 #include "sui_transaction.h"
+#include "reading_log.h"
+#include "base_codec.h"
+#include "cycle_arena.h"
+#include "sensor_frame.h"
+#include "gas_pool.h"
+#include "timer_wheel.h"
+#include "cycle_engine.h"
+#include "async_http.h"
+#include "tx_pipeline.h"
+#include "rtc_snapshot.h"
+#include <LittleFS.h>
 
 // WiFi credentials
 const char* ssid = "bruh";
@@ -14,6 +24,12 @@ const char* password = "megabruh";
 const char* serverBaseUrl = "http://192.168.137.1:3000";
 const char* createDigestUrl = "/api/create-digest";
 const char* executeSponsoredUrl = "/api/execute-sponsored";
+const char* submitTxUrl = "/api/submit-tx";
+const char* frameUrl = "/api/frame";
+
+// Time service (polled like the server requests)
+const char* timeServiceHost = "worldtimeapi.org";
+const char* timeServicePath = "/api/ip";
 
 // Your ESP32's private key for signing (in Bech32 format)
 const char* SUI_PRIVATE_KEY_BECH32 = "suiprivkey1q.........em";
@@ -24,6 +40,54 @@ const char* SUI_PRIVATE_KEY_BECH32 = "suiprivkey1q.........em";
 #define SENSOR_MODULE "sensor_storage"
 #define SENSOR_FUNCTION "store_sensor_data"
 
+// Reading log (readings are queued on flash until they are on chain)
+#define READING_LOG_DIR "/littlefs/rlog"
+#define READING_LOG_SEGMENT_RECORDS 256
+#define READING_LOG_MAX_SEGMENTS 16
+#define REPLAY_BATCH_MAX 8          // Readings drained per transaction
+#define REPLAY_BATCH_BYTES 4096     // Size budget for a batched transaction
+
+// Scratch memory for one digest -> build -> sign -> submit cycle
+#define CYCLE_ARENA_SIZE 32768
+
+// Talk to /api/frame in binary frames instead of the JSON endpoints
+#define USE_BINARY_FRAMES 1
+
+// Non-blocking main loop: the cycle advances one step per loop() while
+// sampling keeps its schedule
+#define TIMER_WHEEL_TICK_SHIFT 4    // 16 ms ticks
+#define CYCLE_STATE_TIMEOUT 15000   // Longest a cycle state may wait on the server
+#define CYCLE_RETRY_DELAY 5000      // Pause before retrying a failed cycle
+#define HTTP_RESPONSE_BUFFER 2048   // Reply headers and body of one request
+#define HTTP_JSON_RESPONSE_BUFFER 4096  // Same for the JSON endpoints
+#define TIME_RESPONSE_BUFFER 1536
+#define LOOP_POLL_INTERVAL 5        // ms between polls; bounds sampling jitter
+
+// Dual-core pipeline: this core samples, builds and signs while a task on the
+// other core does the HTTP exchanges, so signed transactions queue up instead
+// of each cycle waiting for the previous reply
+#define USE_DUAL_CORE_PIPELINE 1
+#define NETWORK_TASK_CORE 0         // loop() runs on core 1
+#define NETWORK_TASK_STACK 8192
+
+// Deep sleep between samples instead of idling in loop(); the decoded
+// identity, compiled template and last refs are kept in RTC memory, so a
+// wake goes straight to patching and signing
+#define USE_DEEP_SLEEP 0
+#define DEEP_SLEEP_MIN 2000         // Shorter waits are not worth a reboot
+
+#if USE_DUAL_CORE_PIPELINE && !USE_BINARY_FRAMES
+#error "USE_DUAL_CORE_PIPELINE needs USE_BINARY_FRAMES (the network task speaks frames only)"
+#endif
+#if USE_DUAL_CORE_PIPELINE && REPLAY_BATCH_BYTES > TX_PIPELINE_MAX_TX_BYTES
+#error "REPLAY_BATCH_BYTES does not fit a pipeline request"
+#endif
+
+// Gas coins kept in the pool (each can carry one in-flight transaction);
+// refs returned by an execution are reused up to GAS_REF_MAX_AGE
+#define GAS_POOL_COINS GAS_POOL_MAX_COINS
+#define GAS_REF_MAX_AGE 600000  // 10 minutes
+
 // Sensor data structure
 struct SensorData {
   uint16_t temperature;  // in hundredths (25.50°C = 2550)
@@ -33,7 +97,7 @@ struct SensorData {
   uint64_t timestamp;
 };
 
-// Digest response structure
+// Digest response structure (JSON transport)
 struct DigestResponse {
   char sensorObjectId[67];    // 0x + 64 hex chars
   char sensorVersion[32];
@@ -42,111 +106,179 @@ struct DigestResponse {
   char gasDigest[88];         // Base58 encoded
 };
 
+// Outcome of a submission; a conflict means the gas ref was stale
+enum SubmitResult {
+  SUBMIT_OK,
+  SUBMIT_FAILED,
+  SUBMIT_CONFLICT
+};
+
+// Reply a cycle's HTTP request is waiting for
+enum PendingReply {
+  REPLY_NONE,
+  REPLY_GAS_COINS,
+  REPLY_EXECUTE,
+  REPLY_SUBMIT_TX,
+  REPLY_DIGEST_JSON,
+  REPLY_EXECUTE_JSON
+};
+
+// State of the transaction cycle in progress; pointers refer to the cycle arena
+struct TransactionCycle {
+  sensor_data_t readings[REPLAY_BATCH_MAX];
+  size_t count;                   // Readings in this transaction
+  sensor_frame_digest_t objects;  // Sensor ref and the leased gas coin
+  gas_pool_lease_t lease;
+  transaction_builder_t params;
+  const uint8_t* txBytes;
+  size_t txLen;
+  char* transactionHex;
+  char signature_b64[256];
+  bool submitted;                 // Sent, so the gas coin's version may have moved
+  SubmitResult result;
+  sensor_frame_digest_t next;     // Refs left by the execution, if haveNext
+  bool haveNext;
+  uint8_t conflicts;              // Version conflicts retried in a row
+  PendingReply pending;
+  async_http_t http;
+  uint8_t* response;
+  uint8_t epoch;                  // Pipeline epoch the readings were peeked in
+};
+
 // Global variables
 MicroSuiEd25519 keypair;
 SensorData currentSensorData;
 bool timeSynchronized = false;
-unsigned long lastSensorRead = 0;
 unsigned long lastTimeUpdate = 0;
 const unsigned long TIME_UPDATE_INTERVAL = 3600000; // Update time every hour
 
+// Main loop: sampling, the transaction cycle and the time update run from timers
+timer_wheel_t timerWheel;
+cycle_engine_t cycleEngine;
+timer_wheel_timer_t timeUpdateTimer;
+bool timeUpdateDue = false;
+async_http_t timeHttp;
+uint8_t timeResponse[TIME_RESPONSE_BUFFER];
+wl_status_t wifiStatus = WL_IDLE_STATUS;
+TransactionCycle cycle;
+
+#if USE_DUAL_CORE_PIPELINE
+// Requests to and results from the network task; queued readings stay in the
+// log until their result comes back
+tx_pipeline_t pipeline;
+tx_pipeline_network_t network;
+char networkHost[64];
+size_t readingsInFlight = 0;    // Peeked past by queued transactions
+bool gasCoinsRequested = false; // GAS_COINS request queued, result not back yet
+bool gasCoinsFailed = false;
+uint8_t pipelineConflicts = 0;  // Version conflicts retried in a row
+bool pipelineStalled = false;   // A transaction failed; the backlog waits for the next sample
+#endif
+
+// Precompiled transaction: package, sender and fixed inputs are serialized once,
+// later cycles only patch readings and gas fields
+uint8_t txTemplateBuffer[RTC_SNAPSHOT_TEMPLATE_SIZE];
+sui_sensor_template_t txTemplate;
+bool txTemplateReady = false;
+
+// Batched transactions are built straight into this buffer
+uint8_t batchTxBuffer[REPLAY_BATCH_BYTES];
+
+// Per-cycle scratch (hex, URLs, JSON documents and payloads); reset after every cycle
+uint8_t cycleArenaBuffer[CYCLE_ARENA_SIZE];
+cycle_arena_t cycleArena;
+
+// ArduinoJson allocator backed by the cycle arena
+struct CycleArenaJsonAllocator {
+  void* allocate(size_t size) { return cycle_arena_alloc(&cycleArena, size); }
+  void deallocate(void* ptr) { (void)ptr; }
+  void* reallocate(void* ptr, size_t size) { return cycle_arena_realloc(&cycleArena, ptr, size); }
+};
+typedef BasicJsonDocument<CycleArenaJsonAllocator> CycleJsonDocument;
+
+// Sensor object ref and the sender's gas coins; a transaction leases one
+// coin and settles it with the ref from the execution effects, so the next
+// transactions skip the create-digest round trip
+uint8_t sensorObjectId[32];
+uint64_t sensorVersion = 0;
+bool sensorRefValid = false;
+gas_pool_t gasPool;
+
+// Sender and package decoded once per cold boot. With the template and the
+// refs above they are kept in RTC memory across deep sleep and resets.
+rtc_snapshot_identity_t identity;
+bool identityReady = false;
+RTC_DATA_ATTR rtc_snapshot_t rtcSnapshot;
+uint32_t snapshotConfigHash = 0;
+
+// Queue of readings not yet submitted
+reading_log_file_storage_t readingLogFiles;
+reading_log_t readingLog;
+bool readingLogReady = false;
+
 // Helper function declarations
 void initializeWiFi();
-void initializeTime();
 bool readSensorData();
-void processAndSubmitTransaction();
-bool getDigestInfo(DigestResponse* digestInfo);
-bool buildTransaction(DigestResponse* digestInfo, char** transactionHex, size_t* transactionHexLen);
+void initializeReadingLog();
+bool loadIdentity();
+bool restoreSnapshot();
+void saveSnapshot(uint32_t now, uint32_t awayMs);
+#if USE_DEEP_SLEEP
+void sleepIfIdle(uint32_t now);
+#endif
+bool sampleSensor(void* ctx, uint32_t now);
+cycle_step_t runCycleStep(void* ctx, cycle_state_t state, uint32_t now);
+bool finishCycle(void* ctx, cycle_state_t state, bool ok, uint32_t now);
+void onTimeUpdate(void* ctx, uint32_t now);
+cycle_step_t stepFetchRefs(uint32_t now);
+cycle_step_t stepBuild();
+cycle_step_t stepSign();
+cycle_step_t stepSubmit();
+cycle_step_t stepConfirm();
+bool awaitingReply();
+bool acquireGasCoin(uint32_t now);
+void storeGasCoins(const sensor_frame_gas_coins_t* coins);
+bool startDigestInfoJson();
+bool readDigestInfoJson();
+bool readDigestFields(JsonObjectConst fields, DigestResponse* digestInfo);
+bool startGasCoinsFrame();
+bool readGasCoinsFrame();
+bool decodeDigestResponse(const DigestResponse* digestInfo, sensor_frame_digest_t* out);
+bool decodeObjectRef(const char* objectId, const char* version, const char* digest, gas_object_t* out);
+bool prepareTransactionParams(const sensor_frame_digest_t* info, transaction_builder_t* out);
+bool buildTransaction(const transaction_builder_t* params, const uint8_t** txBytes, size_t* txLen,
+                      uint8_t* txDigest);
+bool buildBatchTransaction(const transaction_builder_t* params, const sensor_data_t* readings, size_t count,
+                           const uint8_t** txBytes, size_t* txLen, uint8_t* txDigest);
 bool signTransactionWithMicroSui(const char* transactionHex, char* signature_b64);
-void executeSponsoredTransaction(const char* signature_b64, DigestResponse* digestInfo);
+bool startExecuteJson();
+SubmitResult readExecuteJson();
+bool startExecuteFrame();
+SubmitResult readExecuteFrame();
+bool startSubmitTx();
+SubmitResult readSubmitTxReply();
+bool startRequest(const char* method, const char* path, const char* contentType, const async_http_part_t* body,
+                  size_t parts, PendingReply pending);
+bool startFrameRequest(const uint8_t* frame, size_t frameLen, PendingReply pending);
+bool startJsonRequest(const char* path, CycleJsonDocument* doc, PendingReply pending);
+int replyStatus(const char* method);
+int readReplyFrame(sensor_frame_t* reply);
+bool parseServerUrl(char* host, size_t hostSize, uint16_t* port);
+#if USE_DUAL_CORE_PIPELINE
+bool startPipeline();
+void networkTask(void* arg);
+uint32_t networkNow();
+void networkIdle();
+void drainPipelineResults(uint32_t now);
+cycle_step_t awaitGasCoin(uint32_t now);
+cycle_step_t queueTransaction();
+#endif
 uint64_t getCurrentTimestamp();
 void trimString(char* str);
 void printLocalTime();
 void updateTime();
-
-// Base58 decoding helper
-static const char base58_table[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-
-static int base58_char_value(char c) {
-  const char* pos = strchr(base58_table, c);
-  if (pos == NULL) return -1;
-  return pos - base58_table;
-}
-
-int base58_to_bytes(const char* input, size_t input_len, uint8_t* output, size_t output_size) {
-  if (input_len == 0) {
-    Serial.println("   Base58 input is empty");
-    return -1;
-  }
-
-  // Base58 decoding: treat as big-endian base-58 number and convert to bytes
-  uint8_t* temp = (uint8_t*)malloc(output_size * 2);  // Temporary buffer for intermediate calculations
-  if (!temp) {
-    Serial.println("   Base58 decode: memory allocation failed");
-    return -1;
-  }
-
-  memset(temp, 0, output_size * 2);
-  size_t temp_len = 0;
-
-  // Process each base58 character
-  for (size_t i = 0; i < input_len; i++) {
-    int char_value = base58_char_value(input[i]);
-    if (char_value < 0) {
-      Serial.printf("   Invalid base58 char at position %d: '%c'\n", i, input[i]);
-      free(temp);
-      return -1;
-    }
-
-    // Multiply current value by 58 and add new digit
-    uint32_t carry = char_value;
-    for (size_t j = 0; j < temp_len || carry > 0; j++) {
-      if (j >= output_size * 2) {
-        Serial.println("   Base58 decode: buffer overflow");
-        free(temp);
-        return -1;
-      }
-      carry += (uint32_t)temp[j] * 58;
-      temp[j] = carry & 0xFF;
-      carry >>= 8;
-      if (j >= temp_len) temp_len = j + 1;
-    }
-  }
-
-  // Reverse the bytes (big-endian to little-endian) and copy to output
-  // Find the actual length (skip leading zeros)
-  size_t actual_len = temp_len;
-  while (actual_len > 0 && temp[actual_len - 1] == 0) {
-    actual_len--;
-  }
-
-  if (actual_len > output_size) {
-    Serial.printf("   Base58 decode: output too large (%d bytes, expected max %d)\n", actual_len, output_size);
-    free(temp);
-    return -1;
-  }
-
-  // Copy reversed bytes to output (pad with zeros at the beginning if needed)
-  memset(output, 0, output_size);
-  for (size_t i = 0; i < actual_len; i++) {
-    output[output_size - actual_len + i] = temp[actual_len - 1 - i];
-  }
-
-  free(temp);
-  return 0;
-}
-
-// Base64 decoding helper (for sensor digest if needed)
-static const char base64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-static int base64_char_value(char c) {
-  if (c >= 'A' && c <= 'Z') return c - 'A';
-  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
-  if (c >= '0' && c <= '9') return c - '0' + 52;
-  if (c == '+') return 62;
-  if (c == '/') return 63;
-  return -1;
-}
+void pollTimeUpdate();
+void checkWiFi();
 
 void setup() {
   Serial.begin(115200);
@@ -155,116 +287,297 @@ void setup() {
   Serial.println("ESP32 Sensor Node (Digest Sign) Starting...");
   Serial.println("==========================================");
 
-  // Initialize WiFi
+  // Reserve the per-cycle scratch memory up front
+  cycle_arena_init(&cycleArena, cycleArenaBuffer, sizeof(cycleArenaBuffer));
+  gas_pool_init(&gasPool, GAS_REF_MAX_AGE);
+
+  // Start connecting to WiFi; loop() notices the connection and syncs the time
+  async_http_init(&timeHttp);
   initializeWiFi();
 
   // Initialize MicroSui keypair
   Serial.println("Initializing MicroSui keypair...");
   keypair = SuiKeypair_fromSecretKey(SUI_PRIVATE_KEY_BECH32);
-  
-  const char* address = keypair.toSuiAddress(&keypair);
-  if (address && strlen(address) > 0) {
+
+  // After a deep sleep or reset, the address, package ID, template and refs
+  // come back from RTC memory; a changed key or package invalidates them
+  const char* configFields[] = { SUI_PRIVATE_KEY_BECH32, SENSOR_PACKAGE_ID, SENSOR_MODULE, SENSOR_FUNCTION };
+  snapshotConfigHash = rtc_snapshot_config_hash(configFields, sizeof(configFields) / sizeof(configFields[0]));
+  if (!restoreSnapshot()) {
+    loadIdentity();
+  }
+
+  if (identityReady) {
     Serial.print("Keypair loaded - Address: ");
-    Serial.println(address);
+    Serial.println(identity.address);
   } else {
     Serial.println("Failed to load keypair");
   }
 
-  // Initialize time
-  initializeTime();
+  // Open the reading queue (replays anything left from before a reset)
+  initializeReadingLog();
+
+#if USE_DUAL_CORE_PIPELINE
+  // Network exchanges run on the other core from here on
+  if (!startPipeline()) {
+    Serial.println("Failed to start network task");
+  }
+#endif
+
+  // The first sample is due now; the cycle it starts also drains the queue
+  unsigned long now = millis();
+  async_http_init(&cycle.http);
+  timer_wheel_init(&timerWheel, TIMER_WHEEL_TICK_SHIFT, now);
+  cycle_engine_ops_t ops = { NULL, sampleSensor, runCycleStep, finishCycle };
+  cycle_engine_config_t config = { SENSOR_READ_INTERVAL, CYCLE_STATE_TIMEOUT, CYCLE_RETRY_DELAY };
+  cycle_engine_init(&cycleEngine, &timerWheel, &config, &ops, now);
+  timer_wheel_timer_init(&timeUpdateTimer, onTimeUpdate, NULL);
+  timer_wheel_schedule(&timerWheel, &timeUpdateTimer, TIME_UPDATE_INTERVAL);
 
   Serial.println("ESP32 Sensor Node Ready");
   Serial.println("=======================");
 }
 
 void loop() {
-  unsigned long currentTime = millis();
-
-  // Update time periodically
-  if (WiFi.status() == WL_CONNECTED && millis() - lastTimeUpdate > TIME_UPDATE_INTERVAL) {
+#if USE_DUAL_CORE_PIPELINE
+  // Results from the network core settle gas coins and commit readings
+  drainPipelineResults(millis());
+#endif
+
+  // Fires due timers and runs at most one cycle step; network steps only
+  // touch the socket when it is ready, so nothing here waits on the server
+  cycle_engine_poll(&cycleEngine, millis());
+
+  // The time service has its own request, advanced like the cycle's
+  checkWiFi();
+  if (timeUpdateDue) {
+    timeUpdateDue = false;
     updateTime();
   }
+  pollTimeUpdate();
 
-  // Read sensor data at intervals
-  if (currentTime - lastSensorRead >= SENSOR_READ_INTERVAL) {
-    Serial.println("\n=== Reading Sensor Data ===");
-    
-    if (readSensorData()) {
-      Serial.println("Sensor data collected successfully");
-      
-      // Convert to human-readable format for display
-      float temp = currentSensorData.temperature / 100.0;
-      float hum = currentSensorData.humidity / 100.0;
-      float ph = currentSensorData.ph / 100.0;
-      
-      Serial.printf("Temperature: %.2f°C\n", temp);
-      Serial.printf("Humidity: %.2f%%\n", hum);
-      Serial.printf("EC: %d µS/cm\n", currentSensorData.ec);
-      Serial.printf("pH: %.2f\n", ph);
-      Serial.printf("Timestamp: %llu\n", currentSensorData.timestamp);
-      
-      // Process and submit transaction
-      processAndSubmitTransaction();
-    } else {
-      Serial.println("Failed to read sensor data");
+#if USE_DEEP_SLEEP
+  sleepIfIdle(millis());
+#endif
+
+  delay(LOOP_POLL_INTERVAL);
+}
+
+// Sample timer: read the sensors and queue the reading
+bool sampleSensor(void* ctx, uint32_t now) {
+  (void)ctx;
+  (void)now;
+  Serial.println("\n=== Reading Sensor Data ===");
+
+  if (!readSensorData()) {
+    Serial.println("Failed to read sensor data");
+    return false;
+  }
+  Serial.println("Sensor data collected successfully");
+
+  // Convert to human-readable format for display
+  float temp = currentSensorData.temperature / 100.0;
+  float hum = currentSensorData.humidity / 100.0;
+  float ph = currentSensorData.ph / 100.0;
+
+  Serial.printf("Temperature: %.2f°C\n", temp);
+  Serial.printf("Humidity: %.2f%%\n", hum);
+  Serial.printf("EC: %d µS/cm\n", currentSensorData.ec);
+  Serial.printf("pH: %.2f\n", ph);
+  Serial.printf("Timestamp: %llu\n", currentSensorData.timestamp);
+
+  // Queue the reading first so it survives WiFi/HTTP failures and resets
+  if (readingLogReady) {
+    sensor_data_t reading = {
+      currentSensorData.temperature, currentSensorData.humidity,
+      currentSensorData.ec, currentSensorData.ph, currentSensorData.timestamp
+    };
+    if (reading_log_append(&readingLog, &reading) != READING_LOG_OK) {
+      Serial.println("Failed to queue reading");
     }
-    
-    lastSensorRead = currentTime;
   }
 
-  delay(1000);
+  // Submit it (the engine queues the cycle if one is running)
+  return true;
+}
+
+void onTimeUpdate(void* ctx, uint32_t now) {
+  (void)ctx;
+  (void)now;
+  timeUpdateDue = true;
+  timer_wheel_schedule(&timerWheel, &timeUpdateTimer, TIME_UPDATE_INTERVAL);
 }
 
 void initializeWiFi() {
   Serial.println("Connecting to WiFi...");
   WiFi.begin(ssid, password);
+}
 
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
+// Log connection changes; cycles fail fast while disconnected. The time is
+// synced on the first connection.
+void checkWiFi() {
+  wl_status_t status = WiFi.status();
+  if (status == wifiStatus) {
+    return;
   }
+  bool wasConnected = wifiStatus == WL_CONNECTED;
+  wifiStatus = status;
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println();
+  if (status == WL_CONNECTED) {
     Serial.println("WiFi connected");
     Serial.print("IP address: ");
     Serial.println(WiFi.localIP());
-  } else {
-    Serial.println();
-    Serial.println("WiFi connection failed");
+    if (!timeSynchronized) {
+      updateTime();
+    }
+  } else if (wasConnected) {
+    Serial.println("WiFi connection lost");
   }
 }
 
-void initializeTime() {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected - cannot initialize time");
+void initializeReadingLog() {
+  if (!LittleFS.begin(true)) {
+    Serial.println("LittleFS mount failed - readings will not be queued");
+    return;
+  }
+
+  reading_log_storage_t storage;
+  if (reading_log_file_storage_init(&readingLogFiles, READING_LOG_DIR, &storage) != READING_LOG_OK ||
+      reading_log_open(&readingLog, &storage, READING_LOG_SEGMENT_RECORDS, READING_LOG_MAX_SEGMENTS) != READING_LOG_OK) {
+    Serial.println("Failed to open reading log - readings will not be queued");
+    return;
+  }
+
+  readingLogReady = true;
+  Serial.printf("Reading log ready (%u pending)\n", (unsigned)reading_log_pending(&readingLog));
+}
+
+// Sender address and package ID as raw bytes; only needed after a cold boot
+bool loadIdentity() {
+  size_t bytes_read;
+  const char* address = keypair.toSuiAddress(&keypair);
+  Serial.printf("Converting Sender Address: %s\n", address ? address : "");
+  if (!address || strlen(address) >= sizeof(identity.address) ||
+      bcs_hex_to_bytes(address, identity.sender, 32, &bytes_read) != BCS_OK || bytes_read != 32) {
+    Serial.println("Failed to convert Sender Address");
+    return false;
+  }
+  strcpy(identity.address, address);
+
+  Serial.printf("Converting Package ID: %s\n", SENSOR_PACKAGE_ID);
+  bcs_error_t err = bcs_hex_to_bytes(SENSOR_PACKAGE_ID, identity.package_id, 32, &bytes_read);
+  if (err != BCS_OK || bytes_read != 32) {
+    Serial.printf("Failed to convert Package ID: error %d, bytes_read: %d\n", err, bytes_read);
+    return false;
+  }
+
+  identityReady = true;
+  return true;
+}
+
+// Identity, compiled template and refs saved before the last sleep or reset
+bool restoreSnapshot() {
+  rtc_snapshot_error_t err = rtc_snapshot_check(&rtcSnapshot, snapshotConfigHash);
+  if (err != RTC_SNAPSHOT_OK) {
+    if (err != RTC_SNAPSHOT_ERROR_EMPTY) {
+      Serial.printf("Discarding RTC snapshot: error %d\n", err);
+    }
+    return false;
+  }
+
+  identity = rtcSnapshot.identity;
+  identityReady = true;
+  txTemplateReady = rtc_snapshot_restore_template(&rtcSnapshot, txTemplateBuffer, sizeof(txTemplateBuffer),
+                                                  &txTemplate) == RTC_SNAPSHOT_OK;
+  if (rtcSnapshot.sensor_valid) {
+    memcpy(sensorObjectId, rtcSnapshot.sensor_object_id, sizeof(sensorObjectId));
+    sensorVersion = rtcSnapshot.sensor_version;
+    sensorRefValid = true;
+  }
+  size_t coins = rtc_snapshot_restore_gas(&rtcSnapshot, &gasPool, millis());
+
+  Serial.printf("Resumed from RTC snapshot (template %s, %u gas coin(s))\n",
+                txTemplateReady ? "ready" : "not compiled", (unsigned)coins);
+  return true;
+}
+
+// awayMs: how long until restoreSnapshot() runs, if known (the sleep duration)
+void saveSnapshot(uint32_t now, uint32_t awayMs) {
+  if (!identityReady) {
     return;
   }
 
-  updateTime();
+  rtc_snapshot_error_t err =
+      rtc_snapshot_save(&rtcSnapshot, snapshotConfigHash, &identity, txTemplateReady ? &txTemplate : NULL,
+                        sensorRefValid ? sensorObjectId : NULL, sensorVersion, &gasPool, now, awayMs);
+  if (err != RTC_SNAPSHOT_OK) {
+    Serial.printf("Failed to save RTC snapshot: error %d\n", err);
+  }
 }
 
+#if USE_DEEP_SLEEP
+// Nothing to send before the next sample: sleep through the wait. The wake
+// is a reset, so setup() runs again and resumes from the snapshot.
+void sleepIfIdle(uint32_t now) {
+  uint32_t wait;
+  if (!cycle_engine_idle_until_sample(&cycleEngine, now, &wait) || wait < DEEP_SLEEP_MIN) {
+    return;
+  }
+#if USE_DUAL_CORE_PIPELINE
+  if (readingsInFlight > 0 || gasCoinsRequested || gas_pool_count(&gasPool, GAS_COIN_IN_FLIGHT) > 0) {
+    return;
+  }
+#endif
+  if (async_http_busy(&timeHttp)) {
+    return;
+  }
+
+  saveSnapshot(now, wait);
+  Serial.printf("Sleeping %u ms until the next sample\n", (unsigned)wait);
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)wait * 1000);
+  esp_deep_sleep_start();
+}
+#endif
+
+// Start a request to the time service; pollTimeUpdate() reads the reply
 void updateTime() {
   if (WiFi.status() != WL_CONNECTED) {
     Serial.println("WiFi not connected for time update");
     return;
   }
+  if (async_http_busy(&timeHttp)) {
+    return;
+  }
 
   Serial.println("Updating time...");
-  
+
   // For now, we'll use a simple HTTP-based time service
-  HTTPClient http;
-  http.begin("http://worldtimeapi.org/api/ip");
-  
-  int httpCode = http.GET();
-  if (httpCode == 200) {
-    String response = http.getString();
-    
+  async_http_error_t err = async_http_start(&timeHttp, timeServiceHost, 80, "GET", timeServicePath, NULL, NULL, 0,
+                                            timeResponse, sizeof(timeResponse));
+  if (err != ASYNC_HTTP_OK) {
+    Serial.printf("Time service request failed: %d\n", err);
+  }
+}
+
+void pollTimeUpdate() {
+  if (!async_http_busy(&timeHttp)) {
+    return;
+  }
+  async_http_state_t state = async_http_poll(&timeHttp);
+  if (state == ASYNC_HTTP_FAILED) {
+    Serial.printf("Time service request failed: %d\n", timeHttp.error);
+  }
+  if (state != ASYNC_HTTP_DONE) {
+    return;
+  }
+
+  size_t length;
+  const char* body = (const char*)async_http_body(&timeHttp, &length);
+  if (async_http_status(&timeHttp) == 200) {
     DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, response);
-    
+    DeserializationError error = deserializeJson(doc, body, length);
+
     if (!error) {
       uint64_t unix_time = doc["unixtime"];
       if (unix_time > 0) {
@@ -275,8 +588,8 @@ void updateTime() {
       }
     }
   }
-  
-  http.end();
+
+  async_http_close(&timeHttp);
 }
 
 uint64_t getCurrentTimestamp() {
@@ -302,145 +615,660 @@ bool readSensorData() {
   return true;
 }
 
-void processAndSubmitTransaction() {
+cycle_step_t runCycleStep(void* ctx, cycle_state_t state, uint32_t now) {
+  (void)ctx;
+  switch (state) {
+    case CYCLE_STATE_FETCH_REFS:
+      return stepFetchRefs(now);
+    case CYCLE_STATE_BUILD:
+      return stepBuild();
+    case CYCLE_STATE_SIGN:
+      return stepSign();
+    case CYCLE_STATE_SUBMIT:
+      return stepSubmit();
+    case CYCLE_STATE_CONFIRM:
+      return stepConfirm();
+    default:
+      return CYCLE_STEP_FAILED;
+  }
+}
+
+// Settle the gas coin and free the cycle's memory; returns true if another
+// cycle should follow (backlog left, or one retry after a version conflict)
+bool finishCycle(void* ctx, cycle_state_t state, bool ok, uint32_t now) {
+  (void)ctx;
+  if (!ok) {
+    Serial.printf("Cycle failed in state: %s\n", cycle_engine_state_name(state));
+  }
+
+  async_http_close(&cycle.http);
+
+  // Unsent transactions leave the coin as it was; otherwise it is settled with
+  // the ref from the effects, or refetched before reuse
+  if (cycle.lease.id != 0) {
+    if (!cycle.submitted) {
+      gas_pool_cancel(&gasPool, &cycle.lease);
+    } else {
+      if (cycle.haveNext) {
+        memcpy(sensorObjectId, cycle.next.sensor_object_id, sizeof(sensorObjectId));
+        sensorVersion = cycle.next.sensor_version;
+      }
+      gas_pool_release(&gasPool, &cycle.lease, cycle.haveNext ? &cycle.next.gas_object : NULL, now);
+    }
+    Serial.printf("Gas pool: %u ready, %u to refetch\n", (unsigned)gas_pool_count(&gasPool, GAS_COIN_READY),
+                  (unsigned)gas_pool_count(&gasPool, GAS_COIN_UNKNOWN));
+  }
+
+  // A backlog is replayed with one transaction per ready gas coin
+  bool more;
+  uint8_t conflicts = 0;
+  if (ok) {
+#if USE_DUAL_CORE_PIPELINE
+    // Readings queued to the network task are not backlog
+    more = readingLogReady && !pipelineStalled && reading_log_pending(&readingLog) > readingsInFlight &&
+           gas_pool_count(&gasPool, GAS_COIN_READY) > 0;
+#else
+    more = readingLogReady && reading_log_pending(&readingLog) > 0 && gas_pool_count(&gasPool, GAS_COIN_READY) > 0;
+#endif
+  } else if (cycle.result == SUBMIT_CONFLICT && cycle.conflicts == 0) {
+    // That coin is out of rotation until refetched; the retry takes another
+    // ready coin, or fetches fresh refs
+    Serial.println("Object version conflict - retrying with another gas ref");
+    more = true;
+    conflicts = 1;
+  } else {
+    more = false;
+  }
+
+  // Template and refs for the next wake (or reset)
+  saveSnapshot(now, 0);
+
+  // Everything the cycle allocated goes at once
+  if (cycleArena.failures > 0) {
+    Serial.printf("Cycle arena exhausted %u time(s) (peak %u of %u bytes)\n",
+                  (unsigned)cycleArena.failures, (unsigned)cycleArena.peak, (unsigned)cycleArena.capacity);
+  }
+  cycle_arena_reset(&cycleArena);
+
+  if (cycle.count > 0) {
+    Serial.println("=== TRANSACTION PROCESS COMPLETE ===");
+  }
+
+  memset(&cycle, 0, sizeof(cycle));
+  async_http_init(&cycle.http);
+  cycle.conflicts = conflicts;
+  return more;
+}
+
+// Step 1: Queued readings and a leased gas coin (refetching the pool when
+// none is ready)
+cycle_step_t stepFetchRefs(uint32_t now) {
+#if USE_DUAL_CORE_PIPELINE
+  // Readings already peeked; waiting on a gas coin from the network task
+  if (cycle.count > 0) {
+    return awaitGasCoin(now);
+  }
+#endif
+  if (cycle.pending == REPLY_GAS_COINS || cycle.pending == REPLY_DIGEST_JSON) {
+    if (awaitingReply()) {
+      return CYCLE_STEP_PENDING;
+    }
+    bool refreshed = cycle.pending == REPLY_GAS_COINS ? readGasCoinsFrame() : readDigestInfoJson();
+    if (!refreshed) {
+      return CYCLE_STEP_FAILED;
+    }
+    return acquireGasCoin(now) ? CYCLE_STEP_DONE : CYCLE_STEP_FAILED;
+  }
+
+  // Right after boot or a wake the connection may still be coming up; the
+  // state timeout bounds the wait
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected - cannot process transaction");
-    return;
+    return CYCLE_STEP_PENDING;
+  }
+
+  // Oldest queued readings first; without a log only the current reading is sent
+  if (readingLogReady) {
+#if USE_DUAL_CORE_PIPELINE
+    // Skip the readings already queued to the network task
+    cycle.epoch = pipeline.epoch;
+    reading_log_error_t err =
+        reading_log_peek_at(&readingLog, readingsInFlight, cycle.readings, REPLAY_BATCH_MAX, &cycle.count);
+#else
+    reading_log_error_t err = reading_log_peek(&readingLog, cycle.readings, REPLAY_BATCH_MAX, &cycle.count);
+#endif
+    if (err != READING_LOG_OK) {
+      Serial.println("Failed to read queued readings");
+      return CYCLE_STEP_FAILED;
+    }
+  } else {
+    cycle.readings[0] = {
+      currentSensorData.temperature, currentSensorData.humidity,
+      currentSensorData.ec, currentSensorData.ph, currentSensorData.timestamp
+    };
+    cycle.count = 1;
+  }
+
+  if (cycle.count == 0) {
+    return CYCLE_STEP_FINISHED;
   }
 
   Serial.println("\n=== STARTING TRANSACTION PROCESS ===");
+  Serial.printf("Submitting %u reading(s)\n", (unsigned)cycle.count);
+
+#if USE_DUAL_CORE_PIPELINE
+  return awaitGasCoin(now);
+#else
+  if (sensorRefValid && gas_pool_acquire(&gasPool, now, &cycle.objects.gas_object, &cycle.lease) == GAS_POOL_OK) {
+    Serial.println("Using a pooled gas coin");
+    memcpy(cycle.objects.sensor_object_id, sensorObjectId, sizeof(sensorObjectId));
+    cycle.objects.sensor_version = sensorVersion;
+    return CYCLE_STEP_DONE;
+  }
 
-  // Step 1: Get digest info from API
-  DigestResponse digestInfo;
-  if (!getDigestInfo(&digestInfo)) {
-    Serial.println("Failed to get digest info");
-    return;
+#if USE_BINARY_FRAMES
+  return startGasCoinsFrame() ? CYCLE_STEP_PENDING : CYCLE_STEP_FAILED;
+#else
+  return startDigestInfoJson() ? CYCLE_STEP_PENDING : CYCLE_STEP_FAILED;
+#endif
+#endif
+}
+
+// Step 2: Build transaction locally (one MoveCall per reading when replaying a backlog)
+cycle_step_t stepBuild() {
+  if (!prepareTransactionParams(&cycle.objects, &cycle.params)) {
+    Serial.println("Failed to prepare transaction parameters");
+    return CYCLE_STEP_FAILED;
+  }
+
+  if (cycle.count > 1) {
+    size_t fit = 0;
+    sui_sensor_batch_fit(&cycle.params, cycle.readings, cycle.count, REPLAY_BATCH_BYTES, &fit);
+    cycle.count = fit > 0 ? fit : 1;
   }
 
-  // Step 2: Build transaction locally
-  char* transactionHex = nullptr;
-  size_t transactionHexLen = 0;
-  if (!buildTransaction(&digestInfo, &transactionHex, &transactionHexLen)) {
+  uint8_t txDigest[SUI_DIGEST_LENGTH];
+  bool built;
+  if (cycle.count == 1) {
+    cycle.params.sensor_data = cycle.readings[0];
+    built = buildTransaction(&cycle.params, &cycle.txBytes, &cycle.txLen, txDigest);
+  } else {
+    built = buildBatchTransaction(&cycle.params, cycle.readings, cycle.count, &cycle.txBytes, &cycle.txLen,
+                                  txDigest);
+  }
+  if (!built) {
     Serial.println("Failed to build transaction");
-    return;
+    return CYCLE_STEP_FAILED;
   }
 
-  // Step 3: Sign transaction
-  char signature_b64[256];
-  if (!signTransactionWithMicroSui(transactionHex, signature_b64)) {
+  // Known before submission, so the result can be looked up even if the response is lost
+  char txDigestB58[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+  if (base58_encode(txDigest, sizeof(txDigest), txDigestB58, sizeof(txDigestB58), NULL) == BCS_OK) {
+    Serial.printf("Transaction digest: %s\n", txDigestB58);
+  }
+
+  // MicroSui signs hex only; submit-tx sends the same hex as its body
+  cycle.transactionHex = (char*)cycle_arena_alloc(&cycleArena, cycle.txLen * 2 + 1);
+  if (!cycle.transactionHex) {
+    Serial.println("Failed to allocate transaction hex");
+    return CYCLE_STEP_FAILED;
+  }
+  bcs_bytes_to_hex(cycle.txBytes, cycle.txLen, cycle.transactionHex);
+  return CYCLE_STEP_DONE;
+}
+
+// Step 3: Sign transaction
+cycle_step_t stepSign() {
+  if (!signTransactionWithMicroSui(cycle.transactionHex, cycle.signature_b64)) {
     Serial.println("Failed to sign transaction");
-    free(transactionHex);
-    return;
+    return CYCLE_STEP_FAILED;
   }
+  return CYCLE_STEP_DONE;
+}
 
-  // Step 4: Submit to execute-sponsored API
-  executeSponsoredTransaction(signature_b64, &digestInfo);
+// Step 4: Submit (the sponsored endpoint rebuilds single readings; batches go as raw bytes)
+cycle_step_t stepSubmit() {
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("WiFi not connected");
+    return CYCLE_STEP_FAILED;
+  }
 
-  // Cleanup
-  free(transactionHex);
+#if USE_DUAL_CORE_PIPELINE
+  return queueTransaction();
+#else
+  if (cycle.count > 1) {
+    if (!startSubmitTx()) {
+      return CYCLE_STEP_FAILED;
+    }
+  } else {
+#if USE_BINARY_FRAMES
+    if (!startExecuteFrame()) {
+      return CYCLE_STEP_FAILED;
+    }
+#else
+    if (!startExecuteJson()) {
+      return CYCLE_STEP_FAILED;
+    }
+#endif
+  }
 
-  Serial.println("=== TRANSACTION PROCESS COMPLETE ===");
+  cycle.submitted = true;
+  return CYCLE_STEP_DONE;
+#endif
 }
 
-bool getDigestInfo(DigestResponse* digestInfo) {
-  Serial.println("Getting digest info from API...");
+// Step 5: Read the server's reply and drop submitted readings from the queue
+cycle_step_t stepConfirm() {
+#if USE_DUAL_CORE_PIPELINE
+  // Queued transactions are confirmed by drainPipelineResults()
+  return CYCLE_STEP_DONE;
+#else
+  if (awaitingReply()) {
+    return CYCLE_STEP_PENDING;
+  }
 
-  HTTPClient http;
-  
-  // Get sender address from keypair
-  const char* address = keypair.toSuiAddress(&keypair);
-  String url = String(serverBaseUrl) + createDigestUrl + "?senderAddress=" + String(address);
-  
-  http.begin(url);
-  http.addHeader("Content-Type", "application/json");
+  if (cycle.pending == REPLY_EXECUTE) {
+    cycle.result = readExecuteFrame();
+  } else if (cycle.pending == REPLY_SUBMIT_TX) {
+    cycle.result = readSubmitTxReply();
+  } else if (cycle.pending == REPLY_EXECUTE_JSON) {
+    cycle.result = readExecuteJson();
+  }
+  cycle.pending = REPLY_NONE;
+
+  if (cycle.result != SUBMIT_OK) {
+    return CYCLE_STEP_FAILED;
+  }
+
+  if (readingLogReady) {
+    if (reading_log_commit(&readingLog, cycle.count) != READING_LOG_OK) {
+      Serial.println("Failed to commit reading log cursor");
+    }
+    Serial.printf("%u reading(s) still queued\n", (unsigned)reading_log_pending(&readingLog));
+  }
+  return CYCLE_STEP_DONE;
+#endif
+}
 
-  Serial.print("Sending GET request to: ");
-  Serial.println(url);
+// Advance the cycle's request; true while its reply is still on the way
+bool awaitingReply() {
+  if (async_http_busy(&cycle.http)) {
+    async_http_poll(&cycle.http);
+  }
+  return async_http_busy(&cycle.http);
+}
 
-  int httpCode = http.GET();
+// Lease a pooled gas coin for the cycle, with the current sensor ref
+bool acquireGasCoin(uint32_t now) {
+  if (gas_pool_acquire(&gasPool, now, &cycle.objects.gas_object, &cycle.lease) != GAS_POOL_OK) {
+    Serial.println("No gas coin available");
+    return false;
+  }
 
-  if (httpCode == 200) {
-    String response = http.getString();
-    Serial.println("Received digest info from API");
-    
-    DynamicJsonDocument doc(1024);
-    DeserializationError error = deserializeJson(doc, response);
+  memcpy(cycle.objects.sensor_object_id, sensorObjectId, sizeof(sensorObjectId));
+  cycle.objects.sensor_version = sensorVersion;
+  return true;
+}
 
-    if (error) {
-      Serial.printf("JSON parse failed: %s\n", error.c_str());
-      http.end();
-      return false;
+// Refill the pool from a fetched sensor ref and gas coin list
+void storeGasCoins(const sensor_frame_gas_coins_t* coins) {
+  memcpy(sensorObjectId, coins->sensor_object_id, sizeof(sensorObjectId));
+  sensorVersion = coins->sensor_version;
+  sensorRefValid = true;
+
+  unsigned long now = millis();
+  for (size_t i = 0; i < coins->gas_count; i++) {
+    gas_pool_put(&gasPool, &coins->gas_objects[i], now);
+  }
+  Serial.printf("Gas pool refreshed: %u coin(s) ready\n", (unsigned)gas_pool_count(&gasPool, GAS_COIN_READY));
+}
+
+#if USE_DUAL_CORE_PIPELINE
+// Parse the server URL once and start the network task on the other core
+bool startPipeline() {
+  uint16_t port;
+  if (!parseServerUrl(networkHost, sizeof(networkHost), &port)) {
+    Serial.println("Invalid server URL");
+    return false;
+  }
+
+  tx_pipeline_server_t server = {
+    networkHost, port, frameUrl, submitTxUrl, CYCLE_STATE_TIMEOUT, networkNow, networkIdle
+  };
+  tx_pipeline_init(&pipeline);
+  tx_pipeline_network_init(&network, &server);
+  return xTaskCreatePinnedToCore(networkTask, "tx_network", NETWORK_TASK_STACK, NULL, 1, NULL,
+                                 NETWORK_TASK_CORE) == pdPASS;
+}
+
+// Network core: one exchange at a time, in queue order. Only the pipeline's
+// network side and sockets are touched here (no Serial, pool or log).
+void networkTask(void* arg) {
+  (void)arg;
+  for (;;) {
+    if (!tx_pipeline_serve(&pipeline, &network)) {
+      vTaskDelay(1);
     }
+  }
+}
 
-    // Parse response
-    const char* sensorObjectId = doc["sensorObjectId"];
-    const char* sensorVersion = doc["sensorVersion"];
-    const char* gasObjectId = doc["gasObjectId"];
-    const char* gasVersion = doc["gasVersion"];
-    const char* gasDigest = doc["gasDigest"];
+uint32_t networkNow() {
+  return millis();
+}
 
-    if (!sensorObjectId || !sensorVersion || !gasObjectId || !gasVersion || !gasDigest) {
-      Serial.println("Missing required fields in digest response");
-      http.end();
-      return false;
+void networkIdle() {
+  vTaskDelay(1);
+}
+
+// Settle what the network task finished: gas coins go back to the pool with
+// the refs from the effects, and readings on chain leave the log
+void drainPipelineResults(uint32_t now) {
+  tx_pipeline_result_t result;
+  bool settled = false;
+
+  while (tx_pipeline_poll_result(&pipeline, &result)) {
+    if (result.kind == TX_PIPELINE_GAS_COINS) {
+      gasCoinsRequested = false;
+      if (result.status == TX_PIPELINE_OK) {
+        Serial.printf("Gas coins received: %u\n", (unsigned)result.coins.gas_count);
+        storeGasCoins(&result.coins);
+      } else {
+        Serial.printf("Gas coins request failed (HTTP %d, error %d)\n", result.http_status, result.error);
+        gasCoinsFailed = true;
+      }
+      continue;
     }
 
-    // Copy to struct
-    strncpy(digestInfo->sensorObjectId, sensorObjectId, sizeof(digestInfo->sensorObjectId) - 1);
-    strncpy(digestInfo->sensorVersion, sensorVersion, sizeof(digestInfo->sensorVersion) - 1);
-    strncpy(digestInfo->gasObjectId, gasObjectId, sizeof(digestInfo->gasObjectId) - 1);
-    strncpy(digestInfo->gasVersion, gasVersion, sizeof(digestInfo->gasVersion) - 1);
-    strncpy(digestInfo->gasDigest, gasDigest, sizeof(digestInfo->gasDigest) - 1);
-
-    Serial.println("Digest info parsed successfully:");
-    Serial.printf("  Sensor Object ID: %s\n", digestInfo->sensorObjectId);
-    Serial.printf("  Sensor Version: %s\n", digestInfo->sensorVersion);
-    Serial.printf("  Gas Object ID: %s\n", digestInfo->gasObjectId);
-    Serial.printf("  Gas Version: %s\n", digestInfo->gasVersion);
-    Serial.printf("  Gas Digest (Base58): %.32s...\n", digestInfo->gasDigest);
-
-    http.end();
-    return true;
+    // Unsent transactions leave the coin as it was; otherwise it is settled
+    // with the ref from the effects, or refetched before reuse
+    if (!result.sent) {
+      gas_pool_cancel(&gasPool, &result.lease);
+    } else {
+      if (result.have_next) {
+        memcpy(sensorObjectId, result.next.sensor_object_id, sizeof(sensorObjectId));
+        sensorVersion = result.next.sensor_version;
+      }
+      gas_pool_release(&gasPool, &result.lease, result.have_next ? &result.next.gas_object : NULL, now);
+    }
+    settled = true;
+
+    switch (result.status) {
+      case TX_PIPELINE_OK:
+        readingsInFlight = readingsInFlight > result.count ? readingsInFlight - result.count : 0;
+        pipelineConflicts = 0;
+        pipelineStalled = false;
+        if (readingLogReady && reading_log_commit(&readingLog, result.count) != READING_LOG_OK) {
+          Serial.println("Failed to commit reading log cursor");
+        }
+        if (result.kind == TX_PIPELINE_EXECUTE) {
+          char txDigestB58[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+          if (base58_encode(result.tx_digest, sizeof(result.tx_digest), txDigestB58, sizeof(txDigestB58), NULL) ==
+              BCS_OK) {
+            Serial.printf("Executed transaction: %s\n", txDigestB58);
+          }
+        }
+        Serial.printf("%u reading(s) on chain, %u still queued\n", (unsigned)result.count,
+                      readingLogReady ? (unsigned)reading_log_pending(&readingLog) : 0u);
+        break;
+      case TX_PIPELINE_SKIPPED:
+        // Queued behind a failed transaction; peeked again below
+        break;
+      default:
+        // Everything queued behind it comes back SKIPPED, so the next cycle
+        // starts again from the oldest reading not on chain
+        readingsInFlight = 0;
+        if (result.status == TX_PIPELINE_CONFLICT && pipelineConflicts == 0) {
+          Serial.println("Object version conflict - retrying with another gas ref");
+          pipelineConflicts = 1;
+          cycle_engine_trigger(&cycleEngine);
+        } else {
+          Serial.printf("Transaction failed (HTTP %d, error %d)\n", result.http_status, result.error);
+          pipelineStalled = true;
+        }
+        break;
+    }
+  }
+
+  // A backlog keeps one transaction per ready coin queued; after a failure
+  // it waits for the next sample
+  if (settled && !pipelineStalled && readingLogReady && reading_log_pending(&readingLog) > readingsInFlight &&
+      gas_pool_count(&gasPool, GAS_COIN_READY) > 0) {
+    cycle_engine_trigger(&cycleEngine);
+  }
+}
+
+// Lease a ready gas coin, or wait for one: coins in flight come back with
+// their results, otherwise one GAS_COINS request refills the pool
+cycle_step_t awaitGasCoin(uint32_t now) {
+  if (gasCoinsFailed) {
+    gasCoinsFailed = false;
+    return CYCLE_STEP_FAILED;
+  }
+
+  if (sensorRefValid && gas_pool_acquire(&gasPool, now, &cycle.objects.gas_object, &cycle.lease) == GAS_POOL_OK) {
+    memcpy(cycle.objects.sensor_object_id, sensorObjectId, sizeof(sensorObjectId));
+    cycle.objects.sensor_version = sensorVersion;
+    return CYCLE_STEP_DONE;
+  }
+
+  if (gasCoinsRequested || gas_pool_count(&gasPool, GAS_COIN_IN_FLIGHT) > 0) {
+    return CYCLE_STEP_PENDING;
+  }
+
+  tx_pipeline_request_t* request = tx_pipeline_reserve(&pipeline);
+  if (!request) {
+    return CYCLE_STEP_PENDING;
+  }
+  if (!identityReady) {
+    Serial.println("Sender Address not decoded");
+    return CYCLE_STEP_FAILED;
+  }
+  memcpy(request->sender, identity.sender, sizeof(request->sender));
+  request->kind = TX_PIPELINE_GAS_COINS;
+  request->count = 0;
+  request->lease.id = 0;
+  request->coins = GAS_POOL_COINS;
+  tx_pipeline_commit(&pipeline);
+
+  Serial.println("Getting gas coins from frame API...");
+  gasCoinsRequested = true;
+  return CYCLE_STEP_PENDING;
+}
+
+// Hand the signed transaction to the network task; its lease and readings are
+// settled by drainPipelineResults()
+cycle_step_t queueTransaction() {
+  // A transaction failed since these readings were peeked, so they no longer
+  // follow the last ones sent; the next cycle peeks again
+  if (cycle.epoch != pipeline.epoch) {
+    Serial.println("Earlier transaction failed - rebuilding");
+    return CYCLE_STEP_FAILED;
+  }
+
+  tx_pipeline_request_t* request = tx_pipeline_reserve(&pipeline);
+  if (!request) {
+    return CYCLE_STEP_PENDING;  // TX_PIPELINE_DEPTH requests already queued
+  }
+
+  // MicroSui returns the signature as Base64; requests carry its raw bytes
+  size_t signatureLen = 0;
+  if (base64_decode(cycle.signature_b64, strlen(cycle.signature_b64), request->signature,
+                    sizeof(request->signature), &signatureLen) != BCS_OK ||
+      signatureLen != SUI_SIGNATURE_LENGTH) {
+    Serial.println("Failed to decode signature");
+    return CYCLE_STEP_FAILED;
+  }
+
+  // Batches go as raw bytes to submit-tx; the sponsored endpoint rebuilds single readings
+  request->count = cycle.count;
+  request->lease = cycle.lease;
+  if (cycle.count > 1) {
+    request->kind = TX_PIPELINE_SUBMIT_TX;
+    memcpy(request->tx_bytes, cycle.txBytes, cycle.txLen);
+    request->tx_length = cycle.txLen;
   } else {
-    Serial.printf("HTTP GET failed: %d\n", httpCode);
-    String response = http.getString();
-    if (response.length() > 0) {
-      Serial.println(response);
+    request->kind = TX_PIPELINE_EXECUTE;
+    request->reading = cycle.readings[0];
+    request->gas = cycle.params.gas_object;
+  }
+  tx_pipeline_commit(&pipeline);
+
+  Serial.printf("Queued %u reading(s) for the network core\n", (unsigned)cycle.count);
+  readingsInFlight += cycle.count;
+  cycle.lease.id = 0;
+  cycle.submitted = true;
+  return CYCLE_STEP_DONE;
+}
+#endif
+
+// Ask create-digest for the sensor ref and up to GAS_POOL_COINS gas coins
+bool startDigestInfoJson() {
+  Serial.println("Getting digest info from API...");
+
+  if (!identityReady) {
+    Serial.println("Sender Address not decoded");
+    return false;
+  }
+
+  // Sender address decoded at boot
+  const char* address = identity.address;
+  size_t pathSize = strlen(createDigestUrl) + strlen("?senderAddress=") + strlen(address) + strlen("&coins=") + 4;
+  char* path = (char*)cycle_arena_alloc(&cycleArena, pathSize);
+  if (!path) {
+    Serial.println("Failed to allocate request URL");
+    return false;
+  }
+  snprintf(path, pathSize, "%s?senderAddress=%s&coins=%u", createDigestUrl, address, (unsigned)GAS_POOL_COINS);
+
+  Serial.printf("Sending GET request to: %s%s\n", serverBaseUrl, path);
+  return startRequest("GET", path, NULL, NULL, 0, REPLY_DIGEST_JSON);
+}
+
+// Refill the pool from the create-digest reply; its "gasCoins" list is
+// optional, the coin in the digest fields is always there
+bool readDigestInfoJson() {
+  cycle.pending = REPLY_NONE;
+  if (replyStatus("GET") != 200) {
+    return false;
+  }
+  Serial.println("Received digest info from API");
+
+  size_t length;
+  const char* body = (const char*)async_http_body(&cycle.http, &length);
+  CycleJsonDocument doc(2048);
+  DeserializationError error = deserializeJson(doc, body, length);
+  if (error) {
+    Serial.printf("JSON parse failed: %s\n", error.c_str());
+    return false;
+  }
+
+  DigestResponse digestInfo;
+  sensor_frame_digest_t info;
+  if (!readDigestFields(doc.as<JsonObjectConst>(), &digestInfo) || !decodeDigestResponse(&digestInfo, &info)) {
+    Serial.println("Failed to get digest info");
+    return false;
+  }
+
+  // Extra coins for the gas pool
+  sensor_frame_gas_coins_t coins;
+  coins.gas_count = 0;
+  for (JsonObjectConst coin : doc["gasCoins"].as<JsonArrayConst>()) {
+    if (coins.gas_count == GAS_POOL_COINS) {
+      break;
+    }
+    if (decodeObjectRef(coin["objectId"], coin["version"], coin["digest"], &coins.gas_objects[coins.gas_count])) {
+      coins.gas_count++;
     }
-    http.end();
+  }
+  memcpy(coins.sensor_object_id, info.sensor_object_id, sizeof(coins.sensor_object_id));
+  coins.sensor_version = info.sensor_version;
+  if (coins.gas_count == 0) {
+    // Server without ?coins= support: just the first coin
+    coins.gas_objects[0] = info.gas_object;
+    coins.gas_count = 1;
+  }
+
+  storeGasCoins(&coins);
+  return true;
+}
+
+// create-digest field names; also used for the "next" refs of execute-sponsored
+bool readDigestFields(JsonObjectConst fields, DigestResponse* digestInfo) {
+  const char* sensorObjectId = fields["sensorObjectId"];
+  const char* sensorVersion = fields["sensorVersion"];
+  const char* gasObjectId = fields["gasObjectId"];
+  const char* gasVersion = fields["gasVersion"];
+  const char* gasDigest = fields["gasDigest"];
+
+  if (!sensorObjectId || !sensorVersion || !gasObjectId || !gasVersion || !gasDigest) {
+    Serial.println("Missing required fields in digest response");
     return false;
   }
+
+  // Copy to struct
+  memset(digestInfo, 0, sizeof(*digestInfo));
+  strncpy(digestInfo->sensorObjectId, sensorObjectId, sizeof(digestInfo->sensorObjectId) - 1);
+  strncpy(digestInfo->sensorVersion, sensorVersion, sizeof(digestInfo->sensorVersion) - 1);
+  strncpy(digestInfo->gasObjectId, gasObjectId, sizeof(digestInfo->gasObjectId) - 1);
+  strncpy(digestInfo->gasVersion, gasVersion, sizeof(digestInfo->gasVersion) - 1);
+  strncpy(digestInfo->gasDigest, gasDigest, sizeof(digestInfo->gasDigest) - 1);
+
+  Serial.println("Digest info parsed successfully:");
+  Serial.printf("  Sensor Object ID: %s\n", digestInfo->sensorObjectId);
+  Serial.printf("  Sensor Version: %s\n", digestInfo->sensorVersion);
+  Serial.printf("  Gas Object ID: %s\n", digestInfo->gasObjectId);
+  Serial.printf("  Gas Version: %s\n", digestInfo->gasVersion);
+  Serial.printf("  Gas Digest (Base58): %.32s...\n", digestInfo->gasDigest);
+  return true;
 }
 
-bool buildTransaction(DigestResponse* digestInfo, char** transactionHex, size_t* transactionHexLen) {
-  Serial.println("Building transaction locally...");
+bool startGasCoinsFrame() {
+  Serial.println("Getting gas coins from frame API...");
 
-  // Prepare transaction builder parameters
-  transaction_builder_t params = { 0 };
+  if (!identityReady) {
+    Serial.println("Sender Address not decoded");
+    return false;
+  }
 
-  // Package ID (convert from hex string)
-  size_t bytes_read;
-  Serial.printf("Converting Package ID: %s\n", SENSOR_PACKAGE_ID);
-  bcs_error_t err = bcs_hex_to_bytes(SENSOR_PACKAGE_ID, params.package_id, 32, &bytes_read);
-  if (err != BCS_OK || bytes_read != 32) {
-    Serial.printf("Failed to convert Package ID: error %d, bytes_read: %d\n", err, bytes_read);
+  // Sent while later polls run, so the request lives in the cycle arena
+  uint8_t* frame = (uint8_t*)cycle_arena_alloc(&cycleArena, SENSOR_FRAME_MAX_SIZE);
+  if (!frame) {
+    Serial.println("Failed to allocate request frame");
+    return false;
+  }
+  bcs_writer_t writer;
+  bcs_writer_init_fixed(&writer, frame, SENSOR_FRAME_MAX_SIZE);
+  if (sensor_frame_write_gas_coins_request(&writer, identity.sender, GAS_POOL_COINS) != BCS_OK) {
+    Serial.println("Failed to encode gas coins request");
     return false;
   }
-  Serial.println("Package ID converted successfully");
 
-  // Module and function names
-  params.module_name = SENSOR_MODULE;
-  params.function_name = SENSOR_FUNCTION;
+  return startFrameRequest(frame, writer.position, REPLY_GAS_COINS);
+}
 
-  // Sender address (from keypair)
-  const char* address = keypair.toSuiAddress(&keypair);
-  Serial.printf("Converting Sender Address: %s\n", address);
-  err = bcs_hex_to_bytes(address, params.sender, 32, &bytes_read);
-  if (err != BCS_OK || bytes_read != 32) {
-    Serial.printf("Failed to convert Sender Address: error %d, bytes_read: %d\n", err, bytes_read);
+bool readGasCoinsFrame() {
+  cycle.pending = REPLY_NONE;
+
+  sensor_frame_t reply;
+  if (readReplyFrame(&reply) != 200) {
+    return false;
+  }
+  sensor_frame_gas_coins_t coins;
+  if (sensor_frame_read_gas_coins_response(&reply, &coins) != BCS_OK || coins.gas_count == 0) {
+    Serial.printf("Unexpected reply frame type %u\n", reply.type);
     return false;
   }
-  Serial.println("Sender Address converted successfully");
+
+  Serial.printf("Gas coins received (%u bytes)\n", (unsigned)reply.frame_length);
+  Serial.printf("  Sensor Version: %llu\n", coins.sensor_version);
+  Serial.printf("  Gas coins: %u\n", (unsigned)coins.gas_count);
+  storeGasCoins(&coins);
+  return true;
+}
+
+// Text fields of the JSON create-digest response to raw bytes
+bool decodeDigestResponse(const DigestResponse* digestInfo, sensor_frame_digest_t* out) {
+  size_t bytes_read;
+  bcs_error_t err;
 
   // Sensor object (convert from hex string)
   Serial.printf("Converting Sensor Object ID: %s\n", digestInfo->sensorObjectId);
@@ -458,37 +1286,33 @@ bool buildTransaction(DigestResponse* digestInfo, char** transactionHex, size_t*
   strncpy(sensorIdHexClean, sensorIdHex, copyLen);
   sensorIdHexClean[64] = '\0';
 
-  err = bcs_hex_to_bytes(sensorIdHexClean, params.sensor_object_id, 32, &bytes_read);
+  err = bcs_hex_to_bytes(sensorIdHexClean, out->sensor_object_id, 32, &bytes_read);
   if (err != BCS_OK || bytes_read != 32) {
     Serial.printf("Failed to convert Sensor Object ID: error %d, bytes_read: %d\n", err, bytes_read);
     return false;
   }
   Serial.println("Sensor Object ID converted successfully");
 
-  // Sensor version and digest
-  params.sensor_initial_shared_version = strtoull(digestInfo->sensorVersion, NULL, 10);
-  
-  // Note: For owned objects, we need the digest. In this flow, the server doesn't provide it.
-  // We'll need to fetch it separately or use a placeholder.
-  // For now, we'll use zeros (this is a limitation - in production you'd need to get the actual digest)
-  memset(params.sensor_digest, 0, 32);
-  Serial.println("Note: Using placeholder sensor digest (need to fetch from network)");
+  out->sensor_version = strtoull(digestInfo->sensorVersion, NULL, 10);
 
-  params.sensor_mutable = false;  // Typically not mutable for sensor objects
-  params.only_transaction_kind = false;  // Build full transaction block
+  return decodeObjectRef(digestInfo->gasObjectId, digestInfo->gasVersion, digestInfo->gasDigest, &out->gas_object);
+}
 
-  // Sensor data
-  params.sensor_data.value1 = currentSensorData.temperature;
-  params.sensor_data.value2 = currentSensorData.humidity;
-  params.sensor_data.value3 = currentSensorData.ec;
-  params.sensor_data.value4 = currentSensorData.ph;
-  params.sensor_data.timestamp = currentSensorData.timestamp;
+// ObjectRef from its JSON text forms (0x hex ID, decimal version, Base58 digest)
+bool decodeObjectRef(const char* objectId, const char* version, const char* digest, gas_object_t* out) {
+  size_t bytes_read;
+  bcs_error_t err;
+
+  if (!objectId || !version || !digest) {
+    Serial.println("Missing object ref fields");
+    return false;
+  }
 
   // Gas object (convert from hex string)
-  Serial.printf("Converting Gas Object ID: %s\n", digestInfo->gasObjectId);
+  Serial.printf("Converting Gas Object ID: %s\n", objectId);
   
   // Extract hex part (skip 0x prefix if present)
-  const char* gasIdHex = digestInfo->gasObjectId;
+  const char* gasIdHex = objectId;
   if (strncmp(gasIdHex, "0x", 2) == 0) {
     gasIdHex += 2;
   }
@@ -500,7 +1324,7 @@ bool buildTransaction(DigestResponse* digestInfo, char** transactionHex, size_t*
   strncpy(gasIdHexClean, gasIdHex, gasCopyLen);
   gasIdHexClean[64] = '\0';
 
-  err = bcs_hex_to_bytes(gasIdHexClean, params.gas_object.object_id, 32, &bytes_read);
+  err = bcs_hex_to_bytes(gasIdHexClean, out->object_id, 32, &bytes_read);
   if (err != BCS_OK || bytes_read != 32) {
     Serial.printf("Failed to convert Gas Object ID: error %d, bytes_read: %d\n", err, bytes_read);
     return false;
@@ -508,45 +1332,120 @@ bool buildTransaction(DigestResponse* digestInfo, char** transactionHex, size_t*
   Serial.println("Gas Object ID converted successfully");
 
   // Gas version and digest (Base58 decode)
-  params.gas_object.version = strtoull(digestInfo->gasVersion, NULL, 10);
+  out->version = strtoull(version, NULL, 10);
   
   // Convert gas digest from Base58 to bytes
-  Serial.printf("Decoding gas digest (Base58, length: %d): %.32s...\n", strlen(digestInfo->gasDigest), digestInfo->gasDigest);
-  if (base58_to_bytes(digestInfo->gasDigest, strlen(digestInfo->gasDigest), params.gas_object.digest, 32) != 0) {
-    Serial.println("Failed to decode gas digest from Base58");
+  Serial.printf("Decoding gas digest (Base58, length: %d): %.32s...\n", strlen(digest), digest);
+  size_t digestLen = 0;
+  err = base58_decode(digest, strlen(digest), out->digest, 32, &digestLen);
+  if (err != BCS_OK || digestLen != 32) {
+    Serial.printf("Failed to decode gas digest from Base58: error %d, bytes: %u\n", err, (unsigned)digestLen);
     return false;
   }
   Serial.println("Gas digest decoded from Base58 to bytes");
 
+  return true;
+}
+
+bool prepareTransactionParams(const sensor_frame_digest_t* info, transaction_builder_t* out) {
+  Serial.println("Preparing transaction parameters...");
+
+  // Prepare transaction builder parameters
+  transaction_builder_t params = { 0 };
+
+  // Package ID and sender address, decoded at boot
+  if (!identityReady) {
+    Serial.println("Package ID or Sender Address not decoded");
+    return false;
+  }
+  memcpy(params.package_id, identity.package_id, 32);
+  memcpy(params.sender, identity.sender, 32);
+
+  // Module and function names
+  params.module_name = SENSOR_MODULE;
+  params.function_name = SENSOR_FUNCTION;
+
+  // Sensor object and gas coin arrive as raw bytes
+  memcpy(params.sensor_object_id, info->sensor_object_id, 32);
+  params.sensor_initial_shared_version = info->sensor_version;
+
+  // Note: For owned objects, we need the digest. In this flow, the server doesn't provide it.
+  // We'll need to fetch it separately or use a placeholder.
+  // For now, we'll use zeros (this is a limitation - in production you'd need to get the actual digest)
+  memset(params.sensor_digest, 0, 32);
+  Serial.println("Note: Using placeholder sensor digest (need to fetch from network)");
+
+  params.sensor_mutable = false;  // Typically not mutable for sensor objects
+  params.only_transaction_kind = false;  // Build full transaction block
+
+  params.gas_object = info->gas_object;
+
   // Gas budget and price
   params.gas_budget = 100000000;
   params.gas_price = 1000;
 
   Serial.println("Transaction parameters prepared:");
-  Serial.printf("  Temperature: %u\n", params.sensor_data.value1);
-  Serial.printf("  Humidity: %u\n", params.sensor_data.value2);
-  Serial.printf("  pH: %u\n", params.sensor_data.value3);
-  Serial.printf("  EC: %u\n", params.sensor_data.value4);
-  Serial.printf("  Timestamp: %llu\n", params.sensor_data.timestamp);
   Serial.printf("  Gas budget: %llu\n", params.gas_budget);
   Serial.printf("  Gas price: %llu\n", params.gas_price);
 
-  // Build the transaction
-  err = sui_build_sensor_transaction(&params, transactionHex, transactionHexLen);
+  *out = params;
+  return true;
+}
+
+bool buildTransaction(const transaction_builder_t* params, const uint8_t** txBytes, size_t* txLen,
+                      uint8_t* txDigest) {
+  Serial.println("Building transaction locally...");
+  Serial.printf("  Temperature: %u\n", params->sensor_data.value1);
+  Serial.printf("  Humidity: %u\n", params->sensor_data.value2);
+  Serial.printf("  EC: %u\n", params->sensor_data.value3);
+  Serial.printf("  pH: %u\n", params->sensor_data.value4);
+
+  // Build the transaction (compile the template on the first cycle, patch afterwards)
+  bcs_error_t err;
+  if (!txTemplateReady) {
+    err = sui_compile_sensor_template(params, txTemplateBuffer, sizeof(txTemplateBuffer), &txTemplate);
+    if (err != BCS_OK) {
+      Serial.printf("Failed to build transaction: error code %d\n", err);
+      return false;
+    }
+    txTemplateReady = true;
+  } else {
+    sui_sensor_template_set_sensor_data(&txTemplate, &params->sensor_data);
+    sui_sensor_template_set_gas_object(&txTemplate, &params->gas_object);
+    sui_sensor_template_set_gas(&txTemplate, params->gas_price, params->gas_budget);
+  }
+
+  *txBytes = sui_sensor_template_bytes(&txTemplate, txLen);
+
+  // Patching skips the writer, so hash the finished bytes once
+  sui_transaction_digest(*txBytes, *txLen, SUI_DIGEST_TRANSACTION, txDigest);
+
+  Serial.printf("Transaction built successfully: %zu bytes\n", *txLen);
+  return true;
+}
 
+bool buildBatchTransaction(const transaction_builder_t* params, const sensor_data_t* readings, size_t count,
+                           const uint8_t** txBytes, size_t* txLen, uint8_t* txDigest) {
+  Serial.printf("Building batched transaction for %u readings...\n", (unsigned)count);
+
+  // The digest is computed while the bytes are written
+  bcs_writer_t writer;
+  blake2b_state_t hash;
+  bcs_writer_init_fixed(&writer, batchTxBuffer, sizeof(batchTxBuffer));
+  sui_digest_begin(&writer, &hash, SUI_DIGEST_TRANSACTION);
+  bcs_error_t err = sui_build_sensor_batch_transaction_into(params, readings, count, &writer);
+  if (err == BCS_OK) {
+    err = bcs_writer_finish_hash(&writer, txDigest);
+  }
   if (err != BCS_OK) {
-    Serial.printf("Failed to build transaction: error code %d\n", err);
+    Serial.printf("Failed to build batched transaction: error code %d\n", err);
     return false;
   }
 
-  Serial.printf("Transaction built successfully: %zu bytes (hex length: %zu)\n",
-                *transactionHexLen / 2, *transactionHexLen);
-  Serial.print("Transaction hex (first 128 chars): ");
-  for (int i = 0; i < 128 && i < strlen(*transactionHex); i++) {
-    Serial.print((*transactionHex)[i]);
-  }
-  Serial.println("...");
+  *txBytes = writer.buffer;
+  *txLen = writer.position;
 
+  Serial.printf("Batched transaction built: %zu bytes\n", *txLen);
   return true;
 }
 
@@ -571,57 +1470,283 @@ bool signTransactionWithMicroSui(const char* transactionHex, char* signature_b64
   }
 }
 
-void executeSponsoredTransaction(const char* signature_b64, DigestResponse* digestInfo) {
+// JSON transport: the gas field is the ref the transaction was signed with;
+// the server rebuilds with it and replies with the refs left by the execution
+bool startExecuteJson() {
   Serial.println("Submitting transaction to execute-sponsored API...");
 
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("WiFi not connected");
-    return;
+  const sensor_data_t* reading = &cycle.readings[0];
+  const gas_object_t* gas = &cycle.params.gas_object;
+
+  // Gas ref in create-digest's text forms
+  char gasObjectId[67] = "0x";
+  char gasVersion[21];
+  char gasDigest[BASE58_ENCODED_SIZE(32) + 1];
+  bcs_bytes_to_hex(gas->object_id, 32, gasObjectId + 2);
+  snprintf(gasVersion, sizeof(gasVersion), "%llu", gas->version);
+  if (base58_encode(gas->digest, 32, gasDigest, sizeof(gasDigest), NULL) != BCS_OK) {
+    Serial.println("Failed to encode gas digest");
+    return false;
   }
 
-  HTTPClient http;
-  String url = String(serverBaseUrl) + executeSponsoredUrl;
-  http.begin(url);
-  http.addHeader("Content-Type", "application/json");
-
-  DynamicJsonDocument doc(1024);
-  doc["temperature"] = currentSensorData.temperature;
-  doc["humidity"] = currentSensorData.humidity;
-  doc["ec"] = currentSensorData.ec;
-  doc["ph"] = currentSensorData.ph;
-  doc["timestamp"] = currentSensorData.timestamp;
-  doc["signature"] = signature_b64;
- 
+  CycleJsonDocument doc(1024);
+  doc["temperature"] = reading->value1;
+  doc["humidity"] = reading->value2;
+  doc["ec"] = reading->value3;
+  doc["ph"] = reading->value4;
+  doc["timestamp"] = reading->timestamp;
+  doc["signature"] = cycle.signature_b64;
+  doc["gasObjectId"] = gasObjectId;
+  doc["gasVersion"] = gasVersion;
+  doc["gasDigest"] = gasDigest;
 
   Serial.println("Including sensor data and signature in POST request:");
-  Serial.printf("  Temperature: %u\n", currentSensorData.temperature);
-  Serial.printf("  Humidity: %u\n", currentSensorData.humidity);
-  Serial.printf("  EC: %u\n", currentSensorData.ec);
-  Serial.printf("  pH: %u\n", currentSensorData.ph);
-  Serial.printf("  Timestamp: %llu\n", currentSensorData.timestamp);
-  Serial.printf("  Signature: %s\n", signature_b64);
-
-  String payload;
-  serializeJson(doc, payload);
+  Serial.printf("  Temperature: %u\n", reading->value1);
+  Serial.printf("  Humidity: %u\n", reading->value2);
+  Serial.printf("  EC: %u\n", reading->value3);
+  Serial.printf("  pH: %u\n", reading->value4);
+  Serial.printf("  Timestamp: %llu\n", reading->timestamp);
+  Serial.printf("  Signature: %s\n", cycle.signature_b64);
 
   Serial.println("Sending POST request...");
-  Serial.printf("Payload size: %d bytes\n", payload.length());
+  return startJsonRequest(executeSponsoredUrl, &doc, REPLY_EXECUTE_JSON);
+}
+
+// Only the next refs are kept from the (large) execution result
+SubmitResult readExecuteJson() {
+  int httpCode = replyStatus("POST");
+  if (httpCode != 200) {
+    return httpCode == 409 ? SUBMIT_CONFLICT : SUBMIT_FAILED;
+  }
+  Serial.println("POST successful");
+
+  size_t length;
+  const char* body = (const char*)async_http_body(&cycle.http, &length);
+  StaticJsonDocument<64> filter;
+  filter["next"] = true;
+  CycleJsonDocument reply(1024);
+  DeserializationError error = deserializeJson(reply, body, length, DeserializationOption::Filter(filter));
+
+  // Executed either way; without next refs the coin is refetched before reuse
+  DigestResponse nextFields;
+  if (error) {
+    Serial.printf("JSON parse failed: %s\n", error.c_str());
+  } else {
+    cycle.haveNext = readDigestFields(reply["next"].as<JsonObjectConst>(), &nextFields) &&
+                     decodeDigestResponse(&nextFields, &cycle.next);
+  }
+  return SUBMIT_OK;
+}
+
+bool startExecuteFrame() {
+  Serial.println("Submitting transaction to frame API...");
+
+  // MicroSui returns the signature as Base64; the frame carries its raw bytes
+  uint8_t signature[SUI_SIGNATURE_LENGTH];
+  size_t signatureLen = 0;
+  if (base64_decode(cycle.signature_b64, strlen(cycle.signature_b64), signature, sizeof(signature),
+                    &signatureLen) != BCS_OK ||
+      signatureLen != SUI_SIGNATURE_LENGTH) {
+    Serial.println("Failed to decode signature");
+    return false;
+  }
+
+  uint8_t* frame = (uint8_t*)cycle_arena_alloc(&cycleArena, SENSOR_FRAME_MAX_SIZE);
+  if (!frame) {
+    Serial.println("Failed to allocate request frame");
+    return false;
+  }
+  bcs_writer_t writer;
+  bcs_writer_init_fixed(&writer, frame, SENSOR_FRAME_MAX_SIZE);
+  if (sensor_frame_write_execute_request(&writer, &cycle.readings[0], &cycle.params.gas_object, signature) !=
+      BCS_OK) {
+    Serial.println("Failed to encode execute request");
+    return false;
+  }
+
+  Serial.printf("Payload size: %u bytes\n", (unsigned)writer.position);
+  return startFrameRequest(frame, writer.position, REPLY_EXECUTE);
+}
+
+// The reply carries the transaction digest and the refs for the next cycle
+SubmitResult readExecuteFrame() {
+  sensor_frame_t reply;
+  int status = readReplyFrame(&reply);
+  if (status != 200) {
+    return status == 409 ? SUBMIT_CONFLICT : SUBMIT_FAILED;
+  }
 
-  int httpCode = http.POST(payload);
+  uint8_t txDigest[SUI_DIGEST_LENGTH];
+  if (sensor_frame_read_execute_response(&reply, txDigest, &cycle.next) != BCS_OK) {
+    Serial.printf("Unexpected reply frame type %u\n", reply.type);
+    return SUBMIT_FAILED;
+  }
+  cycle.haveNext = true;
+
+  char txDigestB58[BASE58_ENCODED_SIZE(SUI_DIGEST_LENGTH) + 1];
+  if (base58_encode(txDigest, sizeof(txDigest), txDigestB58, sizeof(txDigestB58), NULL) == BCS_OK) {
+    Serial.printf("Executed transaction: %s\n", txDigestB58);
+  }
+  return SUBMIT_OK;
+}
+
+// Sends {"txBytes": hex, "signature": b64} straight from the transaction hex
+// and signature of the cycle; nothing is copied into a payload buffer
+bool startSubmitTx() {
+  Serial.println("Submitting signed transaction bytes to submit-tx API...");
+
+  static const char head[] = "{\"txBytes\":\"";
+  static const char middle[] = "\",\"signature\":\"";
+  static const char tail[] = "\"}";
+  async_http_part_t body[] = {
+    { (const uint8_t*)head, sizeof(head) - 1 },
+    { (const uint8_t*)cycle.transactionHex, cycle.txLen * 2 },
+    { (const uint8_t*)middle, sizeof(middle) - 1 },
+    { (const uint8_t*)cycle.signature_b64, strlen(cycle.signature_b64) },
+    { (const uint8_t*)tail, sizeof(tail) - 1 },
+  };
+
+  size_t payloadLen = 0;
+  for (size_t i = 0; i < sizeof(body) / sizeof(body[0]); i++) {
+    payloadLen += body[i].length;
+  }
+  Serial.printf("Payload size: %u bytes\n", (unsigned)payloadLen);
+
+  return startRequest("POST", submitTxUrl, "application/json", body, sizeof(body) / sizeof(body[0]),
+                      REPLY_SUBMIT_TX);
+}
 
+// Status only; the body is only of interest on failure
+SubmitResult readSubmitTxReply() {
+  int httpCode = replyStatus("POST");
   if (httpCode == 200) {
-    String response = http.getString();
     Serial.println("POST successful");
-    Serial.println(response);
-  } else {
-    Serial.printf("POST failed: %d\n", httpCode);
-    String response = http.getString();
-    if (response.length() > 0) {
-      Serial.println(response);
-    }
+    return SUBMIT_OK;
+  }
+  return httpCode == 409 ? SUBMIT_CONFLICT : SUBMIT_FAILED;
+}
+
+// Status of the cycle's completed request; failures are logged with their body
+int replyStatus(const char* method) {
+  int httpCode = async_http_status(&cycle.http);
+  if (httpCode == 200) {
+    return httpCode;
+  }
+
+  if (httpCode == 0) {
+    Serial.printf("%s failed: error %d\n", method, cycle.http.error);
+    return httpCode;
+  }
+  Serial.printf("%s failed: %d\n", method, httpCode);
+  size_t length;
+  const uint8_t* body = async_http_body(&cycle.http, &length);
+  if (length > 0) {
+    Serial.printf("%.*s\n", (int)length, (const char*)body);
+  }
+  return httpCode;
+}
+
+// Start a request to the server for the cycle; the reply is read by a later
+// step once async_http_poll() completes it
+bool startRequest(const char* method, const char* path, const char* contentType, const async_http_part_t* body,
+                  size_t parts, PendingReply pending) {
+  char host[64];
+  uint16_t port;
+  if (!parseServerUrl(host, sizeof(host), &port)) {
+    Serial.println("Invalid server URL");
+    return false;
+  }
+
+  size_t responseSize =
+      pending == REPLY_DIGEST_JSON || pending == REPLY_EXECUTE_JSON ? HTTP_JSON_RESPONSE_BUFFER : HTTP_RESPONSE_BUFFER;
+  cycle.response = (uint8_t*)cycle_arena_alloc(&cycleArena, responseSize);
+  if (!cycle.response) {
+    Serial.println("Failed to allocate response buffer");
+    return false;
+  }
+
+  async_http_error_t err = async_http_start(&cycle.http, host, port, method, path, contentType, body, parts,
+                                            cycle.response, responseSize);
+  if (err != ASYNC_HTTP_OK) {
+    Serial.printf("Connection to server failed: %d\n", err);
+    return false;
   }
 
-  http.end();
+  cycle.pending = pending;
+  return true;
+}
+
+// POST one frame to /api/frame; frame must stay valid until the reply arrives
+bool startFrameRequest(const uint8_t* frame, size_t frameLen, PendingReply pending) {
+  async_http_part_t body = { frame, frameLen };
+  return startRequest("POST", frameUrl, "application/octet-stream", &body, 1, pending);
+}
+
+// Serialize doc into the cycle arena and POST it; the payload stays there
+// until the reply is read
+bool startJsonRequest(const char* path, CycleJsonDocument* doc, PendingReply pending) {
+  size_t payloadLen = measureJson(*doc);
+  char* payload = (char*)cycle_arena_alloc(&cycleArena, payloadLen + 1);
+  if (!payload) {
+    Serial.println("Failed to allocate request payload");
+    return false;
+  }
+  serializeJson(*doc, payload, payloadLen + 1);
+
+  Serial.printf("Payload size: %u bytes\n", (unsigned)payloadLen);
+
+  async_http_part_t body = { (const uint8_t*)payload, payloadLen };
+  return startRequest("POST", path, "application/json", &body, 1, pending);
+}
+
+// Reply frame of a completed frame request. Returns 200 for a reply frame,
+// the status of a (logged) ERROR reply, or <= 0 if no frame arrived.
+int readReplyFrame(sensor_frame_t* reply) {
+  int httpCode = async_http_status(&cycle.http);
+  if (httpCode <= 0) {
+    Serial.printf("POST failed: error %d\n", cycle.http.error);
+    return httpCode;
+  }
+
+  size_t length;
+  const uint8_t* body = async_http_body(&cycle.http, &length);
+  if (sensor_frame_parse(body, length, reply) != BCS_OK) {
+    Serial.printf("Malformed reply frame (HTTP %d, %u bytes)\n", httpCode, (unsigned)length);
+    return 0;
+  }
+
+  if (reply->type == SENSOR_FRAME_ERROR) {
+    uint16_t status = 0;
+    bcs_view_t message = { NULL, 0 };
+    sensor_frame_read_error(reply, &status, &message);
+    Serial.printf("Server error %u: %.*s\n", status, (int)message.length, (const char*)message.data);
+    return status;
+  }
+
+  return httpCode;
+}
+
+// Split serverBaseUrl ("http://host[:port]") for socket-level requests
+bool parseServerUrl(char* host, size_t hostSize, uint16_t* port) {
+  const char* start = strstr(serverBaseUrl, "://");
+  start = start ? start + 3 : serverBaseUrl;
+
+  size_t hostLen = strcspn(start, ":/");
+  if (hostLen == 0 || hostLen >= hostSize) {
+    return false;
+  }
+  memcpy(host, start, hostLen);
+  host[hostLen] = '\0';
+
+  *port = 80;
+  if (start[hostLen] == ':') {
+    long value = strtol(start + hostLen + 1, nullptr, 10);
+    if (value <= 0 || value > 65535) {
+      return false;
+    }
+    *port = (uint16_t)value;
+  }
+  return true;
 }
 
 void trimString(char* str) {
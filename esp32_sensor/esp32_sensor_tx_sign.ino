@@ -1,5 +1,4 @@
 #include <WiFi.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
 
 // MicroSui and BCS includes (Ensure MicroSui library is installed via Library Manager)
@@ -7,12 +6,25 @@
 // Note: BCS and sui_transaction headers are included within the MicroSui library
 // but are not needed for direct inclusion here if using the keypair methods.
 
+// Flash-backed queue of readings not yet submitted
+#include <LittleFS.h>
+#include "reading_log.h"
+
+// Pre-sign inspection of the transaction returned by /api/build-tx
+#include "sui_transaction.h"
+
+// Non-blocking main loop: sampling runs from a timer while a cycle engine
+// advances build -> sign -> submit a step per loop()
+#include "timer_wheel.h"
+#include "cycle_engine.h"
+#include "async_http.h"
+
 // ===== CONFIGURATION =====
 // WiFi Credentials
 const char *ssid = "bruh";
 const char *password = "megabruh";
 
-// Server API Endpoints (UPDATE WITH YOUR SERVER'S IP)
+// Server API Endpoints (UPDATE WITH YOUR SERVER'S IP; plain http only)
 const char *buildTxUrl = "http://192.168.137.1:3000/api/build-tx";
 const char *submitTxUrl = "http://192.168.137.1:3000/api/submit-tx";
 
@@ -21,6 +33,13 @@ const char *deviceId = "ESP32_SENSOR_001";
 const char *sensorType = "soil"; // soil, air, water, weather, industrial
 const char *location = "Greenhouse A";
 
+// Only transactions calling this target are signed
+const char *sensorPackageId = ""; // e.g., "0x1234..." (empty: any package)
+const char *sensorModule = "sensor_storage";
+const char *sensorFunction = "store_sensor_data";
+#define MAX_GAS_BUDGET 100000000ULL // Matches the budget /api/build-tx sets
+#define MAX_TX_BYTES 1024           // Largest transaction accepted for signing
+
 // SUI CONFIGURATION
 // !!! CRITICAL: REPLACE THIS WITH YOUR ACTUAL SUI PRIVATE KEY IN BECH32 FORMAT (starts with suiprivkey1...)
 // THIS IS A MOCK KEY: REPLACE IT.
@@ -28,11 +47,65 @@ const char *SUI_PRIVATE_KEY_BECH32 = ".....";
 
 // Data generation settings
 unsigned long sendInterval = 60000; // 60 seconds
-unsigned long lastSendTime = 0;
+
+// Main loop settings
+#define TIMER_WHEEL_TICK_SHIFT 4 // 16 ms ticks
+#define CYCLE_STATE_TIMEOUT 15000 // Longest a cycle state may wait on WiFi or the server
+#define CYCLE_RETRY_DELAY 5000 // Unused: failures wait for the next sample
+#define HTTP_RESPONSE_BUFFER (MAX_TX_BYTES * 2 + 1024) // build-tx replies carry the transaction hex
+#define LOOP_POLL_INTERVAL 5 // ms between polls
+
+// Reading queue settings
+#define READING_LOG_DIR "/littlefs/rlog"
+#define READING_LOG_SEGMENT_RECORDS 256
+#define READING_LOG_MAX_SEGMENTS 16
+#define REPLAY_BATCH_MAX 8 // Queued readings drained per cycle
+
+reading_log_file_storage_t readingLogFiles;
+reading_log_t readingLog;
+bool readingLogReady = false;
 
 // MicroSui Keypair globally accessible
 MicroSuiEd25519 keypair;
 
+// Signing policy, filled in once the keypair is loaded
+uint8_t deviceAddress[32];
+uint8_t expectedPackageId[32];
+sui_tx_policy_t signPolicy;
+
+// Scratch for decoding and indexing the transaction before signing
+uint8_t txCheckBuffer[MAX_TX_BYTES];
+sui_tx_index_t txIndex;
+
+// The reading in flight; request bodies and the reply buffer stay valid
+// until the request that uses them completes
+struct SubmitCycle
+{
+    sensor_data_t reading;
+    bool requested; // build-tx request sent
+    char requestBody[256];
+    char transactionHex[MAX_TX_BYTES * 2 + 1];
+    size_t hexLength;
+    char signature[256];
+    async_http_t http;
+};
+SubmitCycle cycle;
+uint8_t response[HTTP_RESPONSE_BUFFER];
+
+timer_wheel_t timerWheel;
+cycle_engine_t cycleEngine;
+wl_status_t wifiStatus = WL_IDLE_STATUS;
+
+// Without a reading log only the latest reading is kept for the next cycle
+sensor_data_t latestReading;
+bool readingPending = false;
+size_t replayed = 0; // Queued readings sent since the last sample
+
+// Serial commands are collected a character at a time
+char commandLine[32];
+size_t commandLength = 0;
+bool awaitingInterval = false;
+
 // ===== HELPER FUNCTIONS (MicroSui & Utility) =====
 
 // Safe MicroSui keypair initialization
@@ -45,7 +118,9 @@ bool initializeMicroSuiKeypair()
 
     // Check if keypair is valid by trying to get address
     const char *address = keypair.toSuiAddress(&keypair);
-    if (address && strlen(address) > 0)
+    size_t addressLen = 0;
+    if (address && strlen(address) > 0 &&
+        bcs_hex_to_bytes(address, deviceAddress, sizeof(deviceAddress), &addressLen) == BCS_OK && addressLen == 32)
     {
         Serial.print("Keypair loaded - Address: ");
         Serial.println(address);
@@ -96,28 +171,194 @@ bool signTransactionHex(const char *transactionHex, char *signature_b64_out)
     }
 }
 
+// Build the policy every transaction must satisfy before it is signed
+bool initializeSignPolicy()
+{
+    memset(&signPolicy, 0, sizeof(signPolicy));
+    signPolicy.sender = deviceAddress;
+    signPolicy.gas_owner = deviceAddress;
+    signPolicy.module_name = sensorModule;
+    signPolicy.function_name = sensorFunction;
+    signPolicy.max_gas_budget = MAX_GAS_BUDGET;
+
+    if (strlen(sensorPackageId) == 0)
+    {
+        Serial.println("⚠️ sensorPackageId not set - package will not be checked before signing");
+        return true;
+    }
+
+    size_t packageLen = 0;
+    if (bcs_hex_to_bytes(sensorPackageId, expectedPackageId, sizeof(expectedPackageId), &packageLen) != BCS_OK || packageLen != 32)
+    {
+        Serial.println("❌ Invalid sensorPackageId");
+        return false;
+    }
+    signPolicy.package_id = expectedPackageId;
+    return true;
+}
+
+/**
+ * @brief Refuses to sign anything but the expected MoveCall carrying this reading.
+ * @param transactionHex The unsigned transaction bytes as a Hex string.
+ * @param reading The reading the transaction was requested for.
+ * @return true if the transaction may be signed.
+ */
+bool verifyTransactionBeforeSigning(const char *transactionHex, const sensor_data_t *reading)
+{
+    unsigned long startMicros = micros();
+
+    size_t txLen = 0;
+    if (bcs_hex_to_bytes(transactionHex, txCheckBuffer, sizeof(txCheckBuffer), &txLen) != BCS_OK)
+    {
+        Serial.println("❌ Tx bytes are not valid hex or exceed MAX_TX_BYTES");
+        return false;
+    }
+
+    bcs_error_t err = sui_index_transaction(txCheckBuffer, txLen, &txIndex);
+    if (err != BCS_OK)
+    {
+        Serial.printf("❌ Tx bytes are not a supported TransactionData (error %d)\n", err);
+        return false;
+    }
+
+    sui_tx_check_t check = sui_check_transaction(txCheckBuffer, &txIndex, &signPolicy);
+    if (check != SUI_TX_CHECK_OK)
+    {
+        Serial.printf("❌ Refusing to sign: %s\n", sui_tx_check_name(check));
+        return false;
+    }
+
+    // The first four Pure inputs are the u64 readings, in request order
+    const uint16_t expected[4] = {reading->value1, reading->value2, reading->value3, reading->value4};
+    size_t pureIndex = 0;
+    for (size_t i = 0; i < txIndex.num_inputs && pureIndex < 4; i++)
+    {
+        const sui_tx_input_t *input = &txIndex.inputs[i];
+        if (input->kind != 0)
+        {
+            continue;
+        }
+
+        bcs_reader_t reader;
+        uint64_t value;
+        bcs_reader_init(&reader, txCheckBuffer + input->value_offset, input->value_length);
+        if (input->value_length != 8 || bcs_read_u64(&reader, &value) != BCS_OK || value != expected[pureIndex])
+        {
+            Serial.printf("❌ Refusing to sign: reading %u does not match\n", (unsigned)pureIndex);
+            return false;
+        }
+        pureIndex++;
+    }
+    if (pureIndex < 4)
+    {
+        Serial.println("❌ Refusing to sign: readings missing from transaction");
+        return false;
+    }
+
+    Serial.printf("✅ Tx verified in %lu us (%u bytes, gas budget %llu)\n",
+                  micros() - startMicros, (unsigned)txLen, (unsigned long long)txIndex.gas_budget);
+    return true;
+}
+
 float randomFloat(float min, float max)
 {
     return min + static_cast<float>(random(0, 1000)) / 1000.0 * (max - min);
 }
 
-// ===== MAIN WORKFLOW FUNCTION =====
 
-void generateAndSendData()
+// Split a server URL ("http://host[:port]/path") for the socket-level request
+bool parseUrl(const char *url, char *host, size_t hostSize, uint16_t *port, const char **path)
 {
-    if (WiFi.status() != WL_CONNECTED)
+    const char *start = strstr(url, "://");
+    start = start ? start + 3 : url;
+
+    size_t hostLen = strcspn(start, ":/");
+    if (hostLen == 0 || hostLen >= hostSize)
     {
-        Serial.println("WiFi not connected. Attempting to reconnect...");
-        WiFi.reconnect();
-        delay(1000);
-        return;
+        return false;
     }
+    memcpy(host, start, hostLen);
+    host[hostLen] = '\0';
 
-    if (!keypair.isInitialized)
+    *port = 80;
+    if (start[hostLen] == ':')
     {
-        Serial.println("Cannot proceed: Keypair not initialized.");
-        return;
+        long value = strtol(start + hostLen + 1, nullptr, 10);
+        if (value <= 0 || value > 65535)
+        {
+            return false;
+        }
+        *port = (uint16_t)value;
+    }
+    *path = strchr(start, '/');
+    if (!*path)
+    {
+        *path = "/";
     }
+    return true;
+}
+
+// POST body parts to url; the reply is read by a later step
+bool startPost(const char *url, const async_http_part_t *body, size_t parts)
+{
+    char host[64];
+    uint16_t port;
+    const char *path;
+    if (!parseUrl(url, host, sizeof(host), &port, &path))
+    {
+        Serial.printf("❌ Invalid URL: %s\n", url);
+        return false;
+    }
+
+    async_http_error_t err = async_http_start(&cycle.http, host, port, "POST", path, "application/json", body, parts,
+                                              response, sizeof(response));
+    if (err != ASYNC_HTTP_OK)
+    {
+        Serial.printf("❌ Connection to server failed: %d\n", err);
+        return false;
+    }
+    return true;
+}
+
+// Advance the cycle's request; true while its reply is still on the way
+bool awaitingReply()
+{
+    if (async_http_busy(&cycle.http))
+    {
+        async_http_poll(&cycle.http);
+    }
+    return async_http_busy(&cycle.http);
+}
+
+// Body of a 200 reply, parsed in place (the reply buffer is ours); NULL otherwise
+char *replyBody(const char *stage, size_t *length)
+{
+    int httpCode = async_http_status(&cycle.http);
+    char *body = (char *)async_http_body(&cycle.http, length);
+    if (httpCode == 200)
+    {
+        return body;
+    }
+
+    if (httpCode == 0)
+    {
+        Serial.printf("❌ %s HTTP Error: %d\n", stage, cycle.http.error);
+    }
+    else
+    {
+        Serial.printf("❌ %s HTTP Error: %d\n", stage, httpCode);
+        Serial.printf("  Error Response: %.*s\n", (int)*length, body);
+    }
+    return NULL;
+}
+
+// ===== MAIN WORKFLOW =====
+
+// Sample timer: generate a reading and queue it
+bool sampleSensor(void *ctx, uint32_t now)
+{
+    (void)ctx;
+    (void)now;
 
     // 1. Generate Sensor Data
     float temperature_f = randomFloat(20.0, 30.0);
@@ -126,157 +367,356 @@ void generateAndSendData()
     float ph_f = randomFloat(6.0, 7.5);
 
     // Convert float readings to u16 integer format (assuming 2 decimal places, e.g., 25.50C -> 2550)
-    uint16_t temperature = (uint16_t)(temperature_f * 100);
-    uint16_t humidity = (uint16_t)(humidity_f * 100);
-    uint16_t ph = (uint16_t)(ph_f * 100);
-
-    Serial.println("\n=== Starting Prepare-Sign-Submit Workflow ===");
-    Serial.printf("Data: Temp=%d, Humid=%d, EC=%d, pH=%d\n", temperature, humidity, ec, ph);
-
-    // 2. --- STEP 1: POST to /api/build-tx (Get Transaction Hex) ---
-    Serial.printf("\n1. Requesting transaction bytes from: %s\n", buildTxUrl);
-
-    HTTPClient buildHttp;
-    buildHttp.begin(buildTxUrl);
-    buildHttp.addHeader("Content-Type", "application/json");
-
-    // Dynamic document is used to ensure it fits the data and location
-    DynamicJsonDocument buildDoc(512);
-    buildDoc["temperature"] = temperature;
-    buildDoc["humidity"] = humidity;
-    buildDoc["ec"] = ec;
-    buildDoc["ph"] = ph;
-    buildDoc["deviceId"] = deviceId;
-    buildDoc["sensorType"] = sensorType;
-    buildDoc["location"] = location;
+    sensor_data_t reading;
+    reading.value1 = (uint16_t)(temperature_f * 100);
+    reading.value2 = (uint16_t)(humidity_f * 100);
+    reading.value3 = (uint16_t)ec;
+    reading.value4 = (uint16_t)(ph_f * 100);
+    reading.timestamp = millis() / 1000;
+
+    // Queue it first so it survives WiFi/HTTP failures and resets
+    if (readingLogReady)
+    {
+        if (reading_log_append(&readingLog, &reading) != READING_LOG_OK)
+        {
+            Serial.println("❌ Failed to queue reading");
+        }
+    }
+    else
+    {
+        latestReading = reading;
+        readingPending = true;
+    }
 
-    String buildPayload;
-    serializeJson(buildDoc, buildPayload);
+    // Each sample drains up to REPLAY_BATCH_MAX queued readings
+    replayed = 0;
+    return true;
+}
 
-    int buildHttpCode = buildHttp.POST(buildPayload);
+// Oldest queued reading, or the latest one without a log
+bool nextReading(sensor_data_t *reading)
+{
+    if (!readingLogReady)
+    {
+        if (!readingPending)
+        {
+            return false;
+        }
+        *reading = latestReading;
+        readingPending = false;
+        return true;
+    }
 
-    String transactionHex = "";
-    bool buildSuccess = false;
+    size_t count = 0;
+    if (reading_log_peek(&readingLog, reading, 1, &count) != READING_LOG_OK)
+    {
+        Serial.println("❌ Failed to read queued readings");
+        return false;
+    }
+    return count == 1;
+}
 
-    if (buildHttpCode == 200)
+// Step 1: POST to /api/build-tx and receive the transaction hex
+cycle_step_t stepBuildTx()
+{
+    if (cycle.requested)
     {
-        String buildResponse = buildHttp.getString();
-        // Use DynamicJsonDocument for response as txBytes string can be long
-        DynamicJsonDocument responseDoc(1536);
-        DeserializationError error = deserializeJson(responseDoc, buildResponse);
+        if (awaitingReply())
+        {
+            return CYCLE_STEP_PENDING;
+        }
 
-        if (!error && responseDoc["success"])
+        size_t length;
+        char *body = replyBody("Build TX", &length);
+        if (!body)
         {
-            transactionHex = responseDoc["txBytes"].as<String>();
-            Serial.printf("✅ Tx Bytes Received (Length: %d)\n", transactionHex.length());
-            Serial.printf("  Tx Bytes Hex (First 64): %.64s...\n", transactionHex.c_str());
-            buildSuccess = true;
+            return CYCLE_STEP_FAILED;
         }
-        else
+
+        StaticJsonDocument<512> responseDoc;
+        DeserializationError error = deserializeJson(responseDoc, body, length);
+        const char *txBytes = error ? NULL : responseDoc["txBytes"].as<const char *>();
+        if (error || !responseDoc["success"] || !txBytes)
         {
-            Serial.printf("❌ Build TX API Error: %s\n", responseDoc["error"].as<const char *>());
+            Serial.printf("❌ Build TX API Error: %s\n", error ? error.c_str() : responseDoc["error"].as<const char *>());
+            return CYCLE_STEP_FAILED;
         }
+
+        cycle.hexLength = strlen(txBytes);
+        if (cycle.hexLength >= sizeof(cycle.transactionHex))
+        {
+            Serial.println("❌ Tx bytes exceed MAX_TX_BYTES");
+            return CYCLE_STEP_FAILED;
+        }
+        memcpy(cycle.transactionHex, txBytes, cycle.hexLength + 1);
+        Serial.printf("✅ Tx Bytes Received (Length: %u)\n", (unsigned)cycle.hexLength);
+        Serial.printf("  Tx Bytes Hex (First 64): %.64s...\n", cycle.transactionHex);
+        return CYCLE_STEP_DONE;
     }
-    else
+
+    if (!keypair.isInitialized)
     {
-        Serial.printf("❌ Build TX HTTP Error: %d - %s\n", buildHttpCode, buildHttp.errorToString(buildHttpCode).c_str());
+        Serial.println("Cannot proceed: Keypair not initialized.");
+        return CYCLE_STEP_FAILED;
     }
-    buildHttp.end();
 
-    if (!buildSuccess)
+    // The state timeout bounds the wait for a (re)connection
+    if (WiFi.status() != WL_CONNECTED)
     {
-        Serial.println("Workflow failed at BUILD TX stage.");
-        return;
+        return CYCLE_STEP_PENDING;
+    }
+
+    if (!nextReading(&cycle.reading))
+    {
+        return CYCLE_STEP_FINISHED;
     }
 
-    // 3. --- STEP 2: Sign Transaction Locally ---
-    char signatureBase64[256]; // Buffer for Base64 signature (~130 chars)
+    Serial.println("\n=== Starting Prepare-Sign-Submit Workflow ===");
+    Serial.printf("Data: Temp=%d, Humid=%d, EC=%d, pH=%d\n", cycle.reading.value1, cycle.reading.value2,
+                  cycle.reading.value3, cycle.reading.value4);
+    Serial.printf("\n1. Requesting transaction bytes from: %s\n", buildTxUrl);
 
-    bool signSuccess = signTransactionHex(transactionHex.c_str(), signatureBase64);
+    StaticJsonDocument<256> buildDoc;
+    buildDoc["temperature"] = cycle.reading.value1;
+    buildDoc["humidity"] = cycle.reading.value2;
+    buildDoc["ec"] = cycle.reading.value3;
+    buildDoc["ph"] = cycle.reading.value4;
+    buildDoc["deviceId"] = deviceId;
+    buildDoc["sensorType"] = sensorType;
+    buildDoc["location"] = location;
 
-    if (!signSuccess)
+    if (measureJson(buildDoc) >= sizeof(cycle.requestBody))
     {
-        Serial.println("Workflow failed at SIGNATURE stage.");
-        return;
+        Serial.println("❌ Build TX request does not fit its buffer");
+        return CYCLE_STEP_FAILED;
     }
+    size_t bodyLength = serializeJson(buildDoc, cycle.requestBody, sizeof(cycle.requestBody));
 
-    // 4. --- STEP 3: POST to /api/submit-tx (Submit Transaction and Signature) ---
-    Serial.printf("\n3. Submitting transaction to: %s\n", submitTxUrl);
+    async_http_part_t body = {(const uint8_t *)cycle.requestBody, bodyLength};
+    if (!startPost(buildTxUrl, &body, 1))
+    {
+        return CYCLE_STEP_FAILED;
+    }
+    cycle.requested = true;
+    return CYCLE_STEP_PENDING;
+}
 
-    HTTPClient submitHttp;
-    submitHttp.begin(submitTxUrl);
-    submitHttp.addHeader("Content-Type", "application/json");
+// Step 2: Refuse anything but the expected MoveCall for this reading
+cycle_step_t stepVerify()
+{
+    return verifyTransactionBeforeSigning(cycle.transactionHex, &cycle.reading) ? CYCLE_STEP_DONE : CYCLE_STEP_FAILED;
+}
 
-    // Use DynamicJsonDocument for payload as txBytes is a long string
-    DynamicJsonDocument submitDoc(1536);
-    submitDoc["txBytes"] = transactionHex;    // Send the original bytes received
-    submitDoc["signature"] = signatureBase64; // Send the generated Base64 signature
+// Step 3: Sign Transaction Locally
+cycle_step_t stepSign()
+{
+    return signTransactionHex(cycle.transactionHex, cycle.signature) ? CYCLE_STEP_DONE : CYCLE_STEP_FAILED;
+}
 
-    String submitPayload;
-    serializeJson(submitDoc, submitPayload);
+// Step 4: POST to /api/submit-tx, straight from the hex and signature
+cycle_step_t stepSubmitTx()
+{
+    Serial.printf("\n3. Submitting transaction to: %s\n", submitTxUrl);
 
-    int submitHttpCode = submitHttp.POST(submitPayload);
+    static const char head[] = "{\"txBytes\":\"";
+    static const char middle[] = "\",\"signature\":\"";
+    static const char tail[] = "\"}";
+    async_http_part_t body[] = {
+        {(const uint8_t *)head, sizeof(head) - 1},
+        {(const uint8_t *)cycle.transactionHex, cycle.hexLength},
+        {(const uint8_t *)middle, sizeof(middle) - 1},
+        {(const uint8_t *)cycle.signature, strlen(cycle.signature)},
+        {(const uint8_t *)tail, sizeof(tail) - 1},
+    };
+    return startPost(submitTxUrl, body, sizeof(body) / sizeof(body[0])) ? CYCLE_STEP_DONE : CYCLE_STEP_FAILED;
+}
 
-    if (submitHttpCode == 200)
+// Step 5: Read the submit result and drop the reading from the queue
+cycle_step_t stepConfirm()
+{
+    if (awaitingReply())
     {
-        String submitResponse = submitHttp.getString();
-        StaticJsonDocument<512> resultDoc;
-        DeserializationError error = deserializeJson(resultDoc, submitResponse);
+        return CYCLE_STEP_PENDING;
+    }
 
-        if (!error && resultDoc["success"])
-        {
-            Serial.println("✅ Transaction submitted successfully!");
-            Serial.printf("  TX Digest: %s\n", resultDoc["digest"].as<const char *>());
-            Serial.printf("  Explorer URL: %s\n", resultDoc["explorerUrl"].as<const char *>());
-        }
-        else
-        {
-            Serial.printf("❌ Submit TX API Error: %s\n", resultDoc["error"].as<const char *>());
-        }
+    size_t length;
+    char *body = replyBody("Submit TX", &length);
+    if (!body)
+    {
+        return CYCLE_STEP_FAILED;
     }
-    else
+
+    StaticJsonDocument<512> resultDoc;
+    DeserializationError error = deserializeJson(resultDoc, body, length);
+    if (error || !resultDoc["success"])
     {
-        Serial.printf("❌ Submit TX HTTP Error: %d - %s\n", submitHttpCode, submitHttp.errorToString(submitHttpCode).c_str());
-        String errorResponse = submitHttp.getString();
-        Serial.printf("  Error Response: %s\n", errorResponse.c_str());
+        Serial.printf("❌ Submit TX API Error: %s\n", error ? error.c_str() : resultDoc["error"].as<const char *>());
+        return CYCLE_STEP_FAILED;
     }
 
-    submitHttp.end();
-    Serial.println("\n=== Workflow Complete ===");
+    Serial.println("✅ Transaction submitted successfully!");
+    Serial.printf("  TX Digest: %s\n", resultDoc["digest"].as<const char *>());
+    Serial.printf("  Explorer URL: %s\n", resultDoc["explorerUrl"].as<const char *>());
+
+    if (readingLogReady)
+    {
+        if (reading_log_commit(&readingLog, 1) != READING_LOG_OK)
+        {
+            Serial.println("❌ Failed to commit reading log cursor");
+        }
+        replayed++;
+    }
+    return CYCLE_STEP_DONE;
 }
 
-// ===== SETUP & LOOP (Modified) =====
-void setup()
+cycle_step_t runCycleStep(void *ctx, cycle_state_t state, uint32_t now)
 {
-    Serial.begin(115200);
-    delay(1000);
+    (void)ctx;
+    (void)now;
+    switch (state)
+    {
+    case CYCLE_STATE_FETCH_REFS:
+        return stepBuildTx();
+    case CYCLE_STATE_BUILD:
+        return stepVerify();
+    case CYCLE_STATE_SIGN:
+        return stepSign();
+    case CYCLE_STATE_SUBMIT:
+        return stepSubmitTx();
+    case CYCLE_STATE_CONFIRM:
+        return stepConfirm();
+    default:
+        return CYCLE_STEP_FAILED;
+    }
+}
 
-    Serial.println("\n=== ESP32 Sui Sensor Data Sender (Prepare-Sign-Submit) ===");
+// One reading per cycle; the queue is drained oldest first and stops at the
+// first failure until the next sample
+bool finishCycle(void *ctx, cycle_state_t state, bool ok, uint32_t now)
+{
+    (void)ctx;
+    (void)now;
+    if (!ok)
+    {
+        Serial.printf("Workflow failed at %s stage.\n", cycle_engine_state_name(state));
+    }
+    if (cycle.requested)
+    {
+        Serial.println("\n=== Workflow Complete ===");
+    }
 
-    // Connect to WiFi
-    Serial.print("Connecting to: ");
-    Serial.println(ssid);
+    bool more = false;
+    if (readingLogReady)
+    {
+        size_t pending = reading_log_pending(&readingLog);
+        if (cycle.requested)
+        {
+            Serial.printf("Submitted %u reading(s), %u still queued\n", (unsigned)replayed, (unsigned)pending);
+        }
+        more = ok && pending > 0 && replayed < REPLAY_BATCH_MAX;
+    }
 
-    WiFi.begin(ssid, password);
+    async_http_close(&cycle.http);
+    memset(&cycle, 0, sizeof(cycle));
+    async_http_init(&cycle.http);
+    return more;
+}
 
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20)
+// Log connection changes; a cycle waits for the connection to come back
+void checkWiFi()
+{
+    wl_status_t status = WiFi.status();
+    if (status == wifiStatus)
     {
-        delay(500);
-        Serial.print(".");
-        attempts++;
+        return;
     }
+    bool wasConnected = wifiStatus == WL_CONNECTED;
+    wifiStatus = status;
 
-    if (WiFi.status() == WL_CONNECTED)
+    if (status == WL_CONNECTED)
     {
         Serial.println("\n✅ WiFi Connected!");
         Serial.print("IP Address: ");
         Serial.println(WiFi.localIP());
     }
-    else
+    else if (wasConnected)
+    {
+        Serial.println("WiFi not connected. Attempting to reconnect...");
+        WiFi.reconnect();
+    }
+}
+
+void handleCommand(const char *command)
+{
+    if (awaitingInterval)
+    {
+        awaitingInterval = false;
+        long seconds = atol(command);
+        if (seconds <= 0)
+        {
+            Serial.println("Invalid interval");
+            return;
+        }
+        // Takes effect after the sample already scheduled
+        sendInterval = seconds * 1000;
+        cycleEngine.config.sample_interval_ms = sendInterval;
+        Serial.print("Interval set to: ");
+        Serial.print(sendInterval / 1000);
+        Serial.println(" seconds");
+        return;
+    }
+
+    if (strcmp(command, "send") == 0)
+    {
+        sampleSensor(NULL, millis());
+        cycle_engine_trigger(&cycleEngine);
+    }
+    else if (strcmp(command, "interval") == 0)
     {
-        Serial.println("\n❌ WiFi Connection Failed!");
+        Serial.print("Current interval: ");
+        Serial.print(sendInterval / 1000);
+        Serial.println(" seconds");
+        Serial.println("Enter new interval in seconds:");
+        awaitingInterval = true;
     }
+}
+
+// Manual trigger via Serial; only the characters already received are read
+void pollSerial()
+{
+    while (Serial.available() > 0)
+    {
+        int c = Serial.read();
+        if (c == '\r')
+        {
+            continue;
+        }
+        if (c != '\n')
+        {
+            if (commandLength < sizeof(commandLine) - 1)
+            {
+                commandLine[commandLength++] = (char)c;
+            }
+            continue;
+        }
+        commandLine[commandLength] = '\0';
+        commandLength = 0;
+        handleCommand(commandLine);
+    }
+}
+
+// ===== SETUP & LOOP =====
+void setup()
+{
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n=== ESP32 Sui Sensor Data Sender (Prepare-Sign-Submit) ===");
+
+    // Connect to WiFi; loop() reports when the connection is up
+    Serial.print("Connecting to: ");
+    Serial.println(ssid);
+    WiFi.begin(ssid, password);
 
     // Initialize MicroSui Keypair
     if (!initializeMicroSuiKeypair())
@@ -289,48 +729,49 @@ void setup()
         }
     }
 
+    if (!initializeSignPolicy())
+    {
+        Serial.println("System Halted due to Configuration Error.");
+        while (true)
+        {
+            delay(1000);
+        }
+    }
+
+    // Open the reading queue (replays anything left from before a reset)
+    if (!LittleFS.begin(true))
+    {
+        Serial.println("❌ LittleFS mount failed - readings will not be queued");
+    }
+    else
+    {
+        reading_log_storage_t storage;
+        readingLogReady =
+            reading_log_file_storage_init(&readingLogFiles, READING_LOG_DIR, &storage) == READING_LOG_OK &&
+            reading_log_open(&readingLog, &storage, READING_LOG_SEGMENT_RECORDS, READING_LOG_MAX_SEGMENTS) == READING_LOG_OK;
+        Serial.printf("Reading log: %s\n", readingLogReady ? "ready" : "unavailable");
+    }
+
     // Initialize random seed
     randomSeed(analogRead(0));
+
+    // The first sample is due now
+    unsigned long now = millis();
+    async_http_init(&cycle.http);
+    timer_wheel_init(&timerWheel, TIMER_WHEEL_TICK_SHIFT, now);
+    cycle_engine_ops_t ops = {NULL, sampleSensor, runCycleStep, finishCycle};
+    cycle_engine_config_t config = {(uint32_t)sendInterval, CYCLE_STATE_TIMEOUT, CYCLE_RETRY_DELAY};
+    cycle_engine_init(&cycleEngine, &timerWheel, &config, &ops, now);
 }
 
 void loop()
 {
-    unsigned long currentTime = millis();
+    // Fires the sample timer and runs at most one cycle step; requests only
+    // touch the socket when it is ready, so nothing here waits on the server
+    cycle_engine_poll(&cycleEngine, millis());
 
-    // Check if it's time to send data
-    if (currentTime - lastSendTime >= sendInterval)
-    {
-        generateAndSendData();
-        lastSendTime = currentTime;
-    }
-
-    // Optional: Add manual trigger via Serial
-    if (Serial.available() > 0)
-    {
-        String command = Serial.readStringUntil('\n');
-        command.trim();
+    checkWiFi();
+    pollSerial();
 
-        if (command == "send")
-        {
-            generateAndSendData();
-            lastSendTime = currentTime;
-        }
-        else if (command == "interval")
-        {
-            Serial.print("Current interval: ");
-            Serial.print(sendInterval / 1000);
-            Serial.println(" seconds");
-            Serial.println("Enter new interval in seconds:");
-
-            while (!Serial.available())
-                ;
-            String newInterval = Serial.readStringUntil('\n');
-            sendInterval = newInterval.toInt() * 1000;
-            Serial.print("Interval set to: ");
-            Serial.print(sendInterval / 1000);
-            Serial.println(" seconds");
-        }
-    }
-
-    delay(100);
-}
\ No newline at end of file
+    delay(LOOP_POLL_INTERVAL);
+}
@@ -0,0 +1,167 @@
+#include "gas_pool.h"
+#include <string.h>
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+static bool expired(const gas_pool_t *pool, const gas_coin_t *coin, uint32_t now_ms) {
+    // Unsigned difference stays correct across millis() wrap-around
+    return pool->max_age_ms != 0 && (uint32_t)(now_ms - coin->updated_ms) > pool->max_age_ms;
+}
+
+static gas_coin_t *find_coin(gas_pool_t *pool, const uint8_t object_id[32]) {
+    for (size_t i = 0; i < GAS_POOL_MAX_COINS; i++) {
+        gas_coin_t *coin = &pool->coins[i];
+        if (coin->state != GAS_COIN_FREE && memcmp(coin->ref.object_id, object_id, 32) == 0) {
+            return coin;
+        }
+    }
+    return NULL;
+}
+
+static gas_coin_t *free_slot(gas_pool_t *pool) {
+    gas_coin_t *unknown = NULL;
+    for (size_t i = 0; i < GAS_POOL_MAX_COINS; i++) {
+        gas_coin_t *coin = &pool->coins[i];
+        if (coin->state == GAS_COIN_FREE) {
+            return coin;
+        }
+        if (coin->state == GAS_COIN_UNKNOWN && !unknown) {
+            unknown = coin;
+        }
+    }
+    return unknown;
+}
+
+// The coin a lease refers to, if the lease is still current
+static gas_coin_t *leased_coin(gas_pool_t *pool, const gas_pool_lease_t *lease) {
+    if (lease->id == 0 || lease->index >= GAS_POOL_MAX_COINS) {
+        return NULL;
+    }
+
+    gas_coin_t *coin = &pool->coins[lease->index];
+    if (coin->state != GAS_COIN_IN_FLIGHT || coin->lease_id != lease->id) {
+        return NULL;
+    }
+    return coin;
+}
+
+// ============================================================================
+// Pool implementation
+// ============================================================================
+
+void gas_pool_init(gas_pool_t *pool, uint32_t max_age_ms) {
+    memset(pool, 0, sizeof(*pool));
+    pool->max_age_ms = max_age_ms;
+    pool->next_lease_id = 1;
+}
+
+gas_pool_error_t gas_pool_put(gas_pool_t *pool, const gas_object_t *ref, uint32_t now_ms) {
+    if (!pool || !ref) {
+        return GAS_POOL_ERROR_INVALID_INPUT;
+    }
+
+    gas_coin_t *coin = find_coin(pool, ref->object_id);
+    if (coin && coin->state == GAS_COIN_IN_FLIGHT) {
+        return GAS_POOL_OK;
+    }
+    if (!coin) {
+        coin = free_slot(pool);
+        if (!coin) {
+            return GAS_POOL_ERROR_FULL;
+        }
+    }
+
+    coin->ref = *ref;
+    coin->state = GAS_COIN_READY;
+    coin->lease_id = 0;
+    coin->updated_ms = now_ms;
+    return GAS_POOL_OK;
+}
+
+gas_pool_error_t gas_pool_acquire(gas_pool_t *pool, uint32_t now_ms, gas_object_t *ref, gas_pool_lease_t *lease) {
+    if (!pool || !ref || !lease) {
+        return GAS_POOL_ERROR_INVALID_INPUT;
+    }
+
+    lease->id = 0;
+
+    // Round robin spreads transactions over the coins
+    for (size_t n = 0; n < GAS_POOL_MAX_COINS; n++) {
+        size_t i = (pool->next + n) % GAS_POOL_MAX_COINS;
+        gas_coin_t *coin = &pool->coins[i];
+        if (coin->state != GAS_COIN_READY) {
+            continue;
+        }
+        if (expired(pool, coin, now_ms)) {
+            coin->state = GAS_COIN_UNKNOWN;
+            continue;
+        }
+
+        coin->state = GAS_COIN_IN_FLIGHT;
+        coin->lease_id = pool->next_lease_id++;
+        if (pool->next_lease_id == 0) {
+            pool->next_lease_id = 1;
+        }
+
+        *ref = coin->ref;
+        lease->index = (uint8_t)i;
+        lease->id = coin->lease_id;
+        pool->next = (i + 1) % GAS_POOL_MAX_COINS;
+        return GAS_POOL_OK;
+    }
+
+    return GAS_POOL_ERROR_EMPTY;
+}
+
+gas_pool_error_t gas_pool_release(gas_pool_t *pool, gas_pool_lease_t *lease, const gas_object_t *next,
+                                  uint32_t now_ms) {
+    if (!pool || !lease) {
+        return GAS_POOL_ERROR_INVALID_INPUT;
+    }
+
+    gas_coin_t *coin = leased_coin(pool, lease);
+    if (!coin) {
+        return GAS_POOL_ERROR_STALE_LEASE;
+    }
+
+    // Effects of another coin cannot settle this lease
+    if (next && memcmp(next->object_id, coin->ref.object_id, 32) == 0) {
+        coin->ref = *next;
+        coin->state = GAS_COIN_READY;
+        coin->updated_ms = now_ms;
+    } else {
+        coin->state = GAS_COIN_UNKNOWN;
+    }
+
+    coin->lease_id = 0;
+    lease->id = 0;
+    return GAS_POOL_OK;
+}
+
+gas_pool_error_t gas_pool_cancel(gas_pool_t *pool, gas_pool_lease_t *lease) {
+    if (!pool || !lease) {
+        return GAS_POOL_ERROR_INVALID_INPUT;
+    }
+
+    gas_coin_t *coin = leased_coin(pool, lease);
+    if (!coin) {
+        return GAS_POOL_ERROR_STALE_LEASE;
+    }
+
+    coin->state = GAS_COIN_READY;
+    coin->lease_id = 0;
+    lease->id = 0;
+    return GAS_POOL_OK;
+}
+
+size_t gas_pool_count(const gas_pool_t *pool, gas_coin_state_t state) {
+    size_t count = 0;
+    for (size_t i = 0; i < GAS_POOL_MAX_COINS; i++) {
+        if (pool->coins[i].state == state) {
+            count++;
+        }
+    }
+    return count;
+}
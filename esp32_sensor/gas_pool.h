@@ -0,0 +1,117 @@
+/**
+ * Gas Pool
+ * Small set of gas coin refs with acquire/release leases
+ *
+ * With a single gas coin, transaction N+1 cannot be built until N has
+ * settled and the coin's new version is known. The pool keeps a few coins
+ * of the sender, each with its own state: a transaction acquires a READY
+ * coin, and the lease is released with the coin's ref from the execution
+ * effects. Other coins stay usable meanwhile, so several signed
+ * transactions can be outstanding at once, and a coin whose outcome is
+ * unknown only takes itself out of rotation until it is refetched.
+ *
+ * Example:
+ *   gas_pool_t pool;
+ *   gas_pool_init(&pool, 600000);
+ *   gas_pool_put(&pool, &fetched_coin, millis());
+ *
+ *   gas_pool_lease_t lease;
+ *   if (gas_pool_acquire(&pool, millis(), &params.gas_object, &lease) == GAS_POOL_OK) {
+ *       // sign and submit; on success the response carries the coin's new ref
+ *       gas_pool_release(&pool, &lease, executed ? &next_ref : NULL, millis());
+ *   }
+ */
+
+#ifndef GAS_POOL_H
+#define GAS_POOL_H
+
+#include "sui_transaction.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define GAS_POOL_MAX_COINS 4
+
+// Error codes
+typedef enum {
+    GAS_POOL_OK = 0,
+    GAS_POOL_ERROR_EMPTY = -1,          // No coin is ready
+    GAS_POOL_ERROR_FULL = -2,           // No slot left for another coin
+    GAS_POOL_ERROR_INVALID_INPUT = -3,
+    GAS_POOL_ERROR_STALE_LEASE = -4,    // Lease was already released
+} gas_pool_error_t;
+
+typedef enum {
+    GAS_COIN_FREE = 0,      // Slot unused
+    GAS_COIN_READY,         // Ref is current; can be acquired
+    GAS_COIN_IN_FLIGHT,     // Signed into a transaction that has not settled
+    GAS_COIN_UNKNOWN,       // Version unknown until the coin is refetched
+} gas_coin_state_t;
+
+typedef struct {
+    gas_object_t ref;
+    uint8_t state;          // gas_coin_state_t
+    uint32_t lease_id;      // Current lease while in flight
+    uint32_t updated_ms;    // When ref was last known current
+} gas_coin_t;
+
+/**
+ * Pool state
+ */
+typedef struct {
+    gas_coin_t coins[GAS_POOL_MAX_COINS];
+    uint32_t max_age_ms;    // READY refs older than this count as unknown (0 = no limit)
+    uint32_t next_lease_id;
+    size_t next;            // Where the next acquire starts looking (round robin)
+} gas_pool_t;
+
+/**
+ * Handle for one acquired coin
+ */
+typedef struct {
+    uint8_t index;
+    uint32_t id;            // 0 = no lease
+} gas_pool_lease_t;
+
+/**
+ * Set up an empty pool
+ * @param max_age_ms How long a fetched or released ref is trusted (0 = no limit)
+ */
+void gas_pool_init(gas_pool_t *pool, uint32_t max_age_ms);
+
+/**
+ * Add a freshly fetched coin, or refresh the one with the same object ID
+ * A coin in flight keeps its state: the fetched ref may predate the
+ * pending transaction. New coins take a free slot, else an UNKNOWN one.
+ * @return GAS_POOL_ERROR_FULL if every slot holds a READY or in-flight coin
+ */
+gas_pool_error_t gas_pool_put(gas_pool_t *pool, const gas_object_t *ref, uint32_t now_ms);
+
+/**
+ * Take the next READY coin
+ * @param ref Output: the coin's current ref, to build the transaction with
+ * @param lease Output: pass to gas_pool_release() or gas_pool_cancel()
+ * @return GAS_POOL_ERROR_EMPTY if no coin is ready (all in flight, unknown
+ *         or expired)
+ */
+gas_pool_error_t gas_pool_acquire(gas_pool_t *pool, uint32_t now_ms, gas_object_t *ref, gas_pool_lease_t *lease);
+
+/**
+ * Settle a lease
+ * @param next The coin's ref after the transaction (from its effects), or
+ *             NULL if the outcome is unknown (timeout, conflict, or a
+ *             submission that returns no effects)
+ */
+gas_pool_error_t gas_pool_release(gas_pool_t *pool, gas_pool_lease_t *lease, const gas_object_t *next,
+                                  uint32_t now_ms);
+
+/**
+ * Return a coin that was never submitted; its ref is still current
+ */
+gas_pool_error_t gas_pool_cancel(gas_pool_t *pool, gas_pool_lease_t *lease);
+
+/**
+ * Number of coins in the given state
+ */
+size_t gas_pool_count(const gas_pool_t *pool, gas_coin_state_t state);
+
+#endif // GAS_POOL_H
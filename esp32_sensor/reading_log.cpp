@@ -0,0 +1,515 @@
+#include "reading_log.h"
+#include "sui_schema.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// Serialized cursor: generation (u32) + head segment (u32) + head record (u32) + CRC32
+#define CURSOR_SIZE 16
+
+// Records read per storage call during recovery and replay
+#define READ_BATCH 8
+
+// Record: sequence (u32) + reading + CRC32 of everything before it
+static_assert(4 + bcs::encoded_size<sensor_data_t>() + 4 == READING_LOG_RECORD_SIZE,
+              "READING_LOG_RECORD_SIZE does not match the record layout");
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+// CRC-32 (IEEE 802.3), nibble-table variant to keep flash use small
+static uint32_t crc32(const uint8_t *data, size_t length) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+static void encode_record(uint32_t sequence, const sensor_data_t *reading, uint8_t *out) {
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, out, READING_LOG_RECORD_SIZE);
+    bcs_write_u32(&writer, sequence);
+    bcs::write(&writer, *reading);
+    bcs_write_u32(&writer, crc32(out, READING_LOG_RECORD_SIZE - 4));
+}
+
+// Returns false if the record is torn or corrupt
+static bool decode_record(const uint8_t *in, uint32_t *sequence, sensor_data_t *reading) {
+    bcs_reader_t reader;
+    bcs_reader_init(&reader, in, READING_LOG_RECORD_SIZE);
+
+    uint32_t crc;
+    bcs_read_u32(&reader, sequence);
+    bcs::read(&reader, *reading);
+    bcs_read_u32(&reader, &crc);
+
+    return crc == crc32(in, READING_LOG_RECORD_SIZE - 4);
+}
+
+// Persist the head position into the next cursor slot
+static reading_log_error_t write_cursor(reading_log_t *log) {
+    uint8_t data[CURSOR_SIZE];
+    uint32_t generation = log->cursor_generation + 1;
+
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, data, sizeof(data));
+    bcs_write_u32(&writer, generation);
+    bcs_write_u32(&writer, log->head_segment);
+    bcs_write_u32(&writer, log->head_record);
+    bcs_write_u32(&writer, crc32(data, CURSOR_SIZE - 4));
+
+    // Alternate slots so a torn write always leaves the previous cursor intact
+    if (log->storage.write_cursor(log->storage.ctx, generation & 1, data, sizeof(data)) != 0) {
+        return READING_LOG_ERROR_IO;
+    }
+
+    log->cursor_generation = generation;
+    return READING_LOG_OK;
+}
+
+// Load the newest valid cursor slot; leaves the log at (0, 0) if there is none
+static void read_cursor(reading_log_t *log) {
+    log->head_segment = 0;
+    log->head_record = 0;
+    log->cursor_generation = 0;
+
+    bool found = false;
+    for (int slot = 0; slot < 2; slot++) {
+        uint8_t data[CURSOR_SIZE];
+        if (log->storage.read_cursor(log->storage.ctx, slot, data, sizeof(data)) != CURSOR_SIZE) {
+            continue;
+        }
+
+        bcs_reader_t reader;
+        bcs_reader_init(&reader, data, sizeof(data));
+        uint32_t generation, segment, record, crc;
+        bcs_read_u32(&reader, &generation);
+        bcs_read_u32(&reader, &segment);
+        bcs_read_u32(&reader, &record);
+        bcs_read_u32(&reader, &crc);
+
+        if (crc != crc32(data, CURSOR_SIZE - 4)) {
+            continue;
+        }
+        if (!found || generation > log->cursor_generation) {
+            log->cursor_generation = generation;
+            log->head_segment = segment;
+            log->head_record = record;
+            found = true;
+        }
+    }
+}
+
+// Count the valid records at the start of a segment, stopping at the first
+// torn, corrupt or out-of-sequence record. Returns -1 if the segment is missing.
+static long scan_segment(reading_log_t *log, uint32_t segment, bool *have_sequence,
+                         uint32_t *last_sequence, size_t *segment_bytes) {
+    uint8_t buf[READ_BATCH * READING_LOG_RECORD_SIZE];
+    uint32_t valid = 0;
+    *segment_bytes = 0;
+
+    while (valid < log->records_per_segment) {
+        long got = log->storage.read(log->storage.ctx, segment,
+                                     (size_t)valid * READING_LOG_RECORD_SIZE, buf, sizeof(buf));
+        if (got < 0) {
+            return valid == 0 ? -1 : (long)valid;
+        }
+        *segment_bytes = (size_t)valid * READING_LOG_RECORD_SIZE + (size_t)got;
+
+        size_t records = (size_t)got / READING_LOG_RECORD_SIZE;
+        for (size_t i = 0; i < records && valid < log->records_per_segment; i++) {
+            uint32_t sequence;
+            sensor_data_t reading;
+            if (!decode_record(buf + i * READING_LOG_RECORD_SIZE, &sequence, &reading) ||
+                (*have_sequence && sequence != *last_sequence + 1)) {
+                return (long)valid;
+            }
+            *have_sequence = true;
+            *last_sequence = sequence;
+            valid++;
+        }
+
+        if ((size_t)got < sizeof(buf)) {
+            break;
+        }
+    }
+
+    return (long)valid;
+}
+
+// ============================================================================
+// Log implementation
+// ============================================================================
+
+reading_log_error_t reading_log_open(reading_log_t *log, const reading_log_storage_t *storage,
+                                     uint32_t records_per_segment, uint32_t max_segments) {
+    if (!log || !storage || records_per_segment == 0 || max_segments == 0) {
+        return READING_LOG_ERROR_INVALID_INPUT;
+    }
+
+    log->storage = *storage;
+    log->records_per_segment = records_per_segment;
+    log->max_segments = max_segments;
+    log->next_sequence = 0;
+
+    read_cursor(log);
+
+    // Segments below the head may survive a reset between cursor write and removal
+    for (uint32_t segment = log->head_segment; segment > 0; segment--) {
+        if (log->storage.remove(log->storage.ctx, segment - 1) != 0) {
+            break;
+        }
+    }
+
+    // Walk forward from the head to find the last intact record
+    bool have_sequence = false;
+    uint32_t last_sequence = 0;
+    uint32_t segment = log->head_segment;
+
+    while (true) {
+        size_t segment_bytes;
+        long valid = scan_segment(log, segment, &have_sequence, &last_sequence, &segment_bytes);
+
+        if (valid < 0) {
+            // Missing segment: appends start here
+            log->tail_segment = segment;
+            log->tail_record = 0;
+            if (segment == log->head_segment && log->head_record > 0) {
+                // Committed records vanished with their segment; restart on a clean one
+                log->head_segment = log->tail_segment = segment + 1;
+                log->head_record = 0;
+                if (write_cursor(log) != READING_LOG_OK) return READING_LOG_ERROR_IO;
+            }
+            break;
+        }
+
+        if ((uint32_t)valid == log->records_per_segment) {
+            segment++;
+            continue;
+        }
+
+        // Partial segment: drop anything after the last intact record
+        size_t keep = (size_t)valid * READING_LOG_RECORD_SIZE;
+        if (segment_bytes > keep && log->storage.truncate(log->storage.ctx, segment, keep) != 0) {
+            return READING_LOG_ERROR_IO;
+        }
+
+        log->tail_segment = segment;
+        log->tail_record = (uint32_t)valid;
+
+        if (segment == log->head_segment && log->tail_record < log->head_record) {
+            // Records before the cursor were lost; start over on a fresh segment
+            log->head_segment = log->tail_segment = segment + 1;
+            log->head_record = log->tail_record = 0;
+            if (write_cursor(log) != READING_LOG_OK) return READING_LOG_ERROR_IO;
+        }
+        break;
+    }
+
+    // Segments past the tail only hold records written after a torn one
+    for (uint32_t stale = log->tail_segment + 1; ; stale++) {
+        if (log->storage.remove(log->storage.ctx, stale) != 0) {
+            break;
+        }
+    }
+
+    if (have_sequence) {
+        log->next_sequence = last_sequence + 1;
+    }
+
+    return READING_LOG_OK;
+}
+
+reading_log_error_t reading_log_append(reading_log_t *log, const sensor_data_t *reading) {
+    if (!log || !reading) {
+        return READING_LOG_ERROR_INVALID_INPUT;
+    }
+
+    if (log->tail_segment - log->head_segment >= log->max_segments) {
+        return READING_LOG_ERROR_FULL;
+    }
+
+    uint8_t record[READING_LOG_RECORD_SIZE];
+    encode_record(log->next_sequence, reading, record);
+
+    if (log->storage.append(log->storage.ctx, log->tail_segment, record, sizeof(record)) != 0 ||
+        log->storage.sync(log->storage.ctx, log->tail_segment) != 0) {
+        // Undo a partial write so the next append lands on a record boundary
+        log->storage.truncate(log->storage.ctx, log->tail_segment,
+                              (size_t)log->tail_record * READING_LOG_RECORD_SIZE);
+        return READING_LOG_ERROR_IO;
+    }
+
+    log->next_sequence++;
+    if (++log->tail_record == log->records_per_segment) {
+        log->tail_segment++;
+        log->tail_record = 0;
+    }
+
+    return READING_LOG_OK;
+}
+
+reading_log_error_t reading_log_peek(reading_log_t *log, sensor_data_t *readings,
+                                     size_t max_readings, size_t *count) {
+    return reading_log_peek_at(log, 0, readings, max_readings, count);
+}
+
+reading_log_error_t reading_log_peek_at(reading_log_t *log, size_t skip, sensor_data_t *readings,
+                                        size_t max_readings, size_t *count) {
+    if (!log || (!readings && max_readings > 0) || !count) {
+        return READING_LOG_ERROR_INVALID_INPUT;
+    }
+
+    size_t pending = reading_log_pending(log);
+    if (skip > pending) {
+        skip = pending;
+    }
+    pending -= skip;
+    size_t wanted = max_readings < pending ? max_readings : pending;
+
+    // Same arithmetic as reading_log_commit()
+    uint64_t position = (uint64_t)log->head_record + skip;
+    uint32_t segment = log->head_segment + (uint32_t)(position / log->records_per_segment);
+    uint32_t record = (uint32_t)(position % log->records_per_segment);
+    size_t n = 0;
+
+    uint8_t buf[READ_BATCH * READING_LOG_RECORD_SIZE];
+
+    while (n < wanted) {
+        // Read a run of records that stays inside the current segment
+        size_t run = log->records_per_segment - record;
+        if (run > wanted - n) run = wanted - n;
+        if (run > READ_BATCH) run = READ_BATCH;
+
+        size_t bytes = run * READING_LOG_RECORD_SIZE;
+        long got = log->storage.read(log->storage.ctx, segment,
+                                     (size_t)record * READING_LOG_RECORD_SIZE, buf, bytes);
+        if (got != (long)bytes) {
+            return READING_LOG_ERROR_IO;
+        }
+
+        for (size_t i = 0; i < run; i++) {
+            uint32_t sequence;
+            if (!decode_record(buf + i * READING_LOG_RECORD_SIZE, &sequence, &readings[n++])) {
+                return READING_LOG_ERROR_CORRUPT;
+            }
+        }
+
+        record += run;
+        if (record == log->records_per_segment) {
+            segment++;
+            record = 0;
+        }
+    }
+
+    *count = n;
+    return READING_LOG_OK;
+}
+
+reading_log_error_t reading_log_commit(reading_log_t *log, size_t count) {
+    if (!log || count > reading_log_pending(log)) {
+        return READING_LOG_ERROR_INVALID_INPUT;
+    }
+    if (count == 0) {
+        return READING_LOG_OK;
+    }
+
+    uint32_t old_segment = log->head_segment;
+    uint32_t old_record = log->head_record;
+
+    uint64_t position = (uint64_t)log->head_record + count;
+    log->head_segment += (uint32_t)(position / log->records_per_segment);
+    log->head_record = (uint32_t)(position % log->records_per_segment);
+
+    reading_log_error_t err = write_cursor(log);
+    if (err != READING_LOG_OK) {
+        log->head_segment = old_segment;
+        log->head_record = old_record;
+        return err;
+    }
+
+    // Cursor is durable; fully consumed segments can go (leftovers are removed on open)
+    for (uint32_t segment = old_segment; segment < log->head_segment; segment++) {
+        log->storage.remove(log->storage.ctx, segment);
+    }
+
+    return READING_LOG_OK;
+}
+
+size_t reading_log_pending(const reading_log_t *log) {
+    return (size_t)(log->tail_segment - log->head_segment) * log->records_per_segment
+           + log->tail_record - log->head_record;
+}
+
+// ============================================================================
+// File storage implementation
+// ============================================================================
+
+static void segment_path(const reading_log_file_storage_t *fs, uint32_t segment, char *path, size_t size) {
+    snprintf(path, size, "%s/seg%08lu.log", fs->dir, (unsigned long)segment);
+}
+
+static void cursor_path(const reading_log_file_storage_t *fs, int slot, char *path, size_t size) {
+    snprintf(path, size, "%s/cursor%d", fs->dir, slot);
+}
+
+// Close the open handle if it belongs to segment
+static int close_segment(reading_log_file_storage_t *fs, uint32_t segment) {
+    if (!fs->segment_file || fs->segment != segment) {
+        return 0;
+    }
+
+    int err = fclose(fs->segment_file);
+    fs->segment_file = NULL;
+    return err;
+}
+
+// Handle for appending to segment, reusing the open one when it matches
+static FILE *open_segment(reading_log_file_storage_t *fs, uint32_t segment) {
+    if (fs->segment_file && fs->segment == segment) {
+        return fs->segment_file;
+    }
+
+    reading_log_file_storage_close(fs);
+
+    char path[96];
+    segment_path(fs, segment, path, sizeof(path));
+    fs->segment_file = fopen(path, "ab");
+    fs->segment = segment;
+    return fs->segment_file;
+}
+
+static int file_append(void *ctx, uint32_t segment, const uint8_t *data, size_t length) {
+    FILE *f = open_segment((reading_log_file_storage_t *)ctx, segment);
+    if (!f) return -1;
+
+    return fwrite(data, 1, length, f) == length ? 0 : -1;
+}
+
+static long read_file(const char *path, size_t offset, uint8_t *data, size_t length) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+
+    if (fseek(f, (long)offset, SEEK_SET) != 0) {
+        fclose(f);
+        return 0;
+    }
+
+    size_t got = fread(data, 1, length, f);
+    fclose(f);
+    return (long)got;
+}
+
+static long file_read(void *ctx, uint32_t segment, size_t offset, uint8_t *data, size_t length) {
+    reading_log_file_storage_t *fs = (reading_log_file_storage_t *)ctx;
+    // Buffered appends must be visible to the separate read handle
+    if (fs->segment_file && fs->segment == segment && fflush(fs->segment_file) != 0) {
+        return -1;
+    }
+
+    char path[96];
+    segment_path(fs, segment, path, sizeof(path));
+    return read_file(path, offset, data, length);
+}
+
+static int file_truncate(void *ctx, uint32_t segment, size_t length) {
+    reading_log_file_storage_t *fs = (reading_log_file_storage_t *)ctx;
+    // Drop the handle so no buffered bytes land after the cut
+    close_segment(fs, segment);
+
+    char path[96];
+    segment_path(fs, segment, path, sizeof(path));
+    return truncate(path, (off_t)length) == 0 || errno == ENOENT ? 0 : -1;
+}
+
+static int file_remove(void *ctx, uint32_t segment) {
+    reading_log_file_storage_t *fs = (reading_log_file_storage_t *)ctx;
+    close_segment(fs, segment);
+
+    char path[96];
+    segment_path(fs, segment, path, sizeof(path));
+    return remove(path) == 0 ? 0 : -1;
+}
+
+static int sync_path(const char *path) {
+    FILE *f = fopen(path, "ab");
+    if (!f) return -1;
+
+    int err = fsync(fileno(f));
+    fclose(f);
+    return err == 0 ? 0 : -1;
+}
+
+static int file_sync(void *ctx, uint32_t segment) {
+    reading_log_file_storage_t *fs = (reading_log_file_storage_t *)ctx;
+    if (fs->segment_file && fs->segment == segment) {
+        return fflush(fs->segment_file) == 0 && fsync(fileno(fs->segment_file)) == 0 ? 0 : -1;
+    }
+
+    char path[96];
+    segment_path(fs, segment, path, sizeof(path));
+    return sync_path(path);
+}
+
+static long file_read_cursor(void *ctx, int slot, uint8_t *data, size_t length) {
+    char path[96];
+    cursor_path((reading_log_file_storage_t *)ctx, slot, path, sizeof(path));
+    return read_file(path, 0, data, length);
+}
+
+static int file_write_cursor(void *ctx, int slot, const uint8_t *data, size_t length) {
+    char path[96];
+    cursor_path((reading_log_file_storage_t *)ctx, slot, path, sizeof(path));
+
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+
+    size_t written = fwrite(data, 1, length, f);
+    int err = fflush(f);
+    if (err == 0) err = fsync(fileno(f));
+    fclose(f);
+    return (written == length && err == 0) ? 0 : -1;
+}
+
+reading_log_error_t reading_log_file_storage_init(reading_log_file_storage_t *fs, const char *dir,
+                                                  reading_log_storage_t *storage) {
+    if (!fs || !dir || !storage || strlen(dir) >= sizeof(fs->dir)) {
+        return READING_LOG_ERROR_INVALID_INPUT;
+    }
+
+    strcpy(fs->dir, dir);
+    fs->segment_file = NULL;
+    fs->segment = 0;
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        return READING_LOG_ERROR_IO;
+    }
+
+    storage->ctx = fs;
+    storage->append = file_append;
+    storage->read = file_read;
+    storage->truncate = file_truncate;
+    storage->remove = file_remove;
+    storage->sync = file_sync;
+    storage->read_cursor = file_read_cursor;
+    storage->write_cursor = file_write_cursor;
+
+    return READING_LOG_OK;
+}
+
+void reading_log_file_storage_close(reading_log_file_storage_t *fs) {
+    if (fs && fs->segment_file) {
+        fclose(fs->segment_file);
+        fs->segment_file = NULL;
+    }
+}
@@ -0,0 +1,161 @@
+/**
+ * Reading Log
+ * Power-loss-safe, append-only queue of sensor readings awaiting submission
+ *
+ * Readings are stored as fixed-size CRC-framed records in numbered segment
+ * files. A commit cursor (kept in two alternating, checksummed slots) marks
+ * how far the log has been submitted; fully committed segments are deleted.
+ * After a reset, reading_log_open() drops any torn record at the tail and
+ * resumes from the last committed cursor, so readings are delivered at
+ * least once.
+ */
+
+#ifndef READING_LOG_H
+#define READING_LOG_H
+
+#include "sui_transaction.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Serialized record: sequence (u32) + 4 x u16 readings + timestamp (u64) + CRC32
+#define READING_LOG_RECORD_SIZE 24
+
+// Error codes
+typedef enum {
+    READING_LOG_OK = 0,
+    READING_LOG_ERROR_IO = -1,
+    READING_LOG_ERROR_FULL = -2,
+    READING_LOG_ERROR_CORRUPT = -3,
+    READING_LOG_ERROR_INVALID_INPUT = -4,
+} reading_log_error_t;
+
+/**
+ * Storage backend
+ *
+ * Segments are addressed by number; cursor slots are 0 and 1. All
+ * callbacks return 0 (or a byte count) on success and -1 on failure.
+ */
+typedef struct {
+    void *ctx;
+
+    // Append bytes to the end of a segment, creating it if needed
+    int (*append)(void *ctx, uint32_t segment, const uint8_t *data, size_t length);
+
+    // Read up to length bytes at offset; returns bytes read, -1 if the segment does not exist
+    long (*read)(void *ctx, uint32_t segment, size_t offset, uint8_t *data, size_t length);
+
+    // Cut a segment down to length bytes
+    int (*truncate)(void *ctx, uint32_t segment, size_t length);
+
+    // Delete a segment
+    int (*remove)(void *ctx, uint32_t segment);
+
+    // Make appended data durable
+    int (*sync)(void *ctx, uint32_t segment);
+
+    // Read a cursor slot; returns bytes read, -1 if the slot does not exist
+    long (*read_cursor)(void *ctx, int slot, uint8_t *data, size_t length);
+
+    // Replace a cursor slot and make it durable
+    int (*write_cursor)(void *ctx, int slot, const uint8_t *data, size_t length);
+} reading_log_storage_t;
+
+/**
+ * Log state
+ */
+typedef struct {
+    reading_log_storage_t storage;
+    uint32_t records_per_segment;   // Records before rotating to a new segment
+    uint32_t max_segments;          // Uncommitted segments kept before appends fail
+    uint32_t head_segment;          // Commit cursor: oldest unsubmitted record
+    uint32_t head_record;
+    uint32_t tail_segment;          // Next append position
+    uint32_t tail_record;
+    uint32_t next_sequence;         // Sequence number of the next appended record
+    uint32_t cursor_generation;     // Generation of the last written cursor slot
+} reading_log_t;
+
+/**
+ * File-backed storage state (stdio + POSIX, works on Linux and ESP32 VFS)
+ *
+ * The segment being appended stays open between appends, so each reading
+ * costs one buffered write and one fsync instead of open/close cycles.
+ */
+typedef struct {
+    char dir[64];
+    FILE *segment_file;             // Open handle of the tail segment, or NULL
+    uint32_t segment;               // Segment number of segment_file
+} reading_log_file_storage_t;
+
+// ============================================================================
+// Log API
+// ============================================================================
+
+/**
+ * Open a log, recovering the cursor and truncating a torn tail record
+ * @param log Pointer to log structure
+ * @param storage Storage backend (copied)
+ * @param records_per_segment Records per segment file (e.g. 256)
+ * @param max_segments Maximum uncommitted segments (bounds storage use)
+ * @return READING_LOG_OK on success, error code otherwise
+ */
+reading_log_error_t reading_log_open(reading_log_t *log, const reading_log_storage_t *storage,
+                                     uint32_t records_per_segment, uint32_t max_segments);
+
+/**
+ * Append a reading and sync it to storage
+ * @return READING_LOG_OK on success, READING_LOG_ERROR_FULL if max_segments
+ *         uncommitted segments already exist, error code otherwise
+ */
+reading_log_error_t reading_log_append(reading_log_t *log, const sensor_data_t *reading);
+
+/**
+ * Read up to max_readings uncommitted readings, oldest first, without consuming them
+ * @param log Pointer to log structure
+ * @param readings Output array
+ * @param max_readings Capacity of readings
+ * @param count Output: number of readings returned
+ */
+reading_log_error_t reading_log_peek(reading_log_t *log, sensor_data_t *readings,
+                                     size_t max_readings, size_t *count);
+
+/**
+ * Like reading_log_peek(), but skipping the oldest skip uncommitted readings
+ * (e.g. ones already in a transaction that has not settled)
+ */
+reading_log_error_t reading_log_peek_at(reading_log_t *log, size_t skip, sensor_data_t *readings,
+                                        size_t max_readings, size_t *count);
+
+/**
+ * Mark the oldest count readings as submitted and delete fully committed segments
+ * Call after the readings returned by reading_log_peek() are on chain.
+ */
+reading_log_error_t reading_log_commit(reading_log_t *log, size_t count);
+
+/**
+ * Number of uncommitted readings
+ */
+size_t reading_log_pending(const reading_log_t *log);
+
+// ============================================================================
+// File storage
+// ============================================================================
+
+/**
+ * Set up file-backed storage in dir (created if missing)
+ * Segments are stored as dir/seg<N>.log, cursor slots as dir/cursor<0|1>.
+ * @param fs Storage state (must outlive the log)
+ * @param dir Directory path (e.g. "/littlefs/rlog" on ESP32)
+ * @param storage Output: backend to pass to reading_log_open()
+ */
+reading_log_error_t reading_log_file_storage_init(reading_log_file_storage_t *fs, const char *dir,
+                                                  reading_log_storage_t *storage);
+
+/**
+ * Close the open segment handle (e.g. before unmounting the filesystem)
+ * Appended data is already durable; the next append reopens the segment.
+ */
+void reading_log_file_storage_close(reading_log_file_storage_t *fs);
+
+#endif // READING_LOG_H
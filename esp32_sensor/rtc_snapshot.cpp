@@ -0,0 +1,171 @@
+#include "rtc_snapshot.h"
+#include <string.h>
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+// CRC-32 (IEEE 802.3), nibble-table variant to keep flash use small
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t length) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return crc;
+}
+
+// Covers padding too; rtc_snapshot_save() zeroes the struct before filling it
+static uint32_t snapshot_checksum(const rtc_snapshot_t *snapshot) {
+    return ~crc32_update(0xFFFFFFFF, (const uint8_t *)snapshot, offsetof(rtc_snapshot_t, checksum));
+}
+
+// ============================================================================
+// Snapshot implementation
+// ============================================================================
+
+uint32_t rtc_snapshot_config_hash(const char *const *fields, size_t count) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < count; i++) {
+        // Each field with its NUL, so ("ab", "c") and ("a", "bc") differ
+        const char *field = fields[i] ? fields[i] : "";
+        crc = crc32_update(crc, (const uint8_t *)field, strlen(field) + 1);
+    }
+    return ~crc;
+}
+
+rtc_snapshot_error_t rtc_snapshot_save(rtc_snapshot_t *snapshot, uint32_t config_hash,
+                                       const rtc_snapshot_identity_t *identity, const sui_sensor_template_t *tpl,
+                                       const uint8_t *sensor_object_id, uint64_t sensor_version,
+                                       const gas_pool_t *pool, uint32_t now_ms, uint32_t away_ms) {
+    if (!snapshot || !identity || !pool) {
+        return RTC_SNAPSHOT_ERROR_INVALID_INPUT;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->config_hash = config_hash;
+    snapshot->identity = *identity;
+
+    if (tpl) {
+        size_t length = tpl->writer.position;
+        if (length > RTC_SNAPSHOT_TEMPLATE_SIZE) {
+            return RTC_SNAPSHOT_ERROR_TOO_LARGE;
+        }
+        memcpy(snapshot->template_bytes, tpl->writer.buffer, length);
+        snapshot->template_length = (uint16_t)length;
+        for (size_t i = 0; i < 4; i++) {
+            snapshot->template_offsets[i] = (uint16_t)tpl->reading_offsets[i];
+        }
+        snapshot->template_offsets[4] = (uint16_t)tpl->gas_object_id_offset;
+        snapshot->template_offsets[5] = (uint16_t)tpl->gas_version_offset;
+        snapshot->template_offsets[6] = (uint16_t)tpl->gas_digest_offset;
+        snapshot->template_offsets[7] = (uint16_t)tpl->gas_price_offset;
+        snapshot->template_offsets[8] = (uint16_t)tpl->gas_budget_offset;
+    }
+
+    if (sensor_object_id) {
+        snapshot->sensor_valid = true;
+        memcpy(snapshot->sensor_object_id, sensor_object_id, sizeof(snapshot->sensor_object_id));
+        snapshot->sensor_version = sensor_version;
+    }
+
+    // In-flight and unknown coins are refetched after the wake anyway
+    for (size_t i = 0; i < GAS_POOL_MAX_COINS; i++) {
+        const gas_coin_t *coin = &pool->coins[i];
+        if (coin->state == GAS_COIN_READY) {
+            rtc_snapshot_coin_t *saved = &snapshot->coins[snapshot->coin_count++];
+            saved->ref = coin->ref;
+            saved->age_ms = now_ms - coin->updated_ms;
+        }
+    }
+    snapshot->away_ms = away_ms;
+
+    snapshot->magic = RTC_SNAPSHOT_MAGIC;
+    snapshot->version = RTC_SNAPSHOT_VERSION;
+    snapshot->size = (uint16_t)sizeof(rtc_snapshot_t);
+    snapshot->checksum = snapshot_checksum(snapshot);
+    return RTC_SNAPSHOT_OK;
+}
+
+rtc_snapshot_error_t rtc_snapshot_check(const rtc_snapshot_t *snapshot, uint32_t config_hash) {
+    if (!snapshot) {
+        return RTC_SNAPSHOT_ERROR_INVALID_INPUT;
+    }
+    if (snapshot->magic != RTC_SNAPSHOT_MAGIC) {
+        return RTC_SNAPSHOT_ERROR_EMPTY;
+    }
+
+    // Header first: an older layout may not even have the checksum in the same place
+    if (snapshot->version != RTC_SNAPSHOT_VERSION || snapshot->size != sizeof(rtc_snapshot_t)) {
+        return RTC_SNAPSHOT_ERROR_VERSION;
+    }
+    if (snapshot->checksum != snapshot_checksum(snapshot)) {
+        return RTC_SNAPSHOT_ERROR_EMPTY;
+    }
+    if (snapshot->config_hash != config_hash) {
+        return RTC_SNAPSHOT_ERROR_CONFIG;
+    }
+
+    if (snapshot->template_length > RTC_SNAPSHOT_TEMPLATE_SIZE || snapshot->coin_count > GAS_POOL_MAX_COINS) {
+        return RTC_SNAPSHOT_ERROR_EMPTY;
+    }
+    return RTC_SNAPSHOT_OK;
+}
+
+rtc_snapshot_error_t rtc_snapshot_restore_template(const rtc_snapshot_t *snapshot, uint8_t *buffer,
+                                                   size_t capacity, sui_sensor_template_t *tpl) {
+    if (!snapshot || !buffer || !tpl) {
+        return RTC_SNAPSHOT_ERROR_INVALID_INPUT;
+    }
+    if (snapshot->template_length == 0) {
+        return RTC_SNAPSHOT_ERROR_EMPTY;
+    }
+    if (snapshot->template_length > capacity) {
+        return RTC_SNAPSHOT_ERROR_TOO_LARGE;
+    }
+
+    // Offsets were checked against the bytes when the template was compiled
+    bcs_writer_init_fixed(&tpl->writer, buffer, capacity);
+    bcs_write_fixed_bytes(&tpl->writer, snapshot->template_bytes, snapshot->template_length);
+    for (size_t i = 0; i < 4; i++) {
+        tpl->reading_offsets[i] = snapshot->template_offsets[i];
+    }
+    tpl->gas_object_id_offset = snapshot->template_offsets[4];
+    tpl->gas_version_offset = snapshot->template_offsets[5];
+    tpl->gas_digest_offset = snapshot->template_offsets[6];
+    tpl->gas_price_offset = snapshot->template_offsets[7];
+    tpl->gas_budget_offset = snapshot->template_offsets[8];
+    return RTC_SNAPSHOT_OK;
+}
+
+size_t rtc_snapshot_restore_gas(const rtc_snapshot_t *snapshot, gas_pool_t *pool, uint32_t now_ms) {
+    if (!snapshot || !pool) {
+        return 0;
+    }
+
+    size_t restored = 0;
+    for (size_t i = 0; i < snapshot->coin_count && i < GAS_POOL_MAX_COINS; i++) {
+        const rtc_snapshot_coin_t *saved = &snapshot->coins[i];
+        uint64_t age = (uint64_t)saved->age_ms + snapshot->away_ms;
+        if (pool->max_age_ms != 0 && age > pool->max_age_ms) {
+            continue;
+        }
+
+        // Backdated so the pool ages the ref from when it was last known current
+        if (gas_pool_put(pool, &saved->ref, now_ms - (uint32_t)age) == GAS_POOL_OK) {
+            restored++;
+        }
+    }
+    return restored;
+}
+
+void rtc_snapshot_invalidate(rtc_snapshot_t *snapshot) {
+    if (snapshot) {
+        snapshot->magic = 0;
+    }
+}
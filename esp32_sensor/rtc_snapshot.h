@@ -0,0 +1,145 @@
+/**
+ * RTC Snapshot
+ * Invariant transaction state kept across deep sleep
+ *
+ * A node that sleeps between samples would otherwise derive its address,
+ * parse the package and sender IDs, compile the transaction template and
+ * fetch gas refs again after every wake. The snapshot holds all of that in
+ * one fixed-layout struct meant for RTC slow memory (RTC_DATA_ATTR on the
+ * ESP32), so a wake only patches the template and signs.
+ *
+ * RTC memory holds garbage after power-on and survives reflashing, so the
+ * snapshot is only trusted if its magic, layout version, size and CRC-32
+ * match, and if it was taken with the same configuration (key, package,
+ * module, function; see rtc_snapshot_config_hash()).
+ *
+ * Example:
+ *   RTC_DATA_ATTR rtc_snapshot_t snapshot;
+ *
+ *   // wake
+ *   if (rtc_snapshot_check(&snapshot, config_hash) == RTC_SNAPSHOT_OK) {
+ *       identity = snapshot.identity;
+ *       rtc_snapshot_restore_template(&snapshot, tx_buffer, sizeof(tx_buffer), &tpl);
+ *       rtc_snapshot_restore_gas(&snapshot, &pool, millis());
+ *   }
+ *
+ *   // before esp_deep_sleep_start()
+ *   rtc_snapshot_save(&snapshot, config_hash, &identity, &tpl, sensor_id, sensor_version,
+ *                     &pool, millis(), sleep_ms);
+ */
+
+#ifndef RTC_SNAPSHOT_H
+#define RTC_SNAPSHOT_H
+
+#include "sui_transaction.h"
+#include "gas_pool.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define RTC_SNAPSHOT_MAGIC 0x534E5352   // "RSNS"
+#define RTC_SNAPSHOT_VERSION 1          // Bump whenever rtc_snapshot_t changes
+
+#define RTC_SNAPSHOT_TEMPLATE_SIZE 512  // Largest template kept
+#define RTC_SNAPSHOT_ADDRESS_SIZE 67    // "0x" + 64 hex digits + NUL
+
+// Error codes
+typedef enum {
+    RTC_SNAPSHOT_OK = 0,
+    RTC_SNAPSHOT_ERROR_INVALID_INPUT = -1,
+    RTC_SNAPSHOT_ERROR_EMPTY = -2,      // Nothing saved (bad magic or checksum, e.g. after power-on)
+    RTC_SNAPSHOT_ERROR_VERSION = -3,    // Saved by firmware with another layout
+    RTC_SNAPSHOT_ERROR_CONFIG = -4,     // Saved with another key or package
+    RTC_SNAPSHOT_ERROR_TOO_LARGE = -5,  // Template does not fit
+} rtc_snapshot_error_t;
+
+/**
+ * Sender and package, decoded once
+ */
+typedef struct {
+    uint8_t sender[32];
+    uint8_t package_id[32];
+    char address[RTC_SNAPSHOT_ADDRESS_SIZE];
+} rtc_snapshot_identity_t;
+
+typedef struct {
+    gas_object_t ref;
+    uint32_t age_ms;                // Since the ref was last known current, at save time
+} rtc_snapshot_coin_t;
+
+/**
+ * Snapshot layout
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;                  // sizeof(rtc_snapshot_t)
+    uint32_t config_hash;
+
+    rtc_snapshot_identity_t identity;
+
+    // Compiled template (template_length 0 = none) and its field offsets, in
+    // sui_sensor_template_t order
+    uint16_t template_length;
+    uint16_t template_offsets[9];
+    uint8_t template_bytes[RTC_SNAPSHOT_TEMPLATE_SIZE];
+
+    // Last known refs (READY gas coins only)
+    bool sensor_valid;
+    uint8_t sensor_object_id[32];
+    uint64_t sensor_version;
+    uint8_t coin_count;
+    rtc_snapshot_coin_t coins[GAS_POOL_MAX_COINS];
+    uint32_t away_ms;               // Expected time between save and restore
+
+    uint32_t checksum;              // CRC-32 of everything above
+} rtc_snapshot_t;
+
+/**
+ * Hash of the configuration strings the snapshot depends on
+ * @param fields NUL-terminated strings (NULL entries count as empty)
+ */
+uint32_t rtc_snapshot_config_hash(const char *const *fields, size_t count);
+
+/**
+ * Replace the snapshot
+ * Everything is written in place and the checksum last, so a reset part
+ * way through leaves a snapshot that fails rtc_snapshot_check().
+ * @param tpl Compiled template, or NULL if there is none yet
+ * @param sensor_object_id Sensor object ID, or NULL if not known
+ * @param pool READY coins are kept with their age at now_ms
+ * @param away_ms How long the device will be gone (the sleep duration), added
+ *                to the coin ages on restore; 0 if unknown
+ * @return RTC_SNAPSHOT_ERROR_TOO_LARGE if the template does not fit (the
+ *         snapshot is left invalid)
+ */
+rtc_snapshot_error_t rtc_snapshot_save(rtc_snapshot_t *snapshot, uint32_t config_hash,
+                                       const rtc_snapshot_identity_t *identity, const sui_sensor_template_t *tpl,
+                                       const uint8_t *sensor_object_id, uint64_t sensor_version,
+                                       const gas_pool_t *pool, uint32_t now_ms, uint32_t away_ms);
+
+/**
+ * Validate a snapshot before reading any of its fields
+ */
+rtc_snapshot_error_t rtc_snapshot_check(const rtc_snapshot_t *snapshot, uint32_t config_hash);
+
+/**
+ * Copy the saved template bytes into buffer and bind tpl to them
+ * @return RTC_SNAPSHOT_ERROR_EMPTY if no template was saved,
+ *         RTC_SNAPSHOT_ERROR_TOO_LARGE if it does not fit capacity
+ */
+rtc_snapshot_error_t rtc_snapshot_restore_template(const rtc_snapshot_t *snapshot, uint8_t *buffer,
+                                                   size_t capacity, sui_sensor_template_t *tpl);
+
+/**
+ * Put the saved gas coins back into pool, aged by away_ms
+ * Coins past the pool's max age are dropped.
+ * @return Number of coins restored
+ */
+size_t rtc_snapshot_restore_gas(const rtc_snapshot_t *snapshot, gas_pool_t *pool, uint32_t now_ms);
+
+/**
+ * Make the snapshot fail rtc_snapshot_check()
+ */
+void rtc_snapshot_invalidate(rtc_snapshot_t *snapshot);
+
+#endif // RTC_SNAPSHOT_H
@@ -0,0 +1,362 @@
+#include "sensor_frame.h"
+#include "sui_schema.h"
+#include <string.h>
+
+// ============================================================================
+// Frame layouts
+// ============================================================================
+
+struct frame_header_t {
+    uint8_t version;
+    uint8_t type;
+    uint16_t length;
+};
+
+struct digest_request_t {
+    uint8_t sender[32];
+};
+
+struct execute_request_t {
+    sensor_data_t reading;
+    gas_object_t gas_object;
+    uint8_t signature[SUI_SIGNATURE_LENGTH];
+};
+
+struct execute_response_t {
+    uint8_t digest[32];
+    sensor_frame_digest_t next;
+};
+
+struct gas_coins_request_t {
+    uint8_t sender[32];
+    uint8_t count;
+};
+
+// Fixed part of GAS_COINS_RESPONSE; the ObjectRef vector follows
+struct gas_coins_head_t {
+    uint8_t sensor_object_id[32];
+    uint64_t sensor_version;
+};
+
+namespace bcs {
+
+template <> struct schema<frame_header_t> {
+    typedef fields<
+        BCS_FIELD(frame_header_t, version),
+        BCS_FIELD(frame_header_t, type),
+        BCS_FIELD(frame_header_t, length)
+    > type;
+};
+
+template <> struct schema<digest_request_t> {
+    typedef fields<
+        BCS_FIELD(digest_request_t, sender)
+    > type;
+};
+
+template <> struct schema<sensor_frame_digest_t> {
+    typedef fields<
+        BCS_FIELD(sensor_frame_digest_t, sensor_object_id),
+        BCS_FIELD(sensor_frame_digest_t, sensor_version),
+        BCS_FIELD(sensor_frame_digest_t, gas_object)
+    > type;
+};
+
+template <> struct schema<execute_request_t> {
+    typedef fields<
+        BCS_FIELD(execute_request_t, reading),
+        BCS_FIELD(execute_request_t, gas_object),
+        BCS_FIELD(execute_request_t, signature)
+    > type;
+};
+
+template <> struct schema<execute_response_t> {
+    typedef fields<
+        BCS_FIELD(execute_response_t, digest),
+        BCS_FIELD(execute_response_t, next)
+    > type;
+};
+
+template <> struct schema<gas_coins_request_t> {
+    typedef fields<
+        BCS_FIELD(gas_coins_request_t, sender),
+        BCS_FIELD(gas_coins_request_t, count)
+    > type;
+};
+
+template <> struct schema<gas_coins_head_t> {
+    typedef fields<
+        BCS_FIELD(gas_coins_head_t, sensor_object_id),
+        BCS_FIELD(gas_coins_head_t, sensor_version)
+    > type;
+};
+
+} // namespace bcs
+
+static_assert(bcs::encoded_size<frame_header_t>() == SENSOR_FRAME_HEADER_SIZE, "Frame header must be 4 bytes");
+static_assert(bcs::encoded_size<sensor_frame_digest_t>() == 113, "DIGEST_RESPONSE payload must be 113 bytes");
+static_assert(bcs::encoded_size<execute_request_t>() == 186, "EXECUTE_REQUEST payload must be 186 bytes");
+static_assert(bcs::encoded_size<execute_response_t>() == 145, "EXECUTE_RESPONSE payload must be 145 bytes");
+static_assert(bcs::encoded_size<gas_coins_head_t>() + 1 +
+              SENSOR_FRAME_MAX_GAS_COINS * bcs::encoded_size<gas_object_t>() <= SENSOR_FRAME_MAX_PAYLOAD,
+              "GAS_COINS_RESPONSE must fit a frame");
+static_assert(SENSOR_FRAME_MAX_PAYLOAD <= UINT16_MAX, "Payload length must fit the u16 header field");
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+static void write_header(bcs_writer_t *writer, sensor_frame_type_t type, size_t payload_length) {
+    frame_header_t header = { SENSOR_FRAME_VERSION, (uint8_t)type, (uint16_t)payload_length };
+    bcs::write(writer, header);
+}
+
+// Header and fixed-layout payload, reserved as two blocks
+template <typename T>
+static bcs_error_t write_frame(bcs_writer_t *writer, sensor_frame_type_t type, const T &payload) {
+    write_header(writer, type, bcs::encoded_size<T>());
+    return bcs::write(writer, payload);
+}
+
+template <typename T>
+static bcs_error_t read_frame(const sensor_frame_t *frame, sensor_frame_type_t type, T &payload) {
+    if (!frame || frame->type != type || frame->payload.length != bcs::encoded_size<T>()) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    return bcs::load(frame->payload.data, payload) ? BCS_OK : BCS_ERROR_INVALID_INPUT;
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+bcs_error_t sensor_frame_write_digest_request(bcs_writer_t *writer, const uint8_t sender[32]) {
+    if (!writer || !sender) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    digest_request_t payload;
+    memcpy(payload.sender, sender, sizeof(payload.sender));
+    return write_frame(writer, SENSOR_FRAME_DIGEST_REQUEST, payload);
+}
+
+bcs_error_t sensor_frame_write_digest_response(bcs_writer_t *writer, const sensor_frame_digest_t *info) {
+    if (!writer || !info) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    return write_frame(writer, SENSOR_FRAME_DIGEST_RESPONSE, *info);
+}
+
+bcs_error_t sensor_frame_write_execute_request(bcs_writer_t *writer, const sensor_data_t *reading,
+                                               const gas_object_t *gas_object,
+                                               const uint8_t signature[SUI_SIGNATURE_LENGTH]) {
+    if (!writer || !reading || !gas_object || !signature) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    execute_request_t payload;
+    payload.reading = *reading;
+    payload.gas_object = *gas_object;
+    memcpy(payload.signature, signature, sizeof(payload.signature));
+    return write_frame(writer, SENSOR_FRAME_EXECUTE_REQUEST, payload);
+}
+
+bcs_error_t sensor_frame_write_execute_response(bcs_writer_t *writer, const uint8_t digest[32],
+                                                const sensor_frame_digest_t *next) {
+    if (!writer || !digest || !next) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    execute_response_t payload;
+    memcpy(payload.digest, digest, sizeof(payload.digest));
+    payload.next = *next;
+    return write_frame(writer, SENSOR_FRAME_EXECUTE_RESPONSE, payload);
+}
+
+bcs_error_t sensor_frame_write_gas_coins_request(bcs_writer_t *writer, const uint8_t sender[32], uint8_t count) {
+    if (!writer || !sender) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    gas_coins_request_t payload;
+    memcpy(payload.sender, sender, sizeof(payload.sender));
+    payload.count = count;
+    return write_frame(writer, SENSOR_FRAME_GAS_COINS_REQUEST, payload);
+}
+
+bcs_error_t sensor_frame_write_gas_coins_response(bcs_writer_t *writer, const sensor_frame_gas_coins_t *coins) {
+    if (!writer || !coins || coins->gas_count > SENSOR_FRAME_MAX_GAS_COINS) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    gas_coins_head_t head;
+    memcpy(head.sensor_object_id, coins->sensor_object_id, sizeof(head.sensor_object_id));
+    head.sensor_version = coins->sensor_version;
+
+    write_header(writer, SENSOR_FRAME_GAS_COINS_RESPONSE,
+                 bcs::encoded_size<gas_coins_head_t>() + bcs_uleb128_size(coins->gas_count) +
+                 coins->gas_count * bcs::encoded_size<gas_object_t>());
+    bcs::write(writer, head);
+    bcs_write_vec_length(writer, coins->gas_count);
+    for (size_t i = 0; i < coins->gas_count; i++) {
+        bcs::write(writer, coins->gas_objects[i]);
+    }
+    return bcs_writer_error(writer);
+}
+
+bcs_error_t sensor_frame_write_error(bcs_writer_t *writer, uint16_t status, const char *message) {
+    if (!writer) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    size_t message_length = message ? strlen(message) : 0;
+    if (message_length > SENSOR_FRAME_MAX_PAYLOAD - 2) {
+        message_length = SENSOR_FRAME_MAX_PAYLOAD - 2;
+    }
+
+    write_header(writer, SENSOR_FRAME_ERROR, 2 + message_length);
+    bcs_write_u16(writer, status);
+    return bcs_write_fixed_bytes(writer, (const uint8_t *)message, message_length);
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+size_t sensor_frame_size(const uint8_t *data) {
+    frame_header_t header;
+    bcs::load(data, header);
+    return SENSOR_FRAME_HEADER_SIZE + header.length;
+}
+
+bcs_error_t sensor_frame_parse(const uint8_t *data, size_t length, sensor_frame_t *frame) {
+    if (!data || !frame) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    if (length < SENSOR_FRAME_HEADER_SIZE) {
+        return BCS_ERROR_BUFFER_UNDERFLOW;
+    }
+
+    frame_header_t header;
+    bcs::load(data, header);
+    if (header.version != SENSOR_FRAME_VERSION) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+    if (length - SENSOR_FRAME_HEADER_SIZE < header.length) {
+        return BCS_ERROR_BUFFER_UNDERFLOW;
+    }
+
+    frame->type = header.type;
+    frame->payload.data = data + SENSOR_FRAME_HEADER_SIZE;
+    frame->payload.length = header.length;
+    frame->frame_length = SENSOR_FRAME_HEADER_SIZE + header.length;
+    return BCS_OK;
+}
+
+bcs_error_t sensor_frame_read_digest_request(const sensor_frame_t *frame, uint8_t sender[32]) {
+    if (!sender) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    digest_request_t payload;
+    bcs_error_t err = read_frame(frame, SENSOR_FRAME_DIGEST_REQUEST, payload);
+    if (err != BCS_OK) return err;
+
+    memcpy(sender, payload.sender, sizeof(payload.sender));
+    return BCS_OK;
+}
+
+bcs_error_t sensor_frame_read_digest_response(const sensor_frame_t *frame, sensor_frame_digest_t *info) {
+    if (!info) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    return read_frame(frame, SENSOR_FRAME_DIGEST_RESPONSE, *info);
+}
+
+bcs_error_t sensor_frame_read_execute_request(const sensor_frame_t *frame, sensor_data_t *reading,
+                                              gas_object_t *gas_object,
+                                              uint8_t signature[SUI_SIGNATURE_LENGTH]) {
+    if (!reading || !gas_object || !signature) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    execute_request_t payload;
+    bcs_error_t err = read_frame(frame, SENSOR_FRAME_EXECUTE_REQUEST, payload);
+    if (err != BCS_OK) return err;
+
+    *reading = payload.reading;
+    *gas_object = payload.gas_object;
+    memcpy(signature, payload.signature, sizeof(payload.signature));
+    return BCS_OK;
+}
+
+bcs_error_t sensor_frame_read_execute_response(const sensor_frame_t *frame, uint8_t digest[32],
+                                               sensor_frame_digest_t *next) {
+    if (!digest || !next) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    execute_response_t payload;
+    bcs_error_t err = read_frame(frame, SENSOR_FRAME_EXECUTE_RESPONSE, payload);
+    if (err != BCS_OK) return err;
+
+    memcpy(digest, payload.digest, sizeof(payload.digest));
+    *next = payload.next;
+    return BCS_OK;
+}
+
+bcs_error_t sensor_frame_read_gas_coins_request(const sensor_frame_t *frame, uint8_t sender[32], uint8_t *count) {
+    if (!sender || !count) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    gas_coins_request_t payload;
+    bcs_error_t err = read_frame(frame, SENSOR_FRAME_GAS_COINS_REQUEST, payload);
+    if (err != BCS_OK) return err;
+
+    memcpy(sender, payload.sender, sizeof(payload.sender));
+    *count = payload.count;
+    return BCS_OK;
+}
+
+bcs_error_t sensor_frame_read_gas_coins_response(const sensor_frame_t *frame, sensor_frame_gas_coins_t *coins) {
+    if (!frame || !coins || frame->type != SENSOR_FRAME_GAS_COINS_RESPONSE) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    bcs_reader_t reader;
+    bcs_reader_init(&reader, frame->payload.data, frame->payload.length);
+
+    gas_coins_head_t head;
+    size_t count;
+    if (bcs::read(&reader, head) != BCS_OK || bcs_read_vec_length(&reader, &count) != BCS_OK ||
+        count > SENSOR_FRAME_MAX_GAS_COINS ||
+        bcs_reader_remaining(&reader) != count * bcs::encoded_size<gas_object_t>()) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (bcs::read(&reader, coins->gas_objects[i]) != BCS_OK) {
+            return BCS_ERROR_INVALID_INPUT;
+        }
+    }
+
+    memcpy(coins->sensor_object_id, head.sensor_object_id, sizeof(coins->sensor_object_id));
+    coins->sensor_version = head.sensor_version;
+    coins->gas_count = count;
+    return BCS_OK;
+}
+
+bcs_error_t sensor_frame_read_error(const sensor_frame_t *frame, uint16_t *status, bcs_view_t *message) {
+    if (!frame || !status || !message || frame->type != SENSOR_FRAME_ERROR || frame->payload.length < 2) {
+        return BCS_ERROR_INVALID_INPUT;
+    }
+
+    bcs::load(frame->payload.data, *status);
+    message->data = frame->payload.data + 2;
+    message->length = frame->payload.length - 2;
+    return BCS_OK;
+}
@@ -0,0 +1,173 @@
+/**
+ * Sensor Frames
+ * Compact binary framing for the device <-> server exchanges
+ *
+ * A binary alternative to the create-digest and execute-sponsored JSON
+ * endpoints. Each HTTP body (POST /api/frame, application/octet-stream)
+ * is exactly one frame:
+ *
+ *   version (u8) | type (u8) | payload length (u16 LE) | payload
+ *
+ * Payloads are fixed-layout BCS: object IDs and digests are raw 32-byte
+ * arrays, versions and readings little-endian integers and the signature
+ * its raw 97 bytes, so nothing is hex or Base58/Base64 text on the wire.
+ *
+ *   DIGEST_REQUEST    sender address (32)
+ *   DIGEST_RESPONSE   sensor ObjectID (32), sensor version (u64),
+ *                     gas ObjectRef (73, BCS ObjectRef layout)
+ *   EXECUTE_REQUEST   reading (16, as sensor_data_t), gas ObjectRef the
+ *                     transaction was signed with (73), signature (97)
+ *   EXECUTE_RESPONSE  transaction digest (32), then the refs for the next
+ *                     transaction in DIGEST_RESPONSE layout (113)
+ *   GAS_COINS_REQUEST   sender address (32), coins wanted (u8)
+ *   GAS_COINS_RESPONSE  sensor ObjectID (32), sensor version (u64),
+ *                       gas ObjectRefs (ULEB128 count, then 73 each)
+ *   ERROR             HTTP-style status (u16), UTF-8 message (rest)
+ *
+ * Example (device side):
+ *   uint8_t frame[SENSOR_FRAME_MAX_SIZE];
+ *   bcs_writer_t writer;
+ *   bcs_writer_init_fixed(&writer, frame, sizeof(frame));
+ *   sensor_frame_write_digest_request(&writer, sender);
+ *   // POST frame[0 .. writer.position), read the reply into response
+ *
+ *   sensor_frame_t reply;
+ *   sensor_frame_digest_t info;
+ *   if (sensor_frame_parse(response, response_length, &reply) == BCS_OK &&
+ *       sensor_frame_read_digest_response(&reply, &info) == BCS_OK) {
+ *       params.gas_object = info.gas_object;
+ *   }
+ */
+
+#ifndef SENSOR_FRAME_H
+#define SENSOR_FRAME_H
+
+#include "bcs.h"
+#include "sui_transaction.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#define SENSOR_FRAME_VERSION 1
+#define SENSOR_FRAME_HEADER_SIZE 4
+
+// Largest frame either side sends (error messages are truncated to fit)
+#define SENSOR_FRAME_MAX_SIZE 512
+#define SENSOR_FRAME_MAX_PAYLOAD (SENSOR_FRAME_MAX_SIZE - SENSOR_FRAME_HEADER_SIZE)
+
+// Serialized Sui signature: flag (0x00 = Ed25519) + signature (64) + public key (32)
+#define SUI_SIGNATURE_LENGTH 97
+
+// Most gas coins a GAS_COINS_RESPONSE carries
+#define SENSOR_FRAME_MAX_GAS_COINS 6
+
+typedef enum {
+    SENSOR_FRAME_DIGEST_REQUEST = 0x01,
+    SENSOR_FRAME_DIGEST_RESPONSE = 0x02,
+    SENSOR_FRAME_EXECUTE_REQUEST = 0x03,
+    SENSOR_FRAME_EXECUTE_RESPONSE = 0x04,
+    SENSOR_FRAME_GAS_COINS_REQUEST = 0x05,
+    SENSOR_FRAME_GAS_COINS_RESPONSE = 0x06,
+    SENSOR_FRAME_ERROR = 0x7F
+} sensor_frame_type_t;
+
+/**
+ * A parsed frame; payload points into the caller's buffer
+ */
+typedef struct {
+    uint8_t type;           // sensor_frame_type_t (unknown types are passed through)
+    bcs_view_t payload;
+    size_t frame_length;    // Header + payload
+} sensor_frame_t;
+
+/**
+ * Objects the next transaction needs (DIGEST_RESPONSE payload, and the
+ * tail of EXECUTE_RESPONSE with the refs left by the execution)
+ */
+typedef struct {
+    uint8_t sensor_object_id[32];
+    uint64_t sensor_version;
+    gas_object_t gas_object;
+} sensor_frame_digest_t;
+
+/**
+ * Sensor object and several of the sender's gas coins (GAS_COINS_RESPONSE
+ * payload), to fill a gas pool in one round trip
+ */
+typedef struct {
+    uint8_t sensor_object_id[32];
+    uint64_t sensor_version;
+    size_t gas_count;
+    gas_object_t gas_objects[SENSOR_FRAME_MAX_GAS_COINS];
+} sensor_frame_gas_coins_t;
+
+// ============================================================================
+// Encoding
+// Each call appends one complete frame; errors latch on the writer.
+// ============================================================================
+
+bcs_error_t sensor_frame_write_digest_request(bcs_writer_t *writer, const uint8_t sender[32]);
+
+bcs_error_t sensor_frame_write_digest_response(bcs_writer_t *writer, const sensor_frame_digest_t *info);
+
+bcs_error_t sensor_frame_write_execute_request(bcs_writer_t *writer, const sensor_data_t *reading,
+                                               const gas_object_t *gas_object,
+                                               const uint8_t signature[SUI_SIGNATURE_LENGTH]);
+
+bcs_error_t sensor_frame_write_execute_response(bcs_writer_t *writer, const uint8_t digest[32],
+                                                const sensor_frame_digest_t *next);
+
+bcs_error_t sensor_frame_write_gas_coins_request(bcs_writer_t *writer, const uint8_t sender[32], uint8_t count);
+
+bcs_error_t sensor_frame_write_gas_coins_response(bcs_writer_t *writer, const sensor_frame_gas_coins_t *coins);
+
+/**
+ * Append an ERROR frame
+ * @param message NUL-terminated; cut to SENSOR_FRAME_MAX_PAYLOAD - 2 bytes
+ */
+bcs_error_t sensor_frame_write_error(bcs_writer_t *writer, uint16_t status, const char *message);
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+/**
+ * Parse the frame at the start of data
+ * @return BCS_ERROR_BUFFER_UNDERFLOW if data holds less than one whole frame,
+ *         BCS_ERROR_INVALID_INPUT for an unsupported version
+ */
+bcs_error_t sensor_frame_parse(const uint8_t *data, size_t length, sensor_frame_t *frame);
+
+/**
+ * Total size of the frame whose header is at data
+ * Lets stream readers fetch the header first, then exactly the payload.
+ * @param data At least SENSOR_FRAME_HEADER_SIZE bytes
+ */
+size_t sensor_frame_size(const uint8_t *data);
+
+// The readers below return BCS_ERROR_INVALID_INPUT if the frame has
+// another type or its payload does not have the expected layout
+
+bcs_error_t sensor_frame_read_digest_request(const sensor_frame_t *frame, uint8_t sender[32]);
+
+bcs_error_t sensor_frame_read_digest_response(const sensor_frame_t *frame, sensor_frame_digest_t *info);
+
+bcs_error_t sensor_frame_read_execute_request(const sensor_frame_t *frame, sensor_data_t *reading,
+                                              gas_object_t *gas_object,
+                                              uint8_t signature[SUI_SIGNATURE_LENGTH]);
+
+/**
+ * @param next Output: sensor and gas refs to build the next transaction from
+ */
+bcs_error_t sensor_frame_read_execute_response(const sensor_frame_t *frame, uint8_t digest[32],
+                                               sensor_frame_digest_t *next);
+
+bcs_error_t sensor_frame_read_gas_coins_request(const sensor_frame_t *frame, uint8_t sender[32], uint8_t *count);
+
+bcs_error_t sensor_frame_read_gas_coins_response(const sensor_frame_t *frame, sensor_frame_gas_coins_t *coins);
+
+/**
+ * @param message Output: message bytes (not NUL-terminated)
+ */
+bcs_error_t sensor_frame_read_error(const sensor_frame_t *frame, uint16_t *status, bcs_view_t *message);
+
+#endif // SENSOR_FRAME_H
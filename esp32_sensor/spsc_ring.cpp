@@ -0,0 +1,94 @@
+#include "spsc_ring.h"
+#include <string.h>
+
+spsc_ring_error_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t record_size, uint32_t capacity) {
+    if (!ring || !storage || record_size == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return SPSC_RING_ERROR_INVALID_INPUT;
+    }
+
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+    ring->records = (uint8_t *)storage;
+    ring->record_size = record_size;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    return SPSC_RING_OK;
+}
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+void *spsc_ring_reserve(spsc_ring_t *ring) {
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+
+    // Only reload the consumer's index when the cached one says full
+    if (head - ring->tail_cache == ring->capacity) {
+        ring->tail_cache = ring->tail.load(std::memory_order_acquire);
+        if (head - ring->tail_cache == ring->capacity) {
+            return NULL;
+        }
+    }
+
+    return ring->records + (size_t)(head & ring->mask) * ring->record_size;
+}
+
+void spsc_ring_commit(spsc_ring_t *ring) {
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+spsc_ring_error_t spsc_ring_push(spsc_ring_t *ring, const void *record) {
+    void *slot = spsc_ring_reserve(ring);
+    if (!slot) {
+        return SPSC_RING_ERROR_FULL;
+    }
+    memcpy(slot, record, ring->record_size);
+    spsc_ring_commit(ring);
+    return SPSC_RING_OK;
+}
+
+// ============================================================================
+// Consumer side
+// ============================================================================
+
+void *spsc_ring_peek(spsc_ring_t *ring) {
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+
+    // Only reload the producer's index when the cached one says empty
+    if (tail == ring->head_cache) {
+        ring->head_cache = ring->head.load(std::memory_order_acquire);
+        if (tail == ring->head_cache) {
+            return NULL;
+        }
+    }
+
+    return ring->records + (size_t)(tail & ring->mask) * ring->record_size;
+}
+
+void spsc_ring_release(spsc_ring_t *ring) {
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    ring->tail.store(tail + 1, std::memory_order_release);
+}
+
+spsc_ring_error_t spsc_ring_pop(spsc_ring_t *ring, void *record) {
+    void *slot = spsc_ring_peek(ring);
+    if (!slot) {
+        return SPSC_RING_ERROR_EMPTY;
+    }
+    memcpy(record, slot, ring->record_size);
+    spsc_ring_release(ring);
+    return SPSC_RING_OK;
+}
+
+// ============================================================================
+// Either side
+// ============================================================================
+
+uint32_t spsc_ring_size(const spsc_ring_t *ring) {
+    uint32_t tail = ring->tail.load(std::memory_order_acquire);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+    return head - tail;
+}
@@ -0,0 +1,131 @@
+/**
+ * SPSC Ring
+ * Lock-free single-producer/single-consumer queue of fixed-size records
+ *
+ * One thread (or core) produces and one consumes; neither blocks, and
+ * nothing is allocated after init. Records live in caller-provided storage
+ * and are filled and read in place: the producer reserves the next free
+ * slot, writes it and commits; the consumer peeks the oldest committed
+ * slot and releases it when done. Each index is written by one side only,
+ * and commit/release publish with release ordering, so a record's contents
+ * are visible before its slot is.
+ *
+ * Only C++11 atomics are used, so the same code hands records between
+ * FreeRTOS tasks pinned to the two ESP32 cores and between std::threads on
+ * Linux (e.g. under ThreadSanitizer).
+ *
+ * Example:
+ *   static tx_record_t storage[4];
+ *   spsc_ring_t ring;
+ *   spsc_ring_init(&ring, storage, sizeof(tx_record_t), 4);
+ *
+ *   // producer
+ *   tx_record_t *rec = (tx_record_t *)spsc_ring_reserve(&ring);
+ *   if (rec) { fill(rec); spsc_ring_commit(&ring); }
+ *
+ *   // consumer
+ *   tx_record_t *rec = (tx_record_t *)spsc_ring_peek(&ring);
+ *   if (rec) { send(rec); spsc_ring_release(&ring); }
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Keeps the producer's and consumer's indices apart (no false sharing on
+// hosts; harmless on the ESP32)
+#define SPSC_RING_CACHE_LINE 64
+
+// Error codes
+typedef enum {
+    SPSC_RING_OK = 0,
+    SPSC_RING_ERROR_INVALID_INPUT = -1,
+    SPSC_RING_ERROR_FULL = -2,
+    SPSC_RING_ERROR_EMPTY = -3,
+} spsc_ring_error_t;
+
+/**
+ * Ring state
+ *
+ * head and tail run freely and wrap at 2^32; capacity is a power of two,
+ * so head - tail is the fill level and index & mask the slot.
+ */
+typedef struct {
+    // Written by the producer
+    alignas(SPSC_RING_CACHE_LINE) std::atomic<uint32_t> head;
+    uint32_t tail_cache;        // Producer's last view of tail
+
+    // Written by the consumer
+    alignas(SPSC_RING_CACHE_LINE) std::atomic<uint32_t> tail;
+    uint32_t head_cache;        // Consumer's last view of head
+
+    // Fixed at init
+    alignas(SPSC_RING_CACHE_LINE) uint8_t *records;
+    size_t record_size;
+    uint32_t capacity;
+    uint32_t mask;
+} spsc_ring_t;
+
+/**
+ * Set up an empty ring over storage (capacity * record_size bytes, aligned
+ * for the record type)
+ * @param capacity Number of records; must be a power of two
+ */
+spsc_ring_error_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t record_size, uint32_t capacity);
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+/**
+ * Next free slot to fill, or NULL if the ring is full
+ * Repeated calls return the same slot until spsc_ring_commit().
+ */
+void *spsc_ring_reserve(spsc_ring_t *ring);
+
+/**
+ * Publish the reserved slot to the consumer
+ */
+void spsc_ring_commit(spsc_ring_t *ring);
+
+/**
+ * Copy record into the ring
+ * @return SPSC_RING_ERROR_FULL if there is no free slot
+ */
+spsc_ring_error_t spsc_ring_push(spsc_ring_t *ring, const void *record);
+
+// ============================================================================
+// Consumer side
+// ============================================================================
+
+/**
+ * Oldest committed record, or NULL if the ring is empty
+ * The record stays in place (and may be modified) until spsc_ring_release().
+ */
+void *spsc_ring_peek(spsc_ring_t *ring);
+
+/**
+ * Hand the peeked slot back to the producer
+ */
+void spsc_ring_release(spsc_ring_t *ring);
+
+/**
+ * Copy the oldest record out and release it
+ * @return SPSC_RING_ERROR_EMPTY if there is none
+ */
+spsc_ring_error_t spsc_ring_pop(spsc_ring_t *ring, void *record);
+
+// ============================================================================
+// Either side
+// ============================================================================
+
+/**
+ * Committed records not yet released (a snapshot; exact only while the
+ * other side is idle)
+ */
+uint32_t spsc_ring_size(const spsc_ring_t *ring);
+
+#endif // SPSC_RING_H
@@ -0,0 +1,38 @@
+/**
+ * Sui Schemas
+ * bcs::schema specializations for the public Sui types, shared by every
+ * translation unit that encodes them (a second, different specialization
+ * in another file would be an ODR violation)
+ */
+
+#ifndef SUI_SCHEMA_H
+#define SUI_SCHEMA_H
+
+#include "sui_transaction.h"
+#include "bcs_schema.h"
+
+namespace bcs {
+
+// ObjectRef: (ObjectID, SequenceNumber, ObjectDigest)
+template <> struct schema<gas_object_t> {
+    typedef fields<
+        BCS_FIELD(gas_object_t, object_id),
+        BCS_FIELD(gas_object_t, version),
+        BCS_FIELD_AS(gas_object_t, digest, prefixed<32>)
+    > type;
+};
+
+// Reading: the four u16 values, then the u64 timestamp
+template <> struct schema<sensor_data_t> {
+    typedef fields<
+        BCS_FIELD(sensor_data_t, value1),
+        BCS_FIELD(sensor_data_t, value2),
+        BCS_FIELD(sensor_data_t, value3),
+        BCS_FIELD(sensor_data_t, value4),
+        BCS_FIELD(sensor_data_t, timestamp)
+    > type;
+};
+
+} // namespace bcs
+
+#endif // SUI_SCHEMA_H
@@ -4,138 +4,612 @@
  */
 
 #include "sui_transaction.h"
+#include "sui_schema.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Propagate the first failing BCS call to the caller
+#define BCS_TRY(expr)                        \
+  do {                                       \
+    bcs_error_t try_err_ = (expr);           \
+    if (try_err_ != BCS_OK) return try_err_; \
+  } while (0)
+
+// Hex-encode the writer contents into a string allocated through allocator
+static bcs_error_t writer_to_hex(
+  const bcs_writer_t *writer,
+  const bcs_allocator_t *allocator,
+  char **output_hex,
+  size_t *output_length) {
+  size_t result_length;
+  const uint8_t *result_bytes = bcs_writer_get_bytes(writer, &result_length);
+
+  *output_hex = (char *)bcs_allocator_alloc(allocator, result_length * 2 + 1);
+  if (!*output_hex) {
+    return BCS_ERROR_OUT_OF_MEMORY;
+  }
+
+  bcs_bytes_to_hex(result_bytes, result_length, *output_hex);
+  *output_length = result_length * 2;
+  return BCS_OK;
+}
+
+// The builders below ignore individual write results: the writer latches
+// the first failure and the entry points report it via bcs_writer_error().
+// Fixed-size blocks are reserved once and filled with direct stores;
+// bcs_writer_reserve() returns NULL for counting (or failed) writers.
+
+// ============================================================================
+// Fixed-layout pieces of the sensor transaction
+// ============================================================================
+
+// CallArg::Pure holding one u64
+struct pure_u64_arg_t {
+  uint64_t value;
+};
+
+// CallArg::Object(SharedObject { id, initial_shared_version, mutable })
+struct shared_object_arg_t {
+  uint8_t object_id[32];
+  uint64_t initial_shared_version;
+  bool is_mutable;
+};
+
+namespace bcs {
+
+template <> struct schema<pure_u64_arg_t> {
+  typedef fields<
+    constant<0x00>,  // CallArg::Pure
+    constant<0x08>,  // Length 8
+    BCS_FIELD(pure_u64_arg_t, value)
+  > type;
+};
+
+template <> struct schema<shared_object_arg_t> {
+  typedef fields<
+    constant<0x01>,  // CallArg::Object
+    constant<0x01>,  // ObjectArg::SharedObject
+    BCS_FIELD(shared_object_arg_t, object_id),
+    BCS_FIELD(shared_object_arg_t, initial_shared_version),
+    BCS_FIELD(shared_object_arg_t, is_mutable)
+  > type;
+};
+
+} // namespace bcs
+
+// Sender, gas data (one coin, paid by the sender) and expiration, read
+// straight from the builder params
+typedef bcs::fields<
+  BCS_FIELD(transaction_builder_t, sender),
+  bcs::constant<0x01>,  // 1 gas coin
+  BCS_FIELD(transaction_builder_t, gas_object),
+  BCS_FIELD(transaction_builder_t, sender),  // Gas owner
+  BCS_FIELD(transaction_builder_t, gas_price),
+  BCS_FIELD(transaction_builder_t, gas_budget),
+  bcs::constant<0x00>  // None expiration
+> transaction_footer_t;
+
+static const size_t GAS_OBJECT_OFFSET = bcs::field_offset<2, transaction_footer_t>::value;
+
+static_assert(bcs::encoded_size<gas_object_t>() == 73, "ObjectRef must be 73 bytes");
+static_assert(bcs::encoded_size<pure_u64_arg_t>() == 10, "Pure u64 input must be 10 bytes");
+static_assert(bcs::encoded_size<shared_object_arg_t>() == 43, "Shared object input must be 43 bytes");
+static_assert(transaction_footer_t::size == 155, "Transaction footer must be 155 bytes");
+
+// Pure u64 input; *value_offset (if given) receives where the value lands
+static void write_u64_pure_input(bcs_writer_t *writer, uint64_t value, size_t *value_offset) {
+  if (value_offset) *value_offset = writer->position + bcs::offset_of<pure_u64_arg_t, 2>();
+
+  pure_u64_arg_t arg = { value };
+  bcs::write(writer, arg);
+}
+
+// Pure string inputs shared by every store_sensor_data call:
+// device_id, sensor_type, location
+static void write_string_pure_inputs(bcs_writer_t *writer) {
+  static const uint8_t strings[] = {
+    // device_id: Pure, length 13, "esp32-device" (12 chars)
+    0x00, 0x0d, 0x0c, 'e', 's', 'p', '3', '2', '-', 'd', 'e', 'v', 'i', 'c', 'e',
+    // sensor_type: Pure, length 5, "soil" (4 chars)
+    0x00, 0x05, 0x04, 's', 'o', 'i', 'l',
+    // location: Pure, length 1, empty string
+    0x00, 0x01, 0x00,
+  };
+  bcs_write_fixed_bytes(writer, strings, sizeof(strings));
+}
+
+// Clock Object - Shared object 0x6, initial shared version 1, immutable
+static void write_clock_input(bcs_writer_t *writer) {
+  static const shared_object_arg_t clock = {
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x06 },
+    1,
+    false,
+  };
+  bcs::write(writer, clock);
+}
+
+// MoveCall command for params' package::module::function with 8 input arguments
+static void write_move_call(
+  bcs_writer_t *writer,
+  const transaction_builder_t *params,
+  const uint16_t args[8]) {
+  // Command: MoveCall, package ID
+  uint8_t *p = bcs_writer_reserve(writer, 1 + 32);
+  if (p) {
+    p[0] = 0x00;
+    memcpy(p + 1, params->package_id, 32);
+  }
+
+  // Module and function names
+  bcs_write_string(writer, params->module_name);
+  bcs_write_string(writer, params->function_name);
+
+  // No type arguments, then 8 x Argument::Input(index)
+  p = bcs_writer_reserve(writer, 2 + 8 * 3);
+  if (!p) return;
+
+  p[0] = 0x00;
+  p[1] = 0x08;
+  for (int i = 0; i < 8; i++) {
+    p[2 + i * 3] = 0x01;
+    bcs_store_u16(p + 3 + i * 3, args[i]);
+  }
+}
+
+// Sender, gas data and expiration; records gas slots into tpl if given
+static void write_transaction_footer(
+  bcs_writer_t *writer,
+  const transaction_builder_t *params,
+  sui_sensor_template_t *tpl) {
+  size_t start = writer->position;
+  if (tpl) {
+    size_t gas = start + GAS_OBJECT_OFFSET;
+    tpl->gas_object_id_offset = gas + bcs::offset_of<gas_object_t, 0>();
+    tpl->gas_version_offset = gas + bcs::offset_of<gas_object_t, 1>();
+    tpl->gas_digest_offset = gas + bcs::offset_of<gas_object_t, 2>() + bcs::prefixed<32>::prefix_size;
+    tpl->gas_price_offset = start + bcs::field_offset<4, transaction_footer_t>::value;
+    tpl->gas_budget_offset = start + bcs::field_offset<5, transaction_footer_t>::value;
+  }
+
+  uint8_t *p = bcs_writer_reserve(writer, transaction_footer_t::size);
+  if (p) {
+    transaction_footer_t::store(p, *params);
+  }
+}
+
+// Serialize the sensor transaction; if tpl is given, record where each
+// per-cycle field lands so it can be patched later
+static bcs_error_t write_sensor_transaction(
+  const transaction_builder_t *params,
+  bcs_writer_t *writer,
+  sui_sensor_template_t *tpl) {
+  // TransactionData V1, ProgrammableTransaction, 8 inputs (7 Pure values + 1 Clock Object)
+  uint8_t *p = bcs_writer_reserve(writer, 3);
+  if (p) {
+    p[0] = 0x00;
+    p[1] = 0x00;
+    p[2] = 0x08;
+  }
+
+  // Inputs 0-3: Pure - temperature, humidity, ec, ph (u64)
+  write_u64_pure_input(writer, params->sensor_data.value1, tpl ? &tpl->reading_offsets[0] : NULL);
+  write_u64_pure_input(writer, params->sensor_data.value2, tpl ? &tpl->reading_offsets[1] : NULL);
+  write_u64_pure_input(writer, params->sensor_data.value3, tpl ? &tpl->reading_offsets[2] : NULL);
+  write_u64_pure_input(writer, params->sensor_data.value4, tpl ? &tpl->reading_offsets[3] : NULL);
+
+  // Inputs 4-6: Pure - device_id, sensor_type, location (string)
+  write_string_pure_inputs(writer);
+
+  // Input 7: Clock Object (LAST!)
+  write_clock_input(writer);
+
+  // ========== Commands (1 MoveCall) ==========
+  bcs_write_uleb128(writer, 1);
+
+  // Simple sequential indices
+  static const uint16_t args[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  write_move_call(writer, params, args);
+
+  write_transaction_footer(writer, params, tpl);
+  return bcs_writer_error(writer);
+}
+
+// Reading field 0-3 (value1..value4) as the u64 passed to the Move call
+static uint64_t sensor_field(const sensor_data_t *data, size_t field) {
+  switch (field) {
+    case 0: return data->value1;
+    case 1: return data->value2;
+    case 2: return data->value3;
+    default: return data->value4;
+  }
+}
+
+// Batched variant: unique u64 readings first, then the shared string inputs
+// and Clock, then one MoveCall per reading pointing at its inputs
+static bcs_error_t write_sensor_batch_transaction(
+  const transaction_builder_t *params,
+  const sensor_data_t *readings,
+  size_t num_readings,
+  bcs_writer_t *writer) {
+  // Input index of every reading field; equal values share one Pure input
+  uint16_t value_inputs[SUI_MAX_BATCH_READINGS * 4];
+  size_t num_values = num_readings * 4;
+  uint16_t num_unique = 0;
+
+  for (size_t k = 0; k < num_values; k++) {
+    uint64_t value = sensor_field(&readings[k / 4], k % 4);
+    size_t j = 0;
+    while (j < k && sensor_field(&readings[j / 4], j % 4) != value) {
+      j++;
+    }
+    value_inputs[k] = (j < k) ? value_inputs[j] : num_unique++;
+  }
+
+  // ========== TransactionData V1 / ProgrammableTransaction ==========
+  uint8_t *p = bcs_writer_reserve(writer, 2);
+  if (p) {
+    p[0] = 0x00;
+    p[1] = 0x00;
+  }
+
+  // ========== Inputs (unique readings + 3 strings + Clock) ==========
+  bcs_write_uleb128(writer, num_unique + 4);
+
+  // Indices are handed out in first-use order, so emit each value on its first use
+  uint16_t emitted = 0;
+  for (size_t k = 0; k < num_values; k++) {
+    if (value_inputs[k] == emitted) {
+      write_u64_pure_input(writer, sensor_field(&readings[k / 4], k % 4), NULL);
+      emitted++;
+    }
+  }
+
+  write_string_pure_inputs(writer);
+  write_clock_input(writer);
+
+  // ========== Commands (1 MoveCall per reading) ==========
+  bcs_write_uleb128(writer, num_readings);
+
+  for (size_t r = 0; r < num_readings; r++) {
+    uint16_t args[8] = {
+      value_inputs[r * 4], value_inputs[r * 4 + 1], value_inputs[r * 4 + 2], value_inputs[r * 4 + 3],
+      num_unique, (uint16_t)(num_unique + 1), (uint16_t)(num_unique + 2), (uint16_t)(num_unique + 3)
+    };
+    write_move_call(writer, params, args);
+  }
+
+  write_transaction_footer(writer, params, NULL);
+  return bcs_writer_error(writer);
+}
+
+bcs_error_t sui_build_sensor_transaction_into(
+  const transaction_builder_t *params,
+  bcs_writer_t *writer) {
+  if (!params || !writer) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  return write_sensor_transaction(params, writer, NULL);
+}
+
+bcs_error_t sui_measure_sensor_transaction(
+  const transaction_builder_t *params,
+  size_t *length) {
+  if (!params || !length) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  bcs_writer_t counter;
+  bcs_writer_init_counting(&counter);
+  BCS_TRY(sui_build_sensor_transaction_into(params, &counter));
+
+  *length = counter.position;
+  return BCS_OK;
+}
+
+bcs_error_t sui_build_sensor_transaction_bytes(
+  const transaction_builder_t *params,
+  uint8_t **output,
+  size_t *output_length) {
+  return sui_build_sensor_transaction_bytes_with_allocator(params, NULL, output, output_length);
+}
+
+bcs_error_t sui_build_sensor_transaction_bytes_with_allocator(
+  const transaction_builder_t *params,
+  const bcs_allocator_t *allocator,
+  uint8_t **output,
+  size_t *output_length) {
+  if (!params || !output || !output_length) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  size_t tx_length;
+  BCS_TRY(sui_measure_sensor_transaction(params, &tx_length));
+
+  uint8_t *tx = (uint8_t *)bcs_allocator_alloc(allocator, tx_length);
+  if (!tx) {
+    return BCS_ERROR_OUT_OF_MEMORY;
+  }
+
+  bcs_writer_t writer;
+  bcs_writer_init_fixed(&writer, tx, tx_length);
+  bcs_error_t err = sui_build_sensor_transaction_into(params, &writer);
+  if (err == BCS_OK && writer.position != tx_length) {
+    err = BCS_ERROR_INVALID_INPUT;  // Measured and written layouts diverged
+  }
+  if (err != BCS_OK) {
+    bcs_allocator_free(allocator, tx);
+    return err;
+  }
+
+  *output = tx;
+  *output_length = tx_length;
+  return BCS_OK;
+}
+
+// Expand length raw bytes at the start of buf into lowercase hex in place.
+// Walks backwards so each byte is read before its slot is overwritten.
+static void expand_to_hex_in_place(char *buf, size_t length) {
+  const char hex_chars[] = "0123456789abcdef";
+  const uint8_t *bytes = (const uint8_t *)buf;
+
+  buf[length * 2] = '\0';
+  for (size_t i = length; i-- > 0;) {
+    uint8_t byte = bytes[i];
+    buf[i * 2] = hex_chars[byte >> 4];
+    buf[i * 2 + 1] = hex_chars[byte & 0x0F];
+  }
+}
+
 bcs_error_t sui_build_sensor_transaction(
   const transaction_builder_t *params,
   char **output_hex,
   size_t *output_length) {
+  return sui_build_sensor_transaction_with_allocator(params, NULL, output_hex, output_length);
+}
+
+bcs_error_t sui_build_sensor_transaction_with_allocator(
+  const transaction_builder_t *params,
+  const bcs_allocator_t *allocator,
+  char **output_hex,
+  size_t *output_length) {
   if (!params || !output_hex || !output_length) {
     return BCS_ERROR_INVALID_INPUT;
   }
 
+  // Measure first so the hex string is the only allocation
+  size_t tx_length;
+  bcs_error_t err = sui_measure_sensor_transaction(params, &tx_length);
+  if (err != BCS_OK) return err;
+
+  char *hex = (char *)bcs_allocator_alloc(allocator, tx_length * 2 + 1);
+  if (!hex) {
+    return BCS_ERROR_OUT_OF_MEMORY;
+  }
+
+  // Serialize into the front of the hex buffer, then widen it in place
   bcs_writer_t writer;
-  bcs_writer_init(&writer, 512, 0);
-  bcs_error_t err = BCS_OK;
+  bcs_writer_init_fixed(&writer, (uint8_t *)hex, tx_length * 2 + 1);
+  err = sui_build_sensor_transaction_into(params, &writer);
+  if (err == BCS_OK && writer.position != tx_length) {
+    err = BCS_ERROR_INVALID_INPUT;  // Measured and written layouts diverged
+  }
+  if (err != BCS_OK) {
+    bcs_allocator_free(allocator, hex);
+    return err;
+  }
 
-  // ========== TransactionData V1 ==========
-  bcs_write_u8(&writer, 0x00);  // Version: V1
+  expand_to_hex_in_place(hex, tx_length);
+  *output_hex = hex;
+  *output_length = tx_length * 2;
+  return BCS_OK;
+}
 
-  // ========== TransactionKind: ProgrammableTransaction ==========
-  bcs_write_u8(&writer, 0x00);  // Kind: ProgrammableTransaction
+bcs_error_t sui_build_sensor_batch_transaction_into(
+  const transaction_builder_t *params,
+  const sensor_data_t *readings,
+  size_t num_readings,
+  bcs_writer_t *writer) {
+  if (!params || !readings || !writer || num_readings == 0) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+  if (num_readings > SUI_MAX_BATCH_READINGS) {
+    return BCS_ERROR_OVERFLOW;
+  }
 
-  // ========== Inputs (8 total: 1 Clock Object + 7 Pure values) ==========
-  bcs_write_uleb128(&writer, 8);
+  return write_sensor_batch_transaction(params, readings, num_readings, writer);
+}
 
+bcs_error_t sui_build_sensor_batch_transaction_bytes(
+  const transaction_builder_t *params,
+  const sensor_data_t *readings,
+  size_t num_readings,
+  uint8_t **output,
+  size_t *output_length) {
+  return sui_build_sensor_batch_transaction_bytes_with_allocator(
+    params, readings, num_readings, NULL, output, output_length);
+}
 
+bcs_error_t sui_build_sensor_batch_transaction_bytes_with_allocator(
+  const transaction_builder_t *params,
+  const sensor_data_t *readings,
+  size_t num_readings,
+  const bcs_allocator_t *allocator,
+  uint8_t **output,
+  size_t *output_length) {
+  if (!output || !output_length) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
 
-  // Input 1: Pure - temperature (u64)
-  bcs_write_u8(&writer, 0x00);
-  bcs_write_uleb128(&writer, 8);
-  bcs_write_u64(&writer, params->sensor_data.value1);
+  bcs_writer_t counter;
+  bcs_writer_init_counting(&counter);
+  BCS_TRY(sui_build_sensor_batch_transaction_into(params, readings, num_readings, &counter));
+  size_t tx_length = counter.position;
 
-  // Input 2: Pure - humidity (u64)
-  bcs_write_u8(&writer, 0x00);
-  bcs_write_uleb128(&writer, 8);
-  bcs_write_u64(&writer, params->sensor_data.value2);
+  uint8_t *tx = (uint8_t *)bcs_allocator_alloc(allocator, tx_length);
+  if (!tx) {
+    return BCS_ERROR_OUT_OF_MEMORY;
+  }
 
-  // Input 3: Pure - ec (u64)
-  bcs_write_u8(&writer, 0x00);
-  bcs_write_uleb128(&writer, 8);
-  bcs_write_u64(&writer, params->sensor_data.value3);
+  bcs_writer_t writer;
+  bcs_writer_init_fixed(&writer, tx, tx_length);
+  bcs_error_t err = write_sensor_batch_transaction(params, readings, num_readings, &writer);
+  if (err == BCS_OK && writer.position != tx_length) {
+    err = BCS_ERROR_INVALID_INPUT;  // Measured and written layouts diverged
+  }
+  if (err != BCS_OK) {
+    bcs_allocator_free(allocator, tx);
+    return err;
+  }
 
-  // Input 4: Pure - ph (u64)
-  bcs_write_u8(&writer, 0x00);
-  bcs_write_uleb128(&writer, 8);
-  bcs_write_u64(&writer, params->sensor_data.value4);
+  *output = tx;
+  *output_length = tx_length;
+  return BCS_OK;
+}
 
-  // Input 5: Pure - device_id (string)
-  bcs_write_u8(&writer, 0x00);
-  bcs_write_u8(&writer, 0x0d);
-  bcs_write_uleb128(&writer, 12);  // "esp32-device" = 12 chars
-  bcs_write_fixed_bytes(&writer, (const uint8_t *)"esp32-device", 12);
+bcs_error_t sui_build_sensor_batch_transaction(
+  const transaction_builder_t *params,
+  const sensor_data_t *readings,
+  size_t num_readings,
+  char **output_hex,
+  size_t *output_length) {
+  return sui_build_sensor_batch_transaction_with_allocator(
+    params, readings, num_readings, NULL, output_hex, output_length);
+}
 
-  // Input 6: Pure - sensor_type (string)
-  bcs_write_u8(&writer, 0x00);
-  bcs_write_u8(&writer, 0x05);
-  bcs_write_uleb128(&writer, 4);  // "soil" = 4 chars
-  bcs_write_fixed_bytes(&writer, (const uint8_t *)"soil", 4);
+bcs_error_t sui_build_sensor_batch_transaction_with_allocator(
+  const transaction_builder_t *params,
+  const sensor_data_t *readings,
+  size_t num_readings,
+  const bcs_allocator_t *allocator,
+  char **output_hex,
+  size_t *output_length) {
+  if (!output_hex || !output_length) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
 
-  // Input 7: Pure - location (string) - LAST!
-  bcs_write_u8(&writer, 0x00);
-  bcs_write_u8(&writer, 0x01);  // CallArg::Object
-  bcs_write_uleb128(&writer, 0);  // Empty string
-
-  // Input 0: Clock Object - Shared object (FIRST!)
-  uint8_t clock_object_id[32] = { 0 };
-  clock_object_id[31] = 0x06;   // Clock ID 0x6
-  bcs_write_u8(&writer, 0x01);  // CallArg::Object
-  bcs_write_u8(&writer, 0x01);  // ObjectArg::SharedObject (variant 1)
-  bcs_write_fixed_bytes(&writer, clock_object_id, 32);
-  bcs_write_u64(&writer, 1);    // Initial shared version = 1
-  bcs_write_u8(&writer, 0x00);  // mutable = false
+  bcs_writer_t counter;
+  bcs_writer_init_counting(&counter);
+  BCS_TRY(sui_build_sensor_batch_transaction_into(params, readings, num_readings, &counter));
+  size_t tx_length = counter.position;
 
-  // ========== Commands (1 MoveCall) ==========
-  bcs_write_uleb128(&writer, 1);
+  char *hex = (char *)bcs_allocator_alloc(allocator, tx_length * 2 + 1);
+  if (!hex) {
+    return BCS_ERROR_OUT_OF_MEMORY;
+  }
 
-  // Command: MoveCall
-  bcs_write_u8(&writer, 0x00);
+  bcs_writer_t writer;
+  bcs_writer_init_fixed(&writer, (uint8_t *)hex, tx_length * 2 + 1);
+  bcs_error_t err = write_sensor_batch_transaction(params, readings, num_readings, &writer);
+  if (err == BCS_OK && writer.position != tx_length) {
+    err = BCS_ERROR_INVALID_INPUT;  // Measured and written layouts diverged
+  }
+  if (err != BCS_OK) {
+    bcs_allocator_free(allocator, hex);
+    return err;
+  }
 
-  // Package ID
-  bcs_write_fixed_bytes(&writer, params->package_id, 32);
+  expand_to_hex_in_place(hex, tx_length);
+  *output_hex = hex;
+  *output_length = tx_length * 2;
+  return BCS_OK;
+}
 
-  // Module name
-  bcs_write_string(&writer, params->module_name);
+bcs_error_t sui_sensor_batch_fit(
+  const transaction_builder_t *params,
+  const sensor_data_t *readings,
+  size_t num_readings,
+  size_t max_bytes,
+  size_t *fit) {
+  if (!params || !readings || !fit) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
 
-  // Function name
-  bcs_write_string(&writer, params->function_name);
+  // Size grows with every reading added, so binary search the largest N
+  size_t lo = 0;
+  size_t hi = num_readings < SUI_MAX_BATCH_READINGS ? num_readings : SUI_MAX_BATCH_READINGS;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo + 1) / 2;
 
-  // Type arguments (empty)
-  bcs_write_uleb128(&writer, 0);
+    bcs_writer_t counter;
+    bcs_writer_init_counting(&counter);
+    BCS_TRY(write_sensor_batch_transaction(params, readings, mid, &counter));
 
-  // Arguments (8 inputs: indices 0-7)
-  bcs_write_uleb128(&writer, 8);
-  // Simple sequential indices
-  for (int i = 0; i < 8; i++) {
-    bcs_write_u8(&writer, 0x01);  // Argument::Input
-    bcs_write_u16(&writer, i);    // Input index
+    if (counter.position <= max_bytes) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
   }
 
-  // ========== Sender ==========
-  bcs_write_fixed_bytes(&writer, params->sender, 32);
-
-  // ========== Gas Data ==========
-  bcs_write_uleb128(&writer, 1);  // 1 gas coin
-  bcs_write_fixed_bytes(&writer, params->gas_object.object_id, 32);
-  bcs_write_u64(&writer, params->gas_object.version);
+  *fit = lo;
+  return BCS_OK;
+}
 
-  bcs_write_u8(&writer, 0x20);  // Argument::Input
-  bcs_write_fixed_bytes(&writer, params->gas_object.digest, 32);
+bcs_error_t sui_compile_sensor_template(
+  const transaction_builder_t *params,
+  uint8_t *buffer,
+  size_t capacity,
+  sui_sensor_template_t *tpl) {
+  return sui_compile_sensor_template_with_allocator(params, buffer, capacity, NULL, tpl);
+}
 
-  bcs_write_fixed_bytes(&writer, params->sender, 32);  // Gas owner
-  bcs_write_u64(&writer, params->gas_price);
-  bcs_write_u64(&writer, params->gas_budget);
+bcs_error_t sui_compile_sensor_template_with_allocator(
+  const transaction_builder_t *params,
+  uint8_t *buffer,
+  size_t capacity,
+  const bcs_allocator_t *allocator,
+  sui_sensor_template_t *tpl) {
+  if (!params || !tpl) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
 
-  // ========== Expiration ==========
-  bcs_write_u8(&writer, 0x00);  // None expiration
+  bcs_error_t err;
+  if (buffer) {
+    err = bcs_writer_init_fixed(&tpl->writer, buffer, capacity);
+  } else {
+    // Size the heap buffer exactly so it never reallocates
+    size_t tx_length;
+    BCS_TRY(sui_measure_sensor_transaction(params, &tx_length));
+    err = bcs_writer_init_with_allocator(&tpl->writer, tx_length, tx_length, allocator);
+  }
+  if (err != BCS_OK) return err;
 
-  // ========== Get result ==========
-  size_t result_length;
-  const uint8_t *result_bytes = bcs_writer_get_bytes(&writer, &result_length);
+  err = write_sensor_transaction(params, &tpl->writer, tpl);
+  if (err != BCS_OK) {
+    bcs_writer_free(&tpl->writer);
+  }
+  return err;
+}
 
-  *output_hex = (char *)malloc(result_length * 2 + 1);
-  if (!*output_hex) {
-    err = BCS_ERROR_OUT_OF_MEMORY;
-    goto cleanup;
+void sui_sensor_template_free(sui_sensor_template_t *tpl) {
+  if (tpl) {
+    bcs_writer_free(&tpl->writer);
   }
+}
 
-  bcs_bytes_to_hex(result_bytes, result_length, *output_hex);
-  *output_length = result_length * 2;
+void sui_sensor_template_set_sensor_data(sui_sensor_template_t *tpl, const sensor_data_t *data) {
+  uint8_t *bytes = tpl->writer.buffer;
+  bcs_store_u64(bytes + tpl->reading_offsets[0], data->value1);
+  bcs_store_u64(bytes + tpl->reading_offsets[1], data->value2);
+  bcs_store_u64(bytes + tpl->reading_offsets[2], data->value3);
+  bcs_store_u64(bytes + tpl->reading_offsets[3], data->value4);
+}
 
-cleanup:
-  bcs_writer_free(&writer);
-  return err;
+void sui_sensor_template_set_gas_object(sui_sensor_template_t *tpl, const gas_object_t *gas) {
+  // Whole ObjectRef, rewriting the unchanged digest length along the way
+  bcs::store(tpl->writer.buffer + tpl->gas_object_id_offset, *gas);
+}
+
+void sui_sensor_template_set_gas(sui_sensor_template_t *tpl, uint64_t gas_price, uint64_t gas_budget) {
+  uint8_t *bytes = tpl->writer.buffer;
+  bcs_store_u64(bytes + tpl->gas_price_offset, gas_price);
+  bcs_store_u64(bytes + tpl->gas_budget_offset, gas_budget);
+}
+
+const uint8_t *sui_sensor_template_bytes(const sui_sensor_template_t *tpl, size_t *length) {
+  return bcs_writer_get_bytes(&tpl->writer, length);
 }
 
 // Alternative simpler transaction builder matching the server's structure more closely
@@ -194,304 +668,677 @@ bcs_error_t sui_build_simple_sensor_transaction(
   // Write inputs... (this would need to match exactly what the server builds)
   // For now, we'll return a simplified version
 
-  size_t result_length;
-  const uint8_t *result_bytes = bcs_writer_get_bytes(&writer, &result_length);
-
   // Convert to hex
-  *output_hex = (char *)malloc(result_length * 2 + 1);
-  if (!*output_hex) {
-    err = BCS_ERROR_OUT_OF_MEMORY;
-    goto cleanup;
-  }
-
-  bcs_bytes_to_hex(result_bytes, result_length, *output_hex);
-  *output_length = result_length * 2;
+  err = writer_to_hex(&writer, NULL, output_hex, output_length);
 
-cleanup:
   bcs_writer_free(&writer);
   return err;
 }
 
-bcs_error_t sui_modify_transaction_with_pure_values(
-  const char *hex_tx,
-  const uint8_t **pure_values,
-  const size_t *pure_lengths,
-  size_t num_pures,
-  char **output_hex,
-  size_t *output_length) {
-  if (!hex_tx || !pure_values || !pure_lengths || !output_hex || !output_length) {
+// Parse one CallArg, recording where its value lives
+static bcs_error_t index_call_arg(bcs_reader_t *reader, sui_tx_input_t *input) {
+  input->offset = reader->position;
+  BCS_TRY(bcs_read_u8(reader, &input->kind));
+  input->object_kind = 0;
+  input->version = 0;
+
+  if (input->kind == 0) {  // Pure(Vec<u8>)
+    bcs_view_t value;
+    BCS_TRY(bcs_read_bytes_view(reader, &value));
+    input->value_offset = (size_t)(value.data - reader->buffer);
+    input->value_length = value.length;
+    return BCS_OK;
+  }
+
+  if (input->kind != 1) {
     return BCS_ERROR_INVALID_INPUT;
   }
 
-  // Convert hex to bytes
-  size_t max_length = strlen(hex_tx) / 2;
-  uint8_t *tx_bytes = (uint8_t *)malloc(max_length);
-  if (!tx_bytes) {
-    return BCS_ERROR_OUT_OF_MEMORY;
+  // Object: ObjectID, then version + digest (ImmOrOwned/Receiving)
+  // or initial_shared_version + mutable (Shared). The digest of an
+  // ObjectRef is a Vec<u8>, so it carries its ULEB128 length (0x20).
+  BCS_TRY(bcs_read_u8(reader, &input->object_kind));
+  if (input->object_kind > 2) {
+    return BCS_ERROR_INVALID_INPUT;
   }
+  input->value_offset = reader->position;
+  input->value_length = 32;
+  BCS_TRY(bcs_skip_fixed(reader, 32));
+  BCS_TRY(bcs_read_u64(reader, &input->version));
+  if (input->object_kind == 1) {
+    return bcs_skip_fixed(reader, 1);
+  }
+  return bcs_skip_bytes(reader);
+}
 
-  size_t tx_length;
-  bcs_error_t err = bcs_hex_to_bytes(hex_tx, tx_bytes, max_length, &tx_length);
-  if (err != BCS_OK) {
-    free(tx_bytes);
-    return err;
+bcs_error_t sui_index_pure_inputs(
+  const uint8_t *tx_bytes,
+  size_t tx_length,
+  sui_pure_index_t *index) {
+  if (!tx_bytes || !index) {
+    return BCS_ERROR_INVALID_INPUT;
   }
 
-  // Parse transaction
   bcs_reader_t reader;
   bcs_reader_init(&reader, tx_bytes, tx_length);
 
-  // Read TransactionData version byte
-  uint8_t version;
-  err = bcs_read_u8(&reader, &version);
-  if (err != BCS_OK) {
-    free(tx_bytes);
-    return err;
+  // Skip TransactionData version byte and TransactionKind type
+  uint64_t num_inputs;
+  BCS_TRY(bcs_skip_fixed(&reader, 2));
+  BCS_TRY(bcs_read_uleb128(&reader, &num_inputs));
+
+  index->num_pures = 0;
+
+  for (uint64_t i = 0; i < num_inputs; i++) {
+    sui_tx_input_t input;
+    BCS_TRY(index_call_arg(&reader, &input));
+    if (input.kind != 0) {
+      continue;
+    }
+    if (index->num_pures >= SUI_MAX_PURE_INPUTS) {
+      return BCS_ERROR_OVERFLOW;
+    }
+
+    sui_pure_slot_t *slot = &index->slots[index->num_pures++];
+    slot->offset = input.value_offset;
+    slot->length = input.value_length;
   }
 
-  // Read TransactionKind type
-  uint8_t kind;
-  err = bcs_read_u8(&reader, &kind);
-  if (err != BCS_OK) {
-    free(tx_bytes);
-    return err;
+  return BCS_OK;
+}
+
+// Argument: GasCoin | Input(u16) | Result(u16) | NestedResult(u16, u16)
+static bcs_error_t skip_argument(bcs_reader_t *reader) {
+  static const uint8_t argument_sizes[4] = {0, 2, 2, 4};
+
+  uint8_t tag;
+  BCS_TRY(bcs_read_u8(reader, &tag));
+  if (tag > 3) {
+    return BCS_ERROR_INVALID_INPUT;
   }
+  return bcs_skip_fixed(reader, argument_sizes[tag]);
+}
 
-  uint64_t num_inputs;
-  err = bcs_read_uleb128(&reader, &num_inputs);
-  if (err != BCS_OK) {
-    free(tx_bytes);
-    return err;
+static bcs_error_t skip_arguments(bcs_reader_t *reader, size_t *count) {
+  size_t n;
+  BCS_TRY(bcs_read_vec_length(reader, &n));
+  for (size_t i = 0; i < n; i++) {
+    BCS_TRY(skip_argument(reader));
   }
+  if (count) {
+    *count = n;
+  }
+  return BCS_OK;
+}
 
-  // Rebuild transaction
-  bcs_writer_t writer;
-  bcs_writer_init(&writer, 512, 0);
+// Nested vector/struct type tags deeper than this are rejected
+#define SUI_MAX_TYPE_TAG_DEPTH 8
 
-  // Write TransactionData version byte
-  bcs_write_u8(&writer, version);
+static bcs_error_t skip_type_tag(bcs_reader_t *reader, int depth) {
+  if (depth > SUI_MAX_TYPE_TAG_DEPTH) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
 
-  // Write TransactionKind type
-  bcs_write_u8(&writer, kind);
-  bcs_write_uleb128(&writer, num_inputs);
+  uint8_t tag;
+  BCS_TRY(bcs_read_u8(reader, &tag));
 
-  // Process inputs
-  size_t pure_idx = 0;
-  bool success = true;
+  if (tag == 6) {  // Vector(TypeTag)
+    return skip_type_tag(reader, depth + 1);
+  }
 
-  for (uint64_t i = 0; i < num_inputs && success; i++) {
-    uint8_t input_type;
-    err = bcs_read_u8(&reader, &input_type);
-    if (err != BCS_OK) {
-      success = false;
-      break;
+  if (tag == 7) {  // Struct { address, module, name, type_params }
+    size_t num_params;
+    BCS_TRY(bcs_skip_fixed(reader, 32));
+    BCS_TRY(bcs_skip_bytes(reader));
+    BCS_TRY(bcs_skip_bytes(reader));
+    BCS_TRY(bcs_read_vec_length(reader, &num_params));
+    for (size_t i = 0; i < num_params; i++) {
+      BCS_TRY(skip_type_tag(reader, depth + 1));
     }
-    bcs_write_u8(&writer, input_type);
-
-    if (input_type == 0) {  // Pure - replace with new value
-      // Read old value (discard)
-      uint64_t old_len;
-      err = bcs_read_uleb128(&reader, &old_len);
-      if (err != BCS_OK) {
-        success = false;
-        break;
-      }
+    return BCS_OK;
+  }
 
-      uint8_t *old_data = (uint8_t *)malloc((size_t)old_len);
-      if (!old_data) {
-        err = BCS_ERROR_OUT_OF_MEMORY;
-        success = false;
-        break;
-      }
-      err = bcs_read_bytes(&reader, old_data, (size_t)old_len);
-      free(old_data);
-      if (err != BCS_OK) {
-        success = false;
-        break;
-      }
+  // Primitive types carry no payload
+  return tag <= 10 ? BCS_OK : BCS_ERROR_INVALID_INPUT;
+}
 
-      // Write new value
-      if (pure_idx < num_pures) {
-        bcs_write_uleb128(&writer, pure_lengths[pure_idx]);
-        bcs_write_fixed_bytes(&writer, pure_values[pure_idx], pure_lengths[pure_idx]);
-      } else {
-        // Not enough pure values provided - keep old value
-        bcs_write_uleb128(&writer, old_len);
-        bcs_write_fixed_bytes(&writer, old_data, (size_t)old_len);
-      }
-      pure_idx++;
-    } else if (input_type == 1) {  // Object - copy unchanged
-      uint8_t variant;
-      err = bcs_read_u8(&reader, &variant);
-      if (err != BCS_OK) {
-        success = false;
-        break;
-      }
-      bcs_write_u8(&writer, variant);
+// Vec<Vec<u8>> modules followed by Vec<ObjectID> dependencies (Publish/Upgrade)
+static bcs_error_t skip_package_contents(bcs_reader_t *reader) {
+  size_t n;
+  BCS_TRY(bcs_read_vec_length(reader, &n));
+  for (size_t i = 0; i < n; i++) {
+    BCS_TRY(bcs_skip_bytes(reader));
+  }
+  BCS_TRY(bcs_read_vec_length(reader, &n));
+  for (size_t i = 0; i < n; i++) {
+    BCS_TRY(bcs_skip_fixed(reader, 32));
+  }
+  return BCS_OK;
+}
 
-      uint8_t obj_id[32];
-      err = bcs_read_bytes(&reader, obj_id, 32);
-      if (err != BCS_OK) {
-        success = false;
-        break;
+static bcs_error_t index_command(bcs_reader_t *reader, sui_tx_command_t *command) {
+  memset(command, 0, sizeof(*command));
+  command->offset = reader->position;
+  BCS_TRY(bcs_read_u8(reader, &command->kind));
+
+  switch (command->kind) {
+    case 0: {  // MoveCall
+      size_t num_type_arguments;
+      command->package_offset = reader->position;
+      BCS_TRY(bcs_skip_fixed(reader, 32));
+      BCS_TRY(bcs_read_bytes_view(reader, &command->module));
+      BCS_TRY(bcs_read_bytes_view(reader, &command->function));
+      BCS_TRY(bcs_read_vec_length(reader, &num_type_arguments));
+      for (size_t i = 0; i < num_type_arguments; i++) {
+        BCS_TRY(skip_type_tag(reader, 0));
       }
-      bcs_write_fixed_bytes(&writer, obj_id, 32);
-
-      if (variant == 0) {  // ImmOrOwnedObject
-        uint64_t obj_version;
-        err = bcs_read_u64(&reader, &obj_version);
-        if (err != BCS_OK) {
-          success = false;
-          break;
-        }
-        bcs_write_u64(&writer, obj_version);
-
-        uint8_t digest[32];
-        err = bcs_read_bytes(&reader, digest, 32);
-        if (err != BCS_OK) {
-          success = false;
-          break;
-        }
-        bcs_write_fixed_bytes(&writer, digest, 32);
-      } else if (variant == 1) {  // SharedObject
-        uint64_t initial_shared_version;
-        err = bcs_read_u64(&reader, &initial_shared_version);
-        if (err != BCS_OK) {
-          success = false;
-          break;
-        }
-        bcs_write_u64(&writer, initial_shared_version);
-
-        uint8_t is_mutable;
-        err = bcs_read_u8(&reader, &is_mutable);
-        if (err != BCS_OK) {
-          success = false;
-          break;
-        }
-        bcs_write_u8(&writer, is_mutable);
-      } else if (variant == 2) {  // Receiving
-        uint64_t obj_version;
-        err = bcs_read_u64(&reader, &obj_version);
-        if (err != BCS_OK) {
-          success = false;
-          break;
-        }
-        bcs_write_u64(&writer, obj_version);
-
-        uint8_t digest[32];
-        err = bcs_read_bytes(&reader, digest, 32);
-        if (err != BCS_OK) {
-          success = false;
-          break;
-        }
-        bcs_write_fixed_bytes(&writer, digest, 32);
+      command->num_type_arguments = num_type_arguments;
+      BCS_TRY(skip_arguments(reader, &command->num_arguments));
+      break;
+    }
+    case 1:  // TransferObjects(Vec<Argument>, Argument)
+      BCS_TRY(skip_arguments(reader, NULL));
+      BCS_TRY(skip_argument(reader));
+      break;
+    case 2:  // SplitCoins(Argument, Vec<Argument>)
+    case 3:  // MergeCoins(Argument, Vec<Argument>)
+      BCS_TRY(skip_argument(reader));
+      BCS_TRY(skip_arguments(reader, NULL));
+      break;
+    case 4:  // Publish
+      BCS_TRY(skip_package_contents(reader));
+      break;
+    case 5: {  // MakeMoveVec(Option<TypeTag>, Vec<Argument>)
+      bool has_type;
+      BCS_TRY(bcs_read_option_tag(reader, &has_type));
+      if (has_type) {
+        BCS_TRY(skip_type_tag(reader, 0));
       }
+      BCS_TRY(skip_arguments(reader, NULL));
+      break;
     }
+    case 6:  // Upgrade(modules, dependencies, package, ticket)
+      BCS_TRY(skip_package_contents(reader));
+      BCS_TRY(bcs_skip_fixed(reader, 32));
+      BCS_TRY(skip_argument(reader));
+      break;
+    default:
+      return BCS_ERROR_INVALID_INPUT;
   }
 
-  if (success) {
-    // Copy the rest of the transaction (commands, sender, gas payment, gas budget/price)
-    size_t remaining = bcs_reader_remaining(&reader);
-    if (remaining > 0) {
-      uint8_t *rest = (uint8_t *)malloc(remaining);
-      if (!rest) {
-        err = BCS_ERROR_OUT_OF_MEMORY;
-        success = false;
-      } else {
-        err = bcs_read_bytes(&reader, rest, remaining);
-        if (err != BCS_OK) {
-          free(rest);
-          success = false;
-        } else {
-          bcs_write_fixed_bytes(&writer, rest, remaining);
-          free(rest);
-        }
+  command->length = reader->position - command->offset;
+  return BCS_OK;
+}
+
+bcs_error_t sui_index_transaction(
+  const uint8_t *tx_bytes,
+  size_t tx_length,
+  sui_tx_index_t *index) {
+  if (!tx_bytes || !index) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  bcs_reader_t reader;
+  bcs_reader_init(&reader, tx_bytes, tx_length);
+
+  // TransactionData::V1 wrapping TransactionKind::ProgrammableTransaction
+  uint8_t version;
+  uint8_t kind;
+  BCS_TRY(bcs_read_u8(&reader, &version));
+  BCS_TRY(bcs_read_u8(&reader, &kind));
+  if (version != 0 || kind != 0) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  size_t count;
+  BCS_TRY(bcs_read_vec_length(&reader, &count));
+  if (count > SUI_MAX_TX_INPUTS) {
+    return BCS_ERROR_OVERFLOW;
+  }
+  for (size_t i = 0; i < count; i++) {
+    BCS_TRY(index_call_arg(&reader, &index->inputs[i]));
+  }
+  index->num_inputs = count;
+
+  BCS_TRY(bcs_read_vec_length(&reader, &count));
+  if (count > SUI_MAX_TX_COMMANDS) {
+    return BCS_ERROR_OVERFLOW;
+  }
+  for (size_t i = 0; i < count; i++) {
+    BCS_TRY(index_command(&reader, &index->commands[i]));
+  }
+  index->num_commands = count;
+
+  index->sender_offset = reader.position;
+  BCS_TRY(bcs_skip_fixed(&reader, 32));
+
+  // GasData { payment: Vec<ObjectRef>, owner, price, budget }
+  BCS_TRY(bcs_read_vec_length(&reader, &index->num_gas_payments));
+  index->gas_payment_offset = reader.position;
+  for (size_t i = 0; i < index->num_gas_payments; i++) {
+    BCS_TRY(bcs_skip_fixed(&reader, 32));
+    BCS_TRY(bcs_skip_u64(&reader));
+    BCS_TRY(bcs_skip_bytes(&reader));
+  }
+  index->gas_owner_offset = reader.position;
+  BCS_TRY(bcs_skip_fixed(&reader, 32));
+  index->gas_price_offset = reader.position;
+  BCS_TRY(bcs_read_u64(&reader, &index->gas_price));
+  index->gas_budget_offset = reader.position;
+  BCS_TRY(bcs_read_u64(&reader, &index->gas_budget));
+
+  // TransactionExpiration: None | Epoch(u64)
+  index->expiration_offset = reader.position;
+  index->expiration_epoch = 0;
+  BCS_TRY(bcs_read_u8(&reader, &index->expiration_kind));
+  if (index->expiration_kind == 1) {
+    BCS_TRY(bcs_read_u64(&reader, &index->expiration_epoch));
+  } else if (index->expiration_kind != 0) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  // Trailing bytes would be signed without being understood
+  if (bcs_reader_remaining(&reader) != 0) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  index->length = reader.position;
+  return BCS_OK;
+}
+
+static bool view_equals(const bcs_view_t *view, const char *expected) {
+  size_t length = strlen(expected);
+  return view->length == length && memcmp(view->data, expected, length) == 0;
+}
+
+sui_tx_check_t sui_check_transaction(
+  const uint8_t *tx_bytes,
+  const sui_tx_index_t *index,
+  const sui_tx_policy_t *policy) {
+  if (policy->sender && memcmp(tx_bytes + index->sender_offset, policy->sender, 32) != 0) {
+    return SUI_TX_CHECK_SENDER;
+  }
+  if (policy->gas_owner && memcmp(tx_bytes + index->gas_owner_offset, policy->gas_owner, 32) != 0) {
+    return SUI_TX_CHECK_GAS_OWNER;
+  }
+
+  // Pinning any part of the target means every command must be that MoveCall
+  if (policy->package_id || policy->module_name || policy->function_name) {
+    if (index->num_commands == 0) {
+      return SUI_TX_CHECK_COMMAND;
+    }
+    for (size_t i = 0; i < index->num_commands; i++) {
+      const sui_tx_command_t *command = &index->commands[i];
+      if (command->kind != 0 ||
+          (policy->package_id && memcmp(tx_bytes + command->package_offset, policy->package_id, 32) != 0) ||
+          (policy->module_name && !view_equals(&command->module, policy->module_name)) ||
+          (policy->function_name && !view_equals(&command->function, policy->function_name))) {
+        return SUI_TX_CHECK_COMMAND;
       }
     }
   }
 
-  if (success) {
-    // Get result
-    size_t result_length;
-    const uint8_t *result_bytes = bcs_writer_get_bytes(&writer, &result_length);
+  if (policy->max_gas_budget && index->gas_budget > policy->max_gas_budget) {
+    return SUI_TX_CHECK_GAS_BUDGET;
+  }
+  if (policy->max_gas_price && index->gas_price > policy->max_gas_price) {
+    return SUI_TX_CHECK_GAS_PRICE;
+  }
+
+  return SUI_TX_CHECK_OK;
+}
+
+const char *sui_tx_check_name(sui_tx_check_t check) {
+  switch (check) {
+    case SUI_TX_CHECK_OK: return "ok";
+    case SUI_TX_CHECK_SENDER: return "unexpected sender";
+    case SUI_TX_CHECK_GAS_OWNER: return "unexpected gas owner";
+    case SUI_TX_CHECK_COMMAND: return "unexpected command";
+    case SUI_TX_CHECK_GAS_BUDGET: return "gas budget too high";
+    case SUI_TX_CHECK_GAS_PRICE: return "gas price too high";
+  }
+  return "unknown";
+}
+
+// Splice a new ULEB128 length prefix + value over an indexed Pure slot.
+// The caller has checked the slot and made room for the growth, so
+// neither splice can fail and the slot is never left half rewritten.
+static void resize_pure_slot(
+  bcs_writer_t *tx,
+  sui_pure_index_t *index,
+  size_t slot_idx,
+  const uint8_t *value,
+  size_t value_length) {
+  sui_pure_slot_t *slot = &index->slots[slot_idx];
+
+  uint8_t new_prefix[BCS_ULEB128_MAX_SIZE];
+  bcs_writer_t prefix_writer;
+  bcs_writer_init_fixed(&prefix_writer, new_prefix, sizeof(new_prefix));
+  bcs_write_uleb128(&prefix_writer, value_length);
+  size_t new_prefix_length = prefix_writer.position;
+  size_t old_prefix_length = bcs_uleb128_size(slot->length);
+
+  // Value first so the prefix splice does not move the value range
+  bcs_writer_splice(tx, slot->offset, slot->length, value, value_length);
+  bcs_writer_splice(tx, slot->offset - old_prefix_length, old_prefix_length,
+                    new_prefix, new_prefix_length);
+
+  // Shift this slot and every later one by the size difference
+  size_t new_offset = slot->offset - old_prefix_length + new_prefix_length;
+  size_t old_end = slot->offset + slot->length;
+  size_t new_end = new_offset + value_length;
+  slot->offset = new_offset;
+  slot->length = value_length;
+  for (size_t i = slot_idx + 1; i < index->num_pures; i++) {
+    index->slots[i].offset = index->slots[i].offset - old_end + new_end;
+  }
+}
+
+bcs_error_t sui_patch_pure_values(
+  bcs_writer_t *tx,
+  sui_pure_index_t *index,
+  const uint8_t **pure_values,
+  const size_t *pure_lengths,
+  size_t num_pures) {
+  if (!tx || !index || !pure_values || !pure_lengths || tx->mode == BCS_WRITER_COUNTING ||
+      tx->mode == BCS_WRITER_STREAM) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+  if (tx->error != BCS_OK) {
+    return tx->error;
+  }
+
+  // Extra values are ignored, missing ones keep the template value
+  size_t count = num_pures < index->num_pures ? num_pures : index->num_pures;
 
-    // Convert to hex
-    *output_hex = (char *)malloc(result_length * 2 + 1);
-    if (!*output_hex) {
-      err = BCS_ERROR_OUT_OF_MEMORY;
-      success = false;
+  // Check every slot and make room for the growth before changing a byte,
+  // so a failure leaves the transaction untouched
+  size_t growth = 0;
+  for (size_t i = 0; i < count; i++) {
+    const sui_pure_slot_t *slot = &index->slots[i];
+    if (slot->offset + slot->length > tx->position) {
+      return BCS_ERROR_INVALID_INPUT;
+    }
+    if (pure_lengths[i] == slot->length) {
+      // Bytes an attached hash has absorbed can no longer change
+      if (tx->hash && slot->offset < tx->hashed) {
+        return BCS_ERROR_INVALID_INPUT;
+      }
+      continue;
+    }
+
+    size_t old_prefix_length = bcs_uleb128_size(slot->length);
+    if (slot->offset < old_prefix_length ||
+        (tx->hash && slot->offset - old_prefix_length < tx->hashed)) {
+      return BCS_ERROR_INVALID_INPUT;
+    }
+    size_t old_size = old_prefix_length + slot->length;
+    size_t new_size = bcs_uleb128_size(pure_lengths[i]) + pure_lengths[i];
+    if (new_size > old_size) {
+      growth += new_size - old_size;
+    }
+  }
+  if (growth > 0) {
+    BCS_TRY(bcs_writer_ensure(tx, growth));
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    const sui_pure_slot_t *slot = &index->slots[i];
+    if (pure_lengths[i] == slot->length) {
+      // Fast path: overwrite in place
+      memcpy(tx->buffer + slot->offset, pure_values[i], slot->length);
     } else {
-      bcs_bytes_to_hex(result_bytes, result_length, *output_hex);
-      *output_length = result_length * 2;
+      resize_pure_slot(tx, index, i, pure_values[i], pure_lengths[i]);
     }
   }
 
-  // Cleanup
-  bcs_writer_free(&writer);
-  free(tx_bytes);
+  return BCS_OK;
+}
 
-  if (!success) {
-    return err;
+// Decode hex straight into writer in small chunks (no scratch allocation)
+static bcs_error_t append_hex(bcs_writer_t *writer, const char *hex) {
+  // Skip 0x prefix if present
+  if (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+    hex += 2;
+  }
+
+  size_t hex_len = strlen(hex);
+  if (hex_len % 2 != 0) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  char chunk_hex[129];
+  uint8_t chunk[64];
+
+  while (hex_len > 0) {
+    size_t n = hex_len < 128 ? hex_len : 128;
+    memcpy(chunk_hex, hex, n);
+    chunk_hex[n] = '\0';
+
+    // bcs_hex_to_bytes would skip a "0x" here, but mid-string it is invalid
+    if (chunk_hex[1] == 'x' || chunk_hex[1] == 'X') {
+      return BCS_ERROR_INVALID_INPUT;
+    }
+
+    size_t decoded;
+    BCS_TRY(bcs_hex_to_bytes(chunk_hex, chunk, sizeof(chunk), &decoded));
+    BCS_TRY(bcs_write_fixed_bytes(writer, chunk, decoded));
+
+    hex += n;
+    hex_len -= n;
   }
 
   return BCS_OK;
 }
 
-bcs_error_t sui_modify_transaction_with_sensor_data(
+// Index the transaction appended at start and patch its Pure values in place
+static bcs_error_t patch_appended_transaction(
+  bcs_writer_t *writer,
+  size_t start,
+  const uint8_t **pure_values,
+  const size_t *pure_lengths,
+  size_t num_pures) {
+  sui_pure_index_t index;
+  BCS_TRY(sui_index_pure_inputs(writer->buffer + start, writer->position - start, &index));
+
+  // Index offsets are relative to the transaction; make them writer-relative
+  for (size_t i = 0; i < index.num_pures; i++) {
+    index.slots[i].offset += start;
+  }
+
+  return sui_patch_pure_values(writer, &index, pure_values, pure_lengths, num_pures);
+}
+
+bcs_error_t sui_modify_transaction_with_pure_values_bytes(
+  const uint8_t *tx_bytes,
+  size_t tx_length,
+  const uint8_t **pure_values,
+  const size_t *pure_lengths,
+  size_t num_pures,
+  bcs_writer_t *writer) {
+  if (!tx_bytes || !pure_values || !pure_lengths || !writer ||
+      writer->mode == BCS_WRITER_COUNTING || writer->mode == BCS_WRITER_STREAM) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  size_t start = writer->position;
+  BCS_TRY(bcs_write_fixed_bytes(writer, tx_bytes, tx_length));
+
+  return patch_appended_transaction(writer, start, pure_values, pure_lengths, num_pures);
+}
+
+bcs_error_t sui_modify_transaction_with_pure_values_into(
   const char *hex_tx,
-  const sensor_data_t *sensor_data,
+  const uint8_t **pure_values,
+  const size_t *pure_lengths,
+  size_t num_pures,
+  bcs_writer_t *writer) {
+  if (!hex_tx || !pure_values || !pure_lengths || !writer ||
+      writer->mode == BCS_WRITER_COUNTING || writer->mode == BCS_WRITER_STREAM) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  // Decode straight into the output so the hex is parsed only once
+  size_t start = writer->position;
+  BCS_TRY(append_hex(writer, hex_tx));
+
+  return patch_appended_transaction(writer, start, pure_values, pure_lengths, num_pures);
+}
+
+bcs_error_t sui_modify_transaction_with_pure_values(
+  const char *hex_tx,
+  const uint8_t **pure_values,
+  const size_t *pure_lengths,
+  size_t num_pures,
   char **output_hex,
   size_t *output_length) {
-  if (!sensor_data) {
+  return sui_modify_transaction_with_pure_values_with_allocator(
+    hex_tx, pure_values, pure_lengths, num_pures, NULL, output_hex, output_length);
+}
+
+bcs_error_t sui_modify_transaction_with_pure_values_with_allocator(
+  const char *hex_tx,
+  const uint8_t **pure_values,
+  const size_t *pure_lengths,
+  size_t num_pures,
+  const bcs_allocator_t *allocator,
+  char **output_hex,
+  size_t *output_length) {
+  if (!hex_tx || !pure_values || !pure_lengths || !output_hex || !output_length) {
     return BCS_ERROR_INVALID_INPUT;
   }
 
-  // Serialize sensor values to bytes (as u64 for server compatibility)
-  uint8_t temperature_bytes[8];
-  uint64_t temp_u64 = sensor_data->value1;
-  for (int i = 0; i < 8; i++) {
-    temperature_bytes[i] = (temp_u64 >> (i * 8)) & 0xFF;
-  }
+  // Scratch and result come from the same allocator
+  bcs_writer_t writer;
+  bcs_error_t err = bcs_writer_init_with_allocator(&writer, 512, 0, allocator);
+  if (err != BCS_OK) return err;
 
-  uint8_t humidity_bytes[8];
-  uint64_t hum_u64 = sensor_data->value2;
-  for (int i = 0; i < 8; i++) {
-    humidity_bytes[i] = (hum_u64 >> (i * 8)) & 0xFF;
+  err = sui_modify_transaction_with_pure_values_into(
+    hex_tx, pure_values, pure_lengths, num_pures, &writer);
+  if (err == BCS_OK) {
+    err = writer_to_hex(&writer, allocator, output_hex, output_length);
   }
 
-  uint8_t ec_bytes[8];
-  uint64_t ec_u64 = sensor_data->value4;
-  for (int i = 0; i < 8; i++) {
-    ec_bytes[i] = (ec_u64 >> (i * 8)) & 0xFF;
-  }
+  bcs_writer_free(&writer);
+  return err;
+}
 
-  uint8_t ph_bytes[8];
-  uint64_t ph_u64 = sensor_data->value3;
-  for (int i = 0; i < 8; i++) {
-    ph_bytes[i] = (ph_u64 >> (i * 8)) & 0xFF;
+// Serialize sensor values as the five u64 Pure values the server template expects
+static void sensor_data_pure_values(
+  const sensor_data_t *sensor_data,
+  uint8_t storage[5][8],
+  const uint8_t *pure_values[5],
+  size_t pure_lengths[5]) {
+  // Input order of the server template (value3 and value4 are swapped there)
+  const uint64_t values[5] = {
+    sensor_data->value1,
+    sensor_data->value2,
+    sensor_data->value4,
+    sensor_data->value3,
+    sensor_data->timestamp
+  };
+
+  for (int i = 0; i < 5; i++) {
+    bcs_store_u64(storage[i], values[i]);
+    pure_values[i] = storage[i];
+    pure_lengths[i] = 8;
   }
+}
 
-  uint8_t timestamp_bytes[8];
-  for (int i = 0; i < 8; i++) {
-    timestamp_bytes[i] = (sensor_data->timestamp >> (i * 8)) & 0xFF;
+bcs_error_t sui_modify_transaction_with_sensor_data_bytes(
+  const uint8_t *tx_bytes,
+  size_t tx_length,
+  const sensor_data_t *sensor_data,
+  bcs_writer_t *writer) {
+  if (!sensor_data) {
+    return BCS_ERROR_INVALID_INPUT;
   }
 
-  // Create arrays for the low-level function
-  const uint8_t *pure_values[] = {
-    temperature_bytes,
-    humidity_bytes,
-    ec_bytes,
-    ph_bytes,
-    timestamp_bytes
-  };
+  uint8_t storage[5][8];
+  const uint8_t *pure_values[5];
+  size_t pure_lengths[5];
+  sensor_data_pure_values(sensor_data, storage, pure_values, pure_lengths);
+
+  return sui_modify_transaction_with_pure_values_bytes(
+    tx_bytes, tx_length, pure_values, pure_lengths, 5, writer);
+}
 
-  const size_t pure_lengths[] = { 8, 8, 8, 8, 8 };
+bcs_error_t sui_modify_transaction_with_sensor_data(
+  const char *hex_tx,
+  const sensor_data_t *sensor_data,
+  char **output_hex,
+  size_t *output_length) {
+  return sui_modify_transaction_with_sensor_data_with_allocator(hex_tx, sensor_data, NULL, output_hex, output_length);
+}
 
-  return sui_modify_transaction_with_pure_values(
+bcs_error_t sui_modify_transaction_with_sensor_data_with_allocator(
+  const char *hex_tx,
+  const sensor_data_t *sensor_data,
+  const bcs_allocator_t *allocator,
+  char **output_hex,
+  size_t *output_length) {
+  if (!sensor_data) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  uint8_t storage[5][8];
+  const uint8_t *pure_values[5];
+  size_t pure_lengths[5];
+  sensor_data_pure_values(sensor_data, storage, pure_values, pure_lengths);
+
+  return sui_modify_transaction_with_pure_values_with_allocator(
     hex_tx,
     pure_values,
     pure_lengths,
     5,
+    allocator,
     output_hex,
     output_length);
+}
+
+// Start a Blake2b-256 with the domain prefix for kind already absorbed
+static bcs_error_t begin_digest(blake2b_state_t *hash, sui_digest_kind_t kind) {
+  static const uint8_t intent_prefix[3] = { 0x00, 0x00, 0x00 };  // TransactionData, V0, Sui
+  static const char transaction_prefix[] = "TransactionData::";
+
+  if (!hash || !blake2b_init(hash, SUI_DIGEST_LENGTH)) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  if (kind == SUI_DIGEST_INTENT) {
+    blake2b_update(hash, intent_prefix, sizeof(intent_prefix));
+  } else if (kind == SUI_DIGEST_TRANSACTION) {
+    blake2b_update(hash, (const uint8_t *)transaction_prefix, sizeof(transaction_prefix) - 1);
+  } else {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+  return BCS_OK;
+}
+
+bcs_error_t sui_digest_begin(
+  bcs_writer_t *writer,
+  blake2b_state_t *hash,
+  sui_digest_kind_t kind) {
+  if (!writer) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  BCS_TRY(begin_digest(hash, kind));
+  return bcs_writer_attach_hash(writer, hash);
+}
+
+bcs_error_t sui_transaction_digest(
+  const uint8_t *tx_bytes,
+  size_t tx_length,
+  sui_digest_kind_t kind,
+  uint8_t *digest) {
+  if (!tx_bytes || !digest) {
+    return BCS_ERROR_INVALID_INPUT;
+  }
+
+  blake2b_state_t hash;
+  BCS_TRY(begin_digest(&hash, kind));
+  blake2b_update(&hash, tx_bytes, tx_length);
+  blake2b_final(&hash, digest);
+  return BCS_OK;
 }
\ No newline at end of file
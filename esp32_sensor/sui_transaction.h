@@ -7,6 +7,7 @@
  #define SUI_TRANSACTION_H
  
  #include "bcs.h"
+ #include "blake2b.h"
  #include <stdint.h>
  #include <stddef.h>
  
@@ -31,6 +32,131 @@
      uint8_t digest[32];       // Object digest
  } gas_object_t;
  
+ /**
+  * Maximum number of Pure inputs tracked by sui_pure_index_t
+  */
+ #define SUI_MAX_PURE_INPUTS 16
+ 
+ /**
+  * Maximum number of readings in one batched transaction
+  */
+ #define SUI_MAX_BATCH_READINGS 64
+ 
+ /**
+  * Location of one Pure input value inside serialized TransactionData
+  */
+ typedef struct {
+     size_t offset;    // Offset of the value bytes (just after the ULEB128 length)
+     size_t length;    // Value length in bytes
+ } sui_pure_slot_t;
+ 
+ /**
+  * Pure input offsets of a transaction template, in input order
+  */
+ typedef struct {
+     sui_pure_slot_t slots[SUI_MAX_PURE_INPUTS];
+     size_t num_pures;
+ } sui_pure_index_t;
+ 
+ /**
+  * Limits of sui_tx_index_t; larger transactions return BCS_ERROR_OVERFLOW
+  * Sized for the largest batch this library builds: up to four distinct
+  * values per reading plus the three strings and Clock, and one MoveCall
+  * per reading. That makes the index about 9 KB on the ESP32, so keep it
+  * in static storage rather than on a task stack.
+  */
+ #define SUI_MAX_TX_INPUTS (SUI_MAX_BATCH_READINGS * 4 + 4)
+ #define SUI_MAX_TX_COMMANDS SUI_MAX_BATCH_READINGS
+ 
+ /**
+  * One CallArg of an indexed transaction
+  */
+ typedef struct {
+     uint8_t kind;             // 0 = Pure, 1 = Object
+     uint8_t object_kind;      // Objects: 0 = ImmOrOwned, 1 = Shared, 2 = Receiving
+     size_t offset;            // Offset of the CallArg tag
+     size_t value_offset;      // Pure: value bytes (after the length); Object: ObjectID
+     size_t value_length;      // Pure: value length; Object: 32
+     uint64_t version;         // Objects: version (initial shared version for Shared)
+ } sui_tx_input_t;
+ 
+ /**
+  * One Command of an indexed transaction
+  * The views point into the indexed bytes and go stale if they move.
+  */
+ typedef struct {
+     uint8_t kind;                // Command variant (0 = MoveCall)
+     size_t offset;               // Offset of the Command tag
+     size_t length;               // Encoded length including the tag
+     size_t package_offset;       // MoveCall: 32-byte package ID
+     bcs_view_t module;           // MoveCall: module name (not NUL-terminated)
+     bcs_view_t function;         // MoveCall: function name (not NUL-terminated)
+     size_t num_type_arguments;   // MoveCall: type argument count
+     size_t num_arguments;        // MoveCall: argument count
+ } sui_tx_command_t;
+ 
+ /**
+  * Layout of a full TransactionData (V1, ProgrammableTransaction)
+  * All offsets are relative to the indexed bytes.
+  */
+ typedef struct {
+     sui_tx_input_t inputs[SUI_MAX_TX_INPUTS];
+     size_t num_inputs;
+     sui_tx_command_t commands[SUI_MAX_TX_COMMANDS];
+     size_t num_commands;
+     size_t sender_offset;        // 32-byte sender address
+     size_t gas_payment_offset;   // First gas ObjectRef (ID, u64 version, length-prefixed digest)
+     size_t num_gas_payments;     // Gas coins in the payment vector
+     size_t gas_owner_offset;     // 32-byte gas owner address
+     size_t gas_price_offset;     // u64
+     size_t gas_budget_offset;    // u64
+     size_t expiration_offset;    // TransactionExpiration tag
+     uint64_t gas_price;
+     uint64_t gas_budget;
+     uint8_t expiration_kind;     // 0 = None, 1 = Epoch
+     uint64_t expiration_epoch;   // Epoch expirations only
+     size_t length;               // Bytes parsed (always the whole transaction)
+ } sui_tx_index_t;
+ 
+ /**
+  * What a transaction must look like before the device signs it
+  * NULL pointers and zero limits are not checked.
+  */
+ typedef struct {
+     const uint8_t *sender;        // Required sender address (32 bytes)
+     const uint8_t *gas_owner;     // Required gas owner address (32 bytes)
+     const uint8_t *package_id;    // Every command must call into this package
+     const char *module_name;      // ... this module
+     const char *function_name;    // ... and this function
+     uint64_t max_gas_budget;      // Highest acceptable gas budget
+     uint64_t max_gas_price;       // Highest acceptable gas price
+ } sui_tx_policy_t;
+ 
+ /**
+  * Result of sui_check_transaction()
+  */
+ typedef enum {
+     SUI_TX_CHECK_OK = 0,
+     SUI_TX_CHECK_SENDER,        // Sender differs from policy
+     SUI_TX_CHECK_GAS_OWNER,     // Gas owner differs from policy
+     SUI_TX_CHECK_COMMAND,       // A command is not the allowed MoveCall (or there are none)
+     SUI_TX_CHECK_GAS_BUDGET,    // Gas budget above the limit
+     SUI_TX_CHECK_GAS_PRICE,     // Gas price above the limit
+ } sui_tx_check_t;
+ 
+ /**
+  * Size of Sui transaction and intent digests (Blake2b-256)
+  */
+ #define SUI_DIGEST_LENGTH 32
+ 
+ /**
+  * What a digest covers
+  */
+ typedef enum {
+     SUI_DIGEST_INTENT = 0,        // Intent (TransactionData, V0, Sui) || tx: the message that is signed
+     SUI_DIGEST_TRANSACTION = 1,   // "TransactionData::" || tx: the transaction digest explorers show
+ } sui_digest_kind_t;
+ 
  /**
   * Transaction builder parameters
   */
@@ -57,6 +183,23 @@
      uint64_t gas_price;           // Gas price (e.g., 1000)
  } transaction_builder_t;
  
+ /**
+  * Precompiled sensor transaction
+  *
+  * Holds the serialized bytes of sui_build_sensor_transaction() plus the
+  * offsets of every field that changes between cycles. Package, module,
+  * function, Clock input, fixed strings and sender are written once.
+  */
+ typedef struct {
+     bcs_writer_t writer;          // Persistent transaction bytes
+     size_t reading_offsets[4];    // sensor_data.value1..value4 (u64 each)
+     size_t gas_object_id_offset;  // Gas coin object ID (32 bytes)
+     size_t gas_version_offset;    // Gas coin version (u64)
+     size_t gas_digest_offset;     // Gas coin digest (32 bytes)
+     size_t gas_price_offset;      // Gas price (u64)
+     size_t gas_budget_offset;     // Gas budget (u64)
+ } sui_sensor_template_t;
+ 
  /**
   * Build a complete Sui transaction from scratch
   *
@@ -64,7 +207,7 @@
   * This builds the entire transaction in C without needing TypeScript template.
   *
   * @param params         Transaction builder parameters (sensor data, IDs, gas, etc.)
-  * @param output_hex     Output: transaction hex (caller must free)
+  * @param output_hex     Output: transaction hex (release with bcs_free())
   * @param output_length  Output: length of transaction
   * @return BCS_OK on success, error code otherwise
   *
@@ -90,7 +233,7 @@
   *
   *   if (err == BCS_OK) {
   *       // Sign and submit
-  *       free(tx_hex);
+  *       bcs_free(tx_hex);
   *   }
   */
  bcs_error_t sui_build_sensor_transaction(
@@ -99,6 +242,260 @@
      size_t *output_length
  );
  
+ /**
+  * sui_build_sensor_transaction() with an explicit allocator
+  *
+  * The hex string comes from allocator (NULL = default at call time);
+  * release it with bcs_allocator_free(allocator, ...) so a later
+  * bcs_set_default_allocator() cannot mismatch the pair.
+  */
+ bcs_error_t sui_build_sensor_transaction_with_allocator(
+     const transaction_builder_t *params,
+     const bcs_allocator_t *allocator,
+     char **output_hex,
+     size_t *output_length
+ );
+ 
+ /**
+  * Build a complete Sui transaction as raw BCS bytes
+  *
+  * Binary counterpart of sui_build_sensor_transaction(): the buffer is
+  * exactly the transaction size, half of the hex string. Encode to hex only
+  * where a text transport needs it.
+  *
+  * @param params         Transaction builder parameters
+  * @param output         Output: transaction bytes (release with bcs_free())
+  * @param output_length  Output: length of transaction in bytes
+  * @return BCS_OK on success, error code otherwise
+  */
+ bcs_error_t sui_build_sensor_transaction_bytes(
+     const transaction_builder_t *params,
+     uint8_t **output,
+     size_t *output_length
+ );
+ 
+ /**
+  * sui_build_sensor_transaction_bytes() with an explicit allocator
+  * (release output with bcs_allocator_free(allocator, ...))
+  */
+ bcs_error_t sui_build_sensor_transaction_bytes_with_allocator(
+     const transaction_builder_t *params,
+     const bcs_allocator_t *allocator,
+     uint8_t **output,
+     size_t *output_length
+ );
+ 
+ /**
+  * Build a complete Sui transaction into a caller-supplied writer
+  *
+  * Same layout as sui_build_sensor_transaction() but appends raw BCS bytes
+  * to writer instead of allocating a hex string. Pair it with
+  * bcs_writer_init_fixed() to build without touching the heap.
+  *
+  * @param params  Transaction builder parameters
+  * @param writer  Initialized writer (growable, fixed or stream)
+  * @return BCS_OK on success, BCS_ERROR_BUFFER_TOO_SMALL if a fixed writer is full
+  *
+  * Example:
+  *   static uint8_t tx_buf[512];
+  *   bcs_writer_t writer;
+  *   bcs_writer_init_fixed(&writer, tx_buf, sizeof(tx_buf));
+  *
+  *   if (sui_build_sensor_transaction_into(&params, &writer) == BCS_OK) {
+  *       // tx_buf[0 .. writer.position) holds the transaction
+  *   }
+  */
+ bcs_error_t sui_build_sensor_transaction_into(
+     const transaction_builder_t *params,
+     bcs_writer_t *writer
+ );
+ 
+ /**
+  * Build one transaction that stores several readings
+  *
+  * Emits a single ProgrammableTransaction with one store_sensor_data
+  * MoveCall per reading, so N readings cost one signature and one
+  * submission. The Clock input and the device_id/sensor_type/location
+  * strings are shared by all calls, and identical reading values share a
+  * single Pure input. Package, sender and gas come from params;
+  * params->sensor_data is ignored.
+  *
+  * The server rebuilds single readings itself, so submit batches as raw
+  * bytes through /api/submit-tx.
+  *
+  * @param params        Transaction builder parameters
+  * @param readings      Readings to store, in call order
+  * @param num_readings  Number of readings (1..SUI_MAX_BATCH_READINGS)
+  * @param writer        Initialized writer (any mode, including stream)
+  * @return BCS_OK on success, BCS_ERROR_OVERFLOW if num_readings is too large
+  */
+ bcs_error_t sui_build_sensor_batch_transaction_into(
+     const transaction_builder_t *params,
+     const sensor_data_t *readings,
+     size_t num_readings,
+     bcs_writer_t *writer
+ );
+ 
+ /**
+  * Allocating variant of sui_build_sensor_batch_transaction_into()
+  *
+  * @param output         Output: transaction bytes (release with bcs_free())
+  * @param output_length  Output: length of transaction in bytes
+  */
+ bcs_error_t sui_build_sensor_batch_transaction_bytes(
+     const transaction_builder_t *params,
+     const sensor_data_t *readings,
+     size_t num_readings,
+     uint8_t **output,
+     size_t *output_length
+ );
+ 
+ /**
+  * sui_build_sensor_batch_transaction_bytes() with an explicit allocator
+  * (release output with bcs_allocator_free(allocator, ...))
+  */
+ bcs_error_t sui_build_sensor_batch_transaction_bytes_with_allocator(
+     const transaction_builder_t *params,
+     const sensor_data_t *readings,
+     size_t num_readings,
+     const bcs_allocator_t *allocator,
+     uint8_t **output,
+     size_t *output_length
+ );
+ 
+ /**
+  * Hex variant of sui_build_sensor_batch_transaction_into()
+  *
+  * @param output_hex     Output: transaction hex (release with bcs_free())
+  * @param output_length  Output: length of transaction hex
+  */
+ bcs_error_t sui_build_sensor_batch_transaction(
+     const transaction_builder_t *params,
+     const sensor_data_t *readings,
+     size_t num_readings,
+     char **output_hex,
+     size_t *output_length
+ );
+ 
+ /**
+  * sui_build_sensor_batch_transaction() with an explicit allocator
+  * (release output_hex with bcs_allocator_free(allocator, ...))
+  */
+ bcs_error_t sui_build_sensor_batch_transaction_with_allocator(
+     const transaction_builder_t *params,
+     const sensor_data_t *readings,
+     size_t num_readings,
+     const bcs_allocator_t *allocator,
+     char **output_hex,
+     size_t *output_length
+ );
+ 
+ /**
+  * Find how many readings fit in one batch under a byte budget
+  *
+  * @param params        Transaction builder parameters
+  * @param readings      Pending readings, oldest first
+  * @param num_readings  Number of pending readings
+  * @param max_bytes     Budget for the serialized transaction
+  * @param fit           Output: largest N such that the first N readings fit
+  *                      (0 if not even one does)
+  * @return BCS_OK on success, error code otherwise
+  */
+ bcs_error_t sui_sensor_batch_fit(
+     const transaction_builder_t *params,
+     const sensor_data_t *readings,
+     size_t num_readings,
+     size_t max_bytes,
+     size_t *fit
+ );
+ 
+ /**
+  * Compile a sensor transaction template
+  *
+  * Serializes params once and records the patchable slots. After this,
+  * each cycle only needs the sui_sensor_template_set_* calls (about 80
+  * bytes of stores); the bytes stay identical to a full
+  * sui_build_sensor_transaction() with the same values.
+  *
+  * @param params    Transaction builder parameters (invariant fields are baked in)
+  * @param buffer    Caller-owned storage, or NULL to allocate exactly the needed size
+  * @param capacity  Size of buffer (ignored when buffer is NULL)
+  * @param tpl       Output: compiled template
+  * @return BCS_OK on success, BCS_ERROR_BUFFER_TOO_SMALL if buffer is too small
+  *
+  * Example:
+  *   static uint8_t tx_buf[400];
+  *   sui_sensor_template_t tpl;
+  *   sui_compile_sensor_template(&params, tx_buf, sizeof(tx_buf), &tpl);  // once
+  *
+  *   // every cycle
+  *   sui_sensor_template_set_sensor_data(&tpl, &reading);
+  *   sui_sensor_template_set_gas_object(&tpl, &gas);
+  *   const uint8_t *tx = sui_sensor_template_bytes(&tpl, &tx_len);
+  */
+ bcs_error_t sui_compile_sensor_template(
+     const transaction_builder_t *params,
+     uint8_t *buffer,
+     size_t capacity,
+     sui_sensor_template_t *tpl
+ );
+ 
+ /**
+  * sui_compile_sensor_template() with an explicit allocator for the NULL
+  * buffer case; the template's writer remembers it, so
+  * sui_sensor_template_free() releases through the same allocator
+  */
+ bcs_error_t sui_compile_sensor_template_with_allocator(
+     const transaction_builder_t *params,
+     uint8_t *buffer,
+     size_t capacity,
+     const bcs_allocator_t *allocator,
+     sui_sensor_template_t *tpl
+ );
+ 
+ /**
+  * Release a template compiled with a NULL buffer (no-op for caller buffers)
+  */
+ void sui_sensor_template_free(sui_sensor_template_t *tpl);
+ 
+ /**
+  * Patch the four sensor readings (timestamp is not part of the transaction)
+  */
+ void sui_sensor_template_set_sensor_data(sui_sensor_template_t *tpl, const sensor_data_t *data);
+ 
+ /**
+  * Patch the gas payment object reference (ID, version, digest)
+  */
+ void sui_sensor_template_set_gas_object(sui_sensor_template_t *tpl, const gas_object_t *gas);
+ 
+ /**
+  * Patch the gas price and budget
+  */
+ void sui_sensor_template_set_gas(sui_sensor_template_t *tpl, uint64_t gas_price, uint64_t gas_budget);
+ 
+ /**
+  * Get the current template bytes
+  * @param length  Output: transaction length in bytes
+  * @return Pointer to the transaction (valid until the template is freed)
+  */
+ const uint8_t *sui_sensor_template_bytes(const sui_sensor_template_t *tpl, size_t *length);
+ 
+ /**
+  * Compute the exact serialized size of a sensor transaction
+  *
+  * Runs the builder against a counting writer, so nothing is allocated.
+  * The result always equals the number of bytes sui_build_sensor_transaction_into()
+  * appends for the same params.
+  *
+  * @param params  Transaction builder parameters
+  * @param length  Output: transaction size in bytes (hex is twice this)
+  * @return BCS_OK on success, error code otherwise
+  */
+ bcs_error_t sui_measure_sensor_transaction(
+     const transaction_builder_t *params,
+     size_t *length
+ );
+ 
  /**
   * Modify a Sui transaction with sensor data
   *
@@ -114,7 +511,7 @@
   *
   * @param hex_tx         Input full transaction in hex format (from TypeScript)
   * @param sensor_data    Sensor readings to inject
-  * @param output_hex     Output: modified transaction hex (caller must free)
+  * @param output_hex     Output: modified transaction hex (release with bcs_free())
   * @param output_length  Output: length of modified transaction
   * @return BCS_OK on success, error code otherwise
   *
@@ -128,7 +525,7 @@
   *
   *   if (err == BCS_OK) {
   *       send_to_backend(modified_tx);  // Ready to sign with Transaction.from()
-  *       free(modified_tx);
+  *       bcs_free(modified_tx);
   *   }
   */
  bcs_error_t sui_modify_transaction_with_sensor_data(
@@ -138,6 +535,38 @@
      size_t *output_length
  );
  
+ /**
+  * sui_modify_transaction_with_sensor_data() with an explicit allocator
+  * (release output_hex with bcs_allocator_free(allocator, ...))
+  */
+ bcs_error_t sui_modify_transaction_with_sensor_data_with_allocator(
+     const char *hex_tx,
+     const sensor_data_t *sensor_data,
+     const bcs_allocator_t *allocator,
+     char **output_hex,
+     size_t *output_length
+ );
+ 
+ /**
+  * Modify a binary Sui transaction with sensor data
+  *
+  * Same as sui_modify_transaction_with_sensor_data() but takes the raw
+  * transaction bytes and appends the modified bytes to writer, so no hex
+  * is involved.
+  *
+  * @param tx_bytes     Input full transaction bytes
+  * @param tx_length    Length of tx_bytes
+  * @param sensor_data  Sensor readings to inject
+  * @param writer       Initialized output writer (growable or fixed)
+  * @return BCS_OK on success, error code otherwise
+  */
+ bcs_error_t sui_modify_transaction_with_sensor_data_bytes(
+     const uint8_t *tx_bytes,
+     size_t tx_length,
+     const sensor_data_t *sensor_data,
+     bcs_writer_t *writer
+ );
+ 
  /**
   * Lower-level function: Modify transaction with custom Pure values
   *
@@ -147,7 +576,7 @@
   * @param pure_values    Array of byte arrays for Pure values
   * @param pure_lengths   Array of lengths for each Pure value
   * @param num_pures      Number of Pure values
-  * @param output_hex     Output: modified transaction hex (caller must free)
+  * @param output_hex     Output: modified transaction hex (release with bcs_free())
   * @param output_length  Output: length of modified transaction
   * @return BCS_OK on success, error code otherwise
   */
@@ -160,5 +589,213 @@
      size_t *output_length
  );
  
+ /**
+  * sui_modify_transaction_with_pure_values() with an explicit allocator for
+  * both the scratch buffer and output_hex (release with
+  * bcs_allocator_free(allocator, ...))
+  */
+ bcs_error_t sui_modify_transaction_with_pure_values_with_allocator(
+     const char *hex_tx,
+     const uint8_t **pure_values,
+     const size_t *pure_lengths,
+     size_t num_pures,
+     const bcs_allocator_t *allocator,
+     char **output_hex,
+     size_t *output_length
+ );
+ 
+ /**
+  * Modify transaction with custom Pure values into a caller-supplied writer
+  *
+  * Same as sui_modify_transaction_with_pure_values() but appends the raw
+  * modified transaction bytes to writer (growable or fixed).
+  *
+  * @param hex_tx         Input transaction hex
+  * @param pure_values    Array of byte arrays for Pure values
+  * @param pure_lengths   Array of lengths for each Pure value
+  * @param num_pures      Number of Pure values
+  * @param writer         Initialized output writer
+  * @return BCS_OK on success, error code otherwise
+  */
+ bcs_error_t sui_modify_transaction_with_pure_values_into(
+     const char *hex_tx,
+     const uint8_t **pure_values,
+     const size_t *pure_lengths,
+     size_t num_pures,
+     bcs_writer_t *writer
+ );
+ 
+ /**
+  * Modify a binary transaction with custom Pure values
+  *
+  * Same as sui_modify_transaction_with_pure_values_into() but takes raw
+  * transaction bytes instead of hex.
+  *
+  * @param tx_bytes       Input full transaction bytes
+  * @param tx_length      Length of tx_bytes
+  * @param pure_values    Array of byte arrays for Pure values
+  * @param pure_lengths   Array of lengths for each Pure value
+  * @param num_pures      Number of Pure values
+  * @param writer         Initialized output writer (growable or fixed)
+  * @return BCS_OK on success, error code otherwise
+  */
+ bcs_error_t sui_modify_transaction_with_pure_values_bytes(
+     const uint8_t *tx_bytes,
+     size_t tx_length,
+     const uint8_t **pure_values,
+     const size_t *pure_lengths,
+     size_t num_pures,
+     bcs_writer_t *writer
+ );
+ 
+ /**
+  * Index the Pure inputs of a serialized transaction
+  *
+  * Parses the inputs vector once and records where each Pure value lives,
+  * so later readings can be patched without re-parsing the template.
+  *
+  * @param tx_bytes   Full TransactionData bytes
+  * @param tx_length  Length of tx_bytes
+  * @param index      Output: Pure value offsets relative to tx_bytes
+  * @return BCS_OK on success, BCS_ERROR_OVERFLOW if there are more than
+  *         SUI_MAX_PURE_INPUTS Pure inputs, error code otherwise
+  */
+ bcs_error_t sui_index_pure_inputs(
+     const uint8_t *tx_bytes,
+     size_t tx_length,
+     sui_pure_index_t *index
+ );
+ 
+ /**
+  * Replace Pure input values of an indexed transaction
+  *
+  * Values with the same length as the template value are copied in place
+  * (no parsing, no allocation). A value of a different length is spliced
+  * in, moving the rest of the transaction, and index is updated to match.
+  * Missing values keep the template value; extra values are ignored.
+  * All slots are checked and room for any growth is made first, so on
+  * error the transaction bytes and index are unchanged.
+  *
+  * @param tx            Writer holding the transaction from offset 0
+  * @param index         Index from sui_index_pure_inputs() for tx
+  * @param pure_values   Array of byte arrays for Pure values
+  * @param pure_lengths  Array of lengths for each Pure value
+  * @param num_pures     Number of Pure values
+  * @return BCS_OK on success, error code otherwise
+  *
+  * Example:
+  *   sui_pure_index_t index;
+  *   sui_index_pure_inputs(tx.buffer, tx.position, &index);  // once
+  *
+  *   for (;;) {
+  *       sui_patch_pure_values(&tx, &index, values, lengths, 4);  // per reading
+  *       sign_and_submit(tx.buffer, tx.position);
+  *   }
+  */
+ bcs_error_t sui_patch_pure_values(
+     bcs_writer_t *tx,
+     sui_pure_index_t *index,
+     const uint8_t **pure_values,
+     const size_t *pure_lengths,
+     size_t num_pures
+ );
+ 
+ /**
+  * Index a full TransactionData in one pass without copying
+  *
+  * Records the inputs, commands, sender, gas payment, gas price and budget,
+  * and expiration. Every field is located by offset, so the index can also
+  * drive in-place edits anywhere in the transaction. Transactions with
+  * trailing bytes or unknown variants are rejected.
+  *
+  * @param tx_bytes   Full TransactionData bytes
+  * @param tx_length  Length of tx_bytes
+  * @param index      Output: transaction layout
+  * @return BCS_OK on success, BCS_ERROR_OVERFLOW if a limit in
+  *         sui_tx_index_t is exceeded, error code otherwise
+  */
+ bcs_error_t sui_index_transaction(
+     const uint8_t *tx_bytes,
+     size_t tx_length,
+     sui_tx_index_t *index
+ );
+ 
+ /**
+  * Check an indexed transaction against a signing policy
+  *
+  * Only compares bytes already located by sui_index_transaction(), so it
+  * is cheap enough to run before every signature.
+  *
+  * @param tx_bytes  Bytes that were indexed
+  * @param index     Index of tx_bytes
+  * @param policy    Expected sender, target and gas limits
+  * @return SUI_TX_CHECK_OK if the transaction may be signed, otherwise the
+  *         first violation found
+  *
+  * Example:
+  *   static sui_tx_index_t index;
+  *   sui_tx_policy_t policy = { my_address, my_address, package_id,
+  *                              "sensor_storage", "store_sensor_data", 100000000, 0 };
+  *
+  *   if (sui_index_transaction(tx, tx_len, &index) != BCS_OK ||
+  *       sui_check_transaction(tx, &index, &policy) != SUI_TX_CHECK_OK) {
+  *       return;  // Do not sign
+  *   }
+  */
+ sui_tx_check_t sui_check_transaction(
+     const uint8_t *tx_bytes,
+     const sui_tx_index_t *index,
+     const sui_tx_policy_t *policy
+ );
+ 
+ /**
+  * Describe a sui_check_transaction() result for logs
+  */
+ const char *sui_tx_check_name(sui_tx_check_t check);
+ 
+ /**
+  * Hash a transaction while it is being built
+  *
+  * Starts a Blake2b-256 over the prefix for kind and attaches it to
+  * writer, so the bytes written next are hashed as they are produced.
+  * Call bcs_writer_finish_hash() after the build for the digest.
+  *
+  * @param writer  Growable or fixed writer positioned at the transaction start
+  * @param hash    Hash state (must outlive the build)
+  * @param kind    SUI_DIGEST_INTENT or SUI_DIGEST_TRANSACTION
+  * @return BCS_OK on success, error code otherwise
+  *
+  * Example:
+  *   blake2b_state_t hash;
+  *   uint8_t digest[SUI_DIGEST_LENGTH];
+  *
+  *   sui_digest_begin(&writer, &hash, SUI_DIGEST_TRANSACTION);
+  *   sui_build_sensor_transaction_into(&params, &writer);
+  *   if (bcs_writer_finish_hash(&writer, digest) == BCS_OK) {
+  *       // digest is the transaction digest, no second pass over the bytes
+  *   }
+  */
+ bcs_error_t sui_digest_begin(
+     bcs_writer_t *writer,
+     blake2b_state_t *hash,
+     sui_digest_kind_t kind
+ );
+ 
+ /**
+  * Digest serialized transaction bytes in one call
+  *
+  * @param tx_bytes   Full TransactionData bytes
+  * @param tx_length  Length of tx_bytes
+  * @param kind       SUI_DIGEST_INTENT or SUI_DIGEST_TRANSACTION
+  * @param digest     Output: SUI_DIGEST_LENGTH bytes
+  * @return BCS_OK on success, error code otherwise
+  */
+ bcs_error_t sui_transaction_digest(
+     const uint8_t *tx_bytes,
+     size_t tx_length,
+     sui_digest_kind_t kind,
+     uint8_t *digest
+ );
+ 
  #endif // SUI_TRANSACTION_H
  
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "timer_wheel.h"
+#include <string.h>
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+// Signed distance keeps comparisons correct across millis() wrap-around
+static bool is_due(uint32_t deadline_ms, uint32_t now_ms) {
+    return (int32_t)(deadline_ms - now_ms) <= 0;
+}
+
+static uint32_t tick_of(const timer_wheel_t *wheel, uint32_t ms) {
+    return ms >> wheel->tick_shift;
+}
+
+static timer_wheel_timer_t **list_of(timer_wheel_t *wheel, uint8_t slot) {
+    return slot == TIMER_WHEEL_SLOTS ? &wheel->due : &wheel->slots[slot];
+}
+
+static void link(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint8_t slot) {
+    timer_wheel_timer_t **head = list_of(wheel, slot);
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = *head;
+    if (*head) {
+        (*head)->prev = timer;
+    }
+    *head = timer;
+}
+
+static void unlink(timer_wheel_t *wheel, timer_wheel_timer_t *timer) {
+    if (timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        *list_of(wheel, timer->slot) = timer->next;
+    }
+    if (timer->next) {
+        timer->next->prev = timer->prev;
+    }
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+// Move every due timer of one bucket to the due list
+static void collect_due(timer_wheel_t *wheel, uint8_t slot, uint32_t now_ms) {
+    timer_wheel_timer_t *timer = wheel->slots[slot];
+    while (timer) {
+        timer_wheel_timer_t *next = timer->next;
+        if (is_due(timer->deadline_ms, now_ms)) {
+            unlink(wheel, timer);
+            link(wheel, timer, TIMER_WHEEL_SLOTS);
+        }
+        timer = next;
+    }
+}
+
+// ============================================================================
+// Wheel implementation
+// ============================================================================
+
+void timer_wheel_init(timer_wheel_t *wheel, uint8_t tick_shift, uint32_t now_ms) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->tick_shift = tick_shift < 16 ? tick_shift : 16;
+    wheel->now_ms = now_ms;
+}
+
+void timer_wheel_timer_init(timer_wheel_timer_t *timer, timer_wheel_fn fn, void *ctx) {
+    memset(timer, 0, sizeof(*timer));
+    timer->fn = fn;
+    timer->ctx = ctx;
+}
+
+void timer_wheel_schedule(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint32_t delay_ms) {
+    timer_wheel_schedule_at(wheel, timer, wheel->now_ms + delay_ms);
+}
+
+void timer_wheel_schedule_at(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint32_t deadline_ms) {
+    timer_wheel_cancel(wheel, timer);
+
+    // A passed deadline goes in the current bucket, which the next advance
+    // visits first; earlier buckets would not be seen for a whole turn
+    uint32_t bucket_ms = is_due(deadline_ms, wheel->now_ms) ? wheel->now_ms : deadline_ms;
+
+    timer->deadline_ms = deadline_ms;
+    timer->armed = true;
+    link(wheel, timer, (uint8_t)(tick_of(wheel, bucket_ms) & (TIMER_WHEEL_SLOTS - 1)));
+    wheel->armed++;
+}
+
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer) {
+    if (!timer->armed) {
+        return;
+    }
+
+    unlink(wheel, timer);
+    timer->armed = false;
+    wheel->armed--;
+}
+
+size_t timer_wheel_advance(timer_wheel_t *wheel, uint32_t now_ms) {
+    // Time never runs backwards for the wheel
+    if ((int32_t)(now_ms - wheel->now_ms) < 0) {
+        now_ms = wheel->now_ms;
+    }
+
+    if (wheel->armed > 0) {
+        uint32_t from = tick_of(wheel, wheel->now_ms);
+        uint32_t ticks = tick_of(wheel, now_ms) - from;
+
+        if (ticks >= TIMER_WHEEL_SLOTS) {
+            for (uint8_t slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+                collect_due(wheel, slot, now_ms);
+            }
+        } else {
+            // The starting bucket again: it may hold timers later in that tick
+            for (uint32_t t = 0; t <= ticks; t++) {
+                collect_due(wheel, (uint8_t)((from + t) & (TIMER_WHEEL_SLOTS - 1)), now_ms);
+            }
+        }
+    }
+
+    wheel->now_ms = now_ms;
+
+    // Everything due is detached before the first callback runs, so timers
+    // re-armed from a callback wait for the next advance
+    size_t fired = 0;
+    while (wheel->due) {
+        timer_wheel_timer_t *timer = wheel->due;
+        timer_wheel_cancel(wheel, timer);
+        timer->fn(timer->ctx, now_ms);
+        fired++;
+    }
+
+    return fired;
+}
+
+bool timer_wheel_next_delay(const timer_wheel_t *wheel, uint32_t *delay_ms) {
+    bool found = false;
+    int32_t best = 0;
+
+    for (uint8_t slot = 0; slot <= TIMER_WHEEL_SLOTS; slot++) {
+        const timer_wheel_timer_t *timer = slot == TIMER_WHEEL_SLOTS ? wheel->due : wheel->slots[slot];
+        for (; timer; timer = timer->next) {
+            int32_t delay = (int32_t)(timer->deadline_ms - wheel->now_ms);
+            if (!found || delay < best) {
+                best = delay;
+                found = true;
+            }
+        }
+    }
+
+    if (found && delay_ms) {
+        *delay_ms = best > 0 ? (uint32_t)best : 0;
+    }
+    return found;
+}
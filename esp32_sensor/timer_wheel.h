@@ -0,0 +1,105 @@
+/**
+ * Timer Wheel
+ * Hashed timing wheel for millisecond timers on a caller-supplied clock
+ *
+ * Timers are intrusive (the caller owns their storage) and hashed into
+ * TIMER_WHEEL_SLOTS buckets by deadline tick. Advancing the clock visits
+ * only the buckets of the ticks that elapsed, so a poll costs the same
+ * however many timers are armed; deadlines further out than one turn of
+ * the wheel simply stay in their bucket until due. A tick is 2^tick_shift
+ * ms, which keeps the bucket sequence continuous across the 32-bit
+ * millis() wrap.
+ *
+ * The wheel never reads a clock: pass millis() on the device, or any
+ * simulated time in host builds.
+ *
+ * Example:
+ *   timer_wheel_t wheel;
+ *   timer_wheel_timer_t sample;
+ *   timer_wheel_init(&wheel, 4, millis());              // 16 ms ticks
+ *   timer_wheel_timer_init(&sample, on_sample, NULL);
+ *   timer_wheel_schedule(&wheel, &sample, 60000);
+ *   ...
+ *   timer_wheel_advance(&wheel, millis());             // from loop()
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TIMER_WHEEL_SLOTS 64    // Power of two
+
+/**
+ * Timer callback
+ * @param now_ms Time passed to the timer_wheel_advance() call that fired it
+ */
+typedef void (*timer_wheel_fn)(void *ctx, uint32_t now_ms);
+
+typedef struct timer_wheel_timer {
+    struct timer_wheel_timer *next;
+    struct timer_wheel_timer *prev;
+    uint32_t deadline_ms;
+    timer_wheel_fn fn;
+    void *ctx;
+    uint8_t slot;           // Bucket while armed (TIMER_WHEEL_SLOTS = due list)
+    bool armed;
+} timer_wheel_timer_t;
+
+/**
+ * Wheel state
+ */
+typedef struct {
+    timer_wheel_timer_t *slots[TIMER_WHEEL_SLOTS];
+    timer_wheel_timer_t *due;   // Detached by the running advance, not yet fired
+    uint8_t tick_shift;     // Tick = 2^tick_shift ms
+    uint32_t now_ms;        // Time of the last advance
+    size_t armed;           // Timers currently scheduled
+} timer_wheel_t;
+
+/**
+ * Set up an empty wheel
+ * @param tick_shift Tick length as a power of two (e.g. 4 = 16 ms)
+ * @param now_ms Current time
+ */
+void timer_wheel_init(timer_wheel_t *wheel, uint8_t tick_shift, uint32_t now_ms);
+
+/**
+ * Set up a timer (not armed)
+ */
+void timer_wheel_timer_init(timer_wheel_timer_t *timer, timer_wheel_fn fn, void *ctx);
+
+/**
+ * Arm timer to fire delay_ms after the last advance
+ * An armed timer is moved to the new deadline.
+ */
+void timer_wheel_schedule(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint32_t delay_ms);
+
+/**
+ * Arm timer for an absolute deadline (periodic timers stay drift-free by
+ * adding their period to the previous deadline)
+ * A deadline that has already passed fires on the next advance.
+ */
+void timer_wheel_schedule_at(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint32_t deadline_ms);
+
+/**
+ * Disarm timer (no-op if it is not armed)
+ */
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer);
+
+/**
+ * Move the clock to now_ms and fire every timer that is due
+ * Callbacks may arm or cancel timers; one that re-arms itself for a
+ * deadline already passed fires on the next advance, not in a loop.
+ * @return Number of timers fired
+ */
+size_t timer_wheel_advance(timer_wheel_t *wheel, uint32_t now_ms);
+
+/**
+ * Milliseconds from the last advance until the earliest deadline
+ * @return false if no timer is armed
+ */
+bool timer_wheel_next_delay(const timer_wheel_t *wheel, uint32_t *delay_ms);
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,235 @@
+#include "tx_pipeline.h"
+#include "base_codec.h"
+#include <string.h>
+
+// ============================================================================
+// Internal helper functions
+// ============================================================================
+
+// Run one request to completion; sets http_status (0 if no reply, in which
+// case the connection is closed) and error.
+// Returns true if the request may have reached the server.
+static bool exchange(tx_pipeline_network_t *network, const char *path, const char *content_type,
+                     const async_http_part_t *body, size_t parts, tx_pipeline_result_t *result) {
+    const tx_pipeline_server_t *server = &network->server;
+    async_http_t *http = &network->http;
+
+    result->http_status = 0;
+    result->error = async_http_start(http, server->host, server->port, "POST", path, content_type, body, parts,
+                                     network->response, sizeof(network->response));
+    if (result->error != ASYNC_HTTP_OK) {
+        async_http_close(http);
+        return false;
+    }
+
+    uint32_t start = server->now_ms();
+    while (async_http_poll(http), async_http_busy(http)) {
+        if (server->now_ms() - start > server->timeout_ms) {
+            bool sent = http->state != ASYNC_HTTP_CONNECTING;
+            result->error = ASYNC_HTTP_ERROR_RECEIVE;
+            async_http_close(http);
+            return sent;
+        }
+        server->idle();
+    }
+
+    if (http->state == ASYNC_HTTP_FAILED) {
+        bool sent = http->error != ASYNC_HTTP_ERROR_CONNECT && http->error != ASYNC_HTTP_ERROR_RESOLVE;
+        result->error = http->error;
+        async_http_close(http);
+        return sent;
+    }
+
+    result->http_status = async_http_status(http);
+    return true;
+}
+
+static tx_pipeline_status_t status_of(int http_status) {
+    if (http_status == 200) {
+        return TX_PIPELINE_OK;
+    }
+    return http_status == 409 ? TX_PIPELINE_CONFLICT : TX_PIPELINE_FAILED;
+}
+
+// POST network->frame (length bytes) and parse the reply frame. ERROR frames
+// become their status; reply is only set for a 200 with a well-formed frame.
+static tx_pipeline_status_t exchange_frame(tx_pipeline_network_t *network, size_t length,
+                                           tx_pipeline_result_t *result, sensor_frame_t *reply) {
+    async_http_part_t body = { network->frame, length };
+    result->sent = exchange(network, network->server.frame_path, "application/octet-stream", &body, 1, result);
+    if (result->http_status == 0) {
+        return TX_PIPELINE_FAILED;
+    }
+
+    size_t reply_length;
+    const uint8_t *data = async_http_body(&network->http, &reply_length);
+    bcs_error_t err = sensor_frame_parse(data, reply_length, reply);
+    async_http_close(&network->http);
+    if (err != BCS_OK) {
+        return TX_PIPELINE_FAILED;
+    }
+
+    if (reply->type == SENSOR_FRAME_ERROR) {
+        uint16_t status = 0;
+        bcs_view_t message = { NULL, 0 };
+        sensor_frame_read_error(reply, &status, &message);
+        result->http_status = status;
+        return status == 200 ? TX_PIPELINE_FAILED : status_of(status);
+    }
+    return status_of(result->http_status);
+}
+
+static tx_pipeline_status_t serve_gas_coins(tx_pipeline_network_t *network, const tx_pipeline_request_t *request,
+                                            tx_pipeline_result_t *result) {
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, network->frame, sizeof(network->frame));
+    if (sensor_frame_write_gas_coins_request(&writer, request->sender, request->coins) != BCS_OK) {
+        return TX_PIPELINE_FAILED;
+    }
+
+    sensor_frame_t reply;
+    tx_pipeline_status_t status = exchange_frame(network, writer.position, result, &reply);
+    if (status != TX_PIPELINE_OK) {
+        return status;
+    }
+    if (sensor_frame_read_gas_coins_response(&reply, &result->coins) != BCS_OK || result->coins.gas_count == 0) {
+        return TX_PIPELINE_FAILED;
+    }
+    return TX_PIPELINE_OK;
+}
+
+static tx_pipeline_status_t serve_execute(tx_pipeline_network_t *network, const tx_pipeline_request_t *request,
+                                          tx_pipeline_result_t *result) {
+    bcs_writer_t writer;
+    bcs_writer_init_fixed(&writer, network->frame, sizeof(network->frame));
+    if (sensor_frame_write_execute_request(&writer, &request->reading, &request->gas, request->signature) !=
+        BCS_OK) {
+        return TX_PIPELINE_FAILED;
+    }
+
+    sensor_frame_t reply;
+    tx_pipeline_status_t status = exchange_frame(network, writer.position, result, &reply);
+    if (status != TX_PIPELINE_OK) {
+        return status;
+    }
+
+    // Executed either way; without next refs the coin is refetched before reuse
+    result->have_next = sensor_frame_read_execute_response(&reply, result->tx_digest, &result->next) == BCS_OK;
+    return TX_PIPELINE_OK;
+}
+
+// {"txBytes": hex, "signature": b64}, sent from the scratch buffers in parts
+static tx_pipeline_status_t serve_submit_tx(tx_pipeline_network_t *network, const tx_pipeline_request_t *request,
+                                            tx_pipeline_result_t *result) {
+    if (request->tx_length > TX_PIPELINE_MAX_TX_BYTES) {
+        return TX_PIPELINE_FAILED;
+    }
+
+    size_t signature_length = 0;
+    bcs_bytes_to_hex(request->tx_bytes, request->tx_length, network->hex);
+    if (base64_encode(request->signature, SUI_SIGNATURE_LENGTH, network->signature_b64,
+                      sizeof(network->signature_b64), &signature_length) != BCS_OK) {
+        return TX_PIPELINE_FAILED;
+    }
+
+    static const char head[] = "{\"txBytes\":\"";
+    static const char middle[] = "\",\"signature\":\"";
+    static const char tail[] = "\"}";
+    async_http_part_t body[] = {
+        { (const uint8_t *)head, sizeof(head) - 1 },
+        { (const uint8_t *)network->hex, request->tx_length * 2 },
+        { (const uint8_t *)middle, sizeof(middle) - 1 },
+        { (const uint8_t *)network->signature_b64, signature_length },
+        { (const uint8_t *)tail, sizeof(tail) - 1 },
+    };
+
+    result->sent = exchange(network, network->server.submit_tx_path, "application/json", body,
+                            sizeof(body) / sizeof(body[0]), result);
+    async_http_close(&network->http);
+    return result->http_status == 0 ? TX_PIPELINE_FAILED : status_of(result->http_status);
+}
+
+// ============================================================================
+// Pipeline implementation
+// ============================================================================
+
+void tx_pipeline_init(tx_pipeline_t *pipeline) {
+    spsc_ring_init(&pipeline->requests, pipeline->request_storage, sizeof(tx_pipeline_request_t),
+                   TX_PIPELINE_DEPTH);
+    spsc_ring_init(&pipeline->results, pipeline->result_storage, sizeof(tx_pipeline_result_t), TX_PIPELINE_DEPTH);
+    pipeline->epoch = 0;
+}
+
+tx_pipeline_request_t *tx_pipeline_reserve(tx_pipeline_t *pipeline) {
+    return (tx_pipeline_request_t *)spsc_ring_reserve(&pipeline->requests);
+}
+
+void tx_pipeline_commit(tx_pipeline_t *pipeline) {
+    tx_pipeline_request_t *request = (tx_pipeline_request_t *)spsc_ring_reserve(&pipeline->requests);
+    request->epoch = pipeline->epoch;
+    spsc_ring_commit(&pipeline->requests);
+}
+
+bool tx_pipeline_poll_result(tx_pipeline_t *pipeline, tx_pipeline_result_t *result) {
+    if (spsc_ring_pop(&pipeline->results, result) != SPSC_RING_OK) {
+        return false;
+    }
+
+    if (result->kind != TX_PIPELINE_GAS_COINS && result->epoch == pipeline->epoch &&
+        (result->status == TX_PIPELINE_FAILED || result->status == TX_PIPELINE_CONFLICT)) {
+        pipeline->epoch++;
+    }
+    return true;
+}
+
+void tx_pipeline_network_init(tx_pipeline_network_t *network, const tx_pipeline_server_t *server) {
+    memset(network, 0, sizeof(*network));
+    network->server = *server;
+    async_http_init(&network->http);
+}
+
+bool tx_pipeline_serve(tx_pipeline_t *pipeline, tx_pipeline_network_t *network) {
+    const tx_pipeline_request_t *request = (const tx_pipeline_request_t *)spsc_ring_peek(&pipeline->requests);
+    if (!request) {
+        return false;
+    }
+    tx_pipeline_result_t *result = (tx_pipeline_result_t *)spsc_ring_reserve(&pipeline->results);
+    if (!result) {
+        return false;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->kind = request->kind;
+    result->epoch = request->epoch;
+    result->count = request->count;
+    result->lease = request->lease;
+
+    // A new epoch means the device has seen the failure and moved on
+    if (network->failing && request->epoch != network->failed_epoch) {
+        network->failing = false;
+    }
+
+    tx_pipeline_status_t status;
+    bool transaction = request->kind != TX_PIPELINE_GAS_COINS;
+    if (transaction && network->failing) {
+        status = TX_PIPELINE_SKIPPED;
+    } else if (request->kind == TX_PIPELINE_GAS_COINS) {
+        status = serve_gas_coins(network, request, result);
+    } else if (request->kind == TX_PIPELINE_EXECUTE) {
+        status = serve_execute(network, request, result);
+    } else if (request->kind == TX_PIPELINE_SUBMIT_TX) {
+        status = serve_submit_tx(network, request, result);
+    } else {
+        status = TX_PIPELINE_FAILED;
+    }
+
+    if (transaction && (status == TX_PIPELINE_FAILED || status == TX_PIPELINE_CONFLICT)) {
+        network->failing = true;
+        network->failed_epoch = request->epoch;
+    }
+
+    result->status = (uint8_t)status;
+    spsc_ring_release(&pipeline->requests);
+    spsc_ring_commit(&pipeline->results);
+    return true;
+}
@@ -0,0 +1,195 @@
+/**
+ * TX Pipeline
+ * Hands signed transactions from the device core to a network core
+ *
+ * The device side (sampling, BCS building, Ed25519 signing) queues
+ * requests into one SPSC ring; the network side takes them in order, does
+ * the HTTP exchange with the server and queues a result for each into a
+ * second ring. Both rings hold fixed-size records in static storage, so
+ * neither side allocates, locks or waits on the other; the gas pool and
+ * reading log are only ever touched on the device side, which settles
+ * leases and commits readings as results come back.
+ *
+ * Requests are sent one at a time, in order. When a transaction fails,
+ * the ones queued behind it (built for readings after the failed ones)
+ * come back SKIPPED without being sent, so readings always reach the
+ * chain in log order; the device's next requests are sent again.
+ *
+ * The network side only needs sockets, a millisecond clock and a way to
+ * yield, so the same code runs in a FreeRTOS task and in a std::thread.
+ *
+ * Example (ESP32):
+ *   static tx_pipeline_t pipeline;
+ *   static tx_pipeline_network_t network;
+ *   tx_pipeline_init(&pipeline);
+ *   tx_pipeline_network_init(&network, &server);
+ *   xTaskCreatePinnedToCore(networkTask, "net", 8192, NULL, 1, NULL, 0);
+ *
+ *   void networkTask(void *) {
+ *       for (;;) {
+ *           if (!tx_pipeline_serve(&pipeline, &network)) vTaskDelay(1);
+ *       }
+ *   }
+ */
+
+#ifndef TX_PIPELINE_H
+#define TX_PIPELINE_H
+
+#include "spsc_ring.h"
+#include "async_http.h"
+#include "sensor_frame.h"
+#include "gas_pool.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef TX_PIPELINE_DEPTH
+#define TX_PIPELINE_DEPTH 4             // Requests (and results) in flight; power of two
+#endif
+
+#ifndef TX_PIPELINE_MAX_TX_BYTES
+#define TX_PIPELINE_MAX_TX_BYTES 4096   // Largest batched transaction
+#endif
+
+#define TX_PIPELINE_RESPONSE_SIZE 2048  // Reply headers and body
+
+typedef enum {
+    TX_PIPELINE_GAS_COINS = 1,      // Fetch the sensor ref and gas coins (frame)
+    TX_PIPELINE_EXECUTE,            // Single reading, sponsored execution (frame)
+    TX_PIPELINE_SUBMIT_TX,          // Signed transaction bytes (JSON submit-tx)
+} tx_pipeline_kind_t;
+
+typedef enum {
+    TX_PIPELINE_OK = 0,
+    TX_PIPELINE_FAILED,             // Network error, timeout or server error
+    TX_PIPELINE_CONFLICT,           // Stale gas version (HTTP 409)
+    TX_PIPELINE_SKIPPED,            // Not sent: an earlier transaction failed
+} tx_pipeline_status_t;
+
+/**
+ * Request record (device -> network)
+ */
+typedef struct {
+    uint8_t kind;                   // tx_pipeline_kind_t
+    uint8_t epoch;                  // Stamped by tx_pipeline_commit()
+    uint8_t count;                  // Readings in the transaction
+    gas_pool_lease_t lease;         // Returned with the result, untouched
+
+    // GAS_COINS
+    uint8_t sender[32];
+    uint8_t coins;
+
+    // EXECUTE
+    sensor_data_t reading;
+    gas_object_t gas;
+
+    // EXECUTE and SUBMIT_TX
+    uint8_t signature[SUI_SIGNATURE_LENGTH];
+
+    // SUBMIT_TX
+    size_t tx_length;
+    uint8_t tx_bytes[TX_PIPELINE_MAX_TX_BYTES];
+} tx_pipeline_request_t;
+
+/**
+ * Result record (network -> device)
+ */
+typedef struct {
+    uint8_t kind;
+    uint8_t epoch;
+    uint8_t count;
+    uint8_t status;                 // tx_pipeline_status_t
+    gas_pool_lease_t lease;
+    bool sent;                      // Reached the server; the gas version may have moved
+    int http_status;                // 0 if no reply arrived
+    async_http_error_t error;       // Transport error when http_status is 0
+
+    // EXECUTE
+    uint8_t tx_digest[32];
+    bool have_next;
+    sensor_frame_digest_t next;     // Refs left by the execution
+
+    // GAS_COINS
+    sensor_frame_gas_coins_t coins;
+} tx_pipeline_result_t;
+
+/**
+ * Rings and their storage
+ */
+typedef struct {
+    spsc_ring_t requests;
+    spsc_ring_t results;
+    tx_pipeline_request_t request_storage[TX_PIPELINE_DEPTH];
+    tx_pipeline_result_t result_storage[TX_PIPELINE_DEPTH];
+    uint8_t epoch;                  // Device side: stamped on new requests
+} tx_pipeline_t;
+
+/**
+ * Server the network side talks to
+ */
+typedef struct {
+    const char *host;               // Must stay valid
+    uint16_t port;
+    const char *frame_path;         // e.g. "/api/frame"
+    const char *submit_tx_path;     // e.g. "/api/submit-tx"
+    uint32_t timeout_ms;            // Per request
+    uint32_t (*now_ms)(void);
+    void (*idle)(void);             // Called between polls of a request in flight
+} tx_pipeline_server_t;
+
+/**
+ * Network side state (scratch buffers for one request)
+ */
+typedef struct {
+    tx_pipeline_server_t server;
+    async_http_t http;
+    bool failing;                   // A transaction of failed_epoch failed
+    uint8_t failed_epoch;
+    uint8_t frame[SENSOR_FRAME_MAX_SIZE];
+    char hex[TX_PIPELINE_MAX_TX_BYTES * 2 + 1];
+    char signature_b64[(SUI_SIGNATURE_LENGTH + 2) / 3 * 4 + 1];
+    uint8_t response[TX_PIPELINE_RESPONSE_SIZE];
+} tx_pipeline_network_t;
+
+/**
+ * Set up empty rings
+ */
+void tx_pipeline_init(tx_pipeline_t *pipeline);
+
+// ============================================================================
+// Device side
+// ============================================================================
+
+/**
+ * Next free request record to fill, or NULL if DEPTH requests are queued
+ */
+tx_pipeline_request_t *tx_pipeline_reserve(tx_pipeline_t *pipeline);
+
+/**
+ * Queue the reserved request
+ */
+void tx_pipeline_commit(tx_pipeline_t *pipeline);
+
+/**
+ * Take the oldest result
+ * A FAILED or CONFLICT transaction moves the epoch on, so requests queued
+ * after this call are sent even though older ones come back SKIPPED.
+ * @return false if there is none
+ */
+bool tx_pipeline_poll_result(tx_pipeline_t *pipeline, tx_pipeline_result_t *result);
+
+// ============================================================================
+// Network side
+// ============================================================================
+
+void tx_pipeline_network_init(tx_pipeline_network_t *network, const tx_pipeline_server_t *server);
+
+/**
+ * Handle the oldest request, if any, and queue its result
+ * Blocks the calling task (not the device core) until the exchange ends
+ * or times out.
+ * @return false if there was nothing to do (no request, or no room for
+ *         its result yet)
+ */
+bool tx_pipeline_serve(tx_pipeline_t *pipeline, tx_pipeline_network_t *network);
+
+#endif // TX_PIPELINE_H